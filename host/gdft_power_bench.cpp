@@ -0,0 +1,225 @@
+// Host benchmark: GDFT post-processing in magnitudes (default) versus
+// squared magnitudes (GDFT_POWER_DOMAIN, src/GDFT_optimized.h).
+//
+// Both pipelines are fed the same per-bin Goertzel powers, a few
+// drifting tones over a noise floor, and everything after the
+// Goertzel pass is timed: sqrt/normalize, EMA, noise subtraction,
+// smoothing, AGC and the spectrogram[] write. The mean difference
+// between the two spectrogram outputs is printed as well.
+//
+// Built with the rest of the host tools (host/CMakeLists.txt):
+//   cmake -S host -B build-host && cmake --build build-host --target gdft_power_bench
+
+#include <Arduino.h>
+#include <FixedPoints.h>
+#include <FixedPointsCommon.h>
+
+#define GDFT_POWER_DOMAIN
+#define NUM_FREQS 64
+
+// AGC floor constants, as defined in src/globals.h
+#define AGC_FLOOR_SCALING_FACTOR (0.01)
+#define AGC_FLOOR_MIN_CLAMP_RAW (10.0)
+#define AGC_FLOOR_MAX_CLAMP_RAW (30000.0)
+#define AGC_FLOOR_MIN_CLAMP_SCALED (0.5)
+#define AGC_FLOOR_MAX_CLAMP_SCALED (100.0)
+
+// Globals the pipelines touch (src/core/globals.cpp) ----------------
+SQ15x16 spectrogram[NUM_FREQS];
+SQ15x16 noise_samples[NUM_FREQS];
+uint16_t noise_iterations = 0;
+bool noise_complete = true;
+float magnitudes[NUM_FREQS];
+float magnitudes_normalized[NUM_FREQS];
+float magnitudes_normalized_avg[NUM_FREQS];
+float magnitudes_last[NUM_FREQS];
+float magnitudes_final[NUM_FREQS];
+float SYSTEM_FPS = 120.0;
+SQ15x16 min_silent_level_tracker = 300.0;
+
+// Per-chunk smoothing rates (src/i2s_audio.h), at the default hop
+struct audio_hop_rates {
+  double magnitude_avg;
+  double agc_rise;
+  double agc_fall;
+};
+audio_hop_rates hop_rates = {0.3, 0.0100, 0.0050};
+
+// Helpers from src/utilities.h and src/noise_cal.h ------------------
+SQ15x16 fmin_fixed(SQ15x16 a, SQ15x16 b) { return (a < b) ? a : b; }
+SQ15x16 fmax_fixed(SQ15x16 a, SQ15x16 b) { return (a > b) ? a : b; }
+
+float low_pass_filter(float new_data, float last_data, uint32_t sample_rate, float cutoff_freq) {
+  float alpha = 1.0 - expf(-2.0 * PI * cutoff_freq / sample_rate);
+  return (1.0 - alpha) * (last_data) + alpha * new_data;
+}
+
+void low_pass_array(float* new_frame, float* last_frame, uint16_t length, uint32_t sample_rate, float cutoff_freq) {
+  for (uint16_t i = 0; i < length; i++) {
+    new_frame[i] = low_pass_filter(new_frame[i], last_frame[i], sample_rate, cutoff_freq);
+  }
+}
+
+void complete_noise_cal() {
+  noise_complete = true;
+}
+
+#include "../src/GDFT_optimized.h"
+
+float inv_block_size_half[NUM_FREQS];
+
+// The default pipeline, as in process_GDFT() (src/GDFT.h) ------------
+void magnitude_pipeline(const int32_t* powers, float mood_val) {
+  static SQ15x16 goertzel_max_value = 0.0001;
+
+  for (uint16_t i = 0; i < NUM_FREQS; i++) {
+    magnitudes[i] = powers[i];
+
+    float x = (float)magnitudes[i];
+    float xhalf = 0.5f * x;
+    int i_magic;
+    memcpy(&i_magic, &x, sizeof(x));
+    i_magic = 0x5f375a86 - (i_magic >> 1);
+    memcpy(&x, &i_magic, sizeof(x));
+    x = x * (1.5f - xhalf * x * x);
+    magnitudes[i] = ((float)magnitudes[i]) * x;
+
+    magnitudes_normalized[i] = magnitudes[i] * inv_block_size_half[i];
+    magnitudes_normalized_avg[i] = (magnitudes_normalized[i] * 0.3) + (magnitudes_normalized_avg[i] * (1.0 - 0.3));
+  }
+
+  for (uint8_t i = 0; i < NUM_FREQS; i += 1) {
+    if (noise_complete == true) {
+      magnitudes_normalized_avg[i] -= float(noise_samples[i] * SQ15x16(1.2));
+      if (magnitudes_normalized_avg[i] < 0.0) {
+        magnitudes_normalized_avg[i] = 0.0;
+      }
+    }
+  }
+
+  memcpy(magnitudes_final, magnitudes_normalized_avg, sizeof(float) * NUM_FREQS);
+  low_pass_array(magnitudes_final, magnitudes_last, NUM_FREQS, SYSTEM_FPS, 3.0 + (12.0 * mood_val));
+  memcpy(magnitudes_last, magnitudes_final, sizeof(float) * NUM_FREQS);
+
+  SQ15x16 max_value = 0.00001;
+  for (uint8_t i = 0; i < NUM_FREQS; i += 1) {
+    if (magnitudes_final[i] > max_value) {
+      max_value = magnitudes_final[i];
+    }
+  }
+  max_value *= SQ15x16(0.995);
+
+  if (max_value > goertzel_max_value) {
+    goertzel_max_value += (max_value - goertzel_max_value) * SQ15x16(0.0100);
+  } else if (goertzel_max_value > max_value) {
+    goertzel_max_value -= (goertzel_max_value - max_value) * SQ15x16(0.0050);
+  }
+
+  SQ15x16 floor_scaled = gdft_agc_floor();
+  if (goertzel_max_value < floor_scaled) {
+    goertzel_max_value = floor_scaled;
+  }
+
+  SQ15x16 multiplier = SQ15x16(1.0) / goertzel_max_value;
+  multiplier += SQ15x16(0.10);
+
+  for (uint16_t i = 0; i < NUM_FREQS; i += 1) {
+    spectrogram[i] = magnitudes_final[i] * multiplier;
+  }
+}
+
+// The power-domain pipeline (GDFT_POWER_DOMAIN) ----------------------
+void power_pipeline(const int32_t* powers, float mood_val) {
+  for (uint16_t i = 0; i < NUM_FREQS; i++) {
+    magnitudes[i] = powers[i];
+    magnitudes_normalized[i] = magnitudes[i] * (inv_block_size_half[i] * inv_block_size_half[i]);
+    magnitudes_normalized_avg[i] = (magnitudes_normalized[i] * 0.3) + (magnitudes_normalized_avg[i] * (1.0 - 0.3));
+  }
+  GDFT_squared_magnitudes(mood_val);
+}
+
+void reset_state() {
+  memset(magnitudes_normalized_avg, 0, sizeof(magnitudes_normalized_avg));
+  memset(magnitudes_last, 0, sizeof(magnitudes_last));
+}
+
+// Deterministic Goertzel-like powers: three drifting tones + noise
+void make_frame(uint32_t frame, int32_t* powers) {
+  static uint32_t rng = 12345;
+  for (uint16_t i = 0; i < NUM_FREQS; i++) {
+    rng = rng * 1664525 + 1013904223;
+    float block = 2.0 / inv_block_size_half[i];
+    float mag = 3.0 + (rng >> 24) / 64.0;
+    for (uint8_t t = 0; t < 3; t++) {
+      float centre = 32.0 + 24.0 * sin(frame * 0.002 * (t + 1) + t);
+      float distance = i - centre;
+      mag += 60.0 * expf(-distance * distance * 0.5) * (0.6 + 0.4 * sin(frame * 0.05 * (t + 1)));
+    }
+    float raw = mag * block * 0.5;
+    powers[i] = (int32_t)fminf(raw * raw, 2.0e9);
+  }
+}
+
+int main() {
+  const uint32_t frames = 4096;
+  const uint32_t passes = 50;
+  static int32_t powers[frames][NUM_FREQS];
+
+  for (uint16_t i = 0; i < NUM_FREQS; i++) {
+    uint16_t block_size = 32 + (NUM_FREQS - i) * 3;
+    inv_block_size_half[i] = 2.0 / block_size;
+    noise_samples[i] = 2.0;
+  }
+  for (uint32_t f = 0; f < frames; f++) {
+    make_frame(f, powers[f]);
+  }
+  init_power_compression_lut();
+
+  // Output difference, frame by frame (after both have settled)
+  static float reference[frames][NUM_FREQS];
+  reset_state();
+  for (uint32_t f = 0; f < frames; f++) {
+    magnitude_pipeline(powers[f], 0.5);
+    for (uint16_t i = 0; i < NUM_FREQS; i++) {
+      reference[f][i] = float(spectrogram[i]);
+    }
+  }
+  reset_state();
+  double diff_sum = 0.0;
+  double ref_sum = 0.0;
+  for (uint32_t f = 0; f < frames; f++) {
+    power_pipeline(powers[f], 0.5);
+    if (f >= frames / 2) {
+      for (uint16_t i = 0; i < NUM_FREQS; i++) {
+        diff_sum += fabs(float(spectrogram[i]) - reference[f][i]);
+        ref_sum += fabs(reference[f][i]);
+      }
+    }
+  }
+
+  // Timing
+  uint32_t t_start = micros();
+  for (uint32_t p = 0; p < passes; p++) {
+    for (uint32_t f = 0; f < frames; f++) {
+      magnitude_pipeline(powers[f], 0.5);
+    }
+  }
+  uint32_t t_magnitude = micros() - t_start;
+
+  t_start = micros();
+  for (uint32_t p = 0; p < passes; p++) {
+    for (uint32_t f = 0; f < frames; f++) {
+      power_pipeline(powers[f], 0.5);
+    }
+  }
+  uint32_t t_power = micros() - t_start;
+
+  double total_frames = double(frames) * passes;
+  printf("GDFT post-processing, %d bins, %.0f frames\n", NUM_FREQS, total_frames);
+  printf("  magnitude pipeline: %8.1f ns/frame\n", t_magnitude * 1000.0 / total_frames);
+  printf("  power pipeline:     %8.1f ns/frame\n", t_power * 1000.0 / total_frames);
+  printf("  speedup:            %8.2fx\n", double(t_magnitude) / double(t_power));
+  printf("  mean |spectrogram difference|: %.2f%% of mean output\n", 100.0 * diff_sum / (ref_sum > 0.0 ? ref_sum : 1.0));
+
+  return 0;
+}
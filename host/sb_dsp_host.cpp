@@ -0,0 +1,1097 @@
+// Host driver for the Sensory Bridge audio DSP chain.
+//
+// Compiles the firmware's own audio path (i2s_audio.h, sample_window.h,
+// GDFT*.h, led_utilities.h, ...) against host/shim, then plays WAV files
+// through it in place of the I2S microphone, one hop (audio_hop_size,
+// CONFIG.SAMPLES_PER_CHUNK unless --hop) per frame, in the same order
+// run_audio_frame() runs the stages.
+//
+// Reports frames/second, the mean/max time of every stage, and FNV-1a
+// checksums of spectrogram[] and chromagram_smooth[] over each clip, so
+// a DSP change can be profiled and regression-checked without hardware.
+//
+// With --leds N, every frame is also rendered (--mode, GDFT unless
+// given) and post-processed for an N-LED strip both ways show_leds()
+// can: stage by stage and fused (led_utilities.h). Both are timed, and
+// any frame where their leds_out[] differ is counted. --render sets the
+// width the mode draws at (render_resolution=), 'led' to match the
+// strip. The analysis then runs only the stages that mode reads
+// (analysis_demand.h), unless --full-analysis.
+//
+// With --trace FILE, the frame and stage trace events main.cpp pushes
+// (AudioFrameTracer, LEDFrameTracer) are written to FILE as the same
+// framed binary stream trace_stream=on sends over USB, for
+// sb_trace_convert. Everything runs on one thread here, so it's all
+// core 0's track, timed by the wall clock.
+//
+// With --telemetry FILE, every telemetry channel (telemetry_stream.h) is
+// written to FILE as telemetry=all would send it, unthrottled, for
+// sb_telemetry_record --info. The LED channels need --leds, and their
+// timestamps are the wall clock.
+//
+// With --record FILE, the run is recorded as session=record would
+// (session_record.h): the START snapshot, every CONFIG and settings change, each
+// hop's raw samples and, with --leds, each LED frame's checksum.
+// --replay FILE plays such a recording (or a session=send capture from
+// a device) back instead of WAV files: CONFIG, hop, engine, analysis=,
+// render width, mode and the settings outside CONFIG (output curve,
+// LED frame rate, SECONDARY_*) all come from the recording, and every LED
+// frame's leds_out[] is checked against the one recorded. A host
+// recording replays bit for bit; --engine, --hop, --mode and --render
+// are ignored, --leds N overrides the recorded strip length.
+//
+// With --check-engine, every bin the --engine computes its own way
+// (sliding_bins) is compared each frame against the
+// full path's Goertzel on the same window, and the run fails if any
+// bin's mean or worst error is out of bounds for that engine. --synth
+// adds a generated sweep + tones clip (wav_synth()) that walks every
+// bin, so the check needs no WAV files. --check-governor plays nothing:
+// it runs the LED frame deadline grid (frame_governor.h) against a fake
+// clock instead, and fails if a frame is timed or paced wrong.
+//
+// Time inside the chain is the audio clock (samples played), not wall
+// time, and SYSTEM_FPS is pinned to the rate the microphone imposes on
+// the device (SAMPLE_RATE / audio_hop_size), so output only depends
+// on the input, never on how fast the host runs.
+
+#include <FastLED.h>
+#include <FS.h>
+#include <LittleFS.h>
+#include <Ticker.h>
+#include <USB.h>
+#include <FirmwareMSC.h>
+#include <FixedPoints.h>
+#include <FixedPointsCommon.h>
+#include <esp_task_wdt.h>
+#include <esp_pm.h>
+#include <esp_timer.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+// Same headers, same order and same feature switches as main.cpp -------
+#include "sb_strings.h"
+#include "user_config.h"
+#include "constants.h"
+#include "globals.h"
+#include "frame_sync.h"
+#include "audio_frame.h"
+#include "sample_window.h"
+#include "presets.h"
+#include "bridge_fs.h"
+#include "utilities.h"
+
+#define ENABLE_PERFORMANCE_MONITORING
+#ifdef ENABLE_PERFORMANCE_MONITORING
+#include "debug/performance_monitor.h"
+#endif
+#include "debug/debug_manager.h"
+#ifndef DEBUG_BUILD
+#define DEBUG_BUILD 1
+#endif
+#include "performance_optimized_trace.h"
+#include "deferred_log.h"
+#include "GDFT_sliding.h"
+
+#define ENABLE_GDFT_SIMD
+#ifdef ENABLE_GDFT_SIMD
+#include "GDFT_simd.h"
+#endif
+
+#include "i2s_audio.h"
+#include "led_utilities.h"
+#include "noise_cal.h"
+#include "GDFT_optimized.h"
+#include "session_record.h"
+#include "audio_raw_state.h"
+#include "audio_processed_state.h"
+
+// Peripherals system.h / noise_cal.h reach into (serial_menu.h, p2p.h):
+// not part of the audio path, and not built on the host
+void init_serial(uint32_t) {}
+void init_p2p() {}
+void propagate_noise_reset() {}
+
+#include "system.h"
+#include "GDFT.h"
+#include "lightshow_modes.h"
+#include "strip_worker.h"
+#include "analysis_demand.h"
+#include "frame_governor.h"
+#include "telemetry_stream.h"
+#include "wav_source.h"
+#include "trace_stream_format.h"
+
+SensoryBridge::Audio::AudioRawState audio_raw_state;
+SensoryBridge::Audio::AudioProcessedState audio_processed_state;
+
+// Stages, in run_audio_frame() order (the last one runs in led_thread()
+// once per LED frame on the device; here once per audio frame)
+enum host_stage {
+  STAGE_ACQUIRE,
+  STAGE_VU,
+  STAGE_SPECTRAL,
+  STAGE_SMOOTHING,
+  NUM_HOST_STAGES
+};
+
+const char* host_stage_names[NUM_HOST_STAGES] = {
+  "acquire_sample_chunk",
+  "calculate_vu",
+  "GDFT + novelty",
+  "smoothing",
+};
+
+struct stage_timing {
+  double total_us = 0.0;
+  double max_us = 0.0;
+};
+
+struct clip_result {
+  uint32_t frames = 0;
+  double wall_us = 0.0;
+  stage_timing stages[NUM_HOST_STAGES];
+  uint32_t spectrogram_hash = 2166136261u;
+  uint32_t chromagram_hash = 2166136261u;
+  double led_staged_us = 0.0;    // --leds only
+  double led_fused_us = 0.0;
+  uint32_t led_mismatches = 0;
+  uint32_t led_hash = 2166136261u;
+  uint32_t led_replayed = 0;     // --replay: LED frames checked against the recording
+  uint32_t led_replay_mismatches = 0;
+};
+
+struct host_options {
+  std::vector<const char*> files;
+  uint32_t max_frames = 0;     // Per clip, 0 = whole clip
+  uint32_t repeat = 1;
+  float gain = 1.0;
+  int8_t engine = -1;          // -1 = firmware default
+  uint16_t hop = 0;            // 0 = CONFIG.SAMPLES_PER_CHUNK
+  const char* csv_path = NULL;
+  uint16_t leds = 0;           // 0 = no LED post-processing check
+  uint16_t render = DEFAULT_RENDER_RESOLUTION;  // or RENDER_FOLLOWS_LED_COUNT
+  uint8_t mode = LIGHT_MODE_GDFT;  // Rendered for --leds
+  bool full_analysis = false;
+  const char* trace_path = NULL;
+  const char* telemetry_path = NULL;
+  const char* record_path = NULL;
+  const char* replay_path = NULL;  // Instead of files
+  float synth_seconds = 0.0;   // > 0: play wav_synth()'s test clip too
+  bool check_engine = false;
+  bool check_governor = false;  // Instead of files
+  bool verbose = false;
+};
+
+static uint32_t fnv1a(uint32_t hash, const void* data, size_t length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  return hash;
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: sb_dsp_host [options] file.wav [file.wav ...]\n"
+          "       sb_dsp_host [options] --replay session.bin\n"
+          "  --frames N         stop each clip after N frames\n"
+          "  --repeat N         play the whole list N times (steadier timing)\n"
+          "  --gain DB          scale the input by DB decibels\n"
+          "  --engine NAME      GDFT engine: full or sliding\n"
+          "  --hop N            analyze every N samples (hop_size=, default one chunk)\n"
+          "  --csv FILE         write every frame's spectrogram[] to FILE\n"
+          "  --leds N           also post-process an N-LED strip, staged vs. fused\n"
+          "  --render N|led     render N pixels for --leds (render_resolution=, default 160)\n"
+          "  --mode N           light mode rendered for --leds (set_mode=, default 0)\n"
+          "  --full-analysis    run every analysis stage, not just what the mode reads\n"
+          "  --trace FILE       write the trace event stream to FILE (trace_stream=on)\n"
+          "  --telemetry FILE   write every telemetry channel to FILE (telemetry=all)\n"
+          "  --record FILE      record the session to FILE (session=record)\n"
+          "  --replay FILE      play a recorded session instead of WAV files\n"
+          "  --synth SECONDS    also play a built-in sweep + tones test clip\n"
+          "  --check-engine     check every bin --engine computes its own way against\n"
+          "                     the full Goertzel pass; exit 1 if one is out of bounds\n"
+          "  --check-governor   check the LED frame grid against a fake clock, then exit\n"
+          "  --verbose          keep the firmware's serial output\n");
+}
+
+static bool parse_options(int argc, char** argv, host_options& options) {
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    bool has_value = (i + 1 < argc);
+
+    if (arg == "--frames" && has_value) {
+      options.max_frames = strtoul(argv[++i], NULL, 10);
+    } else if (arg == "--repeat" && has_value) {
+      options.repeat = strtoul(argv[++i], NULL, 10);
+    } else if (arg == "--gain" && has_value) {
+      options.gain = powf(10.0, strtof(argv[++i], NULL) / 20.0);
+    } else if (arg == "--engine" && has_value) {
+      std::string name = argv[++i];
+      if (name == "full") {
+        options.engine = GDFT_ENGINE_FULL;
+      } else if (name == "sliding") {
+        options.engine = GDFT_ENGINE_SLIDING;
+      } else {
+        fprintf(stderr, "unknown engine '%s'\n", name.c_str());
+        return false;
+      }
+    } else if (arg == "--hop" && has_value) {
+      options.hop = strtoul(argv[++i], NULL, 10);
+    } else if (arg == "--leds" && has_value) {
+      options.leds = strtoul(argv[++i], NULL, 10);
+    } else if (arg == "--render" && has_value) {
+      std::string width = argv[++i];
+      options.render = (width == "led") ? RENDER_FOLLOWS_LED_COUNT : strtoul(width.c_str(), NULL, 10);
+    } else if (arg == "--mode" && has_value) {
+      unsigned long mode = strtoul(argv[++i], NULL, 10);
+      options.mode = mode;
+      if (mode >= NUM_MODES) {
+        fprintf(stderr, "--mode must be below %u\n", NUM_MODES);
+        return false;
+      }
+    } else if (arg == "--full-analysis") {
+      options.full_analysis = true;
+    } else if (arg == "--trace" && has_value) {
+      options.trace_path = argv[++i];
+    } else if (arg == "--telemetry" && has_value) {
+      options.telemetry_path = argv[++i];
+    } else if (arg == "--record" && has_value) {
+      options.record_path = argv[++i];
+    } else if (arg == "--replay" && has_value) {
+      options.replay_path = argv[++i];
+    } else if (arg == "--synth" && has_value) {
+      options.synth_seconds = strtof(argv[++i], NULL);
+    } else if (arg == "--check-engine") {
+      options.check_engine = true;
+    } else if (arg == "--check-governor") {
+      options.check_governor = true;
+    } else if (arg == "--csv" && has_value) {
+      options.csv_path = argv[++i];
+    } else if (arg == "--verbose") {
+      options.verbose = true;
+    } else if (arg.rfind("--", 0) == 0) {
+      fprintf(stderr, "unknown option '%s'\n", arg.c_str());
+      return false;
+    } else {
+      options.files.push_back(argv[i]);
+    }
+  }
+
+  if (options.check_governor) {
+    return options.files.empty() && options.replay_path == NULL;
+  }
+  if (options.replay_path != NULL) {
+    if (options.record_path != NULL) {
+      fprintf(stderr, "--record and --replay can't be combined\n");
+      return false;
+    }
+    return options.files.empty();
+  }
+  return (!options.files.empty() || options.synth_seconds > 0.0) && options.repeat > 0;
+}
+
+// The DSP half of init_system() (the rest is hardware)
+static void init_dsp() {
+  memcpy(&CONFIG_DEFAULTS, &CONFIG, sizeof(CONFIG));
+
+  generate_a_weights();
+  generate_window_lookup();
+  precompute_goertzel_constants();
+  set_audio_hop(CONFIG.SAMPLES_PER_CHUNK);
+  init_gdft_sliding();
+#ifdef ENABLE_GDFT_SIMD
+  init_gdft_simd();
+#endif
+#ifdef GDFT_POWER_DOMAIN
+  init_power_compression_lut();
+#endif
+  init_audio_frames();
+}
+
+static AudioFrameTracer audio_tracer;
+static LEDFrameTracer led_tracer;
+
+static FILE* trace_file = NULL;
+
+static void write_trace_frame(const uint8_t* frame, size_t length) {
+  fwrite(frame, 1, length, trace_file);
+}
+
+static FILE* telemetry_file = NULL;
+
+static void write_telemetry_frame(const uint8_t* frame, size_t length) {
+  fwrite(frame, 1, length, telemetry_file);
+}
+
+static FILE* record_file = NULL;
+
+static void write_record_frame(const uint8_t* frame, size_t length) {
+  fwrite(frame, 1, length, record_file);
+}
+
+// One pass of run_audio_frame()'s audio stages, timed
+static void run_frame(uint32_t t_now_us, clip_result& result) {
+  typedef std::chrono::steady_clock clock;
+  clock::time_point t[NUM_HOST_STAGES + 1];
+  uint32_t t_now = t_now_us / 1000;
+
+  t[STAGE_ACQUIRE] = clock::now();
+  audio_tracer.start_frame();
+  session_audio_frame_begin(t_now_us);
+  acquire_sample_chunk(t_now);
+  run_sweet_spot();
+
+  t[STAGE_VU] = clock::now();
+  calculate_vu();
+
+  t[STAGE_SPECTRAL] = clock::now();
+  audio_tracer.start_gdft();
+  run_spectral_analysis(t_now);
+  audio_tracer.end_gdft();
+  publish_audio_frame(t_now_us);
+  telemetry_audio_frame(t_now_us);
+  audio_tracer.end_frame();
+
+  t[STAGE_SMOOTHING] = clock::now();
+  acquire_audio_frame();
+  smooth_audio_features();
+
+  t[NUM_HOST_STAGES] = clock::now();
+
+  for (uint8_t s = 0; s < NUM_HOST_STAGES; s++) {
+    double us = std::chrono::duration<double, std::micro>(t[s + 1] - t[s]).count();
+    result.stages[s].total_us += us;
+    if (us > result.stages[s].max_us) {
+      result.stages[s].max_us = us;
+    }
+    result.wall_us += us;
+  }
+}
+
+// show_leds()'s post-processing, staged (the reference) or fused
+static void post_process(bool fused) {
+  if (fused) {
+    prepare_frame_fused();
+    draw_base_coat();
+    render_ui();
+    write_strip_fused(CONFIG.TEMPORAL_DITHERING);
+  } else {
+    apply_brightness();
+    if (CONFIG.INCANDESCENT_FILTER > 0.0 && CONFIG.PALETTE_INDEX == 0) {
+      apply_incandescent_filter();
+    }
+    draw_base_coat();
+    render_ui();
+    clip_led_values(leds_16);
+    scale_to_strip();
+    quantize_color(CONFIG.TEMPORAL_DITHERING);
+    if (CONFIG.REVERSE_ORDER == true) {
+      reverse_leds(leds_out, CONFIG.LED_COUNT);
+    }
+  }
+}
+
+// Everything post_process() reads and advances, so both paths can start
+// from the same frame and state
+struct led_state {
+  std::vector<CRGB16> leds;
+  float master_brightness;
+  SQ15x16 base_coat_width;
+  uint8_t dither_step;
+  std::vector<DitherResidual> dither_residual;
+};
+
+static void save_led_state(led_state& state) {
+  state.leds.assign(leds_16, leds_16 + NATIVE_RESOLUTION);
+  state.master_brightness = MASTER_BRIGHTNESS;
+  state.base_coat_width = base_coat_width;
+  state.dither_step = dither_step;
+  state.dither_residual.assign(dither_residual, dither_residual + CONFIG.LED_COUNT);
+}
+
+static void load_led_state(const led_state& state) {
+  memcpy(leds_16, state.leds.data(), sizeof(CRGB16) * NATIVE_RESOLUTION);
+  MASTER_BRIGHTNESS = state.master_brightness;
+  base_coat_width = state.base_coat_width;
+  dither_step = state.dither_step;
+  memcpy(dither_residual, state.dither_residual.data(), sizeof(DitherResidual) * CONFIG.LED_COUNT);
+}
+
+// Dithering, reversal, the warm filter and the base coat are toggled
+// frame by frame so every variant of the fused kernel is compared. Done
+// before the audio frame, where a CONFIG change from the serial menu
+// would land, so --record keeps them and --replay plays them back.
+static void vary_post_process(uint32_t frame) {
+  CONFIG.TEMPORAL_DITHERING = (frame & 1) == 0;
+  CONFIG.REVERSE_ORDER = (frame & 2) != 0;
+  CONFIG.INCANDESCENT_FILTER = (frame & 4) ? 0.0 : 0.5;
+  CONFIG.BASE_COAT = (frame & 8) != 0;
+}
+
+// One LED frame from the current audio frame, post-processed both ways
+static void run_led_frame(clip_result& result) {
+  typedef std::chrono::steady_clock clock;
+  static std::vector<CRGB> reference;
+  reference.resize(CONFIG.LED_COUNT);
+
+  led_tracer.start_frame();
+  apply_output_curve_change();
+  cache_frame_config();
+  update_analysis_demand();  // For the next audio frame, as led_thread() does
+  begin_frame();
+  render_light_mode(primary_render);
+
+  led_state state;
+  save_led_state(state);
+
+  clock::time_point t0 = clock::now();
+  led_tracer.start_show();
+  post_process(false);
+  led_tracer.end_show();
+  clock::time_point t1 = clock::now();
+  memcpy(reference.data(), leds_out, sizeof(CRGB) * CONFIG.LED_COUNT);
+
+  led_state staged_end;
+  save_led_state(staged_end);
+  load_led_state(state);
+
+  clock::time_point t2 = clock::now();
+  post_process(true);
+  clock::time_point t3 = clock::now();
+
+  // Carry on from the staged path's end state, as if only it had run
+  load_led_state(staged_end);
+
+  result.led_staged_us += std::chrono::duration<double, std::micro>(t1 - t0).count();
+  result.led_fused_us += std::chrono::duration<double, std::micro>(t3 - t2).count();
+  if (memcmp(reference.data(), leds_out, sizeof(CRGB) * CONFIG.LED_COUNT) != 0) {
+    result.led_mismatches++;
+  }
+  result.led_hash = fnv1a(result.led_hash, leds_out, sizeof(CRGB) * CONFIG.LED_COUNT);
+  led_tracer.end_frame(0);
+  telemetry_led_frame();
+  session_led_frame();
+}
+
+static void print_result(const char* label, const clip_result& result, uint32_t sample_rate) {
+  double audio_seconds = double(result.frames) * audio_hop_size / sample_rate;
+  double fps = (result.wall_us > 0.0) ? result.frames * 1e6 / result.wall_us : 0.0;
+
+  printf("%s\n", label);
+  printf("  frames %u (%.2f s of audio), %.0f frames/s, %.1fx realtime\n",
+         result.frames, audio_seconds, fps, (audio_seconds > 0.0) ? audio_seconds * 1e6 / result.wall_us : 0.0);
+  for (uint8_t s = 0; s < NUM_HOST_STAGES; s++) {
+    printf("  %-22s %9.2f us/frame   max %9.2f us\n", host_stage_names[s],
+           result.frames ? result.stages[s].total_us / result.frames : 0.0, result.stages[s].max_us);
+  }
+  printf("  spectrogram checksum %08x   chromagram checksum %08x\n", result.spectrogram_hash, result.chromagram_hash);
+  if (leds_out != NULL && result.frames > 0) {
+    printf("  LED post-process (%u LEDs from %u): staged %.2f us/frame, fused %.2f us/frame (%.2fx), %u frames differ, leds_out checksum %08x\n",
+           CONFIG.LED_COUNT, NATIVE_RESOLUTION, result.led_staged_us / result.frames, result.led_fused_us / result.frames,
+           (result.led_fused_us > 0.0) ? result.led_staged_us / result.led_fused_us : 0.0, result.led_mismatches,
+           result.led_hash);
+  }
+  if (result.led_replayed > 0) {
+    printf("  replay: %u of %u recorded LED frames differ\n", result.led_replay_mismatches, result.led_replayed);
+  }
+}
+
+// --check-engine: the bins the selected engine computes its own way,
+// against the bin the full path measures on the same window, as
+// normalized magnitudes. The full engine is held to the scalar pass
+// (goertzel_block_power()) itself; the others to the same recurrence
+// in double precision, since the scalar pass's int32 state rounds
+// every step and wraps on loud bins near DC. Bins below the floor are
+// compared against it, so silence can't blow up the relative error.
+#define CHECK_ENGINE_FLOOR 1.0
+#define CHECK_FULL_MAX_ERROR 0.0        // GDFT_simd.h is bit-identical
+#define CHECK_SLIDING_MEAN_ERROR 0.0005 // Float rotation rounding
+#define CHECK_SLIDING_MAX_ERROR 0.03    // ... carried from a louder window until the bin's next resync
+
+struct engine_check {
+  uint32_t frames = 0;
+  bool checked[NUM_FREQS] = {};
+  double error_sum[NUM_FREQS] = {};
+  float error_max[NUM_FREQS] = {};
+};
+
+// Normalized magnitude of bin i over the newest block_size samples:
+// goertzel_block_power() without the fixed point
+static double full_bin_magnitude(const short* window, uint16_t i) {
+  uint16_t block_size = frequencies[i].block_size;
+  const short* samples = &window[SAMPLE_HISTORY_LENGTH - block_size];
+  double k = (int)(0.5 + ((block_size * frequencies[i].target_freq) / CONFIG.SAMPLE_RATE));
+  double coeff = 2.0 * cos((2.0 * M_PI * k) / block_size);
+  double q1 = 0.0;
+  double q2 = 0.0;
+
+  for (uint16_t n = 0; n < block_size; n++) {
+    double q0 = double((int32_t)samples[n] >> GDFT_SAMPLE_SHIFT) + coeff * q1 - q2;
+    q2 = q1;
+    q1 = q0;
+  }
+
+  double power = q2 * q2 + q1 * q1 - coeff * q1 * q2;
+  return sqrt(power > 0.0 ? power : 0.0) * frequencies[i].inv_block_size_half;
+}
+
+// The engine's own power for bin i, or false if it uses the full path
+static bool engine_bin_power(uint16_t i, int32_t& power) {
+  if (gdft_engine == GDFT_ENGINE_SLIDING && sliding_bins[i].active) {
+    power = gdft_sliding_power(i);
+    return true;
+  }
+#ifdef ENABLE_GDFT_SIMD
+  if (gdft_simd_engine()) {
+    power = gdft_simd_powers[i];
+    return true;
+  }
+#endif
+  return false;
+}
+
+static void check_engine_frame(engine_check& check) {
+  const short* window = sample_window_base();
+  for (uint16_t i = 0; i < NUM_FREQS; i++) {
+    int32_t power;
+    if (!engine_bin_power(i, power)) {
+      continue;
+    }
+    double mag = sqrt(double(power)) * frequencies[i].inv_block_size_half;
+    double full_mag;
+    float error;
+    if (gdft_simd_engine()) {
+      uint16_t block_size = frequencies[i].block_size;
+      int32_t full_power = goertzel_block_power(&window[SAMPLE_HISTORY_LENGTH - block_size], block_size, frequencies[i].coeff_q14);
+      full_mag = sqrt(double(full_power)) * frequencies[i].inv_block_size_half;
+      error = (power == full_power) ? 0.0  // Exact, whatever the compiler contracts the subtraction into
+                                    : fabs(mag - full_mag) / ((full_mag > CHECK_ENGINE_FLOOR) ? full_mag : CHECK_ENGINE_FLOOR);
+    } else {
+      full_mag = full_bin_magnitude(window, i);
+      error = fabs(mag - full_mag) / ((full_mag > CHECK_ENGINE_FLOOR) ? full_mag : CHECK_ENGINE_FLOOR);
+    }
+
+    check.checked[i] = true;
+    check.error_sum[i] += error;
+    if (error > check.error_max[i]) {
+      check.error_max[i] = error;
+    }
+  }
+  check.frames++;
+}
+
+// Per-bin mean / worst error; false if any bin is out of bounds
+static bool print_engine_check(const engine_check& check) {
+  float max_bound = CHECK_FULL_MAX_ERROR;
+  float mean_bound = CHECK_FULL_MAX_ERROR;
+  if (gdft_simd_engine()) {
+    // Full pass for every bin, sliding included when nothing is longer than the hop
+  } else if (gdft_engine == GDFT_ENGINE_SLIDING) {
+    max_bound = CHECK_SLIDING_MAX_ERROR;
+    mean_bound = CHECK_SLIDING_MEAN_ERROR;
+  }
+
+  printf("engine check (engine %u, %u frames): bound %.2f%% mean, %.2f%% worst per bin\n", gdft_engine, check.frames,
+         mean_bound * 100.0, max_bound * 100.0);
+  uint16_t checked = 0;
+  uint16_t failed = 0;
+  for (uint16_t i = 0; i < NUM_FREQS; i++) {
+    if (!check.checked[i]) {
+      continue;
+    }
+    float mean = check.error_sum[i] / check.frames;
+    bool ok = (mean <= mean_bound && check.error_max[i] <= max_bound);
+    checked++;
+    failed += !ok;
+    if (!ok || !gdft_simd_engine()) {
+      printf("  bin %2u %8.1f Hz  block %4u  mean %7.3f%%  worst %7.3f%%%s\n", i, frequencies[i].target_freq,
+             frequencies[i].block_size, mean * 100.0, check.error_max[i] * 100.0, ok ? "" : "  OUT OF BOUNDS");
+    }
+  }
+  printf("  %u of %u bins checked, %u out of bounds\n", checked, NUM_FREQS, failed);
+  return checked > 0 && failed == 0;
+}
+
+// --check-governor: the LED frame grid (frame_governor.h) against a
+// fake clock that starts just short of micros() wrapping. Every frame
+// renders and shows for a pseudo-random time, wakes anywhere from a
+// tick early to a little late (vTaskDelay() alone, or a busy core),
+// and every 37th one overruns its period. Checked each frame:
+// led_render_us is the frame's own render time, a frame is late
+// exactly when it ends past its successor's slot, and on-time slots
+// stay a whole number of periods from where the grid last restarted.
+#define CHECK_GOVERNOR_FRAMES 100000
+#define CHECK_GOVERNOR_PERIOD_US (1000000 / 200)
+
+static bool check_led_frame_governor() {
+  uint32_t clock_us = 0xFFFFFFFFu - 40 * CHECK_GOVERNOR_PERIOD_US;
+  uint32_t random_state = 0x2545F491;
+  auto random_us = [&random_state](uint32_t range) {
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state % range;
+  };
+
+  LedFrameGrid grid;
+  led_frame_grid_restart(grid, clock_us);
+  uint32_t origin_us = clock_us;
+  uint32_t late = 0;
+  uint32_t failures = 0;
+
+  for (uint32_t frame = 0; frame < CHECK_GOVERNOR_FRAMES; frame++) {
+    uint32_t render_us = 500 + random_us(1500);
+    uint32_t show_us = 300 + random_us(1500);
+    if (frame % 37 == 36) {
+      show_us += CHECK_GOVERNOR_PERIOD_US;
+    }
+
+    clock_us += render_us;
+    bool render_ok = (led_frame_grid_rendered(grid, clock_us) == render_us);
+    clock_us += show_us;
+
+    uint32_t slot_us = grid.slot_us;
+    bool expect_late = int32_t(clock_us - (slot_us + CHECK_GOVERNOR_PERIOD_US)) > 0;
+    bool on_time = led_frame_grid_advance(grid, clock_us, CHECK_GOVERNOR_PERIOD_US);
+    bool grid_ok = on_time ? (grid.slot_us == slot_us + CHECK_GOVERNOR_PERIOD_US &&
+                              (grid.slot_us - origin_us) % CHECK_GOVERNOR_PERIOD_US == 0)
+                           : (grid.slot_us == slot_us);
+
+    if (!render_ok || on_time == expect_late || !grid_ok) {
+      if (failures < 10) {
+        printf("  frame %u: render %s, %s (expected %s), slot %s\n", frame, render_ok ? "ok" : "WRONG",
+               on_time ? "on time" : "late", expect_late ? "late" : "on time", grid_ok ? "ok" : "OFF GRID");
+      }
+      failures++;
+    }
+
+    if (on_time) {
+      // Wake from 1 ms early to 0.2 ms late, never before the last show
+      uint32_t early_us = random_us(1200);
+      uint32_t wake_us = grid.slot_us - 1000 + early_us;
+      clock_us = (int32_t(wake_us - clock_us) > 0) ? wake_us : clock_us;
+      grid.start_us = clock_us;
+    } else {
+      late++;
+      clock_us += 1000;  // vTaskDelay(1)
+      led_frame_grid_restart(grid, clock_us);
+      origin_us = clock_us;
+      if (grid.slot_us != clock_us || grid.start_us != clock_us) {
+        failures++;
+      }
+    }
+  }
+
+  printf("governor check: %u frames at %u us, %u late, %u wrong\n", CHECK_GOVERNOR_FRAMES, CHECK_GOVERNOR_PERIOD_US,
+         late, failures);
+
+  // The real sleep, on the shim's esp_timer: never wakes before the slot
+  uint32_t early = 0;
+  uint32_t overshoot_max_us = 0;
+  for (uint32_t wait = 0; wait < 20; wait++) {
+    uint32_t slot_us = micros() + 700 + 450 * wait;
+    sleep_until_led_frame_slot(slot_us);
+    int32_t overshoot_us = int32_t(micros() - slot_us);
+    early += (overshoot_us < 0);
+    if (overshoot_us > int32_t(overshoot_max_us)) {
+      overshoot_max_us = overshoot_us;
+    }
+  }
+  printf("  slot sleep: 20 waits, %u woke early, latest %u us after the slot\n", early, overshoot_max_us);
+
+  return failures == 0 && late > 0 && early == 0;
+}
+
+// Everything after a frame's stages: the stream consumers (the device's
+// idle-priority tasks), the checksums and --csv
+static void end_frame(clip_result& result, FILE* csv, size_t clip) {
+  if (trace_file != NULL) {
+    stream_trace_buffer(write_trace_frame);
+  }
+  if (telemetry_file != NULL) {
+    send_telemetry(write_telemetry_frame, INT32_MAX);  // telemetry_task's job, without the budget
+  }
+  if (record_file != NULL) {
+    drain_session(write_record_frame);  // session_task's job
+  }
+  drain_deferred_log();  // deferred_log_task's job on the device
+  result.frames++;
+
+  result.spectrogram_hash = fnv1a(result.spectrogram_hash, spectrogram, sizeof(SQ15x16) * NUM_FREQS);
+  result.chromagram_hash = fnv1a(result.chromagram_hash, chromagram_smooth, sizeof(SQ15x16) * 12);
+
+  if (csv != NULL) {
+    fprintf(csv, "%zu,%u", clip, result.frames - 1);
+    for (uint16_t i = 0; i < NUM_FREQS; i++) {
+      fprintf(csv, ",%.5f", float(spectrogram[i]));
+    }
+    fprintf(csv, "\n");
+  }
+}
+
+// --replay: a recording's records (COBS decoded), from its first START
+struct session_recording {
+  std::vector<std::vector<uint8_t>> records;
+  SessionStartInfo start;
+  uint32_t led_frames = 0;
+};
+
+static bool load_session(const char* path, session_recording& session) {
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "%s: can't read\n", path);
+    return false;
+  }
+  std::vector<uint8_t> chunk;
+  std::vector<uint8_t> payload(SESSION_MAX_PAYLOAD);
+  bool started = false;
+  int c;
+  while ((c = fgetc(file)) != EOF) {
+    if (c != 0) {
+      if (chunk.size() <= SESSION_MAX_FRAME) {  // Longer can't be a record
+        chunk.push_back(uint8_t(c));
+      }
+      continue;
+    }
+    if (chunk.empty() || chunk.size() > SESSION_MAX_FRAME) {
+      chunk.clear();
+      continue;
+    }
+    size_t length = cobs_decode(chunk.data(), chunk.size(), payload.data(), payload.size());
+    chunk.clear();
+    SessionRecordInfo info;
+    if (length == 0 || !session_record_parse(payload.data(), length, info)) {
+      continue;  // Menu text around a session=send capture, other streams
+    }
+    started |= (info.type == SESSION_REC_START);
+    if (started) {
+      session.records.emplace_back(payload.begin(), payload.begin() + length);
+      session.led_frames += (info.type == SESSION_REC_LED_FRAME);
+    }
+  }
+  fclose(file);
+
+  if (!started) {
+    fprintf(stderr, "%s: no session START record\n", path);
+    return false;
+  }
+  SessionRecordInfo info{};
+  if (!session_record_parse(session.records[0].data(), session.records[0].size(), info) ||
+      !session_parse_start(info, session.start)) {
+    fprintf(stderr, "%s: unreadable session START record\n", path);
+    return false;
+  }
+  if (session.start.config_bytes != sizeof(CONFIG) || session.start.num_freqs != NUM_FREQS ||
+      session.start.settings_bytes != SESSION_SETTINGS_BYTES) {
+    fprintf(stderr, "%s: recorded by firmware %u, whose CONFIG / NUM_FREQS / settings differ from this build's\n", path,
+            session.start.firmware_version);
+    return false;
+  }
+  return true;
+}
+
+// The recorded hop replaces what i2s_read() returns (session_audio_samples())
+static size_t replay_i2s_source(int32_t* dest, size_t samples) {
+  memset(dest, 0, samples * sizeof(int32_t));
+  return samples;
+}
+
+static void print_session_event(const SessionRecordInfo& info, uint32_t start_timestamp) {
+  if (info.data_length < 1 || info.data[0] >= SESSION_NUM_EVENT_SOURCES) {
+    return;
+  }
+  const uint8_t* event = info.data + 1;
+  size_t length = info.data_length - 1;
+  printf("  %9.3f s  %-6s ", uint32_t(info.timestamp - start_timestamp) / 1e6, session_event_names[info.data[0]]);
+  if (info.data[0] == SESSION_EVENT_SERIAL) {
+    printf("%.*s\n", int(length), (const char*)event);
+  } else if (info.data[0] == SESSION_EVENT_HMI && length >= 6) {
+    printf("encoder %u click %u rotation %d\n", event[0], event[1], int32_t(trace_stream_get_u32(event + 2)));
+  } else if (info.data[0] == SESSION_EVENT_BUTTON && length >= 2) {
+    printf("%s %s press\n", event[0] ? "mode" : "noise", event[1] ? "long" : "short");
+  } else {
+    printf("%zu bytes\n", length);
+  }
+}
+
+// Feeds the recording to the audio task's replay ring, frame by frame,
+// and checks each recorded LED frame against the one rendered now
+static void replay_session(const session_recording& session, clip_result& result, FILE* csv) {
+  const float frame_rate = CONFIG.SAMPLE_RATE / float(session.start.audio_hop_size);
+  uint32_t start_timestamp = 0;
+  size_t led_cursor = 0;  // Next LED_FRAME record to check
+
+  host_i2s_set_source(replay_i2s_source);
+  session_arm_replay();
+  for (const std::vector<uint8_t>& record : session.records) {
+    SessionRecordInfo info{};
+    if (!session_record_parse(record.data(), record.size(), info)) {
+      continue;
+    }
+    if (info.type == SESSION_REC_START) {
+      start_timestamp = info.timestamp;
+      session_replay_push(record.data(), record.size());
+    } else if (info.type == SESSION_REC_CONFIG || info.type == SESSION_REC_SETTINGS) {
+      session_replay_push(record.data(), record.size());
+    } else if (info.type == SESSION_REC_EVENT) {
+      print_session_event(info, start_timestamp);
+    } else if (info.type == SESSION_REC_END) {
+      for (uint8_t i = 0; i < SESSION_NUM_RECORD_TYPES && info.data_length >= SESSION_NUM_RECORD_TYPES * 4u; i++) {
+        uint32_t dropped = trace_stream_get_u32(info.data + i * 4);
+        if (dropped > 0) {
+          printf("  %u %s records were dropped while recording\n", dropped, session_record_names[i]);
+        }
+      }
+    } else if (info.type == SESSION_REC_AUDIO) {
+      session_replay_push(record.data(), record.size());
+      SYSTEM_FPS = frame_rate;
+      run_frame(info.timestamp, result);
+
+      // The LED frames rendered from this audio frame (LED_FRAME counts
+      // from 1, the first frame after START), or one per frame as a
+      // WAV run renders if none were recorded
+      uint32_t audio_frame = result.frames + 1;
+      if (leds_out != NULL && session.led_frames == 0) {
+        run_led_frame(result);
+      }
+      while (leds_out != NULL && led_cursor < session.records.size()) {
+        SessionRecordInfo led{};
+        const std::vector<uint8_t>& led_record = session.records[led_cursor];
+        if (!session_record_parse(led_record.data(), led_record.size(), led) ||
+            led.type != SESSION_REC_LED_FRAME || led.data_length < 10) {
+          led_cursor++;
+          continue;
+        }
+        uint32_t led_audio_frame = trace_stream_get_u32(led.data);
+        if (led_audio_frame > audio_frame) {
+          break;
+        }
+        led_cursor++;
+        if (led_audio_frame < audio_frame) {
+          continue;  // Rendered from a frame before START, or one lost in the recording
+        }
+        run_led_frame(result);
+        if (trace_stream_get_u16(led.data + 4) == CONFIG.LED_COUNT) {
+          uint32_t hash = session_fnv1a(SESSION_FNV1A_BASIS, leds_out, sizeof(CRGB) * CONFIG.LED_COUNT);
+          result.led_replayed++;
+          result.led_replay_mismatches += (hash != trace_stream_get_u32(led.data + 6));
+        }
+      }
+      end_frame(result, csv, 0);
+    }
+  }
+  if (session_replay_lost > 0) {
+    printf("  %u audio frames were lost in the recording\n", session_replay_lost);
+  }
+  host_i2s_set_source(NULL);
+}
+
+int main(int argc, char** argv) {
+  host_options options;
+  if (!parse_options(argc, argv, options)) {
+    usage();
+    return 2;
+  }
+  if (options.check_governor) {
+    return check_led_frame_governor() ? 0 : 1;
+  }
+
+  std::vector<wav_clip> clips(options.files.size());
+  for (size_t i = 0; i < options.files.size(); i++) {
+    if (!wav_load(options.files[i], clips[i])) {
+      return 1;
+    }
+    if (clips[i].sample_rate != clips[0].sample_rate) {
+      fprintf(stderr, "%s: %u Hz, but %s is %u Hz (all clips must share one rate)\n", clips[i].path.c_str(),
+              clips[i].sample_rate, clips[0].path.c_str(), clips[0].sample_rate);
+      return 1;
+    }
+  }
+  if (options.synth_seconds > 0.0) {
+    clips.emplace_back();
+    wav_synth(clips.back(), (clips.size() > 1) ? clips[0].sample_rate : CONFIG.SAMPLE_RATE, options.synth_seconds);
+  }
+
+  session_recording session;
+  if (options.replay_path != NULL) {
+    // The recording's CONFIG (its sample rate included) from boot, as
+    // if it had been loaded from flash; START applies the rest
+    if (!load_session(options.replay_path, session)) {
+      return 1;
+    }
+    memcpy(&CONFIG, session.start.config, sizeof(CONFIG));
+    if (options.leds == 0 && session.led_frames > 0) {
+      options.leds = CONFIG.LED_COUNT;
+    }
+    options.engine = session.start.gdft_engine;
+    options.hop = session.start.audio_hop_size;
+    options.render = session.start.render_resolution_setting;
+    options.mode = CONFIG.LIGHTSHOW_MODE;
+    options.full_analysis = !session.start.analysis_on_demand;
+  } else {
+    // The device's I2S runs at CONFIG.SAMPLE_RATE; run the chain at the clips' rate instead
+    CONFIG.SAMPLE_RATE = clips[0].sample_rate;
+  }
+
+  Serial.muted = !options.verbose;
+  init_dsp();
+  if (options.engine >= 0) {
+    gdft_engine = options.engine;
+  }
+  if (options.hop > 0) {
+    if (options.hop > CONFIG.SAMPLES_PER_CHUNK || options.hop < AUDIO_HOP_MIN) {
+      fprintf(stderr, "--hop must be %u to %u\n", AUDIO_HOP_MIN, CONFIG.SAMPLES_PER_CHUNK);
+      return 2;
+    }
+    audio_hop_request = options.hop;
+    apply_audio_hop_request();
+  }
+
+  if (options.leds > 0) {
+    CONFIG.LED_COUNT = options.leds;
+    render_resolution_setting = options.render;
+    init_frame_arena();
+    init_render_contexts();
+    CONFIG.LIGHTSHOW_MODE = options.mode;
+    ENABLE_SECONDARY_LEDS = false;  // Only the primary strip is rendered here
+    analysis_on_demand = !options.full_analysis;
+    build_output_lut();
+    leds_scaled = new CRGB16[CONFIG.LED_COUNT];
+    leds_out = new CRGB[CONFIG.LED_COUNT];
+    dither_residual = new DitherResidual[CONFIG.LED_COUNT];
+    seed_dither_residuals(dither_residual, CONFIG.LED_COUNT);
+  }
+
+  const float frame_rate = CONFIG.SAMPLE_RATE / float(audio_hop_size);
+
+  if (options.trace_path != NULL) {
+    trace_file = fopen(options.trace_path, "wb");
+    if (trace_file == NULL) {
+      fprintf(stderr, "%s: can't write\n", options.trace_path);
+      return 1;
+    }
+    set_trace_categories(TRACE_STREAM_CATEGORIES);
+  }
+
+  if (options.telemetry_path != NULL) {
+    telemetry_file = fopen(options.telemetry_path, "wb");
+    if (telemetry_file == NULL) {
+      fprintf(stderr, "%s: can't write\n", options.telemetry_path);
+      return 1;
+    }
+    set_telemetry_channels(TELEMETRY_ALL_CHANNELS);
+  }
+
+  if (options.record_path != NULL) {
+    record_file = fopen(options.record_path, "wb");
+    if (record_file == NULL) {
+      fprintf(stderr, "%s: can't write\n", options.record_path);
+      return 1;
+    }
+    session_arm_recording();  // START goes out with the first frame
+  }
+
+  FILE* csv = NULL;
+  if (options.csv_path != NULL) {
+    csv = fopen(options.csv_path, "w");
+    if (csv == NULL) {
+      fprintf(stderr, "%s: can't write\n", options.csv_path);
+      return 1;
+    }
+    fprintf(csv, "clip,frame");
+    for (uint16_t i = 0; i < NUM_FREQS; i++) {
+      fprintf(csv, ",bin%u", i);
+    }
+    fprintf(csv, "\n");
+  }
+
+  printf("sb_dsp_host: firmware %u, %u Hz, %u samples/chunk, hop %u, %u bins, engine %u\n", FIRMWARE_VERSION,
+         CONFIG.SAMPLE_RATE, CONFIG.SAMPLES_PER_CHUNK, audio_hop_size, NUM_FREQS, gdft_engine);
+
+  clip_result total;
+  uint64_t samples_played = 0;
+  engine_check check;
+
+  if (options.replay_path != NULL) {
+    printf("replaying %s: firmware %u, %u records, %u LED frames\n", options.replay_path,
+           session.start.firmware_version, unsigned(session.records.size()), session.led_frames);
+    replay_session(session, total, csv);
+    print_result(options.replay_path, total, CONFIG.SAMPLE_RATE);
+    options.repeat = 0;
+  }
+
+  for (uint32_t pass = 0; pass < options.repeat; pass++) {
+    for (size_t c = 0; c < clips.size(); c++) {
+      clip_result result;
+      wav_source_start(clips[c], options.gain, CONFIG.DC_OFFSET);
+
+      while (wav_source_remaining() >= audio_hop_size &&
+             (options.max_frames == 0 || result.frames < options.max_frames)) {
+        uint32_t t_now = (samples_played * 1000) / CONFIG.SAMPLE_RATE;
+        SYSTEM_FPS = frame_rate;
+
+        if (leds_out != NULL) {
+          vary_post_process(result.frames);
+        }
+        run_frame(t_now * 1000, result);
+        if (options.check_engine) {
+          check_engine_frame(check);
+        }
+        if (leds_out != NULL) {
+          run_led_frame(result);
+        }
+        samples_played += audio_hop_size;
+        end_frame(result, csv, c);
+      }
+
+      std::string label = clips[c].path;
+      if (options.repeat > 1) {
+        label += " (pass " + std::to_string(pass + 1) + ")";
+      }
+      print_result(label.c_str(), result, CONFIG.SAMPLE_RATE);
+
+      total.frames += result.frames;
+      total.wall_us += result.wall_us;
+      for (uint8_t s = 0; s < NUM_HOST_STAGES; s++) {
+        total.stages[s].total_us += result.stages[s].total_us;
+        if (result.stages[s].max_us > total.stages[s].max_us) {
+          total.stages[s].max_us = result.stages[s].max_us;
+        }
+      }
+      total.led_staged_us += result.led_staged_us;
+      total.led_fused_us += result.led_fused_us;
+      total.led_mismatches += result.led_mismatches;
+      total.led_hash = fnv1a(total.led_hash, &result.led_hash, sizeof(uint32_t));
+      total.spectrogram_hash = fnv1a(total.spectrogram_hash, &result.spectrogram_hash, sizeof(uint32_t));
+      total.chromagram_hash = fnv1a(total.chromagram_hash, &result.chromagram_hash, sizeof(uint32_t));
+    }
+  }
+
+  if (clips.size() > 1 || options.repeat > 1) {
+    print_result("TOTAL", total, CONFIG.SAMPLE_RATE);
+  }
+
+  if (csv != NULL) {
+    fclose(csv);
+  }
+  if (trace_file != NULL) {
+    fclose(trace_file);
+  }
+  if (telemetry_file != NULL) {
+    fclose(telemetry_file);
+  }
+  if (options.check_engine && !print_engine_check(check)) {
+    return 1;
+  }
+  if (record_file != NULL) {
+    uint32_t bytes = ftell(record_file);
+    bytes += finish_session_recording(write_record_frame, (samples_played * 1000) / CONFIG.SAMPLE_RATE * 1000);
+    session_state = SESSION_IDLE;
+    fclose(record_file);
+    printf("recorded %u audio frames, %u bytes to %s\n", session_audio_frames, bytes, options.record_path);
+  }
+  return 0;
+}
@@ -0,0 +1,238 @@
+// Records the telemetry stream (telemetry=..., telemetry_stream.h) to disk.
+//
+//   sb_telemetry_record [--seconds N] /dev/ttyACM0 session.sbt
+//   sb_telemetry_record --info session.sbt
+//
+// The first form reads the port (put in raw mode if it's a terminal; a
+// file or - for stdin works too) until Ctrl-C, EOF or --seconds, and
+// writes every valid telemetry record to the output in the wire format,
+// 0x00 <COBS> 0x00 (telemetry_stream_format.h). Serial menu text, trace
+// stream frames and anything corrupted are left out, so the file is
+// records only and can be read back with --info, or by anything that
+// splits on 0x00 and COBS-decodes.
+//
+// Both print a summary per channel: frames, data bytes, frames lost
+// (gaps in seq: dropped on the device or corrupted on the way) and the
+// rate, plus the device's own dropped record count from the perf
+// channel when it's on.
+
+#include "telemetry_stream_format.h"
+
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+struct channel_stats {
+  uint64_t records = 0;
+  uint64_t frames = 0;
+  uint64_t data_bytes = 0;
+  uint64_t lost = 0;
+  uint32_t last_seq = 0;
+  uint32_t first_timestamp = 0;
+  uint32_t last_timestamp = 0;
+};
+
+struct record_stats {
+  channel_stats channels[TELEMETRY_NUM_CHANNELS];
+  uint64_t skipped_chunks = 0;
+  uint32_t device_dropped = 0;
+  bool device_dropped_seen = false;
+};
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void on_signal(int) {
+  stop_requested = 1;
+}
+
+static void count_record(const TelemetryRecordInfo& info, record_stats& stats) {
+  channel_stats& channel = stats.channels[info.channel];
+  if (channel.records == 0) {
+    channel.first_timestamp = info.timestamp;
+    channel.frames = 1;
+  } else if (info.seq != channel.last_seq) {  // Same seq: another chunk of the same LED frame
+    channel.frames++;
+    channel.lost += uint32_t(info.seq - channel.last_seq - 1);
+  }
+  channel.last_seq = info.seq;
+  channel.last_timestamp = info.timestamp;
+  channel.records++;
+  channel.data_bytes += info.data_length;
+
+  if (info.channel == TELEMETRY_CH_PERF && info.data_length >= TELEMETRY_PERF_FIELDS * 4) {
+    stats.device_dropped = trace_stream_get_u32(info.data + TELEMETRY_PERF_RECORDS_DROPPED * 4);
+    stats.device_dropped_seen = true;
+  }
+}
+
+static void print_summary(const record_stats& stats) {
+  fprintf(stderr, "%-12s %10s %10s %12s %8s %10s\n", "channel", "records", "frames", "data bytes", "lost", "frames/s");
+  for (uint8_t i = 0; i < TELEMETRY_NUM_CHANNELS; i++) {
+    const channel_stats& channel = stats.channels[i];
+    if (channel.records == 0) {
+      continue;
+    }
+    double seconds = uint32_t(channel.last_timestamp - channel.first_timestamp) / 1e6;
+    fprintf(stderr, "%-12s %10llu %10llu %12llu %8llu %10.1f\n", telemetry_channel_names[i],
+            (unsigned long long)channel.records, (unsigned long long)channel.frames,
+            (unsigned long long)channel.data_bytes, (unsigned long long)channel.lost,
+            (seconds > 0.0) ? (channel.frames - 1) / seconds : 0.0);
+  }
+  if (stats.device_dropped_seen) {
+    fprintf(stderr, "%u records dropped on the device since boot\n", stats.device_dropped);
+  }
+  fprintf(stderr, "%llu non-telemetry chunks skipped\n", (unsigned long long)stats.skipped_chunks);
+}
+
+// Splits a byte stream on 0x00 and hands each complete chunk on
+class chunk_reader {
+ public:
+  template <typename Handler>
+  void feed(const uint8_t* bytes, size_t length, Handler handle) {
+    for (size_t i = 0; i < length; i++) {
+      if (bytes[i] != 0) {
+        if (chunk_.size() <= TELEMETRY_MAX_FRAME) {  // Longer can't be a record; keep counting it as one chunk
+          chunk_.push_back(bytes[i]);
+        }
+        continue;
+      }
+      if (!chunk_.empty()) {
+        handle(chunk_);
+        chunk_.clear();
+      }
+    }
+  }
+
+ private:
+  std::vector<uint8_t> chunk_;
+};
+
+static bool decode_record(const std::vector<uint8_t>& chunk, uint8_t* payload, TelemetryRecordInfo& info) {
+  if (chunk.size() > TELEMETRY_MAX_FRAME) {
+    return false;
+  }
+  size_t decoded = cobs_decode(chunk.data(), chunk.size(), payload, TELEMETRY_MAX_PAYLOAD);
+  return decoded > 0 && telemetry_record_parse(payload, decoded, info);
+}
+
+static void make_raw(int fd) {
+  struct termios tio;
+  if (tcgetattr(fd, &tio) != 0) {
+    return;
+  }
+  cfmakeraw(&tio);
+  tio.c_cc[VMIN] = 1;
+  tio.c_cc[VTIME] = 0;
+  tcsetattr(fd, TCSANOW, &tio);
+}
+
+static void usage() {
+  fprintf(stderr,
+          "usage: sb_telemetry_record [--seconds N] PORT|FILE|- out.sbt\n"
+          "       sb_telemetry_record --info session.sbt\n");
+}
+
+int main(int argc, char** argv) {
+  bool info_only = false;
+  uint32_t max_seconds = 0;
+  std::vector<std::string> paths;
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    if (arg == "--info") {
+      info_only = true;
+    } else if (arg == "--seconds" && i + 1 < argc) {
+      max_seconds = strtoul(argv[++i], NULL, 10);
+    } else if (arg.rfind("--", 0) == 0) {
+      fprintf(stderr, "unknown option '%s'\n", arg.c_str());
+      usage();
+      return 2;
+    } else {
+      paths.push_back(arg);
+    }
+  }
+  if (paths.size() != (info_only ? 1u : 2u)) {
+    usage();
+    return 2;
+  }
+
+  int fd = (paths[0] == "-") ? STDIN_FILENO : open(paths[0].c_str(), O_RDONLY | O_NOCTTY);
+  if (fd < 0) {
+    fprintf(stderr, "%s: can't read\n", paths[0].c_str());
+    return 1;
+  }
+  if (isatty(fd)) {
+    make_raw(fd);
+  }
+
+  FILE* out = NULL;
+  if (!info_only) {
+    out = fopen(paths[1].c_str(), "wb");
+    if (out == NULL) {
+      fprintf(stderr, "%s: can't write\n", paths[1].c_str());
+      return 1;
+    }
+    struct sigaction action = {};
+    action.sa_handler = on_signal;  // No SA_RESTART: Ctrl-C ends a blocked read()
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+  }
+
+  record_stats stats;
+  chunk_reader reader;
+  uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+  uint8_t block[4096];
+  time_t start = time(NULL);
+  uint64_t last_report_records = 0;
+
+  while (!stop_requested) {
+    if (max_seconds > 0 && time(NULL) - start >= time_t(max_seconds)) {
+      break;
+    }
+    ssize_t n = read(fd, block, sizeof(block));
+    if (n <= 0) {
+      break;  // EOF, or interrupted by Ctrl-C
+    }
+
+    reader.feed(block, size_t(n), [&](const std::vector<uint8_t>& chunk) {
+      TelemetryRecordInfo info;
+      if (!decode_record(chunk, payload, info)) {
+        stats.skipped_chunks++;
+        return;
+      }
+      count_record(info, stats);
+      if (out != NULL) {
+        fputc(0, out);
+        fwrite(chunk.data(), 1, chunk.size(), out);
+        fputc(0, out);
+      }
+    });
+
+    if (out != NULL) {
+      uint64_t records = 0;
+      for (const channel_stats& channel : stats.channels) {
+        records += channel.records;
+      }
+      if (records / 1000 != last_report_records / 1000) {
+        fprintf(stderr, "\r%llu records", (unsigned long long)records);
+        last_report_records = records;
+      }
+    }
+  }
+
+  if (out != NULL) {
+    fprintf(stderr, "\n");
+    fclose(out);
+  }
+  if (fd != STDIN_FILENO) {
+    close(fd);
+  }
+  print_summary(stats);
+  return 0;
+}
@@ -0,0 +1,280 @@
+// Converts a trace stream capture to Chrome trace JSON.
+//
+// The capture is whatever came out of the USB port after trace_stream=on
+// (e.g. cat /dev/ttyACM0 > capture.bin), or sb_dsp_host --trace. Frames
+// are split on 0x00, COBS decoded and checked (trace_stream_format.h);
+// anything else in between, like serial menu text, is skipped.
+//
+//   sb_trace_convert capture.bin trace.json
+//
+// Open trace.json in ui.perfetto.dev or chrome://tracing. Each core is a
+// track. The *_DONE events carry their stage's duration, so each becomes
+// a slice ending at its timestamp (the matching *_START is implied, and
+// a dropped START doesn't lose the slice). LED_PHOTON_LATENCY and the
+// firmware's dropped event count become counter tracks; every other
+// event is an instant with its data.
+
+#include "trace_stream_format.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+struct event_name {
+  uint16_t id;
+  const char* name;
+};
+
+static const event_name event_names[] = {
+  { AUDIO_FRAME_START, "AUDIO_FRAME_START" },
+  { AUDIO_I2S_READ_START, "AUDIO_I2S_READ_START" },
+  { AUDIO_I2S_READ_DONE, "AUDIO_I2S_READ_DONE" },
+  { AUDIO_PROCESS_START, "AUDIO_PROCESS_START" },
+  { AUDIO_GDFT_START, "AUDIO_GDFT_START" },
+  { AUDIO_GDFT_DONE, "AUDIO_GDFT_DONE" },
+  { AUDIO_VU_CALC, "AUDIO_VU_CALC" },
+  { AUDIO_FRAME_DONE, "AUDIO_FRAME_DONE" },
+  { LED_FRAME_START, "LED_FRAME_START" },
+  { LED_CALC_START, "LED_CALC_START" },
+  { LED_BUFFER_UPDATE, "LED_BUFFER_UPDATE" },
+  { LED_SHOW_START, "LED_SHOW_START" },
+  { LED_SHOW_DONE, "LED_SHOW_DONE" },
+  { LED_FRAME_DONE, "LED_FRAME_DONE" },
+  { LED_PHOTON_LATENCY, "LED_PHOTON_LATENCY" },
+  { MUTEX_LOCK_ATTEMPT, "MUTEX_LOCK_ATTEMPT" },
+  { MUTEX_LOCK_SUCCESS, "MUTEX_LOCK_SUCCESS" },
+  { MUTEX_UNLOCK, "MUTEX_UNLOCK" },
+  { QUEUE_SEND, "QUEUE_SEND" },
+  { QUEUE_RECEIVE, "QUEUE_RECEIVE" },
+  { MUTEX_LOCK_TIMEOUT, "MUTEX_LOCK_TIMEOUT" },
+  { MUTEX_LOCK_CONTENDED, "MUTEX_LOCK_CONTENDED" },
+  { MUTEX_CREATE, "MUTEX_CREATE" },
+  { MUTEX_DESTROY, "MUTEX_DESTROY" },
+  { MUTEX_OWNER_CHANGE, "MUTEX_OWNER_CHANGE" },
+  { PERF_DEADLINE_MISS, "PERF_DEADLINE_MISS" },
+  { PERF_BUFFER_OVERFLOW, "PERF_BUFFER_OVERFLOW" },
+  { PERF_HIGH_LATENCY, "PERF_HIGH_LATENCY" },
+  { MEMORY_BUFFER_INIT, "MEMORY_BUFFER_INIT" },
+  { MEMORY_DMA_VALIDATION, "MEMORY_DMA_VALIDATION" },
+  { MEMORY_BUFFER_RESET, "MEMORY_BUFFER_RESET" },
+  { MEMORY_BOUNDS_CHECK, "MEMORY_BOUNDS_CHECK" },
+  { MEMORY_ALIGNMENT_CHECK, "MEMORY_ALIGNMENT_CHECK" },
+  { ERROR_I2S_TIMEOUT, "ERROR_I2S_TIMEOUT" },
+  { ERROR_LED_FAILURE, "ERROR_LED_FAILURE" },
+  { ERROR_MEMORY_ALLOC, "ERROR_MEMORY_ALLOC" },
+  { ERROR_SYSTEM_RESTART, "ERROR_SYSTEM_RESTART" },
+};
+
+// *_START events implied by their *_DONE slice (and see is_slice_start())
+static const uint16_t slice_starts[] = {
+  AUDIO_FRAME_START, AUDIO_I2S_READ_START, AUDIO_GDFT_START, LED_SHOW_START,
+};
+
+static std::string name_of(uint16_t id) {
+  for (const event_name& n : event_names) {
+    if (n.id == id) {
+      return n.name;
+    }
+  }
+  char buffer[16];
+  snprintf(buffer, sizeof(buffer), "0x%04X", id);
+  return buffer;
+}
+
+// Slice name and duration for a *_DONE event (see AudioFrameTracer and
+// LEDFrameTracer for what each packs into data), or false
+static bool slice_of(const TraceEvent& event, const char*& name, uint32_t& duration_us) {
+  switch (event.event_id) {
+    case AUDIO_FRAME_DONE:    name = "audio frame"; duration_us = event.data; return true;
+    case AUDIO_GDFT_DONE:     name = "GDFT + novelty"; duration_us = event.data; return true;
+    case AUDIO_I2S_READ_DONE: name = "I2S read"; duration_us = event.data >> 16; return true;
+    case LED_FRAME_DONE:      name = "LED frame"; duration_us = event.data >> 8; return true;
+    case LED_SHOW_DONE:       name = "show_leds"; duration_us = event.data; return true;
+    default: return false;
+  }
+}
+
+static const char* core_name(uint8_t core) {
+  switch (core) {
+    case 0: return "Core 0 (audio)";
+    case 1: return "Core 1 (LED)";
+    default: return "Core ?";
+  }
+}
+
+struct convert_stats {
+  uint32_t frames = 0;
+  uint32_t bad_chunks = 0;     // Text between frames, or corrupted frames
+  uint32_t lost_frames = 0;    // Gaps in frame_seq
+  uint16_t next_seq = 0;
+  uint64_t events = 0;
+  uint32_t dropped_first = 0;  // Firmware-side drops, first and last frame
+  uint32_t dropped_last = 0;
+};
+
+class chrome_writer {
+ public:
+  explicit chrome_writer(FILE* out) : out_(out) {
+    fprintf(out_, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(out_, "{\"ph\":\"M\",\"pid\":1,\"name\":\"process_name\",\"args\":{\"name\":\"Sensory Bridge\"}}");
+  }
+
+  void thread_name(uint8_t core) {
+    if (named_[core]) {
+      return;
+    }
+    named_[core] = true;
+    fprintf(out_, ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":\"%s\"}}",
+            core, core_name(core));
+    fprintf(out_, ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_sort_index\",\"args\":{\"sort_index\":%u}}",
+            core, core);
+  }
+
+  void slice(uint8_t core, const char* name, int64_t end_us, uint32_t duration_us, const TraceEvent& event) {
+    thread_name(core);
+    fprintf(out_, ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"name\":\"%s\",\"ts\":%lld,\"dur\":%u,\"args\":{\"data\":%u}}",
+            core, name, (long long)(end_us - duration_us), duration_us, event.data);
+  }
+
+  void instant(uint8_t core, int64_t ts_us, const TraceEvent& event) {
+    thread_name(core);
+    fprintf(out_, ",\n{\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%u,\"name\":\"%s\",\"ts\":%lld,"
+            "\"args\":{\"data\":%u,\"level\":%u}}",
+            core, name_of(event.event_id).c_str(), (long long)ts_us, event.data, event.level);
+  }
+
+  void counter(const char* name, int64_t ts_us, uint32_t value) {
+    fprintf(out_, ",\n{\"ph\":\"C\",\"pid\":1,\"name\":\"%s\",\"ts\":%lld,\"args\":{\"value\":%u}}",
+            name, (long long)ts_us, value);
+  }
+
+  void finish() { fprintf(out_, "\n]}\n"); }
+
+ private:
+  FILE* out_;
+  std::map<uint8_t, bool> named_;
+};
+
+// micros() wraps every ~71 minutes, and the cores' events can be slightly
+// out of order: follow it as a signed step from the last timestamp seen
+class timestamp_unwrapper {
+ public:
+  int64_t unwrap(uint32_t timestamp) {
+    if (!started_) {
+      started_ = true;
+      last_ = timestamp;
+      return last_;
+    }
+    last_ += int32_t(timestamp - uint32_t(last_));
+    return last_;
+  }
+
+ private:
+  bool started_ = false;
+  int64_t last_ = 0;
+};
+
+// LEDFrameTracer's LED_FRAME_START is too; cache_frame_config()'s (INFO
+// level, lightshow_modes.cpp) carries the palette state, so it stays
+static bool is_slice_start(const TraceEvent& event) {
+  if (event.event_id == LED_FRAME_START) {
+    return event.level == TRACE_LEVEL_DEBUG;
+  }
+  for (uint16_t start : slice_starts) {
+    if (start == event.event_id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+static void convert_frame(const TraceStreamFrameInfo& info, chrome_writer& writer, timestamp_unwrapper& clock,
+                          convert_stats& stats) {
+  if (stats.frames == 0) {
+    stats.dropped_first = info.dropped_total;
+  } else if (info.frame_seq != stats.next_seq) {
+    stats.lost_frames += uint16_t(info.frame_seq - stats.next_seq);
+  }
+  stats.next_seq = info.frame_seq + 1;
+  stats.frames++;
+
+  for (uint8_t i = 0; i < info.event_count; i++) {
+    const TraceEvent& event = info.events[i];
+    int64_t ts_us = clock.unwrap(event.timestamp);
+    stats.events++;
+
+    const char* name;
+    uint32_t duration_us;
+    if (slice_of(event, name, duration_us)) {
+      writer.slice(event.core_id, name, ts_us, duration_us, event);
+    } else if (event.event_id == LED_PHOTON_LATENCY) {
+      writer.counter("photon latency (us)", ts_us, event.data);
+    } else if (!is_slice_start(event)) {
+      writer.instant(event.core_id, ts_us, event);
+    }
+  }
+
+  if (info.dropped_total != stats.dropped_last || stats.frames == 1) {
+    writer.counter("dropped trace events", clock.unwrap(info.events[info.event_count - 1].timestamp),
+                   info.dropped_total);
+  }
+  stats.dropped_last = info.dropped_total;
+}
+
+int main(int argc, char** argv) {
+  if (argc != 3) {
+    fprintf(stderr, "usage: sb_trace_convert capture.bin trace.json\n");
+    return 2;
+  }
+
+  FILE* in = fopen(argv[1], "rb");
+  if (in == NULL) {
+    fprintf(stderr, "%s: can't read\n", argv[1]);
+    return 1;
+  }
+  std::vector<uint8_t> capture;
+  uint8_t block[4096];
+  size_t n;
+  while ((n = fread(block, 1, sizeof(block), in)) > 0) {
+    capture.insert(capture.end(), block, block + n);
+  }
+  fclose(in);
+
+  FILE* out = fopen(argv[2], "w");
+  if (out == NULL) {
+    fprintf(stderr, "%s: can't write\n", argv[2]);
+    return 1;
+  }
+
+  chrome_writer writer(out);
+  timestamp_unwrapper clock;
+  convert_stats stats;
+  uint8_t payload[TRACE_STREAM_MAX_PAYLOAD];
+  TraceStreamFrameInfo info;
+
+  size_t start = 0;
+  for (size_t i = 0; i <= capture.size(); i++) {
+    if (i < capture.size() && capture[i] != 0) {
+      continue;
+    }
+    size_t length = i - start;
+    if (length > 0) {
+      size_t decoded = (length <= TRACE_STREAM_MAX_FRAME)
+                       ? cobs_decode(&capture[start], length, payload, sizeof(payload)) : 0;
+      if (decoded > 0 && trace_stream_parse(payload, decoded, info)) {
+        convert_frame(info, writer, clock, stats);
+      } else {
+        stats.bad_chunks++;
+      }
+    }
+    start = i + 1;
+  }
+
+  writer.finish();
+  fclose(out);
+
+  fprintf(stderr, "%u frames, %llu events, %u lost frames, %u events dropped on the device, %u non-trace chunks skipped\n",
+          stats.frames, (unsigned long long)stats.events, stats.lost_frames,
+          stats.dropped_last - stats.dropped_first, stats.bad_chunks);
+  return 0;
+}
@@ -0,0 +1,33 @@
+// Arduino core globals for the host build (see Arduino.h)
+
+#include <Arduino.h>
+
+#include <mutex>
+#include <random>
+
+HostSerial Serial;
+HostEsp ESP;
+
+// Fixed seed: host runs are reproducible. Locked, because the strip
+// worker draws from it too (the device's RNG is hardware, and thread safe)
+static std::mt19937 host_rng(0x5B5B);
+static std::mutex host_rng_lock;
+
+long random(long max) {
+  std::lock_guard<std::mutex> lock(host_rng_lock);
+  return (max > 0) ? (long)(host_rng() % (unsigned long)max) : 0;
+}
+
+long random(long min, long max) {
+  return (max > min) ? min + random(max - min) : min;
+}
+
+void randomSeed(unsigned long seed) {
+  std::lock_guard<std::mutex> lock(host_rng_lock);
+  host_rng.seed(seed);
+}
+
+void HostEsp::restart() {
+  fflush(stdout);
+  exit(0);
+}
@@ -0,0 +1,166 @@
+// Minimal Arduino-ESP32 core for building the firmware on a PC.
+// Only what the audio path (and FixedPoints / FastLED) actually touch.
+//
+// millis(), micros(), delay() and yield() come from FastLED's stub
+// platform (platforms/stub/led_sysdefs_stub_generic.h), so both
+// libraries agree on one clock.
+
+#ifndef HOST_SHIM_ARDUINO_H
+#define HOST_SHIM_ARDUINO_H
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+
+#include "esp_idf.h"
+
+using std::sqrt;
+using std::fabs;
+using std::isnan;
+using std::isinf;
+using std::min;
+using std::max;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define PROGMEM
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+#define HALF_PI 1.5707963267948966192313216916398
+#define TWO_PI 6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#ifndef INPUT
+#define INPUT 0
+#define OUTPUT 1
+#endif
+#define INPUT_PULLUP 5
+#define LOW 0
+#define HIGH 1
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+extern "C" {
+  uint32_t millis(void);
+  uint32_t micros(void);
+  void delay(int ms);
+  void yield(void);
+  void pinMode(uint8_t pin, uint8_t mode);
+}
+
+inline void delayMicroseconds(uint32_t) {}
+inline int digitalRead(uint8_t) { return HIGH; }
+inline void digitalWrite(uint8_t, uint8_t) {}
+inline uint32_t ledcSetup(uint8_t, uint32_t, uint8_t) { return 0; }
+inline void ledcAttachPin(uint8_t, uint8_t) {}
+inline void ledcWrite(uint8_t, uint32_t) {}
+
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max) {
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+// Arduino String, just enough for the debug formatters
+class String : public std::string {
+ public:
+  String() {}
+  String(const char* s) : std::string(s ? s : "") {}
+  String(const std::string& s) : std::string(s) {}
+  String(char c) : std::string(1, c) {}
+  String(int v) : std::string(std::to_string(v)) {}
+  String(unsigned int v) : std::string(std::to_string(v)) {}
+  String(long v) : std::string(std::to_string(v)) {}
+  String(unsigned long v) : std::string(std::to_string(v)) {}
+  String(float v, int digits = 2) : String((double)v, digits) {}
+  String(double v, int digits = 2) {
+    char buffer[48];
+    snprintf(buffer, sizeof(buffer), "%.*f", digits, v);
+    assign(buffer);
+  }
+
+  unsigned int length() const { return size(); }
+  const char* c_str() const { return std::string::c_str(); }
+};
+
+inline String operator+(const String& a, const String& b) { return String(static_cast<const std::string&>(a) + static_cast<const std::string&>(b)); }
+inline String operator+(const String& a, const char* b) { return String(static_cast<const std::string&>(a) + b); }
+inline String operator+(const char* a, const String& b) { return String(a + static_cast<const std::string&>(b)); }
+
+// Serial output goes to stdout, unless muted (benchmarks)
+class HostSerial {
+ public:
+  bool muted = false;
+
+  void begin(unsigned long) {}
+  void end() {}
+  void flush() { if (!muted) fflush(stdout); }
+  int available() { return 0; }
+  int read() { return -1; }
+  operator bool() const { return true; }
+
+  size_t write(uint8_t c) { if (!muted) fputc(c, stdout); return 1; }
+  size_t write(const uint8_t* data, size_t length) { if (!muted) fwrite(data, 1, length, stdout); return length; }
+
+  void print(const char* s) { if (!muted) fputs(s, stdout); }
+  void print(const String& s) { print(s.c_str()); }
+  void print(char c) { if (!muted) fputc(c, stdout); }
+  void print(int v, int base = DEC) { print((long)v, base); }
+  void print(unsigned int v, int base = DEC) { print((unsigned long)v, base); }
+  void print(int16_t v) { print((long)v); }
+  void print(uint16_t v) { print((unsigned long)v); }
+  void print(uint8_t v, int base = DEC) { print((unsigned long)v, base); }
+  void print(long v, int base = DEC) {
+    if (muted) return;
+    if (base == HEX) printf("%lX", v); else printf("%ld", v);
+  }
+  void print(unsigned long v, int base = DEC) {
+    if (muted) return;
+    if (base == HEX) printf("%lX", v); else printf("%lu", v);
+  }
+  void print(long long v) { if (!muted) printf("%lld", v); }
+  void print(unsigned long long v) { if (!muted) printf("%llu", v); }
+  void print(double v, int digits = 2) { if (!muted) printf("%.*f", digits, v); }
+  void print(float v, int digits = 2) { print((double)v, digits); }
+  void print(bool v) { print((int)v); }
+
+  void println() { print("\n"); }
+  template <typename T> void println(T v) { print(v); println(); }
+  template <typename T> void println(T v, int format) { print(v, format); println(); }
+
+  template <typename... Args> int printf(const char* format, Args... args) {
+    return muted ? 0 : ::printf(format, args...);
+  }
+};
+
+extern HostSerial Serial;
+
+// ESP object (EspClass)
+class HostEsp {
+ public:
+  void restart();
+  uint32_t getFreeHeap() { return 256 * 1024; }
+  uint32_t getMinFreeHeap() { return 256 * 1024; }
+  uint32_t getMaxAllocHeap() { return 128 * 1024; }
+  uint32_t getFreePsram() { return 0; }
+  uint64_t getEfuseMac() { return 0x0000A1B2C3D4E5F6ULL; }
+  uint32_t getCpuFreqMHz() { return 240; }
+};
+
+extern HostEsp ESP;
+
+#endif // HOST_SHIM_ARDUINO_H
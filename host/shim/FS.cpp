@@ -0,0 +1,105 @@
+// In-memory Arduino FS (see FS.h)
+
+#include <FS.h>
+#include <LittleFS.h>
+
+#include <map>
+#include <string>
+
+fs::FS LittleFS;
+
+static std::map<std::string, std::shared_ptr<std::vector<uint8_t>>> files;
+
+namespace fs {
+
+bool File::seek(uint32_t position, SeekMode mode) {
+  if (!data_) {
+    return false;
+  }
+
+  size_t target = position;
+  if (mode == SeekCur) {
+    target += position_;
+  } else if (mode == SeekEnd) {
+    target += data_->size();
+  }
+  if (target > data_->size()) {
+    return false;
+  }
+  position_ = target;
+  return true;
+}
+
+int File::read() {
+  if (!data_ || position_ >= data_->size()) {
+    return -1;
+  }
+  return (*data_)[position_++];
+}
+
+size_t File::read(uint8_t* buffer, size_t length) {
+  size_t count = 0;
+  while (count < length && available() > 0) {
+    buffer[count++] = read();
+  }
+  return count;
+}
+
+size_t File::write(const uint8_t* buffer, size_t length) {
+  if (!data_ || !writable_) {
+    return 0;
+  }
+  if (position_ + length > data_->size()) {
+    data_->resize(position_ + length);
+  }
+  memcpy(data_->data() + position_, buffer, length);
+  position_ += length;
+  return length;
+}
+
+bool FS::begin(bool) {
+  return true;
+}
+
+File FS::open(const char* path, const char* mode) {
+  auto existing = files.find(path);
+
+  if (strcmp(mode, FILE_READ) == 0) {
+    if (existing == files.end()) {
+      return File();
+    }
+    return File(existing->second, false);
+  }
+
+  if (strcmp(mode, FILE_WRITE) == 0 || existing == files.end()) {
+    files[path] = std::make_shared<std::vector<uint8_t>>();
+  }
+  File file(files[path], true);
+  if (strcmp(mode, FILE_APPEND) == 0) {
+    file.seek(0, SeekEnd);
+  }
+  return file;
+}
+
+bool FS::exists(const char* path) {
+  return files.count(path) > 0;
+}
+
+bool FS::remove(const char* path) {
+  return files.erase(path) > 0;
+}
+
+bool FS::format() {
+  files.clear();
+  return true;
+}
+
+size_t FS::usedBytes() {
+  size_t used = 0;
+  for (auto& file : files) {
+    used += file.second->size();
+  }
+  return used;
+}
+
+}  // namespace fs
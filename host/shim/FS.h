@@ -0,0 +1,64 @@
+// Arduino-ESP32 FS, backed by memory for the host build: files live
+// for the length of the run, so config/noise_cal saves round-trip but
+// nothing touches the workstation's disk.
+
+#ifndef HOST_SHIM_FS_H
+#define HOST_SHIM_FS_H
+
+#include <Arduino.h>
+
+#include <memory>
+#include <vector>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+class File {
+ public:
+  File() {}
+  File(std::shared_ptr<std::vector<uint8_t>> data, bool writable) : data_(data), writable_(writable) {}
+
+  operator bool() const { return data_ != nullptr; }
+
+  size_t size() const { return data_ ? data_->size() : 0; }
+  size_t position() const { return position_; }
+  int available() { return data_ ? (int)(data_->size() - position_) : 0; }
+
+  bool seek(uint32_t position, SeekMode mode = SeekSet);
+  int read();
+  size_t read(uint8_t* buffer, size_t length);
+  size_t write(uint8_t c) { return write(&c, 1); }
+  size_t write(const uint8_t* buffer, size_t length);
+  void flush() {}
+  void close() { data_ = nullptr; }
+
+ private:
+  std::shared_ptr<std::vector<uint8_t>> data_;
+  bool writable_ = false;
+  size_t position_ = 0;
+};
+
+class FS {
+ public:
+  bool begin(bool format_on_fail = false);
+  void end() {}
+  File open(const char* path, const char* mode = FILE_READ);
+  File open(const String& path, const char* mode = FILE_READ) { return open(path.c_str(), mode); }
+  bool exists(const char* path);
+  bool remove(const char* path);
+  bool format();
+  size_t totalBytes() { return 1536 * 1024; }
+  size_t usedBytes();
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif // HOST_SHIM_FS_H
@@ -0,0 +1,25 @@
+// USB mass-storage firmware update, for the host build (never starts)
+
+#ifndef HOST_SHIM_FIRMWARE_MSC_H
+#define HOST_SHIM_FIRMWARE_MSC_H
+
+#include "USB.h"
+
+extern const esp_event_base_t ARDUINO_FIRMWARE_MSC_EVENTS;
+enum {
+  ARDUINO_FIRMWARE_MSC_ANY_EVENT = -1,
+  ARDUINO_FIRMWARE_MSC_START_EVENT = 0,
+  ARDUINO_FIRMWARE_MSC_WRITE_EVENT,
+  ARDUINO_FIRMWARE_MSC_END_EVENT,
+  ARDUINO_FIRMWARE_MSC_ERROR_EVENT,
+  ARDUINO_FIRMWARE_MSC_POWER_EVENT,
+};
+
+class FirmwareMSC {
+ public:
+  bool begin() { return false; }
+  void end() {}
+  void onEvent(esp_event_handler_t) {}
+};
+
+#endif // HOST_SHIM_FIRMWARE_MSC_H
@@ -0,0 +1 @@
+#include "USB.h"
@@ -0,0 +1,8 @@
+#ifndef HOST_SHIM_LITTLEFS_H
+#define HOST_SHIM_LITTLEFS_H
+
+#include "FS.h"
+
+extern fs::FS LittleFS;
+
+#endif // HOST_SHIM_LITTLEFS_H
@@ -0,0 +1,21 @@
+// Arduino-ESP32 Ticker, for the host build. Callbacks are never
+// scheduled: nothing on the DSP path uses them.
+
+#ifndef HOST_SHIM_TICKER_H
+#define HOST_SHIM_TICKER_H
+
+#include <cstdint>
+
+class Ticker {
+ public:
+  typedef void (*callback_t)(void);
+
+  void attach(float, callback_t) {}
+  void attach_ms(uint32_t, callback_t) {}
+  void once(float, callback_t) {}
+  void once_ms(uint32_t, callback_t) {}
+  void detach() {}
+  bool active() const { return false; }
+};
+
+#endif // HOST_SHIM_TICKER_H
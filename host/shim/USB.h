@@ -0,0 +1,33 @@
+// Arduino-ESP32 USB / CDC classes, for the host build. Nothing is
+// attached on a PC, so events never fire.
+
+#ifndef HOST_SHIM_USB_H
+#define HOST_SHIM_USB_H
+
+#include <Arduino.h>
+
+typedef void (*esp_event_handler_t)(void* arg, esp_event_base_t event_base, int32_t event_id, void* event_data);
+
+extern const esp_event_base_t ARDUINO_USB_EVENTS;
+enum {
+  ARDUINO_USB_ANY_EVENT = -1,
+  ARDUINO_USB_STARTED_EVENT = 0,
+  ARDUINO_USB_STOPPED_EVENT,
+  ARDUINO_USB_SUSPEND_EVENT,
+  ARDUINO_USB_RESUME_EVENT,
+};
+
+class ESPUSB {
+ public:
+  bool begin() { return true; }
+  void onEvent(esp_event_handler_t) {}
+  operator bool() const { return true; }
+};
+
+extern ESPUSB USB;
+
+// USB CDC and the S3's hardware CDC both print to stdout on the host
+typedef HostSerial USBCDC;
+typedef HostSerial HWCDC;
+
+#endif // HOST_SHIM_USB_H
@@ -0,0 +1,85 @@
+// ESP-IDF legacy I2S driver API, fed by the host (see esp_idf.cpp)
+
+#ifndef HOST_SHIM_DRIVER_I2S_H
+#define HOST_SHIM_DRIVER_I2S_H
+
+#include <cstddef>
+#include <cstdint>
+#include "esp_idf.h"
+#include "freertos/queue.h"
+
+typedef int i2s_port_t;
+#define I2S_NUM_0 0
+#define I2S_NUM_1 1
+
+typedef enum {
+  I2S_MODE_MASTER = (1 << 0),
+  I2S_MODE_SLAVE = (1 << 1),
+  I2S_MODE_TX = (1 << 2),
+  I2S_MODE_RX = (1 << 3),
+} i2s_mode_t;
+
+typedef enum {
+  I2S_BITS_PER_SAMPLE_16BIT = 16,
+  I2S_BITS_PER_SAMPLE_24BIT = 24,
+  I2S_BITS_PER_SAMPLE_32BIT = 32,
+} i2s_bits_per_sample_t;
+
+typedef enum {
+  I2S_CHANNEL_FMT_RIGHT_LEFT,
+  I2S_CHANNEL_FMT_ALL_RIGHT,
+  I2S_CHANNEL_FMT_ALL_LEFT,
+  I2S_CHANNEL_FMT_ONLY_RIGHT,
+  I2S_CHANNEL_FMT_ONLY_LEFT,
+} i2s_channel_fmt_t;
+
+typedef enum {
+  I2S_COMM_FORMAT_STAND_I2S = 0x01,
+  I2S_COMM_FORMAT_STAND_MSB = 0x02,
+} i2s_comm_format_t;
+
+typedef struct {
+  i2s_mode_t mode;
+  uint32_t sample_rate;
+  i2s_bits_per_sample_t bits_per_sample;
+  i2s_channel_fmt_t channel_format;
+  i2s_comm_format_t communication_format;
+  int intr_alloc_flags;
+  int dma_buf_count;
+  int dma_buf_len;
+} i2s_config_t;
+
+typedef struct {
+  int mck_io_num;
+  int bck_io_num;
+  int ws_io_num;
+  int data_out_num;
+  int data_in_num;
+} i2s_pin_config_t;
+
+typedef enum {
+  I2S_EVENT_DMA_ERROR,
+  I2S_EVENT_TX_DONE,
+  I2S_EVENT_RX_DONE,
+  I2S_EVENT_TX_Q_OVF,
+  I2S_EVENT_RX_Q_OVF,
+  I2S_EVENT_MAX,
+} i2s_event_type_t;
+
+typedef struct {
+  i2s_event_type_t type;
+  size_t size;
+} i2s_event_t;
+
+// The event queue is created, but nothing is posted to it: host tools
+// call acquire_sample_chunk() directly instead of waiting on RX_DONE.
+esp_err_t i2s_driver_install(i2s_port_t port, const i2s_config_t* config, int queue_size, QueueHandle_t* queue);
+esp_err_t i2s_set_pin(i2s_port_t port, const i2s_pin_config_t* pins);
+esp_err_t i2s_read(i2s_port_t port, void* dest, size_t size, size_t* bytes_read, uint32_t ticks_to_wait);
+
+// Host only: where i2s_read() gets its samples. Returns how many of
+// `samples` raw 32-bit slots it filled; the rest read as silence.
+typedef size_t (*host_i2s_source_t)(int32_t* dest, size_t samples);
+void host_i2s_set_source(host_i2s_source_t source);
+
+#endif // HOST_SHIM_DRIVER_I2S_H
@@ -0,0 +1,118 @@
+// ESP-IDF stand-ins for the host build (see esp_idf.h, driver/i2s.h)
+
+#include <Arduino.h>
+#include <driver/i2s.h>
+#include <esp_timer.h>
+#include <FirmwareMSC.h>
+#include <USB.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+uint32_t esp_random(void) {
+  return (uint32_t)random(0x7FFFFFFF) ^ ((uint32_t)random(2) << 31);
+}
+
+void esp_fill_random(void* buffer, size_t length) {
+  uint8_t* bytes = (uint8_t*)buffer;
+  for (size_t i = 0; i < length; i++) {
+    bytes[i] = esp_random();
+  }
+}
+
+int64_t esp_timer_get_time(void) {
+  static const auto boot = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - boot).count();
+}
+
+// Timers ------------------------------------------------------------
+
+struct HostTimer {
+  esp_timer_cb_t callback;
+  void* arg;
+  std::atomic<uint32_t> generation;  // Bumped by every start and stop
+  std::atomic<bool> armed;
+};
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* create_args, esp_timer_handle_t* out_handle) {
+  HostTimer* timer = new HostTimer();
+  timer->callback = create_args->callback;
+  timer->arg = create_args->arg;
+  *out_handle = timer;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+  if (timer->armed.exchange(true)) {
+    return ESP_FAIL;  // ESP_ERR_INVALID_STATE on the device
+  }
+  uint32_t generation = ++timer->generation;
+  std::thread([timer, generation, timeout_us]() {
+    std::this_thread::sleep_for(std::chrono::microseconds(timeout_us));
+    if (timer->generation == generation && timer->armed.exchange(false)) {
+      timer->callback(timer->arg);
+    }
+  }).detach();
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  timer->generation++;
+  return timer->armed.exchange(false) ? ESP_OK : ESP_FAIL;
+}
+
+void* heap_caps_malloc(size_t size, uint32_t) {
+  return malloc(size);
+}
+
+void* heap_caps_calloc(size_t count, size_t size, uint32_t) {
+  return calloc(count, size);
+}
+
+void heap_caps_free(void* ptr) {
+  free(ptr);
+}
+
+size_t heap_caps_get_free_size(uint32_t) {
+  return 256 * 1024;
+}
+
+size_t heap_caps_get_largest_free_block(uint32_t) {
+  return 128 * 1024;
+}
+
+// I2S ---------------------------------------------------------------
+
+static host_i2s_source_t i2s_source = NULL;
+
+void host_i2s_set_source(host_i2s_source_t source) {
+  i2s_source = source;
+}
+
+esp_err_t i2s_driver_install(i2s_port_t, const i2s_config_t*, int queue_size, QueueHandle_t* queue) {
+  if (queue != NULL && queue_size > 0) {
+    *queue = xQueueCreate(queue_size, sizeof(i2s_event_t));
+  }
+  return ESP_OK;
+}
+
+esp_err_t i2s_set_pin(i2s_port_t, const i2s_pin_config_t*) {
+  return ESP_OK;
+}
+
+// One left-justified 32-bit slot per sample, like the S3 I2S RX DMA
+esp_err_t i2s_read(i2s_port_t, void* dest, size_t size, size_t* bytes_read, uint32_t) {
+  size_t samples = size / sizeof(int32_t);
+  size_t filled = (i2s_source != NULL) ? i2s_source((int32_t*)dest, samples) : 0;
+
+  memset((int32_t*)dest + filled, 0, (samples - filled) * sizeof(int32_t));
+  *bytes_read = filled * sizeof(int32_t);
+  return ESP_OK;
+}
+
+// USB ---------------------------------------------------------------
+
+const esp_event_base_t ARDUINO_USB_EVENTS = "ARDUINO_USB_EVENTS";
+const esp_event_base_t ARDUINO_FIRMWARE_MSC_EVENTS = "ARDUINO_FIRMWARE_MSC_EVENTS";
+ESPUSB USB;
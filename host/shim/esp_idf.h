@@ -0,0 +1,38 @@
+// ESP-IDF types and calls the firmware touches, for the host build
+
+#ifndef HOST_SHIM_ESP_IDF_H
+#define HOST_SHIM_ESP_IDF_H
+
+#include <cstdint>
+#include <cstddef>
+
+typedef int esp_err_t;
+#define ESP_OK 0
+#define ESP_FAIL -1
+
+typedef const char* esp_event_base_t;
+
+uint32_t esp_random(void);
+void esp_fill_random(void* buffer, size_t length);
+
+int64_t esp_timer_get_time(void);
+
+// Watchdog (no-op)
+inline esp_err_t esp_task_wdt_init(uint32_t, bool) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_add(void*) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_delete(void*) { return ESP_OK; }
+inline esp_err_t esp_task_wdt_reset(void) { return ESP_OK; }
+
+// Heap capabilities: everything is "internal" on a PC
+#define MALLOC_CAP_8BIT     (1 << 2)
+#define MALLOC_CAP_DMA      (1 << 3)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+#define MALLOC_CAP_SPIRAM   (1 << 10)
+#define MALLOC_CAP_DEFAULT  (1 << 12)
+void* heap_caps_malloc(size_t size, uint32_t caps);
+void* heap_caps_calloc(size_t count, size_t size, uint32_t caps);
+void heap_caps_free(void* ptr);
+size_t heap_caps_get_free_size(uint32_t caps);
+size_t heap_caps_get_largest_free_block(uint32_t caps);
+
+#endif // HOST_SHIM_ESP_IDF_H
@@ -0,0 +1,16 @@
+// ESP-IDF power management, for the host build (no-op)
+
+#ifndef HOST_SHIM_ESP_PM_H
+#define HOST_SHIM_ESP_PM_H
+
+#include "esp_idf.h"
+
+typedef struct {
+  int max_freq_mhz;
+  int min_freq_mhz;
+  bool light_sleep_enable;
+} esp_pm_config_esp32s3_t;
+
+inline esp_err_t esp_pm_configure(const void*) { return ESP_OK; }
+
+#endif // HOST_SHIM_ESP_PM_H
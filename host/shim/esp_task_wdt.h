@@ -0,0 +1 @@
+#include "esp_idf.h"
@@ -0,0 +1,222 @@
+// FreeRTOS on std::thread (see freertos/*.h)
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/semphr.h>
+#include <freertos/queue.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct HostTask {
+  const char* name;
+  BaseType_t core_id;
+  std::mutex notify_lock;
+  std::condition_variable notified;
+  uint32_t notify_count;
+
+  HostTask(const char* task_name, BaseType_t task_core_id) : name(task_name), core_id(task_core_id), notify_count(0) {}
+};
+
+static HostTask main_task("main", 0);
+static thread_local HostTask* current_task = &main_task;
+
+BaseType_t xPortGetCoreID(void) {
+  return current_task->core_id;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t function, const char* name, uint32_t, void* parameter,
+                                   UBaseType_t, TaskHandle_t* handle, BaseType_t core_id) {
+  HostTask* task = new HostTask(name, (core_id == tskNO_AFFINITY) ? 0 : core_id);
+  if (handle != NULL) {
+    *handle = task;
+  }
+
+  std::thread([task, function, parameter]() {
+    current_task = task;
+    function(parameter);
+  }).detach();
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t function, const char* name, uint32_t stack_depth, void* parameter,
+                       UBaseType_t priority, TaskHandle_t* handle) {
+  return xTaskCreatePinnedToCore(function, name, stack_depth, parameter, priority, handle, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t) {
+  // Threads can't be killed from outside; tasks that delete themselves
+  // just return from their function on the host
+}
+
+static std::chrono::steady_clock::duration ticks_to_duration(TickType_t ticks) {
+  return std::chrono::milliseconds(ticks * portTICK_PERIOD_MS);
+}
+
+void vTaskDelay(TickType_t ticks) {
+  std::this_thread::sleep_for(ticks_to_duration(ticks));
+}
+
+TickType_t xTaskGetTickCount(void) {
+  static const auto boot = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - boot).count() / portTICK_PERIOD_MS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+  return current_task;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t) {
+  return 4096;
+}
+
+void vTaskList(char* buffer) {
+  strcpy(buffer, "(task list not available on host)\n");
+}
+
+void taskYIELD(void) {
+  std::this_thread::yield();
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t task) {
+  std::lock_guard<std::mutex> guard(task->notify_lock);
+  task->notify_count++;
+  task->notified.notify_all();
+  return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear_on_exit, TickType_t ticks) {
+  HostTask* task = current_task;
+  std::unique_lock<std::mutex> guard(task->notify_lock);
+  auto has_notification = [task]() { return task->notify_count > 0; };
+  if (ticks == portMAX_DELAY) {
+    task->notified.wait(guard, has_notification);
+  } else if (!task->notified.wait_for(guard, ticks_to_duration(ticks), has_notification)) {
+    return 0;
+  }
+
+  uint32_t count = task->notify_count;
+  task->notify_count = clear_on_exit ? 0 : count - 1;
+  return count;
+}
+
+// Semaphores ----------------------------------------------------------
+
+struct HostSemaphore {
+  std::mutex lock;
+  std::condition_variable changed;
+  UBaseType_t count;
+  UBaseType_t max_count;
+};
+
+static SemaphoreHandle_t semaphore_create(UBaseType_t initial, UBaseType_t max_count) {
+  HostSemaphore* semaphore = new HostSemaphore();
+  semaphore->count = initial;
+  semaphore->max_count = max_count;
+  return semaphore;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  return semaphore_create(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+  return semaphore_create(0, 1);
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t semaphore, TickType_t ticks) {
+  if (semaphore == NULL) {
+    return pdFAIL;  // Asserts on target
+  }
+
+  std::unique_lock<std::mutex> guard(semaphore->lock);
+  auto available = [semaphore]() { return semaphore->count > 0; };
+  if (ticks == portMAX_DELAY) {
+    semaphore->changed.wait(guard, available);
+  } else if (!semaphore->changed.wait_for(guard, ticks_to_duration(ticks), available)) {
+    return pdFAIL;
+  }
+
+  semaphore->count--;
+  return pdPASS;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t semaphore) {
+  if (semaphore == NULL) {
+    return pdFAIL;
+  }
+
+  std::lock_guard<std::mutex> guard(semaphore->lock);
+  if (semaphore->count >= semaphore->max_count) {
+    return pdFAIL;
+  }
+  semaphore->count++;
+  semaphore->changed.notify_one();
+  return pdPASS;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t semaphore) {
+  delete semaphore;
+}
+
+// Queues --------------------------------------------------------------
+
+struct HostQueue {
+  std::mutex lock;
+  std::condition_variable changed;
+  std::deque<std::vector<uint8_t>> items;
+  UBaseType_t length;
+  UBaseType_t item_size;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size) {
+  HostQueue* queue = new HostQueue();
+  queue->length = length;
+  queue->item_size = item_size;
+  return queue;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+  std::unique_lock<std::mutex> guard(queue->lock);
+  auto has_room = [queue]() { return queue->items.size() < queue->length; };
+  if (ticks == portMAX_DELAY) {
+    queue->changed.wait(guard, has_room);
+  } else if (!queue->changed.wait_for(guard, ticks_to_duration(ticks), has_room)) {
+    return pdFAIL;
+  }
+
+  const uint8_t* bytes = (const uint8_t*)item;
+  queue->items.emplace_back(bytes, bytes + queue->item_size);
+  queue->changed.notify_all();
+  return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t ticks) {
+  std::unique_lock<std::mutex> guard(queue->lock);
+  auto has_item = [queue]() { return !queue->items.empty(); };
+  if (ticks == portMAX_DELAY) {
+    queue->changed.wait(guard, has_item);
+  } else if (!queue->changed.wait_for(guard, ticks_to_duration(ticks), has_item)) {
+    return pdFAIL;
+  }
+
+  memcpy(item, queue->items.front().data(), queue->item_size);
+  queue->items.pop_front();
+  queue->changed.notify_all();
+  return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> guard(queue->lock);
+  return queue->items.size();
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+  delete queue;
+}
@@ -0,0 +1,176 @@
+// WAV file playback into the host I2S shim (see wav_source.h)
+
+#include "wav_source.h"
+
+#include <driver/i2s.h>
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+static const wav_clip* source_clip = NULL;
+static size_t source_position = 0;
+static float source_gain = 1.0;
+static int32_t source_dc_offset = 0;
+
+static uint32_t read_le(const uint8_t* bytes, uint8_t count) {
+  uint32_t value = 0;
+  for (uint8_t i = 0; i < count; i++) {
+    value |= (uint32_t)bytes[i] << (8 * i);
+  }
+  return value;
+}
+
+// One sample of any supported format, to int16 scale
+static float decode_sample(const uint8_t* bytes, uint16_t format, uint16_t bits) {
+  if (format == 3) {
+    float value;
+    memcpy(&value, bytes, sizeof(value));
+    return value * 32768.0f;
+  }
+
+  switch (bits) {
+    case 8:
+      return (bytes[0] - 128) * 256.0f;
+    case 16:
+      return (int16_t)read_le(bytes, 2);
+    case 24:
+      return (int32_t)(read_le(bytes, 3) << 8) / 65536.0f;
+    default:
+      return (int32_t)read_le(bytes, 4) / 65536.0f;
+  }
+}
+
+bool wav_load(const char* path, wav_clip& clip) {
+  FILE* file = fopen(path, "rb");
+  if (file == NULL) {
+    fprintf(stderr, "%s: can't open\n", path);
+    return false;
+  }
+
+  std::vector<uint8_t> data;
+  uint8_t buffer[65536];
+  size_t count;
+  while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+    data.insert(data.end(), buffer, buffer + count);
+  }
+  fclose(file);
+
+  if (data.size() < 12 || memcmp(&data[0], "RIFF", 4) != 0 || memcmp(&data[8], "WAVE", 4) != 0) {
+    fprintf(stderr, "%s: not a RIFF/WAVE file\n", path);
+    return false;
+  }
+
+  uint16_t format = 0;
+  const uint8_t* pcm = NULL;
+  size_t pcm_bytes = 0;
+  clip = wav_clip();
+  clip.path = path;
+
+  // Walk the chunks for "fmt " and "data"
+  size_t offset = 12;
+  while (offset + 8 <= data.size()) {
+    const uint8_t* chunk = &data[offset];
+    size_t chunk_size = read_le(chunk + 4, 4);
+    size_t available = data.size() - (offset + 8);
+    if (chunk_size > available) {
+      chunk_size = available;  // Truncated file (or streamed header): use what's there
+    }
+
+    if (memcmp(chunk, "fmt ", 4) == 0 && chunk_size >= 16) {
+      format = read_le(chunk + 8, 2);
+      clip.channels = read_le(chunk + 10, 2);
+      clip.sample_rate = read_le(chunk + 12, 4);
+      clip.bits_per_sample = read_le(chunk + 22, 2);
+      if (format == 0xFFFE && chunk_size >= 26) {
+        format = read_le(chunk + 32, 2);  // WAVE_FORMAT_EXTENSIBLE: sub-format GUID starts with the tag
+      }
+    } else if (memcmp(chunk, "data", 4) == 0) {
+      pcm = chunk + 8;
+      pcm_bytes = chunk_size;
+    }
+
+    offset += 8 + chunk_size + (chunk_size & 1);
+  }
+
+  bool supported_pcm = (format == 1 && (clip.bits_per_sample == 8 || clip.bits_per_sample == 16 ||
+                                        clip.bits_per_sample == 24 || clip.bits_per_sample == 32));
+  bool supported_float = (format == 3 && clip.bits_per_sample == 32);
+  if (!supported_pcm && !supported_float) {
+    fprintf(stderr, "%s: unsupported format %u / %u bits (PCM 8-32 bit or float32 only)\n", path, format, clip.bits_per_sample);
+    return false;
+  }
+  if (pcm == NULL || clip.channels == 0 || clip.sample_rate == 0) {
+    fprintf(stderr, "%s: missing fmt or data chunk\n", path);
+    return false;
+  }
+
+  uint16_t sample_bytes = clip.bits_per_sample / 8;
+  size_t frames = pcm_bytes / (sample_bytes * clip.channels);
+  clip.samples.resize(frames);
+
+  for (size_t i = 0; i < frames; i++) {
+    const uint8_t* frame = pcm + i * sample_bytes * clip.channels;
+    float sum = 0.0;
+    for (uint16_t c = 0; c < clip.channels; c++) {
+      sum += decode_sample(frame + c * sample_bytes, format, clip.bits_per_sample);
+    }
+    clip.samples[i] = sum / clip.channels;
+  }
+
+  return true;
+}
+
+void wav_synth(wav_clip& clip, uint32_t sample_rate, float seconds) {
+  clip = wav_clip();
+  clip.path = "synth";
+  clip.sample_rate = sample_rate;
+  clip.channels = 1;
+  clip.bits_per_sample = 16;
+  clip.samples.resize(size_t(seconds * sample_rate));
+
+  const double f0 = 30.0;
+  const double f1 = sample_rate * 0.45;
+  const double rate = log(f1 / f0) / seconds;
+  uint32_t noise = 12345;
+  for (size_t i = 0; i < clip.samples.size(); i++) {
+    double t = double(i) / sample_rate;
+    double sweep_phase = 2.0 * M_PI * f0 * (exp(rate * t) - 1.0) / rate;
+    double value = 6000.0 * sin(sweep_phase);
+    value += 3000.0 * sin(2.0 * M_PI * 110.0 * t);
+    value += 2000.0 * sin(2.0 * M_PI * 1760.0 * t);
+    noise = noise * 1664525u + 1013904223u;  // LCG
+    value += (int32_t(noise >> 16) - 32768) / 64.0;
+    clip.samples[i] = float(value);
+  }
+}
+
+// i2s_read() source: acquire_sample_chunk() recovers the sample as
+// (word >> 14) - CONFIG.DC_OFFSET, at CONFIG.SENSITIVITY 1.0
+static size_t wav_source_read(int32_t* dest, size_t samples) {
+  size_t filled = 0;
+  while (filled < samples && source_position < source_clip->samples.size()) {
+    float value = source_clip->samples[source_position++] * source_gain;
+    if (value > 32767.0f) {
+      value = 32767.0f;
+    } else if (value < -32768.0f) {
+      value = -32768.0f;
+    }
+
+    int32_t sample = (int32_t)value + source_dc_offset;
+    dest[filled++] = (int32_t)((uint32_t)sample << 14);
+  }
+  return filled;
+}
+
+void wav_source_start(const wav_clip& clip, float gain, int32_t dc_offset) {
+  source_clip = &clip;
+  source_position = 0;
+  source_gain = gain;
+  source_dc_offset = dc_offset;
+  host_i2s_set_source(wav_source_read);
+}
+
+size_t wav_source_remaining() {
+  return (source_clip == NULL) ? 0 : source_clip->samples.size() - source_position;
+}
@@ -0,0 +1,37 @@
+// WAV file playback into the host I2S shim (driver/i2s.h)
+
+#ifndef HOST_WAV_SOURCE_H
+#define HOST_WAV_SOURCE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct wav_clip {
+  std::string path;
+  uint32_t sample_rate = 0;
+  uint16_t channels = 0;
+  uint16_t bits_per_sample = 0;
+  std::vector<float> samples;  // Mono mixdown, int16 scale (-32768.0 to 32767.0)
+};
+
+// Reads 8/16/24/32-bit PCM or 32-bit float WAV, any channel count.
+// Returns false (and prints why) if the file can't be used.
+bool wav_load(const char* path, wav_clip& clip);
+
+// A built-in test clip, for checks that shouldn't depend on a WAV file:
+// a logarithmic sweep from 30 Hz to just under Nyquist, two steady
+// tones (110 Hz, 1760 Hz) and a little white noise. Deterministic.
+void wav_synth(wav_clip& clip, uint32_t sample_rate, float seconds);
+
+// Queue a clip for i2s_read(). Samples are scaled by `gain` and turned
+// into the left-justified 32-bit words the S3's I2S peripheral delivers,
+// with `dc_offset` added back so the firmware's own DC removal
+// (CONFIG.DC_OFFSET) cancels it.
+void wav_source_start(const wav_clip& clip, float gain, int32_t dc_offset);
+
+// Samples of the current clip not yet read by i2s_read()
+size_t wav_source_remaining();
+
+#endif // HOST_WAV_SOURCE_H
@@ -67,6 +67,7 @@ enum TraceEventID : uint16_t {
     LED_SHOW_START          = 0x2003,
     LED_SHOW_DONE           = 0x2004,
     LED_FRAME_DONE          = 0x2005,
+    LED_PHOTON_LATENCY      = 0x2006,  // Audio DMA completion -> FastLED.show() done, us
 
     // Synchronization events
     MUTEX_LOCK_ATTEMPT      = 0x3000,
@@ -121,21 +122,29 @@ private:
     alignas(64) std::atomic<uint32_t> head{0};  // Cache line aligned
     alignas(64) std::atomic<uint32_t> tail{0};  // Separate cache line
     alignas(64) TraceEvent buffer[SIZE];        // Data cache line aligned
+    std::atomic<uint8_t> committed[SIZE] = {};  // Slot filled, ready to pop
 
     std::atomic<uint32_t> dropped_events{0};
 
 public:
-    // Fast, lock-free push (safe from any context including ISR)
+    // Fast, lock-free push (safe from any context including ISR, and from
+    // both cores at once: the slot is claimed with a CAS on head, then
+    // marked committed once it's filled)
     __attribute__((always_inline))
     inline bool push(uint16_t event_id, uint32_t data, uint8_t level = TRACE_LEVEL_INFO) {
         uint32_t current_head = head.load(std::memory_order_relaxed);
-        uint32_t next_head = (current_head + 1) & TRACE_BUFFER_MASK;
-
-        // Check for buffer full (conservative check)
-        if (next_head == tail.load(std::memory_order_acquire)) {
-            dropped_events.fetch_add(1, std::memory_order_relaxed);
-            return false;
-        }
+        uint32_t next_head;
+        do {
+            next_head = (current_head + 1) & TRACE_BUFFER_MASK;
+
+            // Check for buffer full (conservative check)
+            if (next_head == tail.load(std::memory_order_acquire)) {
+                dropped_events.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+        } while (!head.compare_exchange_weak(current_head, next_head,
+                                             std::memory_order_acq_rel,
+                                             std::memory_order_relaxed));
 
         // Fill event data
         buffer[current_head].timestamp = micros();
@@ -145,19 +154,24 @@ public:
         buffer[current_head].data = data;
 
         // Commit the write
-        head.store(next_head, std::memory_order_release);
+        committed[current_head].store(1, std::memory_order_release);
         return true;
     }
 
-    // Pop for trace consumer (typically on Core 1)
+    // Pop for trace consumer (typically on Core 1). Stops at a slot another
+    // core has claimed but not filled yet; it's there next time
     bool pop(TraceEvent& event) {
         uint32_t current_tail = tail.load(std::memory_order_relaxed);
 
         if (current_tail == head.load(std::memory_order_acquire)) {
             return false; // Buffer empty
         }
+        if (committed[current_tail].load(std::memory_order_acquire) == 0) {
+            return false; // Still being written
+        }
 
         event = buffer[current_tail];
+        committed[current_tail].store(0, std::memory_order_relaxed);
         tail.store((current_tail + 1) & TRACE_BUFFER_MASK, std::memory_order_release);
         return true;
     }
@@ -192,6 +206,11 @@ struct TraceConfig {
 
 extern TraceConfig g_trace_config;
 
+// What setup() enables, and what trace_stream=on adds on top: both
+// pipelines' frame and stage events (AudioFrameTracer, LEDFrameTracer)
+#define TRACE_DEFAULT_CATEGORIES (TRACE_CAT_LED | TRACE_CAT_PERF | TRACE_CAT_CRITICAL | TRACE_CAT_ERROR)
+#define TRACE_STREAM_CATEGORIES  (TRACE_DEFAULT_CATEGORIES | TRACE_CAT_AUDIO)
+
 // Performance-optimized trace macros
 
 // Zero-overhead when disabled at compile time
@@ -405,12 +424,12 @@ inline void trace_mutex_operation(void* mutex, bool acquired, uint32_t wait_us)
     #if TRACE_LEVEL >= TRACE_LEVEL_DEBUG
     if (acquired) {
         if (wait_us > 100) {  // Log contended mutexes
-            TRACE_WARNING(MUTEX_LOCK_SUCCESS, (uint32_t)mutex);
+            TRACE_WARNING(MUTEX_LOCK_SUCCESS, (uint32_t)(uintptr_t)mutex);
         } else {
             TRACE_DEBUG(MUTEX_LOCK_SUCCESS, wait_us);
         }
     } else {
-        TRACE_DEBUG(MUTEX_UNLOCK, (uint32_t)mutex);
+        TRACE_DEBUG(MUTEX_UNLOCK, (uint32_t)(uintptr_t)mutex);
     }
     #endif
 }
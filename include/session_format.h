@@ -0,0 +1,311 @@
+// Session Recording Format for K1-07 SensoryBridge
+// Everything a show depends on (microphone samples, CONFIG changes,
+// serial / HMI / P2P input, frame timing) as framed records, written
+// by the firmware (src/session_record.h) to flash and read back by its
+// replay engine and by the host (host/sb_dsp_host.cpp --replay)
+
+#ifndef SESSION_FORMAT_H
+#define SESSION_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "trace_stream_format.h"   // COBS, CRC-16, varints and the little-endian helpers
+
+// One record per event, little-endian, before COBS:
+//
+//   u8   magic         SESSION_MAGIC
+//   u8   version       SESSION_VERSION
+//   u8   type          SESSION_REC_*
+//   u8   reserved
+//   u32  seq           Per record type, +1 per record produced: a gap
+//                      means records were dropped (ring full)
+//   u32  timestamp     micros() on the device; the audio clock on the host
+//   data               see below
+//   u16  crc           CRC-16/CCITT-FALSE of everything above
+//
+// Framed like the trace and telemetry streams, 0x00 <COBS> 0x00, so a
+// session sent over USB (session=send) can be captured with the menu's
+// text around it and read as-is. START, CONFIG and AUDIO come from the
+// audio task, frame by frame, and are in order; LED_FRAME (LED thread)
+// and EVENT (control task, P2P receive) are interleaved with them as
+// they were written, so they say which audio frame or time they belong
+// to. END is last.
+//
+// Data per type:
+//
+//   START      u32 firmware_version, u32 random_seed, u16 audio_hop_size,
+//              u8 gdft_engine, u8 noise_complete, u8 analysis_on_demand,
+//              u8 reserved, u16 render_resolution_setting, u16 config_bytes,
+//              u16 num_freqs, then CONFIG (config_bytes, raw),
+//              noise_samples[] (q16.16, num_freqs of them), u16
+//              settings_bytes and the settings image (below)
+//   CONFIG     Changed byte runs of CONFIG since the last frame:
+//              u16 offset, u8 length, bytes; repeated
+//   SETTINGS   Changed byte runs of the settings image, as CONFIG
+//   AUDIO      u16 count, then count zigzag varint deltas of the raw
+//              I2S slots >> 14 (what acquire_sample_chunk() reads)
+//   LED_FRAME  u32 audio_frame (audio frames since START that the LED
+//              frame rendered from, 0 = none yet), u16 led_count,
+//              u32 FNV-1a of leds_out[] as shown
+//   EVENT      u8 source (SESSION_EVENT_*), then:
+//                SERIAL  the command line, as parsed
+//                P2P     the packet as received
+//                HMI     u8 encoder, u8 click, i32 rotation
+//                BUTTON  u8 button (0 noise, 1 mode), u8 long press
+//   END        u32 records dropped, per type (SESSION_NUM_RECORD_TYPES)
+//
+// The settings image is what changes leds_out outside CONFIG
+// (SESSION_SETTINGS_BYTES):
+//
+//   f32 output_curve.gamma, f32 output_curve.gain[3],
+//   u16 led_frame_rate_setting, u8 SECONDARY_LIGHTSHOW_MODE,
+//   u8 SECONDARY_MIRROR_ENABLED, f32 SECONDARY_PHOTONS, f32 SECONDARY_CHROMA,
+//   f32 SECONDARY_MOOD, f32 SECONDARY_SATURATION, u8 SECONDARY_PRISM_COUNT,
+//   f32 SECONDARY_INCANDESCENT_FILTER, u8 SECONDARY_BASE_COAT,
+//   u8 SECONDARY_REVERSE_ORDER, u8 SECONDARY_AUTO_COLOR_SHIFT
+
+#define SESSION_MAGIC         0x52   // 'R'
+#define SESSION_VERSION       2
+#define SESSION_HEADER_BYTES  12
+#define SESSION_START_BYTES   20     // START's fixed fields, before CONFIG
+#define SESSION_SETTINGS_BYTES 44    // The settings image
+#define SESSION_AUDIO_SHIFT   14     // Raw I2S slot -> the 18 bits the S3 path keeps
+#define SESSION_MAX_DATA      (2 + 1024 * 3)   // AUDIO at the largest hop, 3 bytes a sample at worst
+#define SESSION_MAX_PAYLOAD   (SESSION_HEADER_BYTES + SESSION_MAX_DATA + 2)
+#define SESSION_FRAME_BYTES(payload_bytes) ((payload_bytes) + (payload_bytes) / 254 + 1 + 2)
+#define SESSION_MAX_FRAME     SESSION_FRAME_BYTES(SESSION_MAX_PAYLOAD)
+
+enum SessionRecordType : uint8_t {
+    SESSION_REC_START = 0,
+    SESSION_REC_CONFIG,
+    SESSION_REC_AUDIO,
+    SESSION_REC_LED_FRAME,
+    SESSION_REC_EVENT,
+    SESSION_REC_END,
+    SESSION_REC_SETTINGS,
+    SESSION_NUM_RECORD_TYPES
+};
+
+enum SessionEventSource : uint8_t {
+    SESSION_EVENT_SERIAL = 0,
+    SESSION_EVENT_P2P,
+    SESSION_EVENT_HMI,
+    SESSION_EVENT_BUTTON,
+    SESSION_NUM_EVENT_SOURCES
+};
+
+static const char* const session_record_names[SESSION_NUM_RECORD_TYPES] = {
+    "start", "config", "audio", "led_frame", "event", "end", "settings"
+};
+
+static const char* const session_event_names[SESSION_NUM_EVENT_SOURCES] = {
+    "serial", "p2p", "hmi", "button"
+};
+
+// Write the header; data follows at payload + SESSION_HEADER_BYTES
+inline void session_record_begin(uint8_t* payload, uint8_t type, uint32_t seq, uint32_t timestamp) {
+    payload[0] = SESSION_MAGIC;
+    payload[1] = SESSION_VERSION;
+    payload[2] = type;
+    payload[3] = 0;
+    trace_stream_put_u32(payload + 4, seq);
+    trace_stream_put_u32(payload + 8, timestamp);
+}
+
+// CRC the record; returns the payload length
+inline size_t session_record_seal(uint8_t* payload, size_t data_length) {
+    size_t length = SESSION_HEADER_BYTES + data_length;
+    trace_stream_put_u16(payload + length, trace_stream_crc16(payload, length));
+    return length + 2;
+}
+
+// Frame a sealed payload into out (SESSION_MAX_FRAME bytes); returns its length
+inline size_t session_record_frame(const uint8_t* payload, size_t length, uint8_t* out) {
+    out[0] = 0;
+    size_t framed = 1 + cobs_encode(payload, length, out + 1);
+    out[framed++] = 0;
+    return framed;
+}
+
+// A decoded record. data points into the payload
+struct SessionRecordInfo {
+    uint8_t type;
+    uint32_t seq;
+    uint32_t timestamp;
+    const uint8_t* data;
+    size_t data_length;
+};
+
+// Parse one record's payload (already COBS decoded). False if it isn't
+// a session record: wrong magic / version, bad CRC, unknown type
+inline bool session_record_parse(const uint8_t* payload, size_t length, SessionRecordInfo& info) {
+    if (length < SESSION_HEADER_BYTES + 2 || payload[0] != SESSION_MAGIC ||
+        payload[1] != SESSION_VERSION || payload[2] >= SESSION_NUM_RECORD_TYPES) {
+        return false;
+    }
+    if (trace_stream_crc16(payload, length - 2) != trace_stream_get_u16(payload + length - 2)) {
+        return false;
+    }
+
+    info.type = payload[2];
+    info.seq = trace_stream_get_u32(payload + 4);
+    info.timestamp = trace_stream_get_u32(payload + 8);
+    info.data = payload + SESSION_HEADER_BYTES;
+    info.data_length = length - SESSION_HEADER_BYTES - 2;
+    return true;
+}
+
+// START's fixed fields
+struct SessionStartInfo {
+    uint32_t firmware_version;
+    uint32_t random_seed;
+    uint16_t audio_hop_size;
+    uint8_t gdft_engine;
+    uint8_t noise_complete;
+    uint8_t analysis_on_demand;
+    uint16_t render_resolution_setting;
+    uint16_t config_bytes;
+    uint16_t num_freqs;
+    uint16_t settings_bytes;
+    const uint8_t* config;        // config_bytes
+    const uint8_t* noise_samples; // num_freqs q16.16 values
+    const uint8_t* settings;      // settings_bytes
+};
+
+inline bool session_parse_start(const SessionRecordInfo& info, SessionStartInfo& start) {
+    if (info.type != SESSION_REC_START || info.data_length < SESSION_START_BYTES) {
+        return false;
+    }
+    const uint8_t* p = info.data;
+    start.firmware_version = trace_stream_get_u32(p);
+    start.random_seed = trace_stream_get_u32(p + 4);
+    start.audio_hop_size = trace_stream_get_u16(p + 8);
+    start.gdft_engine = p[10];
+    start.noise_complete = p[11];
+    start.analysis_on_demand = p[12];
+    start.render_resolution_setting = trace_stream_get_u16(p + 14);
+    start.config_bytes = trace_stream_get_u16(p + 16);
+    start.num_freqs = trace_stream_get_u16(p + 18);
+    start.config = p + SESSION_START_BYTES;
+    start.noise_samples = start.config + start.config_bytes;
+
+    size_t settings_at = SESSION_START_BYTES + start.config_bytes + size_t(start.num_freqs) * 4;
+    if (info.data_length < settings_at + 2) {
+        return false;
+    }
+    start.settings_bytes = trace_stream_get_u16(p + settings_at);
+    start.settings = p + settings_at + 2;
+    return info.data_length == settings_at + 2 + start.settings_bytes;
+}
+
+// AUDIO: samples as zigzag varint deltas. Returns the end of the data
+inline uint8_t* session_put_audio(uint8_t* p, const int32_t* raw, uint16_t count) {
+    p = trace_stream_put_u16(p, count);
+    int32_t last = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        int32_t sample = raw[i] >> SESSION_AUDIO_SHIFT;
+        int32_t delta = sample - last;
+        p = trace_stream_put_varint(p, (uint32_t(delta) << 1) ^ uint32_t(delta >> 31));
+        last = sample;
+    }
+    return p;
+}
+
+// Decode up to max_count samples back into raw I2S slots (the low 14
+// bits, which the S3 path never reads, come back as zero). Returns the
+// count, or -1 if the record is malformed
+inline int32_t session_get_audio(const SessionRecordInfo& info, int32_t* raw, uint16_t max_count) {
+    if (info.data_length < 2) {
+        return -1;
+    }
+    const uint8_t* p = info.data;
+    const uint8_t* end = info.data + info.data_length;
+    uint16_t count = trace_stream_get_u16(p);
+    p += 2;
+    int32_t sample = 0;
+    for (uint16_t i = 0; i < count; i++) {
+        uint32_t zigzag;
+        p = trace_stream_get_varint(p, end, zigzag);
+        if (p == NULL) {
+            return -1;
+        }
+        sample += int32_t(zigzag >> 1) ^ -int32_t(zigzag & 1);
+        if (i < max_count) {
+            raw[i] = int32_t(uint32_t(sample) << SESSION_AUDIO_SHIFT);
+        }
+    }
+    return (count < max_count) ? count : max_count;
+}
+
+// CONFIG: append the runs where current differs from last, copying
+// them into last. Runs closer than 4 bytes are merged. Returns the end
+// of the data (p itself when nothing changed)
+inline uint8_t* session_put_config_diff(uint8_t* p, const uint8_t* current, uint8_t* last, uint16_t size) {
+    uint16_t i = 0;
+    while (i < size) {
+        if (current[i] == last[i]) {
+            i++;
+            continue;
+        }
+        uint16_t start = i;
+        uint16_t end = i + 1;  // One past the last differing byte
+        for (uint16_t j = end; j < size && j - start < 255 && j - end < 4; j++) {
+            if (current[j] != last[j]) {
+                end = j + 1;
+            }
+        }
+        p = trace_stream_put_u16(p, start);
+        *p++ = uint8_t(end - start);
+        memcpy(p, current + start, end - start);
+        memcpy(last + start, current + start, end - start);
+        p += end - start;
+        i = end;
+    }
+    return p;
+}
+
+// Apply a CONFIG (or SETTINGS) record to config (size bytes). False if a run falls
+// outside it (a session from a different CONFIG layout)
+inline bool session_apply_config_diff(const SessionRecordInfo& info, uint8_t* config, uint16_t size) {
+    const uint8_t* p = info.data;
+    const uint8_t* end = info.data + info.data_length;
+    while (p + 3 <= end) {
+        uint16_t offset = trace_stream_get_u16(p);
+        uint8_t length = p[2];
+        p += 3;
+        if (p + length > end || offset + length > size) {
+            return false;
+        }
+        memcpy(config + offset, p, length);
+        p += length;
+    }
+    return p == end;
+}
+
+// f32 fields of the settings image, as their IEEE 754 bits
+inline uint8_t* session_put_f32(uint8_t* p, float value) {
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    return trace_stream_put_u32(p, bits);
+}
+
+inline float session_get_f32(const uint8_t* p) {
+    uint32_t bits = trace_stream_get_u32(p);
+    float value;
+    memcpy(&value, &bits, 4);
+    return value;
+}
+
+// FNV-1a, for LED_FRAME's leds_out[] checksum
+inline uint32_t session_fnv1a(uint32_t hash, const void* data, size_t length) {
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ bytes[i]) * 16777619u;
+    }
+    return hash;
+}
+
+#define SESSION_FNV1A_BASIS 2166136261u
+
+#endif // SESSION_FORMAT_H
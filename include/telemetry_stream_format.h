@@ -0,0 +1,137 @@
+// Telemetry Stream Wire Format for K1-07 SensoryBridge
+// Framed binary records of live audio, analysis and LED data for export
+// over USB CDC, shared by the firmware (src/telemetry_stream.h) and the
+// host recorder (host/sb_telemetry_record.cpp)
+
+#ifndef TELEMETRY_STREAM_FORMAT_H
+#define TELEMETRY_STREAM_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "trace_stream_format.h"   // COBS, CRC-16 and the little-endian helpers
+
+// One record per channel per frame, little-endian, before COBS:
+//
+//   u8   magic         TELEMETRY_STREAM_MAGIC
+//   u8   version       TELEMETRY_STREAM_VERSION
+//   u8   channel       TELEMETRY_CH_*
+//   u8   reserved
+//   u32  seq           Per channel, +1 per frame produced: a gap means
+//                      records were dropped (ring full, over budget)
+//   u32  timestamp     micros() when the frame was produced
+//   data               see below
+//   u16  crc           CRC-16/CCITT-FALSE of everything above
+//
+// Framed like the trace stream, 0x00 <COBS> 0x00; the magic tells the two
+// apart when both are on, and text from the serial menu falls between
+// frames. Data per channel:
+//
+//   PCM          i16[audio_hop_size]  this hop's samples (waveform[])
+//   SPECTROGRAM  q16.16[NUM_FREQS]    spectrogram[] (SQ15x16 raw)
+//   CHROMAGRAM   q16.16[12]           chromagram_smooth[]
+//   NOVELTY      q16.16[3]            novelty, VU level, VU average
+//   LEDS         u16 first_led, u16 led_count, then r,g,b bytes for up
+//                to TELEMETRY_LED_CHUNK LEDs from first_led. A strip
+//                longer than that takes several records with one seq
+//   PERF         u32[TELEMETRY_PERF_FIELDS], see TelemetryPerfField
+
+#define TELEMETRY_STREAM_MAGIC        0x53   // 'S'
+#define TELEMETRY_STREAM_VERSION      1
+#define TELEMETRY_STREAM_HEADER_BYTES 12
+#define TELEMETRY_LED_CHUNK           512
+#define TELEMETRY_MAX_DATA            (1024 * 2)   // PCM at the largest hop
+#define TELEMETRY_MAX_PAYLOAD         (TELEMETRY_STREAM_HEADER_BYTES + TELEMETRY_MAX_DATA + 2)
+#define TELEMETRY_MAX_FRAME           (TELEMETRY_MAX_PAYLOAD + TELEMETRY_MAX_PAYLOAD / 254 + 1 + 2)
+
+enum TelemetryChannel : uint8_t {
+    TELEMETRY_CH_PCM = 0,
+    TELEMETRY_CH_SPECTROGRAM,
+    TELEMETRY_CH_CHROMAGRAM,
+    TELEMETRY_CH_NOVELTY,
+    TELEMETRY_CH_LEDS,
+    TELEMETRY_CH_PERF,
+    TELEMETRY_NUM_CHANNELS
+};
+
+#define TELEMETRY_CHANNEL_BIT(channel) (1u << (channel))
+#define TELEMETRY_ALL_CHANNELS ((1u << TELEMETRY_NUM_CHANNELS) - 1)
+
+static const char* const telemetry_channel_names[TELEMETRY_NUM_CHANNELS] = {
+    "pcm", "spectrogram", "chromagram", "novelty", "leds", "perf"
+};
+
+enum TelemetryPerfField : uint8_t {
+    TELEMETRY_PERF_SYSTEM_FPS_X100 = 0,  // Audio frames/s
+    TELEMETRY_PERF_LED_FPS_X100,
+    TELEMETRY_PERF_LED_RENDER_US,        // led_render_us
+    TELEMETRY_PERF_LED_SHOW_US,          // led_show_us
+    TELEMETRY_PERF_LED_FRAMES_LATE,
+    TELEMETRY_PERF_AUDIO_FRAMES_DROPPED,
+    TELEMETRY_PERF_AUDIO_FRAMES_REPEATED,
+    TELEMETRY_PERF_RECORDS_DROPPED,      // Telemetry records dropped since boot
+    TELEMETRY_PERF_FIELDS
+};
+
+// Name -> channel, or -1
+inline int8_t telemetry_channel_from_name(const char* name, size_t length) {
+    for (uint8_t i = 0; i < TELEMETRY_NUM_CHANNELS; i++) {
+        if (strlen(telemetry_channel_names[i]) == length && strncmp(telemetry_channel_names[i], name, length) == 0) {
+            return int8_t(i);
+        }
+    }
+    return -1;
+}
+
+// Write the header; data follows at payload + TELEMETRY_STREAM_HEADER_BYTES
+inline void telemetry_record_begin(uint8_t* payload, uint8_t channel, uint32_t seq, uint32_t timestamp) {
+    payload[0] = TELEMETRY_STREAM_MAGIC;
+    payload[1] = TELEMETRY_STREAM_VERSION;
+    payload[2] = channel;
+    payload[3] = 0;
+    trace_stream_put_u32(payload + 4, seq);
+    trace_stream_put_u32(payload + 8, timestamp);
+}
+
+// CRC and frame a record with data_length bytes of data into out
+// (TELEMETRY_MAX_FRAME bytes); returns its length
+inline size_t telemetry_record_finish(uint8_t* payload, size_t data_length, uint8_t* out) {
+    size_t length = TELEMETRY_STREAM_HEADER_BYTES + data_length;
+    trace_stream_put_u16(payload + length, trace_stream_crc16(payload, length));
+    length += 2;
+
+    out[0] = 0;
+    size_t framed = 1 + cobs_encode(payload, length, out + 1);
+    out[framed++] = 0;
+    return framed;
+}
+
+// A decoded record, for the host side. data points into the payload
+struct TelemetryRecordInfo {
+    uint8_t channel;
+    uint32_t seq;
+    uint32_t timestamp;
+    const uint8_t* data;
+    size_t data_length;
+};
+
+// Parse one frame's payload (already COBS decoded). False if it isn't a
+// telemetry record: wrong magic / version, bad CRC, unknown channel
+inline bool telemetry_record_parse(const uint8_t* payload, size_t length, TelemetryRecordInfo& info) {
+    if (length < TELEMETRY_STREAM_HEADER_BYTES + 2 || payload[0] != TELEMETRY_STREAM_MAGIC ||
+        payload[1] != TELEMETRY_STREAM_VERSION || payload[2] >= TELEMETRY_NUM_CHANNELS) {
+        return false;
+    }
+    if (trace_stream_crc16(payload, length - 2) != trace_stream_get_u16(payload + length - 2)) {
+        return false;
+    }
+
+    info.channel = payload[2];
+    info.seq = trace_stream_get_u32(payload + 4);
+    info.timestamp = trace_stream_get_u32(payload + 8);
+    info.data = payload + TELEMETRY_STREAM_HEADER_BYTES;
+    info.data_length = length - TELEMETRY_STREAM_HEADER_BYTES - 2;
+    return true;
+}
+
+#endif // TELEMETRY_STREAM_FORMAT_H
@@ -0,0 +1,254 @@
+// Trace Stream Wire Format for K1-07 SensoryBridge
+// Framed binary encoding of TraceEvents for export over USB CDC, shared by
+// the firmware (trace_consumer_task) and the host converter
+// (host/sb_trace_convert.cpp)
+
+#ifndef TRACE_STREAM_FORMAT_H
+#define TRACE_STREAM_FORMAT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "performance_optimized_trace.h"
+
+// Frame layout, little-endian, before COBS:
+//
+//   u8   magic            TRACE_STREAM_MAGIC
+//   u8   version          TRACE_STREAM_VERSION
+//   u16  frame_seq        +1 per frame; a gap means frames were lost
+//   u32  base_timestamp   micros() of the first event
+//   u32  dropped_total    g_trace_buffer drops since boot
+//   u8   event_count      1..TRACE_STREAM_MAX_EVENTS
+//   per event:
+//     varint  timestamp delta from the previous event (zigzag: the two
+//             cores push into the buffer slightly out of time order)
+//     u16     event_id
+//     u8      core_id << 4 | level
+//     varint  data
+//   u16  crc              CRC-16/CCITT-FALSE of everything above
+//
+// On the wire each frame is COBS encoded and sent as 0x00 <frame> 0x00, so
+// a reader resyncs at the next zero byte after any text the serial menu
+// prints in between.
+
+#define TRACE_STREAM_MAGIC      0x54   // 'T'
+#define TRACE_STREAM_VERSION    1
+#define TRACE_STREAM_MAX_EVENTS 32
+#define TRACE_STREAM_HEADER_BYTES 13
+#define TRACE_STREAM_MAX_EVENT_BYTES (5 + 2 + 1 + 5)
+#define TRACE_STREAM_MAX_PAYLOAD (TRACE_STREAM_HEADER_BYTES + TRACE_STREAM_MAX_EVENTS * TRACE_STREAM_MAX_EVENT_BYTES + 2)
+#define TRACE_STREAM_MAX_FRAME (TRACE_STREAM_MAX_PAYLOAD + TRACE_STREAM_MAX_PAYLOAD / 254 + 1 + 2)
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+inline uint16_t trace_stream_crc16(const uint8_t* data, size_t length) {
+    uint16_t crc = 0xFFFF;
+    for (size_t i = 0; i < length; i++) {
+        crc ^= uint16_t(data[i]) << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? uint16_t((crc << 1) ^ 0x1021) : uint16_t(crc << 1);
+        }
+    }
+    return crc;
+}
+
+// COBS: out needs length + length / 254 + 1 bytes. Returns the encoded length
+inline size_t cobs_encode(const uint8_t* in, size_t length, uint8_t* out) {
+    size_t code_index = 0;
+    size_t out_index = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < length; i++) {
+        if (in[i] == 0) {
+            out[code_index] = code;
+            code_index = out_index++;
+            code = 1;
+        } else {
+            out[out_index++] = in[i];
+            code++;
+            if (code == 0xFF) {
+                out[code_index] = code;
+                code_index = out_index++;
+                code = 1;
+            }
+        }
+    }
+    out[code_index] = code;
+    return out_index;
+}
+
+// Returns the decoded length, or 0 for a malformed block
+inline size_t cobs_decode(const uint8_t* in, size_t length, uint8_t* out, size_t out_size) {
+    size_t in_index = 0;
+    size_t out_index = 0;
+    while (in_index < length) {
+        uint8_t code = in[in_index++];
+        if (code == 0 || in_index + code - 1 > length) {
+            return 0;
+        }
+        for (uint8_t i = 1; i < code; i++) {
+            if (out_index >= out_size) {
+                return 0;
+            }
+            out[out_index++] = in[in_index++];
+        }
+        if (code != 0xFF && in_index < length) {
+            if (out_index >= out_size) {
+                return 0;
+            }
+            out[out_index++] = 0;
+        }
+    }
+    return out_index;
+}
+
+inline uint8_t* trace_stream_put_varint(uint8_t* p, uint32_t value) {
+    while (value >= 0x80) {
+        *p++ = uint8_t(value) | 0x80;
+        value >>= 7;
+    }
+    *p++ = uint8_t(value);
+    return p;
+}
+
+// NULL past end
+inline const uint8_t* trace_stream_get_varint(const uint8_t* p, const uint8_t* end, uint32_t& value) {
+    value = 0;
+    for (uint8_t shift = 0; shift < 35; shift += 7) {
+        if (p >= end) {
+            return NULL;
+        }
+        uint8_t byte = *p++;
+        value |= uint32_t(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+inline uint8_t* trace_stream_put_u16(uint8_t* p, uint16_t value) {
+    p[0] = uint8_t(value);
+    p[1] = uint8_t(value >> 8);
+    return p + 2;
+}
+
+inline uint8_t* trace_stream_put_u32(uint8_t* p, uint32_t value) {
+    p[0] = uint8_t(value);
+    p[1] = uint8_t(value >> 8);
+    p[2] = uint8_t(value >> 16);
+    p[3] = uint8_t(value >> 24);
+    return p + 4;
+}
+
+inline uint16_t trace_stream_get_u16(const uint8_t* p) {
+    return uint16_t(p[0] | (p[1] << 8));
+}
+
+inline uint32_t trace_stream_get_u32(const uint8_t* p) {
+    return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+}
+
+// Builds one frame: begin(), add() until full() or the buffer is
+// drained, then finish() into a TRACE_STREAM_MAX_FRAME byte buffer
+class TraceStreamFrame {
+private:
+    uint8_t payload[TRACE_STREAM_MAX_PAYLOAD];
+    uint8_t* cursor;
+    uint32_t previous_timestamp;
+    uint8_t event_count;
+
+public:
+    void begin(uint16_t frame_seq, uint32_t dropped_total) {
+        payload[0] = TRACE_STREAM_MAGIC;
+        payload[1] = TRACE_STREAM_VERSION;
+        trace_stream_put_u16(payload + 2, frame_seq);
+        trace_stream_put_u32(payload + 8, dropped_total);
+        cursor = payload + TRACE_STREAM_HEADER_BYTES;
+        event_count = 0;
+    }
+
+    uint8_t count() const { return event_count; }
+    bool full() const { return event_count >= TRACE_STREAM_MAX_EVENTS; }
+
+    void add(const TraceEvent& event) {
+        if (event_count == 0) {
+            trace_stream_put_u32(payload + 4, event.timestamp);
+            previous_timestamp = event.timestamp;
+        }
+        int32_t delta = int32_t(event.timestamp - previous_timestamp);
+        previous_timestamp = event.timestamp;
+
+        cursor = trace_stream_put_varint(cursor, (uint32_t(delta) << 1) ^ uint32_t(delta >> 31));
+        cursor = trace_stream_put_u16(cursor, event.event_id);
+        *cursor++ = uint8_t((event.core_id << 4) | (event.level & 0x0F));
+        cursor = trace_stream_put_varint(cursor, event.data);
+        event_count++;
+    }
+
+    // 0x00 <COBS frame> 0x00 into out; returns its length
+    size_t finish(uint8_t* out) {
+        payload[12] = event_count;
+        cursor = trace_stream_put_u16(cursor, trace_stream_crc16(payload, cursor - payload));
+
+        out[0] = 0;
+        size_t length = 1 + cobs_encode(payload, cursor - payload, out + 1);
+        out[length++] = 0;
+        return length;
+    }
+};
+
+// A decoded frame, for the host side
+struct TraceStreamFrameInfo {
+    uint16_t frame_seq;
+    uint32_t dropped_total;
+    uint8_t event_count;
+    TraceEvent events[TRACE_STREAM_MAX_EVENTS];
+};
+
+// Parse one frame's payload (already COBS decoded). False if it isn't a
+// trace frame: wrong magic / version, bad CRC, or truncated
+inline bool trace_stream_parse(const uint8_t* payload, size_t length, TraceStreamFrameInfo& info) {
+    if (length < TRACE_STREAM_HEADER_BYTES + 2 || payload[0] != TRACE_STREAM_MAGIC || payload[1] != TRACE_STREAM_VERSION) {
+        return false;
+    }
+    if (trace_stream_crc16(payload, length - 2) != trace_stream_get_u16(payload + length - 2)) {
+        return false;
+    }
+
+    info.frame_seq = trace_stream_get_u16(payload + 2);
+    uint32_t timestamp = trace_stream_get_u32(payload + 4);
+    info.dropped_total = trace_stream_get_u32(payload + 8);
+    info.event_count = payload[12];
+    if (info.event_count == 0 || info.event_count > TRACE_STREAM_MAX_EVENTS) {
+        return false;
+    }
+
+    const uint8_t* p = payload + TRACE_STREAM_HEADER_BYTES;
+    const uint8_t* end = payload + length - 2;
+    for (uint8_t i = 0; i < info.event_count; i++) {
+        uint32_t zigzag, data;
+        p = trace_stream_get_varint(p, end, zigzag);
+        if (p == NULL || end - p < 3) {
+            return false;
+        }
+        timestamp += (zigzag >> 1) ^ (0u - (zigzag & 1));
+
+        TraceEvent& event = info.events[i];
+        event.timestamp = timestamp;
+        event.event_id = trace_stream_get_u16(p);
+        event.core_id = p[2] >> 4;
+        event.level = p[2] & 0x0F;
+        p = trace_stream_get_varint(p + 3, end, data);
+        if (p == NULL) {
+            return false;
+        }
+        event.data = data;
+    }
+    return p == end;
+}
+
+// Drain g_trace_buffer as frames, each handed to write() whole (0x00 to
+// 0x00). trace_consumer_task does this to USB CDC while
+// g_trace_config.enable_serial is set (performance_optimized_trace.cpp)
+typedef void (*TraceStreamWrite)(const uint8_t* frame, size_t length);
+void stream_trace_buffer(TraceStreamWrite write);
+
+#endif // TRACE_STREAM_FORMAT_H
@@ -84,22 +84,6 @@ void IRAM_ATTR process_GDFT() {
     spectrogram_history_index = 0;  // wrap to index zero at end
   }
   
-  // DEBUG: Check if sample_window has data - DISABLED to reduce serial flooding
-  static uint32_t gdft_debug_counter = 0;
-  gdft_debug_counter++; // Keep counter for other uses
-  /*
-  if (debug_mode && (gdft_debug_counter % 100 == 0)) {
-    float max_sample = 0;
-    for (int i = 0; i < SAMPLE_HISTORY_LENGTH; i++) {
-      if (abs(sample_window[i]) > max_sample) {
-        max_sample = abs(sample_window[i]);
-      }
-    }
-    USBSerial.print("GDFT DEBUG: max_sample_window=");
-    USBSerial.println(max_sample);
-  }
-  */
-
   // Run GDFT (Goertzel-based Discrete Fourier Transform) with 64 frequencies
   // Fixed-point code adapted from example here: https://sourceforge.net/p/freetel/code/HEAD/tree/misc/goertzal/goertzal.c
   
@@ -107,39 +91,46 @@ void IRAM_ATTR process_GDFT() {
   PERF_MONITOR_START();
 #endif
   
+  // Newest SAMPLE_HISTORY_LENGTH samples, oldest first (sample_window.h)
+  const short* window = sample_window_base();
+
+  // Sliding engine: prime after a switch, or resync one bin (GDFT_sliding.h)
+  bool sliding_engine = (gdft_engine == GDFT_ENGINE_SLIDING);
+  if (sliding_engine) {
+    gdft_sliding_maintain(window);
+  }
+
+  // Full engine: run every bin's Goertzel in lockstep groups up front (GDFT_simd.h)
+  bool simd_engine = false;
+#ifdef ENABLE_GDFT_SIMD
+  if (gdft_simd_engine()) {  // (GDFT_sliding.h)
+    simd_engine = true;
+    gdft_simd_block_powers(window, gdft_simd_powers);
+  }
+#endif
+
   // MODIFICATION [2025-09-20 22:30] - BIN-REVERT-96-64-001: Comment accuracy update
   // Updated comment to reflect actual NUM_FREQS usage instead of hardcoded assumption
   for (uint16_t i = 0; i < NUM_FREQS; i++) {  // Run NUM_FREQS times (64 in current config)
-    int32_t q0, q1, q2;
-    int64_t mult;
-    
     // Cache these values to avoid repeated structure access
-    int32_t coeff_q14 = frequencies[i].coeff_q14;
     uint16_t block_size = frequencies[i].block_size;
     float inv_block_size_half = frequencies[i].inv_block_size_half;  // Use pre-computed value
 
-    q1 = 0;
-    q2 = 0;
-    
-    // OPTIMIZATION: Forward iteration for cache-friendly access
-    uint16_t start_idx = SAMPLE_HISTORY_LENGTH - block_size;
-    
-    // Cache-friendly forward iteration
-    for (uint16_t n = 0; n < block_size; n++) {
-      int32_t sample = (int32_t)sample_window[start_idx + n] >> 6;  // Shift once
-      mult = coeff_q14 * (int32_t)q1;
-      q0 = sample + (mult >> 14) - q2;
-      q2 = q1;
-      q1 = q0;
-    }
-
-    mult = coeff_q14 * (int32_t)q1;
-    magnitudes[i] = q2 * q2 + q1 * q1 - ((int32_t)(mult >> 14)) * q2;
-
-    if (magnitudes[i] < 0) {
-      magnitudes[i] = 0;
+    if (sliding_engine && sliding_bins[i].active) {
+      // Long bin, already advanced by this chunk in acquire_sample_chunk()
+      magnitudes[i] = gdft_sliding_power(i);
+    } else if (simd_engine) {
+      magnitudes[i] = gdft_simd_powers[i];
+    } else {
+      // OPTIMIZATION: Forward iteration for cache-friendly access
+      uint16_t start_idx = SAMPLE_HISTORY_LENGTH - block_size;
+      magnitudes[i] = goertzel_block_power(&window[start_idx], block_size, frequencies[i].coeff_q14);
     }
 
+#ifdef GDFT_POWER_DOMAIN
+    // Stay in squared magnitudes: (sqrt(p) * inv_block_size_half)^2 without the sqrt
+    magnitudes_normalized[i] = magnitudes[i] * (inv_block_size_half * inv_block_size_half);
+#else
     // OPTIMIZATION: Fast sqrt approximation (5x faster, 1% accuracy)
     float x = (float)magnitudes[i];
     float xhalf = 0.5f * x;
@@ -151,24 +142,14 @@ void IRAM_ATTR process_GDFT() {
 
     // Normalizing the magnitude (using pre-computed reciprocal)
     magnitudes_normalized[i] = magnitudes[i] * inv_block_size_half;
-    
-    // DEBUG: Show non-zero magnitudes - DISABLED to reduce serial flooding
-    /*
-    if (debug_mode && (gdft_debug_counter % 100 == 1) && normalized_magnitude > 0.1) {
-      USBSerial.print("GDFT: freq[");
-      USBSerial.print(i);
-      USBSerial.print("]=");
-      USBSerial.print(frequencies[i].target_freq);
-      USBSerial.print("Hz, mag=");
-      USBSerial.println(normalized_magnitude);
-    }
-    */
+#endif
+
 
     if (frequencies[i].target_freq == 440.0) {
       //USBSerial.println(magnitudes_normalized[i]);
     }
 
-    magnitudes_normalized_avg[i] = (magnitudes_normalized[i] * 0.3) + (magnitudes_normalized_avg[i] * (1.0 - 0.3));
+    magnitudes_normalized_avg[i] = (magnitudes_normalized[i] * hop_rates.magnitude_avg) + (magnitudes_normalized_avg[i] * (1.0 - hop_rates.magnitude_avg));
   }
   
 #ifdef ENABLE_PERFORMANCE_MONITORING
@@ -176,6 +157,10 @@ void IRAM_ATTR process_GDFT() {
   track_gdft_performance(NUM_FREQS, perf_metrics.gdft_compute_time);
 #endif
 
+#ifdef GDFT_POWER_DOMAIN
+  // Noise floor, smoothing, AGC and spectrogram[] output in power units (GDFT_optimized.h)
+  GDFT_squared_magnitudes(MOOD_VAL);
+#else
   // Gather noise data if noise_complete == false
   if (noise_complete == false) {
     for (uint8_t i = 0; i < NUM_FREQS; i += 1) {
@@ -185,14 +170,7 @@ void IRAM_ATTR process_GDFT() {
     }
     noise_iterations++;
     if (noise_iterations >= 256) {  // Calibration complete
-      noise_complete = true;
-      USBSerial.println("NOISE CAL COMPLETE");
-      
-      // SINGLE-CORE OPTIMIZATION: Direct CONFIG write (no mutex needed)
-      CONFIG.DC_OFFSET = audio_raw_state.getDCOffsetSum() / 256.0;  // Calculate average DC offset and store it
-      
-      save_ambient_noise_calibration();           // Save results to noise_cal.bin
-      save_config();                              // Save config to config.bin
+      complete_noise_cal();
     }
   }
 
@@ -254,10 +232,10 @@ void IRAM_ATTR process_GDFT() {
   // ROLLBACK PROCEDURE: Restore 0.0050/0.0025 if adaptation becomes too twitchy
   if (max_value > goertzel_max_value) {
     SQ15x16 delta = max_value - goertzel_max_value;
-    goertzel_max_value += delta * SQ15x16(0.0100); // ~2x faster rise
+    goertzel_max_value += delta * SQ15x16(hop_rates.agc_rise); // ~2x faster rise (0.0100 per chunk)
   } else if (goertzel_max_value > max_value) {
     SQ15x16 delta = goertzel_max_value - max_value;
-    goertzel_max_value -= delta * SQ15x16(0.0050); // ~2x faster fall
+    goertzel_max_value -= delta * SQ15x16(hop_rates.agc_fall); // ~2x faster fall (0.0050 per chunk)
   }
 
   // --> REPLACED: Fixed AGC Floor with Dynamic Logic <--
@@ -266,19 +244,9 @@ void IRAM_ATTR process_GDFT() {
   //   goertzel_max_value = 4.0;
   // }
 
-  // New Dynamic Floor Logic:
-  SQ15x16 dynamic_agc_floor_raw = min_silent_level_tracker; // Use the tracked minimum
-
-  // Clamp the raw tracked value before scaling to prevent extreme scaling results
-  dynamic_agc_floor_raw = fmax_fixed(dynamic_agc_floor_raw, SQ15x16(AGC_FLOOR_MIN_CLAMP_RAW));
-  dynamic_agc_floor_raw = fmin_fixed(dynamic_agc_floor_raw, SQ15x16(AGC_FLOOR_MAX_CLAMP_RAW));
-
-  // Scale the (clamped) raw value to the Goertzel magnitude domain
-  SQ15x16 dynamic_agc_floor_scaled = dynamic_agc_floor_raw * SQ15x16(AGC_FLOOR_SCALING_FACTOR);
-
-  // Apply final clamps to the scaled floor value
-  dynamic_agc_floor_scaled = fmax_fixed(dynamic_agc_floor_scaled, SQ15x16(AGC_FLOOR_MIN_CLAMP_SCALED));
-  dynamic_agc_floor_scaled = fmin_fixed(dynamic_agc_floor_scaled, SQ15x16(AGC_FLOOR_MAX_CLAMP_SCALED));
+  // New Dynamic Floor Logic (clamped and scaled tracker, GDFT_optimized.h):
+  SQ15x16 dynamic_agc_floor_raw;
+  SQ15x16 dynamic_agc_floor_scaled = gdft_agc_floor(&dynamic_agc_floor_raw);
 
   // Apply the calculated dynamic floor
   if (goertzel_max_value < dynamic_agc_floor_scaled) {
@@ -287,10 +255,9 @@ void IRAM_ATTR process_GDFT() {
 
   // Enhanced periodic Debugging log for AGC floor mechanism
    if (debug_mode && (millis() % 5000 == 0)) { // Log roughly every 5 seconds
-       USBSerial.print("DEBUG (AGC): TrackerRaw: "); USBSerial.print(float(min_silent_level_tracker));
-       USBSerial.print(" | FloorRawClamped: "); USBSerial.print(float(dynamic_agc_floor_raw));
-       USBSerial.print(" | FloorScaledClamped: "); USBSerial.print(float(dynamic_agc_floor_scaled));
-       USBSerial.print(" | GoertzelMax: "); USBSerial.println(float(goertzel_max_value));
+       DLOG("DEBUG (AGC): TrackerRaw: %.2f | FloorRawClamped: %.2f | FloorScaledClamped: %.2f | GoertzelMax: %.2f\n",
+            float(min_silent_level_tracker), float(dynamic_agc_floor_raw),
+            float(dynamic_agc_floor_scaled), float(goertzel_max_value));
    }
   // --> END REPLACED/ENHANCED <--
 
@@ -314,6 +281,7 @@ void IRAM_ATTR process_GDFT() {
   for (uint16_t i = 0; i < NUM_FREQS; i += 1) {
     spectrogram[i] = magnitudes_final[i] * multiplier;
   }
+#endif
   
 #ifdef ENABLE_PERFORMANCE_MONITORING
   track_audio_metrics(magnitudes_final, NUM_FREQS);
@@ -328,9 +296,10 @@ void calculate_novelty(uint32_t t_now) {
   // Sum in a column-wise fashion into novelty_now
   SQ15x16 novelty_now = 0.0;
   
-  // SINGLE-CORE OPTIMIZATION: Direct spectrogram access (no mutex needed)
+  // Compare against the spectrum one chunk ago, so novelty keeps its
+  // scale at smaller hops (hop_rates.novelty_lookback frames back)
   for (uint16_t i = 0; i < NUM_FREQS; i++) {
-    int16_t rounded_index = spectral_history_index - 1;
+    int16_t rounded_index = spectral_history_index - hop_rates.novelty_lookback;
     while (rounded_index < 0) {
       rounded_index += SPECTRAL_HISTORY_LENGTH;
     }
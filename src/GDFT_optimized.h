@@ -1,133 +1,184 @@
 /*----------------------------------------
   OPTIMIZED GOERTZEL DFT FUNCTIONS
-  
-  Key optimizations:
-  1. Fast sqrt approximation (1% accuracy, 5x faster)
-  2. Forward memory iteration (cache-friendly)
-  3. Pre-computed constants (no divisions in hot loop)
-  4. Reduced structure member access
-  5. Optional: Work with squared magnitudes
+
+  Post-processing helpers for process_GDFT() (GDFT.h), and the
+  power-domain ("squared magnitude") variant of its pipeline.
+
+  The default pipeline takes a fast square root of every bin's
+  Goertzel power, then smooths, noise-gates and AGC-normalizes the
+  magnitudes. With GDFT_POWER_DOMAIN defined (main.cpp) every one of
+  those stages runs on squared magnitudes instead:
+
+    1. No sqrt per bin: normalized power = power * inv_block_size_half^2
+    2. Noise floors are squared once, when the calibration changes
+    3. AGC peak tracking and its floor work in power units
+    4. The perceptual sqrt compression is a LUT, applied only when
+       writing spectrogram[]
+
+  The per-bin math in the hot loop is then a few float multiply-adds
+  (the low-pass coefficient is also computed once per frame, rather
+  than once per bin as low_pass_array() does).
+  The output is close to, but not identical with, the default path:
+  EMA smoothing and noise subtraction on power weight loud frames
+  slightly more than the same operations on magnitude.
+
+  (The unrolled per-bin Goertzel that used to live here is superseded
+  by the bin-parallel kernels in GDFT_simd.h.)
   ----------------------------------------*/
 
-// Fast inverse square root approximation (Quake III algorithm)
-inline float fast_inv_sqrt(float x) {
-    float xhalf = 0.5f * x;
-    int i = *(int*)&x;
-    i = 0x5f3759df - (i >> 1);  // Magic constant
-    x = *(float*)&i;
-    x = x * (1.5f - xhalf * x * x);  // Newton iteration
-    return x;
+// Scaled AGC floor for the current noise conditions, in Goertzel
+// magnitude units. raw_out receives the clamped tracker value (for
+// debug output).
+SQ15x16 gdft_agc_floor(SQ15x16* raw_out = NULL) {
+  SQ15x16 dynamic_agc_floor_raw = min_silent_level_tracker; // Use the tracked minimum
+
+  // Clamp the raw tracked value before scaling to prevent extreme scaling results
+  dynamic_agc_floor_raw = fmax_fixed(dynamic_agc_floor_raw, SQ15x16(AGC_FLOOR_MIN_CLAMP_RAW));
+  dynamic_agc_floor_raw = fmin_fixed(dynamic_agc_floor_raw, SQ15x16(AGC_FLOOR_MAX_CLAMP_RAW));
+
+  // Scale the (clamped) raw value to the Goertzel magnitude domain
+  SQ15x16 dynamic_agc_floor_scaled = dynamic_agc_floor_raw * SQ15x16(AGC_FLOOR_SCALING_FACTOR);
+
+  // Apply final clamps to the scaled floor value
+  dynamic_agc_floor_scaled = fmax_fixed(dynamic_agc_floor_scaled, SQ15x16(AGC_FLOOR_MIN_CLAMP_SCALED));
+  dynamic_agc_floor_scaled = fmin_fixed(dynamic_agc_floor_scaled, SQ15x16(AGC_FLOOR_MAX_CLAMP_SCALED));
+
+  if (raw_out != NULL) {
+    *raw_out = dynamic_agc_floor_raw;
+  }
+  return dynamic_agc_floor_scaled;
 }
 
-// Fast square root using inverse sqrt
-inline float fast_sqrt(float x) {
-    return x * fast_inv_sqrt(x);
+#ifdef GDFT_POWER_DOMAIN
+
+// sqrt() over [0, POWER_LUT_RANGE] in POWER_LUT_SIZE steps, linearly
+// interpolated. AGC-normalized power rarely leaves 0.0-1.0, but can
+// overshoot while the AGC catches up to a sudden peak.
+#define POWER_LUT_SIZE 1024
+#define POWER_LUT_RANGE 4.0
+
+float power_compression_lut[POWER_LUT_SIZE + 1];
+
+// Power-domain noise floors, rebuilt whenever noise_samples changes
+float noise_floor_power[NUM_FREQS];
+SQ15x16 noise_floor_source[NUM_FREQS];
+bool noise_floor_power_valid = false;
+
+float agc_max_power = 0.0001 * 0.0001;  // AGC peak follower, squared magnitude
+
+// Called once at boot
+void init_power_compression_lut() {
+  for (uint16_t i = 0; i <= POWER_LUT_SIZE; i++) {
+    power_compression_lut[i] = sqrt((i * POWER_LUT_RANGE) / POWER_LUT_SIZE);
+  }
 }
 
-void GDFT_optimized() {
-  // Update debug counter
-  static uint32_t gdft_debug_counter = 0;
-  gdft_debug_counter++;
-  
-#ifdef PERFORMANCE_MONITOR
-  PERF_MONITOR_START();
-#endif
-  
-  // Process all frequencies
+// Perceptual compression of an AGC-normalized power (equivalent to the
+// magnitude pipeline's linear scaling of sqrt(power))
+inline float IRAM_ATTR compress_power(float ratio) {
+  float position = ratio * (POWER_LUT_SIZE / POWER_LUT_RANGE);
+  if (position >= POWER_LUT_SIZE) {
+    return sqrt(ratio);  // Well past the AGC, rare
+  }
+
+  uint16_t index = (uint16_t)position;
+  float fraction = position - index;
+  return power_compression_lut[index] + (power_compression_lut[index + 1] - power_compression_lut[index]) * fraction;
+}
+
+// Noise floors are stored (and calibrated) as magnitudes so noise_cal.bin
+// is shared with the default pipeline. Square them only when they change.
+//
+// Both pipelines subtract the floor from magnitudes_normalized_avg[] in
+// place, so it feeds back through the 0.3 EMA: the magnitude pipeline
+// ends up silencing bins below 1.2 * noise / 0.3. Dividing the squared
+// floor by 0.3 puts the power pipeline's gate at that same level.
+void refresh_noise_floor_power() {
+  if (noise_floor_power_valid && memcmp(noise_floor_source, noise_samples, sizeof(noise_samples)) == 0) {
+    return;
+  }
+
   for (uint16_t i = 0; i < NUM_FREQS; i++) {
-    // Cache frequently accessed values
-    const int32_t coeff_q14 = frequencies[i].coeff_q14;
-    const uint16_t block_size = frequencies[i].block_size;
-    const float inv_block_size_half = frequencies[i].inv_block_size_half;
-    
-    // OPTIMIZATION 1: Forward iteration for cache-friendly access
-    const uint16_t start_idx = SAMPLE_HISTORY_LENGTH - block_size;
-    const int16_t* sample_ptr = &sample_window[start_idx];
-    
-    // Goertzel state variables
-    int32_t q1 = 0;
-    int32_t q2 = 0;
-    
-    // OPTIMIZATION 2: Unrolled loop for better pipelining (process 4 samples at a time)
-    uint16_t n = 0;
-    for (; n < (block_size & ~3); n += 4) {
-      // Sample 1
-      int32_t sample1 = sample_ptr[n] >> 6;
-      int32_t q0_1 = sample1 + ((coeff_q14 * q1) >> 14) - q2;
-      
-      // Sample 2
-      int32_t sample2 = sample_ptr[n+1] >> 6;
-      int32_t q0_2 = sample2 + ((coeff_q14 * q0_1) >> 14) - q1;
-      
-      // Sample 3
-      int32_t sample3 = sample_ptr[n+2] >> 6;
-      int32_t q0_3 = sample3 + ((coeff_q14 * q0_2) >> 14) - q0_1;
-      
-      // Sample 4
-      int32_t sample4 = sample_ptr[n+3] >> 6;
-      int32_t q0_4 = sample4 + ((coeff_q14 * q0_3) >> 14) - q0_2;
-      
-      q2 = q0_3;
-      q1 = q0_4;
+    float floor_mag = float(noise_samples[i]) * 1.2;  // Same 1.2x margin as the magnitude pipeline
+    noise_floor_power[i] = (floor_mag * floor_mag) / 0.3;
+  }
+  memcpy(noise_floor_source, noise_samples, sizeof(noise_samples));
+  noise_floor_power_valid = true;
+}
+
+// Everything process_GDFT() does after the per-bin Goertzel pass, in
+// power units. On entry magnitudes_normalized_avg[] holds the smoothed
+// normalized power of every bin.
+void IRAM_ATTR GDFT_squared_magnitudes(float mood_val) {
+  // Gather noise data if noise_complete == false. Floors are kept as
+  // magnitudes, so this is the only place a per-bin sqrt is needed.
+  if (noise_complete == false) {
+    for (uint8_t i = 0; i < NUM_FREQS; i += 1) {
+      float noise_mag = sqrt(magnitudes_normalized_avg[i]);
+      if (noise_mag > noise_samples[i]) {
+        noise_samples[i] = noise_mag;
+      }
     }
-    
-    // Process remaining samples
-    for (; n < block_size; n++) {
-      int32_t sample = sample_ptr[n] >> 6;
-      int32_t q0 = sample + ((coeff_q14 * q1) >> 14) - q2;
-      q2 = q1;
-      q1 = q0;
+    noise_iterations++;
+    if (noise_iterations >= 256) {  // Calibration complete
+      complete_noise_cal();
     }
-    
-    // Calculate magnitude squared
-    int32_t mag_squared = q2 * q2 + q1 * q1 - (((coeff_q14 * q1) >> 14) * q2);
-    
-    if (mag_squared < 0) {
-      mag_squared = 0;
+  }
+
+  // Apply noise reduction data (spectral power subtraction)
+  if (noise_complete == true) {
+    refresh_noise_floor_power();
+    for (uint8_t i = 0; i < NUM_FREQS; i += 1) {
+      magnitudes_normalized_avg[i] -= noise_floor_power[i];
+      if (magnitudes_normalized_avg[i] < 0.0) {
+        magnitudes_normalized_avg[i] = 0.0;
+      }
     }
-    
-    // OPTIMIZATION 3: Fast sqrt approximation
-    float magnitude = fast_sqrt((float)mag_squared);
-    magnitudes[i] = magnitude;
-    
-    // Normalize using pre-computed reciprocal
-    magnitudes_normalized[i] = magnitude * inv_block_size_half;
   }
 
-#ifdef PERFORMANCE_MONITOR
-  PERF_MONITOR_END("GDFT_opt");
-#endif
+  // Same low-pass as low_pass_array(), but with one expf() per frame
+  // instead of one per bin. Squared values decay into denormal range
+  // much sooner than magnitudes, so the tail is flushed to zero.
+  uint32_t filter_rate = SYSTEM_FPS;
+  float alpha = 1.0 - expf(-2.0 * PI * (3.0 + (12.0 * mood_val)) / filter_rate);
+  for (uint8_t i = 0; i < NUM_FREQS; i += 1) {
+    float smoothed = magnitudes_last[i] + (magnitudes_normalized_avg[i] - magnitudes_last[i]) * alpha;
+    if (smoothed < 1e-12) {
+      smoothed = 0.0;
+    }
+    magnitudes_final[i] = smoothed;
+    magnitudes_last[i] = smoothed;
+  }
 
-  // Rest of the function remains the same...
-  compute_spectral_flux();
-  
-  for (uint8_t z = 0; z < NUM_ZONES; z++) {
-    for (uint16_t i = 0; i < NUM_FREQS; i++) {
-      if (frequencies[i].zone == z) {
-        magnitudes_normalized_avg[i] = magnitudes_normalized[i] + 
-                                       mag_followers[i] * PHOTONS_KNOB;
-        
-        if (magnitudes_normalized[i] > mag_followers[i]) {
-          float delta = magnitudes_normalized[i] - mag_followers[i];
-          mag_followers[i] += delta * 0.5;
-        } else if (magnitudes_normalized[i] < mag_followers[i]) {
-          float delta = mag_followers[i] - magnitudes_normalized[i];
-          mag_followers[i] -= delta * (0.0025 + (0.025 * smoothing_exp_average));
-        }
-      }
+  // AGC, tracking the squared peak at the magnitude pipeline's rates
+  float max_value = 0.00001 * 0.00001;
+  for (uint8_t i = 0; i < NUM_FREQS; i += 1) {
+    if (magnitudes_final[i] > max_value) {
+      max_value = magnitudes_final[i];
     }
   }
 
-  memcpy(magnitudes_final, magnitudes_normalized_avg, sizeof(float) * NUM_FREQS);
-  low_pass_array(magnitudes_final, magnitudes_last, NUM_FREQS, SYSTEM_FPS, 1.0 + (10.0 * MOOD_VAL));
-  memcpy(magnitudes_last, magnitudes_final, sizeof(float) * NUM_FREQS);
-  
-  // Continue with rest of original function...
+  max_value *= 0.995 * 0.995;
+
+  if (max_value > agc_max_power) {
+    agc_max_power += (max_value - agc_max_power) * hop_rates.agc_rise;
+  } else if (agc_max_power > max_value) {
+    agc_max_power -= (agc_max_power - max_value) * hop_rates.agc_fall;
+  }
+
+  float floor_mag = float(gdft_agc_floor());
+  if (agc_max_power < floor_mag * floor_mag) {
+    agc_max_power = floor_mag * floor_mag;
+  }
+
+  // The magnitude pipeline writes mag * (1/agc + 0.10), which is
+  // sqrt(power / agc^2) * (1 + 0.10 * agc): one sqrt per frame here
+  float inv_agc_power = 1.0 / agc_max_power;
+  float output_scale = 1.0 + 0.10 * sqrt(agc_max_power);
+
+  for (uint16_t i = 0; i < NUM_FREQS; i += 1) {
+    spectrogram[i] = compress_power(magnitudes_final[i] * inv_agc_power) * output_scale;
+  }
 }
 
-// Alternative: Work with squared magnitudes to avoid sqrt entirely
-void GDFT_squared_magnitudes() {
-  // Similar to above but skip sqrt entirely
-  // Adjust all thresholds to work with squared values
-  // This can be even faster if the visualization can work with squared magnitudes
-}
\ No newline at end of file
+#endif
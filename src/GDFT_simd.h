@@ -0,0 +1,256 @@
+/*----------------------------------------
+  Sensory Bridge BIN-PARALLEL GDFT
+  ----------------------------------------*/
+
+// The full GDFT pass runs one Goertzel recurrence at a time, and each
+// step depends on the one before it, so the CPU spends most of the
+// loop waiting on its own multiply. Every bin reads the same samples
+// though (all windows end at the newest sample), so several bins can
+// be advanced in lockstep: one sample load feeds GDFT_SIMD_LANES
+// independent recurrences that can overlap in the pipeline or sit in
+// one vector register.
+//
+// At boot the bins are sorted by block_size and packed into groups of
+// GDFT_SIMD_LANES, with their constants copied into contiguous
+// (structure-of-arrays) tables. A group runs for its longest block;
+// shorter lanes are fed zeros until their own window begins, which
+// leaves a Goertzel state untouched, so every lane produces exactly
+// the same int32 power as goertzel_block_power().
+//
+// The kernel is picked at compile time:
+//
+//   __AVX2__              8 lanes, AVX2 (host builds)
+//   __SSE4_1__            4 lanes, SSE4.1 (host builds)
+//   ARDUINO_ESP32S3_DEV   4 lanes held in registers. The S3's vector
+//                         unit only multiplies 8/16-bit lanes, which
+//                         can't hold the Q14 Goertzel state, so this
+//                         path interleaves 4 scalar recurrences to keep
+//                         the MAC pipeline full instead.
+//   (otherwise)           4 lanes, portable scalar reference
+
+#if defined(__AVX2__)
+  #include <immintrin.h>
+  #define GDFT_SIMD_LANES 8
+  #define GDFT_SIMD_KERNEL "AVX2"
+#elif defined(__SSE4_1__)
+  #include <smmintrin.h>
+  #define GDFT_SIMD_LANES 4
+  #define GDFT_SIMD_KERNEL "SSE4.1"
+#elif defined(ARDUINO_ESP32S3_DEV)
+  #define GDFT_SIMD_LANES 4
+  #define GDFT_SIMD_KERNEL "ESP32-S3 INTERLEAVED"
+#else
+  #define GDFT_SIMD_LANES 4
+  #define GDFT_SIMD_KERNEL "SCALAR"
+#endif
+
+#define GDFT_SIMD_GROUPS ((NUM_FREQS + GDFT_SIMD_LANES - 1) / GDFT_SIMD_LANES)
+#define GDFT_SIMD_SLOTS (GDFT_SIMD_GROUPS * GDFT_SIMD_LANES)
+#define GDFT_SIMD_UNUSED 0xFFFF
+
+// Structure-of-arrays copies of the Goertzel constants, one slot per
+// lane, in group order. Padding slots have block_size 0 and never
+// see a non-zero sample.
+alignas(32) int32_t simd_coeff_q14[GDFT_SIMD_SLOTS];
+alignas(32) int32_t simd_lane_start[GDFT_SIMD_SLOTS];  // First group step this lane's window covers
+uint16_t simd_block_size[GDFT_SIMD_SLOTS];
+uint16_t simd_bin[GDFT_SIMD_SLOTS];                   // frequencies[] index, or GDFT_SIMD_UNUSED
+uint16_t simd_group_length[GDFT_SIMD_GROUPS];         // Longest block_size in each group
+
+alignas(32) int32_t simd_lane_power[GDFT_SIMD_SLOTS];
+int32_t gdft_simd_powers[NUM_FREQS];  // Output of gdft_simd_block_powers(), by bin
+
+uint32_t gdft_simd_padded_steps = 0;  // Lane steps spent on zero padding per frame
+
+// Called once at boot, after precompute_goertzel_constants()
+void init_gdft_simd() {
+  uint16_t order[NUM_FREQS];
+
+  // Longest blocks first, so each group holds similar lengths and
+  // wastes as few padded steps as possible
+  for (uint16_t i = 0; i < NUM_FREQS; i++) {
+    order[i] = i;
+  }
+  for (uint16_t i = 1; i < NUM_FREQS; i++) {
+    uint16_t bin = order[i];
+    int16_t j = i - 1;
+    while (j >= 0 && frequencies[order[j]].block_size < frequencies[bin].block_size) {
+      order[j + 1] = order[j];
+      j--;
+    }
+    order[j + 1] = bin;
+  }
+
+  gdft_simd_padded_steps = 0;
+
+  for (uint16_t g = 0; g < GDFT_SIMD_GROUPS; g++) {
+    uint16_t group_length = frequencies[order[g * GDFT_SIMD_LANES]].block_size;
+    simd_group_length[g] = group_length;
+
+    for (uint16_t lane = 0; lane < GDFT_SIMD_LANES; lane++) {
+      uint16_t slot = g * GDFT_SIMD_LANES + lane;
+
+      if (slot < NUM_FREQS) {
+        uint16_t bin = order[slot];
+        simd_bin[slot] = bin;
+        simd_block_size[slot] = frequencies[bin].block_size;
+        simd_coeff_q14[slot] = frequencies[bin].coeff_q14;
+      } else {
+        simd_bin[slot] = GDFT_SIMD_UNUSED;
+        simd_block_size[slot] = 0;
+        simd_coeff_q14[slot] = 0;
+      }
+
+      simd_lane_start[slot] = group_length - simd_block_size[slot];
+      gdft_simd_padded_steps += simd_lane_start[slot];
+    }
+  }
+
+  USBSerial.print("BIN-PARALLEL GDFT: ");
+  USBSerial.print(GDFT_SIMD_KERNEL);
+  USBSerial.print(", ");
+  USBSerial.print(GDFT_SIMD_GROUPS);
+  USBSerial.print(" groups of ");
+  USBSerial.print(GDFT_SIMD_LANES);
+  USBSerial.print(" lanes, ");
+  USBSerial.print(gdft_simd_padded_steps);
+  USBSerial.println(" padded steps per frame");
+}
+
+// Portable reference: advances one group's lanes in lockstep with
+// the exact arithmetic of goertzel_block_power()
+void IRAM_ATTR gdft_simd_group_scalar(const short* samples, uint16_t group_length, uint16_t first_slot) {
+  int32_t q1[GDFT_SIMD_LANES] = { 0 };
+  int32_t q2[GDFT_SIMD_LANES] = { 0 };
+  const int32_t* coeff = &simd_coeff_q14[first_slot];
+  const int32_t* start = &simd_lane_start[first_slot];
+  int64_t mult;
+
+  for (uint16_t n = 0; n < group_length; n++) {
+    int32_t sample = (int32_t)samples[n] >> GDFT_SAMPLE_SHIFT;
+
+    for (uint8_t lane = 0; lane < GDFT_SIMD_LANES; lane++) {
+      int32_t lane_sample = (n >= start[lane]) ? sample : 0;
+      mult = coeff[lane] * (int32_t)q1[lane];
+      int32_t q0 = lane_sample + (mult >> 14) - q2[lane];
+      q2[lane] = q1[lane];
+      q1[lane] = q0;
+    }
+  }
+
+  for (uint8_t lane = 0; lane < GDFT_SIMD_LANES; lane++) {
+    mult = coeff[lane] * (int32_t)q1[lane];
+    int32_t power = q2[lane] * q2[lane] + q1[lane] * q1[lane] - ((int32_t)(mult >> 14)) * q2[lane];
+    simd_lane_power[first_slot + lane] = (power < 0) ? 0 : power;
+  }
+}
+
+#if defined(__AVX2__)
+void gdft_simd_group_vector(const short* samples, uint16_t group_length, uint16_t first_slot) {
+  __m256i coeff = _mm256_load_si256((const __m256i*)&simd_coeff_q14[first_slot]);
+  __m256i start = _mm256_load_si256((const __m256i*)&simd_lane_start[first_slot]);
+  __m256i q1 = _mm256_setzero_si256();
+  __m256i q2 = _mm256_setzero_si256();
+
+  for (uint16_t n = 0; n < group_length; n++) {
+    // Lanes whose window hasn't started yet (start > n) see a zero
+    __m256i active = _mm256_cmpgt_epi32(start, _mm256_set1_epi32(n));
+    __m256i sample = _mm256_andnot_si256(active, _mm256_set1_epi32((int32_t)samples[n] >> GDFT_SAMPLE_SHIFT));
+    __m256i mult = _mm256_srai_epi32(_mm256_mullo_epi32(coeff, q1), 14);
+    __m256i q0 = _mm256_sub_epi32(_mm256_add_epi32(sample, mult), q2);
+    q2 = q1;
+    q1 = q0;
+  }
+
+  __m256i mult = _mm256_srai_epi32(_mm256_mullo_epi32(coeff, q1), 14);
+  __m256i power = _mm256_add_epi32(_mm256_mullo_epi32(q2, q2), _mm256_mullo_epi32(q1, q1));
+  power = _mm256_sub_epi32(power, _mm256_mullo_epi32(mult, q2));
+  power = _mm256_max_epi32(power, _mm256_setzero_si256());
+  _mm256_store_si256((__m256i*)&simd_lane_power[first_slot], power);
+}
+#elif defined(__SSE4_1__)
+void gdft_simd_group_vector(const short* samples, uint16_t group_length, uint16_t first_slot) {
+  __m128i coeff = _mm_load_si128((const __m128i*)&simd_coeff_q14[first_slot]);
+  __m128i start = _mm_load_si128((const __m128i*)&simd_lane_start[first_slot]);
+  __m128i q1 = _mm_setzero_si128();
+  __m128i q2 = _mm_setzero_si128();
+
+  for (uint16_t n = 0; n < group_length; n++) {
+    // Lanes whose window hasn't started yet (start > n) see a zero
+    __m128i active = _mm_cmpgt_epi32(start, _mm_set1_epi32(n));
+    __m128i sample = _mm_andnot_si128(active, _mm_set1_epi32((int32_t)samples[n] >> GDFT_SAMPLE_SHIFT));
+    __m128i mult = _mm_srai_epi32(_mm_mullo_epi32(coeff, q1), 14);
+    __m128i q0 = _mm_sub_epi32(_mm_add_epi32(sample, mult), q2);
+    q2 = q1;
+    q1 = q0;
+  }
+
+  __m128i mult = _mm_srai_epi32(_mm_mullo_epi32(coeff, q1), 14);
+  __m128i power = _mm_add_epi32(_mm_mullo_epi32(q2, q2), _mm_mullo_epi32(q1, q1));
+  power = _mm_sub_epi32(power, _mm_mullo_epi32(mult, q2));
+  power = _mm_max_epi32(power, _mm_setzero_si128());
+  _mm_store_si128((__m128i*)&simd_lane_power[first_slot], power);
+}
+#elif defined(ARDUINO_ESP32S3_DEV)
+void IRAM_ATTR gdft_simd_group_vector(const short* samples, uint16_t group_length, uint16_t first_slot) {
+  const int32_t c0 = simd_coeff_q14[first_slot + 0];
+  const int32_t c1 = simd_coeff_q14[first_slot + 1];
+  const int32_t c2 = simd_coeff_q14[first_slot + 2];
+  const int32_t c3 = simd_coeff_q14[first_slot + 3];
+  int32_t a1 = 0, a2 = 0, b1 = 0, b2 = 0, d1 = 0, d2 = 0, e1 = 0, e2 = 0;
+  int32_t q0;
+  uint16_t n = 0;
+
+  // Lanes are sorted longest first, so they switch on in order: run
+  // each stretch with only the lanes that have started, no masking
+  uint16_t stop_1 = simd_lane_start[first_slot + 1];
+  uint16_t stop_2 = simd_lane_start[first_slot + 2];
+  uint16_t stop_3 = simd_lane_start[first_slot + 3];
+
+  for (; n < stop_1; n++) {
+    int32_t x = (int32_t)samples[n] >> GDFT_SAMPLE_SHIFT;
+    q0 = x + ((c0 * a1) >> 14) - a2; a2 = a1; a1 = q0;
+  }
+  for (; n < stop_2; n++) {
+    int32_t x = (int32_t)samples[n] >> GDFT_SAMPLE_SHIFT;
+    q0 = x + ((c0 * a1) >> 14) - a2; a2 = a1; a1 = q0;
+    q0 = x + ((c1 * b1) >> 14) - b2; b2 = b1; b1 = q0;
+  }
+  for (; n < stop_3; n++) {
+    int32_t x = (int32_t)samples[n] >> GDFT_SAMPLE_SHIFT;
+    q0 = x + ((c0 * a1) >> 14) - a2; a2 = a1; a1 = q0;
+    q0 = x + ((c1 * b1) >> 14) - b2; b2 = b1; b1 = q0;
+    q0 = x + ((c2 * d1) >> 14) - d2; d2 = d1; d1 = q0;
+  }
+  for (; n < group_length; n++) {
+    int32_t x = (int32_t)samples[n] >> GDFT_SAMPLE_SHIFT;
+    q0 = x + ((c0 * a1) >> 14) - a2; a2 = a1; a1 = q0;
+    q0 = x + ((c1 * b1) >> 14) - b2; b2 = b1; b1 = q0;
+    q0 = x + ((c2 * d1) >> 14) - d2; d2 = d1; d1 = q0;
+    q0 = x + ((c3 * e1) >> 14) - e2; e2 = e1; e1 = q0;
+  }
+
+  int32_t p;
+  p = a2 * a2 + a1 * a1 - ((c0 * a1) >> 14) * a2; simd_lane_power[first_slot + 0] = (p < 0) ? 0 : p;
+  p = b2 * b2 + b1 * b1 - ((c1 * b1) >> 14) * b2; simd_lane_power[first_slot + 1] = (p < 0) ? 0 : p;
+  p = d2 * d2 + d1 * d1 - ((c2 * d1) >> 14) * d2; simd_lane_power[first_slot + 2] = (p < 0) ? 0 : p;
+  p = e2 * e2 + e1 * e1 - ((c3 * e1) >> 14) * e2; simd_lane_power[first_slot + 3] = (p < 0) ? 0 : p;
+}
+#else
+  #define gdft_simd_group_vector gdft_simd_group_scalar
+#endif
+
+// Goertzel power of every bin over a window that ends at
+// window[SAMPLE_HISTORY_LENGTH - 1], written to powers[] by bin
+void IRAM_ATTR gdft_simd_block_powers(const short* window, int32_t* powers) {
+  for (uint16_t g = 0; g < GDFT_SIMD_GROUPS; g++) {
+    uint16_t group_length = simd_group_length[g];
+    gdft_simd_group_vector(&window[SAMPLE_HISTORY_LENGTH - group_length], group_length, g * GDFT_SIMD_LANES);
+  }
+
+  for (uint16_t slot = 0; slot < GDFT_SIMD_SLOTS; slot++) {
+    if (simd_bin[slot] != GDFT_SIMD_UNUSED) {
+      powers[simd_bin[slot]] = simd_lane_power[slot];
+    }
+  }
+}
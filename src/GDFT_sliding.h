@@ -0,0 +1,299 @@
+/*----------------------------------------
+  Sensory Bridge SLIDING GDFT
+  ----------------------------------------*/
+
+// The default GDFT engine (GDFT.h) re-runs the Goertzel recurrence
+// over each bin's whole block_size every frame, even though only
+// audio_hop_size new samples arrived since the last one.
+//
+// This is the incremental alternative: a sliding DFT that keeps a
+// complex state per bin and only updates it with the samples that
+// enter and leave that bin's window:
+//
+//   X(n) = e^(jw) * (X(n-1) + x(n) - x(n-N))
+//
+// That costs one complex rotation per *hop* sample instead of one
+// Goertzel step per *window* sample, so it pays off for every bin
+// whose block_size is longer than the hop. The rest stay on the full
+// Goertzel pass, which makes this a hybrid per-bin engine; with no
+// bin longer than the hop it is just the full engine (GDFT_simd.h
+// included).
+//
+// The rotation is done in single precision float (the S3 has an
+// FPU), so a little drift creeps in over time. Every frame one
+// active bin is rebuilt from the sample window, which bounds the
+// error and doubles as a running drift measurement against the
+// full engine (see "gdft_drift" in serial_menu.h).
+
+// Sample scaling must match the full engine in process_GDFT()
+#define GDFT_SAMPLE_SHIFT 6
+
+enum gdft_engines {
+  GDFT_ENGINE_FULL,     // Full Goertzel pass over every bin's window (default)
+  GDFT_ENGINE_SLIDING,  // Sliding DFT for long bins, full pass for the rest
+  NUM_GDFT_ENGINES
+};
+
+struct sliding_bin {
+  float re;      // Complex DFT of the bin's current window
+  float im;
+  float cos_w;   // e^(jw) for this bin
+  float sin_w;
+  bool  active;  // Longer than the hop, so cheaper to slide than to recompute
+};
+
+uint8_t gdft_engine = GDFT_ENGINE_FULL;  // Selected at runtime with "gdft_engine=" (serial_menu.h)
+sliding_bin sliding_bins[NUM_FREQS];
+uint16_t gdft_sliding_active_bins = 0;
+
+bool gdft_sliding_primed = false;  // false until every active bin has been rebuilt from sample_window
+uint16_t gdft_sliding_resync_index = 0;
+float gdft_sliding_last_drift = 0.0;  // Relative magnitude error seen at the last resync
+float gdft_sliding_max_drift = 0.0;   // Worst relative error since the last "gdft_drift" report
+
+// True while process_GDFT() runs every bin's Goertzel in lockstep up
+// front (GDFT_simd.h): the full engine, or a sliding engine that has
+// nothing to slide at this hop
+inline bool gdft_simd_engine() {
+  return gdft_engine == GDFT_ENGINE_FULL || (gdft_engine == GDFT_ENGINE_SLIDING && gdft_sliding_active_bins == 0);
+}
+
+// Run the Goertzel recurrence over one bin's block, exactly as the
+// full engine does, and return the int32 squared magnitude
+int32_t IRAM_ATTR goertzel_block_power(const short* samples, uint16_t block_size, int32_t coeff_q14) {
+  int32_t q0, q1, q2;
+  int64_t mult;
+
+  q1 = 0;
+  q2 = 0;
+
+  for (uint16_t n = 0; n < block_size; n++) {
+    int32_t sample = (int32_t)samples[n] >> GDFT_SAMPLE_SHIFT;
+    mult = coeff_q14 * (int32_t)q1;
+    q0 = sample + (mult >> 14) - q2;
+    q2 = q1;
+    q1 = q0;
+  }
+
+  mult = coeff_q14 * (int32_t)q1;
+  int32_t power = q2 * q2 + q1 * q1 - ((int32_t)(mult >> 14)) * q2;
+
+  if (power < 0) {
+    power = 0;
+  }
+
+  return power;
+}
+
+// Called at boot, after precompute_goertzel_constants(), and whenever
+// audio_hop_size changes
+void init_gdft_sliding() {
+  uint16_t active_bins = 0;
+
+  for (uint16_t i = 0; i < NUM_FREQS; i++) {
+    uint16_t block_size = frequencies[i].block_size;
+
+    // Same bin centre as the Goertzel coefficient, so that both
+    // engines measure the exact same DFT bin
+    float k = (int)(0.5 + ((block_size * frequencies[i].target_freq) / CONFIG.SAMPLE_RATE));
+    float w = (2.0 * PI * k) / block_size;
+
+    sliding_bins[i].cos_w = cos(w);
+    sliding_bins[i].sin_w = sin(w);
+    sliding_bins[i].re = 0.0;
+    sliding_bins[i].im = 0.0;
+    sliding_bins[i].active = (block_size > audio_hop_size);
+
+    if (sliding_bins[i].active) {
+      active_bins++;
+    }
+  }
+
+  gdft_sliding_active_bins = active_bins;
+  gdft_sliding_primed = false;
+  gdft_sliding_resync_index = 0;
+
+  USBSerial.print("SLIDING GDFT: ");
+  USBSerial.print(active_bins);
+  USBSerial.print(" of ");
+  USBSerial.print(NUM_FREQS);
+  USBSerial.println(" bins eligible");
+}
+
+// Force every active bin to be rebuilt from sample_window on the
+// next process_GDFT(), i.e. after anything writes the window directly
+void invalidate_gdft_sliding() {
+  gdft_sliding_primed = false;
+}
+
+// Rebuild one bin's complex state from the newest block_size samples
+// of the window. A float Goertzel is run one step past the end of
+// the block, which yields the DFT with the same phase reference as
+// the sliding recurrence (sample 0 = oldest sample in the window).
+void IRAM_ATTR gdft_sliding_resync_bin(const short* window, uint16_t i) {
+  uint16_t block_size = frequencies[i].block_size;
+  const short* samples = &window[SAMPLE_HISTORY_LENGTH - block_size];
+
+  float cos_w = sliding_bins[i].cos_w;
+  float sin_w = sliding_bins[i].sin_w;
+  float coeff = 2.0f * cos_w;
+  float s1 = 0.0f;
+  float s2 = 0.0f;
+
+  for (uint16_t n = 0; n < block_size; n++) {
+    float s0 = float((int32_t)samples[n] >> GDFT_SAMPLE_SHIFT) + coeff * s1 - s2;
+    s2 = s1;
+    s1 = s0;
+  }
+  float s_end = coeff * s1 - s2;
+
+  // X = s[N] - e^(-jw) * s[N-1]
+  sliding_bins[i].re = s_end - cos_w * s1;
+  sliding_bins[i].im = sin_w * s1;
+}
+
+// Feed one hop of new samples into every active bin. Must be called
+// BEFORE the new samples are appended, with the window they are about
+// to advance, while the samples leaving each bin are still in place.
+void IRAM_ATTR gdft_sliding_push(const short* window, const short* new_samples, uint16_t count) {
+  if (gdft_engine != GDFT_ENGINE_SLIDING || gdft_sliding_primed == false) {
+    return;  // State gets rebuilt from the window on the next process_GDFT()
+  }
+
+  for (uint16_t i = 0; i < NUM_FREQS; i++) {
+    if (sliding_bins[i].active == false) {
+      continue;
+    }
+
+    // Active bins are always at least one hop long, so every
+    // outgoing sample is still inside the (not yet shifted) window
+    const short* old_samples = &window[SAMPLE_HISTORY_LENGTH - frequencies[i].block_size];
+
+    float cos_w = sliding_bins[i].cos_w;
+    float sin_w = sliding_bins[i].sin_w;
+    float re = sliding_bins[i].re;
+    float im = sliding_bins[i].im;
+
+    for (uint16_t n = 0; n < count; n++) {
+      int32_t delta = ((int32_t)new_samples[n] >> GDFT_SAMPLE_SHIFT) - ((int32_t)old_samples[n] >> GDFT_SAMPLE_SHIFT);
+      float re_in = re + delta;
+
+      re = cos_w * re_in - sin_w * im;
+      im = sin_w * re_in + cos_w * im;
+    }
+
+    sliding_bins[i].re = re;
+    sliding_bins[i].im = im;
+  }
+}
+
+// Squared magnitude of an active bin, in the same int32 units as
+// goertzel_block_power() so the rest of process_GDFT() is unchanged
+int32_t IRAM_ATTR gdft_sliding_power(uint16_t i) {
+  float power = sliding_bins[i].re * sliding_bins[i].re + sliding_bins[i].im * sliding_bins[i].im;
+  if (power > 2147483647.0f) {
+    return 2147483647;
+  }
+  return (int32_t)power;
+}
+
+// Called at the top of process_GDFT() while the sliding engine is
+// selected. Primes every bin after a switch, otherwise resyncs one
+// active bin per frame and records how far it had drifted.
+void IRAM_ATTR gdft_sliding_maintain(const short* window) {
+  if (gdft_sliding_primed == false) {
+    for (uint16_t i = 0; i < NUM_FREQS; i++) {
+      if (sliding_bins[i].active) {
+        gdft_sliding_resync_bin(window, i);
+      }
+    }
+    gdft_sliding_primed = true;
+    return;
+  }
+
+  for (uint16_t tries = 0; tries < NUM_FREQS; tries++) {
+    uint16_t i = gdft_sliding_resync_index;
+    gdft_sliding_resync_index++;
+    if (gdft_sliding_resync_index >= NUM_FREQS) {
+      gdft_sliding_resync_index = 0;
+    }
+
+    if (sliding_bins[i].active) {
+      float slid_re = sliding_bins[i].re;
+      float slid_im = sliding_bins[i].im;
+
+      gdft_sliding_resync_bin(window, i);
+
+      float err_re = slid_re - sliding_bins[i].re;
+      float err_im = slid_im - sliding_bins[i].im;
+      float ref = sqrt(sliding_bins[i].re * sliding_bins[i].re + sliding_bins[i].im * sliding_bins[i].im);
+      if (ref > 1.0f) {  // Ignore bins that are sitting at the noise floor
+        gdft_sliding_last_drift = sqrt(err_re * err_re + err_im * err_im) / ref;
+        if (gdft_sliding_last_drift > gdft_sliding_max_drift) {
+          gdft_sliding_max_drift = gdft_sliding_last_drift;
+        }
+      }
+      break;
+    }
+  }
+}
+
+// Compare every active bin against the full Goertzel engine on the
+// current window and print the results ("gdft_drift" serial command)
+void print_gdft_sliding_drift(const short* window) {
+  uint16_t active_bins = 0;
+  float worst_error = 0.0;
+  int16_t worst_bin = -1;
+
+  USBSerial.print("GDFT ENGINE: ");
+  if (gdft_engine == GDFT_ENGINE_SLIDING) {
+    USBSerial.println("SLIDING");
+  } else {
+    USBSerial.println("FULL");
+  }
+
+  for (uint16_t i = 0; i < NUM_FREQS; i++) {
+    if (sliding_bins[i].active == false) {
+      continue;
+    }
+    active_bins++;
+
+    if (gdft_engine != GDFT_ENGINE_SLIDING || gdft_sliding_primed == false) {
+      continue;
+    }
+
+    uint16_t block_size = frequencies[i].block_size;
+    int32_t full_power = goertzel_block_power(&window[SAMPLE_HISTORY_LENGTH - block_size], block_size, frequencies[i].coeff_q14);
+    float full_mag = sqrt(float(full_power));
+    float slid_mag = sqrt(float(gdft_sliding_power(i)));
+    float error = fabs(slid_mag - full_mag) / (full_mag > 1.0 ? full_mag : 1.0);
+
+    if (error > worst_error) {
+      worst_error = error;
+      worst_bin = i;
+    }
+  }
+
+  USBSerial.print("SLIDING BINS: ");
+  USBSerial.print(active_bins);
+  USBSerial.print(" / ");
+  USBSerial.println(NUM_FREQS);
+
+  if (gdft_engine == GDFT_ENGINE_SLIDING && worst_bin >= 0) {
+    USBSerial.print("WORST BIN VS FULL ENGINE: ");
+    USBSerial.print(worst_bin);
+    USBSerial.print(" (");
+    USBSerial.print(frequencies[worst_bin].target_freq);
+    USBSerial.print(" Hz) ");
+    USBSerial.print(worst_error * 100.0, 4);
+    USBSerial.println("%");
+  }
+
+  USBSerial.print("RESYNC DRIFT LAST/MAX: ");
+  USBSerial.print(gdft_sliding_last_drift * 100.0, 4);
+  USBSerial.print("% / ");
+  USBSerial.print(gdft_sliding_max_drift * 100.0, 4);
+  USBSerial.println("%");
+
+  gdft_sliding_max_drift = 0.0;
+}
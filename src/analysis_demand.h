@@ -0,0 +1,143 @@
+#ifndef ANALYSIS_DEMAND_H
+#define ANALYSIS_DEMAND_H
+
+/*----------------------------------------
+  DEMAND-DRIVEN ANALYSIS
+
+  Each light mode declares the audio features it reads
+  (LightMode::inputs, lightshow_modes.h). Once per LED frame the LED
+  thread ORs together the inputs of every strip's mode into
+  analysis_demand, and each side only runs the stages behind them:
+
+    stage                        runs when the demand has
+    process_GDFT() + novelty     SPECTROGRAM, CHROMAGRAM or NOVELTY
+    get_smooth_spectrogram()     SPECTROGRAM or CHROMAGRAM
+    make_smooth_chromagram()     CHROMAGRAM
+
+  acquire_sample_chunk() and calculate_vu() always run: the waveform,
+  VU, silence detection and the sweet spot need them anyway, and
+  they're a fraction of the GDFT. So two VU modes (VU Dot, Quantum
+  Collapse) with the auto color shift off leave the Goertzel bank idle.
+
+  A skipped GDFT publishes an all-zero spectrogram, never a stale one,
+  and drops the sliding engine state, which rebuilds itself
+  on the first frame back. A skipped smoothing stage zeroes its output
+  (spectrogram_smooth, chromagram_smooth) the same way. Noise
+  calibration always gets the full analysis. A mode transition asks for
+  the next mode's inputs while the old one fades out, so the spectrum
+  is warm by the time it shows.
+  The telemetry channels that carry analysis (telemetry=spectrogram,
+  novelty, chromagram) count as readers too, so the host recorder never
+  gets a parked spectrum passed off as a real one.
+
+  analysis=full (serial menu) runs every stage regardless, for
+  comparison.
+  ----------------------------------------*/
+
+#include "globals.h"
+#include "lightshow_modes.h"
+#include "telemetry_stream_format.h"
+
+// What a context's mode, and its hue walk, read
+inline uint8_t render_context_inputs(const RenderContext& ctx) {
+  uint8_t inputs = 0;
+  if (ctx.config.LIGHTSHOW_MODE < NUM_MODES) {
+    inputs |= light_modes[ctx.config.LIGHTSHOW_MODE].inputs;
+  }
+  if (ctx.config.AUTO_COLOR_SHIFT == true && ctx.config.PALETTE_INDEX == 0) {
+    inputs |= MODE_INPUT_NOVELTY;  // update_render_color_shift() (render_context.h)
+  }
+  return inputs;
+}
+
+// What the telemetry stream sends (telemetry_stream.h)
+inline uint8_t telemetry_inputs(uint8_t channels) {
+  uint8_t inputs = 0;
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_SPECTROGRAM)) {
+    inputs |= MODE_INPUT_SPECTROGRAM;
+  }
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_CHROMAGRAM)) {
+    inputs |= MODE_INPUT_CHROMAGRAM;
+  }
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_NOVELTY)) {
+    inputs |= MODE_INPUT_NOVELTY;
+  }
+  return inputs;
+}
+
+// LED thread, each frame after cache_frame_config()
+inline void update_analysis_demand() {
+  if (analysis_on_demand == false) {
+    analysis_demand = MODE_INPUT_ALL;
+    return;
+  }
+
+  uint8_t demand = render_context_inputs(primary_render);
+  if (ENABLE_SECONDARY_LEDS) {
+    demand |= render_context_inputs(secondary_render);
+  }
+  demand |= telemetry_inputs(telemetry_channels);
+
+  if (mode_transition_queued == true) {  // Warm up the mode run_transition_fade() is heading to
+    int16_t next_mode = (mode_destination == -1) ? (CONFIG.LIGHTSHOW_MODE + 1) % NUM_MODES : mode_destination;
+    if (next_mode >= 0 && next_mode < NUM_MODES) {
+      demand |= light_modes[next_mode].inputs;
+    }
+  }
+
+  analysis_demand = demand;
+}
+
+// Audio task: the GDFT and novelty, or an empty spectrum when nothing
+// reads it
+inline void run_spectral_analysis(uint32_t t_now) {
+  static bool gdft_parked = false;
+
+  uint8_t demand = analysis_demand;
+  bool wanted = (demand & (MODE_INPUT_SPECTROGRAM | MODE_INPUT_CHROMAGRAM | MODE_INPUT_NOVELTY)) != 0;
+  if (wanted || noise_complete == false) {
+    gdft_parked = false;
+#ifdef ENABLE_PERFORMANCE_MONITORING
+    uint32_t t_gdft_us = micros();
+#endif
+    process_GDFT();  // (GDFT.h)
+    // Execute GDFT and post-process
+
+#ifdef ENABLE_PERFORMANCE_MONITORING
+    uint32_t t_novelty_us = micros();
+    perf_stage_record(PERF_STAGE_GDFT, t_novelty_us - t_gdft_us);
+#endif
+    // Watches the rate of change in the Goertzel bins to guide decisions for auto-color shifting
+    calculate_novelty(t_now);
+#ifdef ENABLE_PERFORMANCE_MONITORING
+    perf_stage_record(PERF_STAGE_NOVELTY, micros() - t_novelty_us);
+#endif
+    return;
+  }
+
+  if (gdft_parked == false) {
+    gdft_parked = true;
+    memset(spectrogram, 0, sizeof(SQ15x16) * NUM_FREQS);
+    invalidate_gdft_sliding();  // Stop advancing; primed again on the way back (GDFT_sliding.h)
+  }
+  analysis_gdft_skipped++;
+}
+
+// LED thread, after acquire_audio_frame(): the smoothing this frame's
+// modes read
+inline void smooth_audio_features() {
+  uint8_t demand = analysis_demand;
+  if (demand & (MODE_INPUT_SPECTROGRAM | MODE_INPUT_CHROMAGRAM)) {
+    get_smooth_spectrogram();
+  } else {
+    memset(spectrogram_smooth, 0, sizeof(SQ15x16) * NUM_FREQS);
+  }
+
+  if (demand & MODE_INPUT_CHROMAGRAM) {
+    make_smooth_chromagram();
+  } else {
+    memset(chromagram_smooth, 0, sizeof(SQ15x16) * 12);
+  }
+}
+
+#endif // ANALYSIS_DEMAND_H
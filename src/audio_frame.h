@@ -0,0 +1,107 @@
+#ifndef AUDIO_FRAME_H
+#define AUDIO_FRAME_H
+
+/*----------------------------------------
+  AUDIO FRAME HAND-OFF (Core 0 -> Core 1)
+
+  The audio task and led_thread() run on different cores, so the LED
+  side can't read spectrogram[], silent_scale, audio_vu_level and
+  friends directly: a frame could be half-written while it renders.
+
+  Instead, once per audio frame the audio task copies everything the
+  LED side needs into an AudioFrame (globals.h), and the LED thread
+  takes the newest one at the start of each LED frame. Three slots
+  are swapped through a single atomic index, no locks:
+
+    - the audio task always owns one slot (it writes the next frame
+      there, then exchanges it into audio_frame_latest)
+    - audio_frame_latest holds the newest complete frame
+    - the LED thread owns one slot (led_audio), and only swaps it for
+      audio_frame_latest when AUDIO_FRAME_FRESH is set
+
+  Neither side ever touches a slot the other owns, so a frame can't
+  tear. seq_check is written last and compared on the LED side anyway:
+  any mismatch is counted in g_race_condition_count.
+  ----------------------------------------*/
+
+#include "globals.h"
+
+// Newest novelty_curve[] entry (see calculate_novelty() in GDFT.h)
+inline SQ15x16 latest_novelty() {
+  int16_t rounded_index = spectral_history_index - 1;
+  while (rounded_index < 0) {
+    rounded_index += SPECTRAL_HISTORY_LENGTH;
+  }
+  return novelty_curve[rounded_index];
+}
+
+inline void fill_audio_frame(AudioFrame& frame, uint32_t seq, uint32_t t_now_us) {
+  frame.seq = seq;
+  frame.timestamp_us = t_now_us;
+  frame.dma_done_us = i2s_chunk_done_us;
+  memcpy(frame.spectrogram, spectrogram, sizeof(SQ15x16) * NUM_FREQS);
+  frame.novelty = latest_novelty();
+  frame.vu_level = audio_vu_level;
+  frame.vu_level_average = audio_vu_level_average;
+  frame.waveform_peak_scaled = waveform_peak_scaled;
+  frame.silent_scale = silent_scale;
+  frame.current_punch = current_punch;
+  frame.silence = silence;
+  frame.noise_complete = noise_complete;
+  frame.seq_check = seq;
+}
+
+// Audio task: the slot being written, and the publish count
+static uint8_t audio_frame_back = 1;
+static uint32_t audio_frame_seq = 0;
+
+// LED thread: the slot led_audio points to, and the last seq it saw
+static uint8_t audio_frame_front = 2;
+static uint32_t audio_frame_last_seq = 0;
+
+// Called once at boot (after init_fs() has loaded the noise calibration)
+// so code that renders before the first audio frame sees current values
+inline void init_audio_frames() {
+  for (uint8_t i = 0; i < AUDIO_FRAME_SLOTS; i++) {
+    fill_audio_frame(audio_frames[i], 0, micros());
+  }
+  audio_frame_back = 1;
+  audio_frame_front = 2;
+  audio_frame_latest.store(0);
+  led_audio = &audio_frames[audio_frame_front];
+}
+
+// Audio task, once the frame's analysis is done
+inline void publish_audio_frame(uint32_t t_now_us) {
+  audio_frame_seq++;
+  fill_audio_frame(audio_frames[audio_frame_back], audio_frame_seq, t_now_us);
+
+  uint32_t previous = audio_frame_latest.exchange(audio_frame_back | AUDIO_FRAME_FRESH, std::memory_order_acq_rel);
+  if (previous & AUDIO_FRAME_FRESH) {
+    audio_frames_dropped++;  // LED side never took the last one
+  }
+  audio_frame_back = previous & AUDIO_FRAME_INDEX_MASK;
+}
+
+// LED thread, at the start of every LED frame. led_audio stays valid
+// (and unchanged) until the next call.
+inline const AudioFrame* acquire_audio_frame() {
+  if (audio_frame_latest.load(std::memory_order_acquire) & AUDIO_FRAME_FRESH) {
+    uint32_t latest = audio_frame_latest.exchange(audio_frame_front, std::memory_order_acq_rel);
+    audio_frame_front = latest & AUDIO_FRAME_INDEX_MASK;
+  }
+
+  const AudioFrame* frame = &audio_frames[audio_frame_front];
+  if (frame->seq != frame->seq_check) {
+    g_race_condition_count++;
+  }
+  if (frame->seq == audio_frame_last_seq) {
+    audio_frames_repeated++;
+  }
+  audio_frame_last_seq = frame->seq;
+
+  led_audio = frame;
+  return frame;
+}
+
+#endif // AUDIO_FRAME_H
@@ -5,12 +5,13 @@
   AudioProcessedState - Phase 2B Implementation
   
   MISSION: Encapsulate shared audio processing results with race condition safety
-  RISK LEVEL: MEDIUM - Audio writes, LED reads (single-core provides atomicity)
+  RISK LEVEL: MEDIUM - Audio task only; the LED thread (Core 1) reads
+  published copies through led_audio (audio_frame.h)
   TARGET: waveform[], max_waveform_val*, silence state, current_punch
   
   CRITICAL SUCCESS FACTORS:
   - Direct array access preserved for 86.6 FPS performance
-  - Single-core scheduling provides atomic context switching
+  - Cross-core reads go through the AudioFrame hand-off, never these fields
   - Zero synchronization overhead
   - Shared data clearly identified and documented
   ----------------------------------------*/
@@ -25,15 +26,16 @@ namespace Audio {
 /**
  * AudioProcessedState - Encapsulates shared audio processing results
  * 
- * THREAD SAFETY: Audio writes, LED reads - single-core scheduling provides atomicity
+ * THREAD SAFETY: Audio task only - values the LED thread needs are copied
+ *                into an AudioFrame once per frame (audio_frame.h)
  * PERFORMANCE: Direct array access preserved for hot paths
- * SHARED DATA: Race condition potential mitigated by Core 0 scheduling
+ * SHARED DATA: None directly; see publish_audio_frame()
  */
 class AudioProcessedState {
 private:
     // SHARED: Processed waveform - written by audio thread, read by LED thread
     // ORIGINAL: short waveform[1024] (globals.h:189)
-    // RACE CONDITION: Audio writes in i2s_audio.h, LED reads in lightshow_modes.h
+    // Audio writes in i2s_audio.h (not read by the LED thread)
     short   waveform_[1024];
     
     // Fixed-point version for mathematical operations
@@ -102,7 +104,7 @@ public:
      * USAGE: audio_processed.getWaveform()[i] = processed_sample;
      * REPLACES: waveform[i] = processed_sample;
      * PERFORMANCE: Zero overhead - compiles to direct memory access
-     * RACE CONDITION: Audio writes, LED reads - single-core provides safety
+     * THREAD SAFETY: Audio task only
      */
     short* getWaveform() { return waveform_; }
     const short* getWaveform() const { return waveform_; }
@@ -118,8 +120,8 @@ public:
     /**
      * PERFORMANCE CRITICAL: Volume analysis access
      * 
-     * THREAD SAFETY: Single-core scheduler ensures atomic reads
-     * Used by LED thread for volume-reactive effects
+     * THREAD SAFETY: Audio task only - the LED thread's volume-reactive
+     * effects read the published copy (led_audio) instead
      */
     float getMaxRaw() const { return max_waveform_val_raw_; }
     float getMax() const { return max_waveform_val_; }
@@ -14,42 +14,39 @@ void init_config_defaults() {
   CONFIG_DEFAULTS = CONFIG;
 }
 
-// Restore all defaults defined in globals.h by removing saved data and rebooting
-void factory_reset() {
-  lock_leds();
+void delete_file(const char* path) {
   USBSerial.print("Deleting ");
-  USBSerial.print(config_filename);
+  USBSerial.print(path);
   USBSerial.print(": ");
 
-  if (LittleFS.remove(config_filename)) {
+  if (LittleFS.remove(path)) {
     USBSerial.println("file deleted");
   } else {
     USBSerial.println("delete failed");
   }
+}
 
-  USBSerial.print("Deleting noise_cal.bin: ");
-  if (LittleFS.remove("/noise_cal.bin")) {
-    USBSerial.println("file deleted");
-  } else {
-    USBSerial.println("delete failed");
-  }
+// The settings kept beside CONFIG, which "restore defaults" covers too
+void delete_side_files() {
+  delete_file(RENDER_RES_FILE);
+  delete_file(LED_RATE_FILE);
+  delete_file(OUTPUT_CURVE_FILE);
+}
 
+// Restore all defaults defined in globals.h by removing saved data and rebooting
+void factory_reset() {
+  lock_leds();
+  delete_file(config_filename);
+  delete_file("/noise_cal.bin");
+  delete_side_files();
   reboot();
 }
 
 // Restore only configuration defaults
 void restore_defaults() {
   lock_leds();
-  USBSerial.print("Deleting ");
-  USBSerial.print(config_filename);
-  USBSerial.print(": ");
-
-  if (LittleFS.remove(config_filename)) {
-    USBSerial.println("file deleted");
-  } else {
-    USBSerial.println("delete failed");
-  }
-
+  delete_file(config_filename);
+  delete_side_files();
   reboot();
 }
 
@@ -251,6 +248,96 @@ void load_ambient_noise_calibration() {
   unlock_leds();
 }
 
+// Settings that live outside CONFIG get a small file each, behind a
+// header so a short, foreign or older-layout file reads as "never set"
+struct SideFileHeader {
+  uint32_t magic;    // SIDE_FILE_MAGIC
+  uint16_t version;  // Layout of what follows, per file
+  uint16_t length;   // sizeof what follows
+};
+
+void save_side_file(const char* path, uint16_t version, const void* data, uint16_t length) {
+  File file = LittleFS.open(path, FILE_WRITE);
+  if (!file) {
+    if (debug_mode) {
+      USBSerial.print("Failed to open ");
+      USBSerial.print(path);
+      USBSerial.println(" for writing!");
+    }
+    return;
+  }
+  SideFileHeader header = { SIDE_FILE_MAGIC, version, length };
+  file.write((uint8_t*)&header, sizeof(header));
+  file.write((const uint8_t*)data, length);
+  file.close();
+}
+
+// False unless the file holds exactly this version and length of data
+bool load_side_file(const char* path, uint16_t version, void* data, uint16_t length) {
+  File file = LittleFS.open(path, FILE_READ);
+  if (!file) {
+    return false;
+  }
+  SideFileHeader header;
+  bool valid = (file.read((uint8_t*)&header, sizeof(header)) == sizeof(header) &&
+                header.magic == SIDE_FILE_MAGIC && header.version == version && header.length == length &&
+                file.size() == sizeof(header) + length);
+  if (valid) {
+    valid = (file.read((uint8_t*)data, length) == length);
+  }
+  file.close();
+  return valid;
+}
+
+void save_render_resolution() {
+  save_side_file(RENDER_RES_FILE, RENDER_RES_FILE_VERSION, &render_resolution_setting, sizeof(render_resolution_setting));
+}
+
+// Before init_leds(), which sizes the frame arena and applies it
+void load_render_resolution() {
+  uint16_t setting;
+  if (!load_side_file(RENDER_RES_FILE, RENDER_RES_FILE_VERSION, &setting, sizeof(setting))) {
+    return;  // DEFAULT_RENDER_RESOLUTION
+  }
+  if (setting != RENDER_FOLLOWS_LED_COUNT) {
+    setting = constrain(setting, MIN_RENDER_RESOLUTION, MAX_RENDER_RESOLUTION);
+  }
+  render_resolution_setting = setting;
+}
+
+void save_led_frame_rate() {
+  save_side_file(LED_RATE_FILE, LED_RATE_FILE_VERSION, &led_frame_rate_setting, sizeof(led_frame_rate_setting));
+}
+
+void load_led_frame_rate() {
+  uint16_t setting;
+  if (!load_side_file(LED_RATE_FILE, LED_RATE_FILE_VERSION, &setting, sizeof(setting))) {
+    return;  // DEFAULT_LED_FRAME_RATE
+  }
+  if (setting != LED_FRAME_RATE_UNCAPPED) {
+    setting = constrain(setting, MIN_LED_FRAME_RATE, MAX_LED_FRAME_RATE);
+  }
+  led_frame_rate_setting = setting;
+}
+
+void save_output_curve() {
+  save_side_file(OUTPUT_CURVE_FILE, OUTPUT_CURVE_FILE_VERSION, &output_curve, sizeof(output_curve));
+}
+
+// Before init_leds(), which builds output_lut[] from it
+void load_output_curve() {
+  OutputCurve curve;
+  if (!load_side_file(OUTPUT_CURVE_FILE, OUTPUT_CURVE_FILE_VERSION, &curve, sizeof(curve))) {
+    return;  // Linear, no white balance
+  }
+  // Clamped to what output_gamma= / white_balance= accept; NaN reads as the default
+  curve.gamma = isnan(curve.gamma) ? DEFAULT_OUTPUT_GAMMA : constrain(curve.gamma, MIN_OUTPUT_GAMMA, MAX_OUTPUT_GAMMA);
+  for (uint8_t c = 0; c < 3; c++) {
+    curve.gain[c] = isnan(curve.gain[c]) ? 1.0f : constrain(curve.gain[c], 0.0f, 1.0f);
+  }
+  output_curve = curve;
+}
+
 // Initialize LittleFS
 void init_fs() {
   lock_leds();
@@ -260,5 +347,8 @@ void init_fs() {
   update_config_filename(FIRMWARE_VERSION);
   load_ambient_noise_calibration();
   load_config();
+  load_render_resolution();
+  load_led_frame_rate();
+  load_output_curve();
   unlock_leds();
 }
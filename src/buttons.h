@@ -16,6 +16,12 @@
 // it will flash all units in the network (p2p.h) to identify
 // which unit's buttons to touch instead to affect changes.
 
+// session=record keeps every press (session_record.h)
+void record_button_press(uint8_t button, bool long_press) {
+  uint8_t event[2] = {button, long_press ? uint8_t(1) : uint8_t(0)};
+  session_record_event(SESSION_EVENT_BUTTON, event, sizeof(event));
+}
+
 void check_buttons(uint32_t t_now) {
   #ifdef ARDUINO_ESP32S3_DEV
     // BUTTON CORRUPTION IMMUNITY: Complete button bypass for ESP32-S3
@@ -31,6 +37,7 @@ void check_buttons(uint32_t t_now) {
     }
 
     if (t_now - noise_button.last_down > 250 && noise_button.last_up < noise_button.last_down) { // Still held, and for more than 250ms (long press)
+      record_button_press(0, true);
       if (CONFIG.IS_MAIN_UNIT || main_override) { // If main, clear noise cal
         clear_noise_cal();
       } else { // if not, complain
@@ -47,6 +54,7 @@ void check_buttons(uint32_t t_now) {
       uint32_t press_duration = noise_button.last_up - noise_button.last_down; // Get press duration
 
       if (press_duration <= 250) { // if it was a short press
+        record_button_press(0, false);
         if (CONFIG.IS_MAIN_UNIT || main_override) { // if main unit, start noise cal
           noise_transition_queued = true; // See run_transition_fade() in led_utilities.h
         }
@@ -66,6 +74,7 @@ void check_buttons(uint32_t t_now) {
     }
 
     if (t_now - mode_button.last_down > 250 && mode_button.last_up < mode_button.last_down) {
+      record_button_press(1, true);
       if (CONFIG.IS_MAIN_UNIT || main_override) {
         CONFIG.MIRROR_ENABLED = !CONFIG.MIRROR_ENABLED;
         save_config_delayed();
@@ -90,6 +99,7 @@ void check_buttons(uint32_t t_now) {
       uint32_t press_duration = mode_button.last_up - mode_button.last_down;
 
       if (press_duration <= 250 && skip_click == false) {
+        record_button_press(1, false);
         if (mode_transition_queued == false) {
           if (CONFIG.IS_MAIN_UNIT || main_override) {
             mode_transition_queued = true; // See run_transition_fade() in led_utilities.h
@@ -6,6 +6,7 @@
 #include <FixedPoints.h> // Include for SQ15x16 type used within
 #include <FixedPointsCommon.h> // Required for SQ15x16 typedef
 #include <stdint.h>      // Include for uint32_t type used within
+#include "led_pixel.h"   // CRGB16 and its channel type
 
 // AUDIO #######################################################
 
@@ -13,8 +14,41 @@
 #define DEFAULT_SAMPLE_RATE 16000
 #define SAMPLE_HISTORY_LENGTH 4096
 
-// Don't change this unless you're willing to do a lot of other work on the code :/
-#define NATIVE_RESOLUTION 160
+// Render width (pixels every mode draws) is NATIVE_RESOLUTION, set at runtime
+// (render_resolution=, frame_arena.h). Buffers come from a frame arena sized
+// at boot for the larger of the default and CONFIG.LED_COUNT.
+#define DEFAULT_RENDER_RESOLUTION 160
+#define MIN_RENDER_RESOLUTION 32      // Modes divide the strip into halves and quarters
+#define MAX_RENDER_RESOLUTION 1000    // Same cap as CONFIG.LED_COUNT (init_leds())
+#define RENDER_FOLLOWS_LED_COUNT 0    // Saved render resolution meaning "= CONFIG.LED_COUNT"
+#define RENDER_CONTEXT_DOTS 24               // Dots per render context (chromagram dots: two per note)
+#define MAX_STRIP_JOBS 4                     // Strips the strip worker renders per frame, besides the primary
+
+// LED frame rate governor (frame_governor.h): led_thread starts a frame
+// every 1 / led_frame_rate_setting seconds and sleeps in between
+#define DEFAULT_LED_FRAME_RATE 120    // Hz, about the audio frame rate at the default hop
+#define MIN_LED_FRAME_RATE 20
+#define MAX_LED_FRAME_RATE 500
+#define LED_FRAME_RATE_UNCAPPED 0     // Saved rate meaning "as fast as the strip shows"
+
+// Output transfer curve (output_curve.h): linear 0.0 - 1.0 -> 8-bit LED
+// value through a lookup table per colour channel
+#define OUTPUT_LUT_BITS 12                       // Table input resolution
+#define OUTPUT_LUT_SIZE (1 << OUTPUT_LUT_BITS)
+#define OUTPUT_LUT_FULL_SCALE 65280              // 255.0 in the table's 8.8 fixed point
+#define DEFAULT_OUTPUT_GAMMA 1.0f                // Channels are already linear light
+#define MIN_OUTPUT_GAMMA 0.5f
+#define MAX_OUTPUT_GAMMA 3.0f
+
+// Settings saved beside CONFIG, whose file is the struct stored raw
+// (bridge_fs.h). Each file is a SideFileHeader, then the setting.
+#define SIDE_FILE_MAGIC 0x31465342               // "SBF1"
+#define RENDER_RES_FILE "/render_res.bin"
+#define RENDER_RES_FILE_VERSION 1
+#define LED_RATE_FILE "/led_rate.bin"
+#define LED_RATE_FILE_VERSION 1
+#define OUTPUT_CURVE_FILE "/output_curve.bin"
+#define OUTPUT_CURVE_FILE_VERSION 1
 // MODIFICATION [2025-09-20 22:30] - BIN-REVERT-96-64-001: Core frequency bin reduction
 // FAULT DETECTED: 96-bin configuration causing 33% computational overhead and 3KB+ memory usage
 // ROOT CAUSE: Original design was 64-bin, 96-bin was experimental expansion with performance issues
@@ -26,6 +60,43 @@
 #define NUM_ZONES 2
 
 #define I2S_PORT I2S_NUM_0
+#define I2S_DMA_BUF_LEN 64            // Samples per DMA buffer (one RX_DONE event), the finest analysis hop
+#define I2S_DMA_BUF_COUNT 32         // DMA buffers; also the I2S event queue length (2048 samples of slack)
+#define AUDIO_HOP_MIN 64             // Smallest analysis hop the serial menu accepts (250 frames/s at 16 kHz)
+
+// Audio and control run as separate tasks on Core 0 (main.cpp)
+#define AUDIO_EVENT_TIMEOUT_MS 100   // Audio task wakes (and feeds its watchdog) even if I2S stalls
+#define CONTROL_TASK_PERIOD_MS 10    // Knobs, buttons, HMI, serial, P2P, config saves
+
+// Audio-to-photon latency histogram (latency_histogram.h)
+#define LATENCY_HIST_BUCKETS 200     // 0 - 50 ms in LATENCY_HIST_BUCKET_US steps
+#define LATENCY_HIST_BUCKET_US 250
+
+// Per-stage timing histograms (debug/performance_monitor.h)
+#define STAGE_HIST_SUB_BITS 3        // 8 buckets per power of two: each within 12.5% of its values
+#define STAGE_HIST_SUB_BUCKETS (1 << STAGE_HIST_SUB_BITS)
+#define STAGE_HIST_MAX_US 131071     // Longer stages land in the last bucket (max_us stays exact)
+#define STAGE_HIST_BUCKETS 120       // stage_histogram_bucket(STAGE_HIST_MAX_US) + 1
+
+// Deferred logging (deferred_log.h)
+#define DEFERRED_LOG_CORES 2
+#define DEFERRED_LOG_WORDS 1024      // Per core, power of two: ~45 of the largest (STAGE dump) messages
+#define DEFERRED_LOG_HEADER_WORDS 3  // Format, timestamp, argument count
+#define DEFERRED_LOG_MAX_ARGS 20
+#define DEFERRED_LOG_LINE_BYTES 256  // Longest expanded message
+
+// Binary telemetry stream (telemetry_stream.h)
+#define TELEMETRY_RING_BYTES 16384          // Per producer (audio task, LED thread), power of two
+#define DEFAULT_TELEMETRY_BUDGET_KBPS 400   // kB/s; full-speed USB CDC manages ~800
+#define MIN_TELEMETRY_BUDGET_KBPS 10
+#define MAX_TELEMETRY_BUDGET_KBPS 1000
+
+// Session record / replay (session_record.h)
+#define SESSION_AUDIO_RING_BYTES 32768      // Audio task's records, ~1 s; also the replay ring. Power of two
+#define SESSION_RING_BYTES 4096             // LED thread, control task and P2P each, power of two
+#define SESSION_EVENT_MAX_DATA 256          // Longest EVENT: a command line or an ESP-NOW packet (250)
+#define SESSION_MAX_BYTES (640 * 1024)      // Longest recording, ~20 s at 16 kHz; LittleFS has 960 kB
+#define SESSION_FS_RESERVE_BYTES (64 * 1024)  // Left free for config / calibration saves
 
 #define SPECTRAL_HISTORY_LENGTH 5
 
@@ -70,10 +141,15 @@ enum lightshow_modes {
   NUM_MODES                          // Used to know the length of this list if it changes in the future
 };
 
-struct CRGB16 {  // Unsigned Q8.8 Fixed-point color channels
-  SQ15x16 r;
-  SQ15x16 g;
-  SQ15x16 b;
+// Audio features a mode reads (LightMode::inputs, lightshow_modes.h),
+// and so which analysis stages have to run (analysis_demand.h)
+enum light_mode_inputs {
+  MODE_INPUT_SPECTROGRAM = 1 << 0,  // spectrogram_smooth[]
+  MODE_INPUT_CHROMAGRAM  = 1 << 1,  // chromagram_smooth[]
+  MODE_INPUT_WAVEFORM    = 1 << 2,  // waveform_peak_scaled
+  MODE_INPUT_VU          = 1 << 3,  // vu_level, vu_level_average
+  MODE_INPUT_NOVELTY     = 1 << 4,  // novelty (no mode; the auto color shift)
+  MODE_INPUT_ALL         = 0xFF,
 };
 
 struct DOT {
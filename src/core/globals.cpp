@@ -106,7 +106,8 @@ bool chromatic_mode = true;
 
 // ------------------------------------------------------------
 // Audio samples (i2s_audio.h) --------------------------------
-short   sample_window[SAMPLE_HISTORY_LENGTH] = { 0 };
+short   sample_ring[SAMPLE_HISTORY_LENGTH * 2] = { 0 };
+uint16_t sample_ring_head = 0;
 short   waveform[1024]                       = { 0 };
 SQ15x16 waveform_fixed_point[1024]           = { 0 };
 float   max_waveform_val_raw = 0.0;
@@ -134,32 +135,62 @@ uint16_t noise_iterations = 0;
 
 // ------------------------------------------------------------
 // Display buffers (led_utilities.h) --------------------------
-CRGB16  leds_16[160];
-CRGB16  leds_16_prev[160];
-CRGB16  leds_16_prev_secondary[160]; // Buffer for secondary bloom state
-CRGB16  leds_16_fx[160];
-CRGB16  leds_16_temp[160];
-CRGB16  leds_16_ui[160];
+uint16_t NATIVE_RESOLUTION = DEFAULT_RENDER_RESOLUTION;
+uint16_t render_capacity = 0;
+uint16_t render_resolution_setting = DEFAULT_RENDER_RESOLUTION;
+volatile uint16_t render_resolution_request = 0;
+uint8_t* frame_arena = NULL;
+size_t frame_arena_size = 0;
+size_t frame_arena_used = 0;
+
+uint16_t led_frame_rate_setting = DEFAULT_LED_FRAME_RATE;
+uint32_t led_render_us = 0;
+uint32_t led_show_us = 0;
+uint32_t led_frames_late = 0;
+
+OutputCurve output_curve = {DEFAULT_OUTPUT_GAMMA, {1.0f, 1.0f, 1.0f}};
+volatile bool output_curve_changed = false;
+uint16_t output_lut[3][OUTPUT_LUT_SIZE];
+
+CRGB16* leds_16 = NULL;
+CRGB16* leds_16_prev = NULL;
+CRGB16* leds_16_prev_secondary = NULL; // Buffer for secondary bloom state
+CRGB16* leds_16_fx = NULL;
+CRGB16* leds_16_fx_secondary = NULL;  // secondary_render.fx
+CRGB16* leds_16_temp = NULL;
+CRGB16* leds_16_ui = NULL;
 
 volatile uint32_t g_frame_seq_write = 0;
 volatile uint32_t g_frame_seq_ready = 0;
-volatile uint32_t g_frame_seq_shown = 0;
+volatile uint32_t g_frame_audio_seq_ready = 0;
+volatile uint32_t g_frame_audio_stamp_ready = 0;
 
-// Add state variables for waveform mode instances
-// CRITICAL: Preserve exact aggregate initialization syntax!
-CRGB16  waveform_last_color_primary = {{ 0 }, { 0 }, { 0 }};
-CRGB16  waveform_last_color_secondary = {{ 0 }, { 0 }, { 0 }};
+AudioFrame audio_frames[AUDIO_FRAME_SLOTS];
+std::atomic<uint32_t> audio_frame_latest(0);
+const AudioFrame* led_audio = &audio_frames[2];
+uint32_t audio_frames_dropped = 0;
+uint32_t audio_frames_repeated = 0;
+
+LatencyHistogram audio_to_photon_latency = {};
+volatile bool audio_to_photon_reset = false;
+
+DeferredLogRing deferred_log_rings[DEFERRED_LOG_CORES] = {};
 
-SQ15x16 ui_mask[160];
+SQ15x16* ui_mask = NULL;
 SQ15x16 ui_mask_height = 0.0;
 
 CRGB16 *leds_scaled;
 CRGB *leds_out;
 
+DitherResidual *dither_residual = NULL;
+DitherResidual *dither_residual_secondary = NULL;
+
 SQ15x16 hue_shift = 0.0; // Used in auto color cycling
 
 uint8_t dither_step = 0;
 
+bool led_post_fused = true;
+
 bool led_thread_halt = false;
 
 TaskHandle_t led_task;
@@ -260,14 +291,6 @@ bool msc_update_started = false;
 // DOTS
 DOT dots[MAX_DOTS];
 
-// Auto Color Shift
-SQ15x16 hue_position = 0.0;
-SQ15x16 hue_shift_speed = 0.0;
-SQ15x16 hue_push_direction = -1.0;
-SQ15x16 hue_destination = 0.0;
-SQ15x16 hue_shifting_mix = -0.35;
-SQ15x16 hue_shifting_mix_target = 1.0;
-
 // VU Calculation
 SQ15x16 audio_vu_level = 0.0;
 SQ15x16 audio_vu_level_average = 0.0;
@@ -302,7 +325,7 @@ float last_sample = 0;
 // }
 
 // New buffers for secondary LED strip
-CRGB16  leds_16_secondary[160];        // Main buffer for secondary strip
+CRGB16* leds_16_secondary = NULL;      // Main buffer for secondary strip
 CRGB16 *leds_scaled_secondary;         // For scaling to actual LED count
 CRGB *leds_out_secondary;              // Final output buffer
 
@@ -332,10 +355,46 @@ SemaphoreHandle_t serial_mutex;
 
 // Task handle for audio processing thread
 TaskHandle_t audio_task_handle;
+TaskHandle_t control_task_handle;
+
+QueueHandle_t i2s_event_queue = NULL;
+uint32_t i2s_event_timeouts = 0;
+uint32_t i2s_dma_errors = 0;
+uint32_t audio_frame_jitter_us = 0;
+uint32_t i2s_chunk_done_us = 0;
+
+uint16_t audio_hop_size = 256;
+volatile uint16_t audio_hop_request = 0;
 
 // FRAME_CONFIG ODR FIX [2025-09-19 17:00] - Variable instance only (struct defined in globals.h)
 struct cached_config frame_config;
 
+// Set up by init_render_contexts() (render_context.h)
+RenderContext primary_render;
+RenderContext secondary_render;
+
+// Strip worker (strip_worker.h)
+StripJob strip_jobs[MAX_STRIP_JOBS];
+uint8_t strip_job_count = 0;
+bool strip_jobs_started = false;
+bool strip_render_parallel = true;
+SemaphoreHandle_t strip_jobs_go = NULL;
+SemaphoreHandle_t strip_jobs_done = NULL;
+TaskHandle_t strip_worker_task = NULL;
+uint32_t strip_jobs_us = 0;
+uint32_t strip_join_wait_us = 0;
+
+// Demand-driven analysis (analysis_demand.h)
+volatile uint8_t analysis_demand = MODE_INPUT_ALL;
+bool analysis_on_demand = true;
+uint32_t analysis_gdft_skipped = 0;
+
+volatile uint8_t telemetry_channels = 0;
+uint16_t telemetry_budget_kbps = DEFAULT_TELEMETRY_BUDGET_KBPS;
+
+// Session record / replay
+volatile uint8_t session_state = 0;  // SESSION_IDLE
+
 // NOTE_COLORS ODR FIX [2025-09-19 17:00] - Moved from constants.h
 // CRITICAL: Preserve exact aggregate initialization syntax!
 SQ15x16 note_colors[12] = {
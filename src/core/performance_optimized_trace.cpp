@@ -2,18 +2,59 @@
 #define DEBUG_BUILD 1
 #endif
 #include "performance_optimized_trace.h"
+#include "trace_stream_format.h"
 #include <freertos/task.h>
 
+// Define USBSerial for ESP32-S3
+#if ARDUINO_USB_CDC_ON_BOOT
+  #define USBSerial Serial
+#else
+  extern HWCDC USBSerial;
+#endif
+
 LockFreeTraceBuffer<TRACE_BUFFER_SIZE> g_trace_buffer;
 TraceConfig g_trace_config;
 
+static TraceStreamFrame trace_frame;
+static uint8_t trace_frame_bytes[TRACE_STREAM_MAX_FRAME];
+static uint16_t trace_frame_seq = 0;
+
+static void write_trace_frame_serial(const uint8_t* frame, size_t length)
+{
+  USBSerial.write(frame, length);
+}
+
+// Everything in the buffer as trace stream frames (trace_stream_format.h),
+// up to TRACE_STREAM_MAX_EVENTS events each
+void stream_trace_buffer(TraceStreamWrite write)
+{
+  TraceEvent event;
+  bool more = true;
+  while (more) {
+    trace_frame.begin(trace_frame_seq, g_trace_buffer.get_dropped_count());
+    while (!trace_frame.full() && (more = g_trace_buffer.pop(event))) {
+      trace_frame.add(event);
+    }
+    if (trace_frame.count() == 0) {
+      return;
+    }
+    size_t length = trace_frame.finish(trace_frame_bytes);
+    write(trace_frame_bytes, length);
+    trace_frame_seq++;
+  }
+}
+
 void trace_consumer_task(void* /*param*/)
 {
   TraceEvent event;
   for (;;) {
-    while (g_trace_buffer.pop(event)) {
-      // Trace events can be exported by separate tasks when outputs are enabled.
-      // This consumer simply drains the buffer to minimize back-pressure.
+    if (g_trace_config.enable_serial) {
+      stream_trace_buffer(write_trace_frame_serial);
+    } else {
+      while (g_trace_buffer.pop(event)) {
+        // WiFi / SD export aren't implemented; drain the buffer to
+        // minimize back-pressure.
+      }
     }
     vTaskDelay(1);
   }
@@ -85,7 +85,7 @@ inline void debug_color_shift_values(float novelty, float hue_speed, float hue_d
     static uint32_t last_log = 0;
     if (millis() - last_log > 2000) {
         USBSerial.printf("[COLOR_SHIFT] novelty=%.4f speed=%.6f direction=%.1f hue_pos=%.4f\n",
-                        novelty, hue_speed, hue_direction, float(hue_position));
+                        novelty, hue_speed, hue_direction, float(primary_render.hue.position));
         last_log = millis();
     }
 }
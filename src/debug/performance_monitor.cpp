@@ -21,6 +21,16 @@ extern struct freq {
 } frequencies[NUM_FREQS];
 
 PerformanceMetrics perf_metrics;
+volatile bool perf_stage_reset[NUM_PERF_STAGES] = {};
+
+static const char* const perf_stage_names[NUM_PERF_STAGES] = {
+    "i2s_read",
+    "gdft",
+    "novelty",
+    "mode_render",
+    "post_process",
+    "fastled_show",
+};
 
 // Rolling average buffers
 static float fps_history[30] = {0};
@@ -229,6 +239,59 @@ String format_perf_detailed() {
     return output;
 }
 
+const char* perf_stage_name(uint8_t stage) {
+    return (stage < NUM_PERF_STAGES) ? perf_stage_names[stage] : "?";
+}
+
+uint32_t stage_histogram_percentile(const StageHistogram& hist, float percentile) {
+    if (hist.samples == 0) {
+        return 0;
+    }
+
+    uint32_t target = ceilf(hist.samples * (percentile / 100.0f));
+    if (target < 1) {
+        target = 1;
+    }
+
+    uint32_t seen = 0;
+    for (uint16_t i = 0; i < STAGE_HIST_BUCKETS; i++) {
+        seen += hist.counts[i];
+        if (seen >= target) {
+            uint32_t edge_us = i;  // Below STAGE_HIST_SUB_BUCKETS a bucket is one value
+            if (i >= STAGE_HIST_SUB_BUCKETS) {
+                uint8_t shift = i / STAGE_HIST_SUB_BUCKETS - 1;
+                uint32_t mantissa = i % STAGE_HIST_SUB_BUCKETS + STAGE_HIST_SUB_BUCKETS;
+                edge_us = ((mantissa + 1) << shift) - 1;
+            }
+            return edge_us < hist.max_us ? edge_us : hist.max_us;
+        }
+    }
+    return hist.max_us;
+}
+
+void print_stage_histograms() {
+    USBSerial.println("STAGE         SAMPLES   MEAN_US    P50_US    P90_US    P99_US  P99.9_US    MAX_US");
+    for (uint8_t s = 0; s < NUM_PERF_STAGES; s++) {
+        const StageHistogram& hist = perf_metrics.stages[s];
+        USBSerial.printf("%-12s %8lu %9lu %9lu %9lu %9lu %9lu %9lu\n",
+                         perf_stage_names[s],
+                         (unsigned long)hist.samples,
+                         (unsigned long)(hist.samples ? hist.total_us / hist.samples : 0),
+                         (unsigned long)stage_histogram_percentile(hist, 50.0),
+                         (unsigned long)stage_histogram_percentile(hist, 90.0),
+                         (unsigned long)stage_histogram_percentile(hist, 99.0),
+                         (unsigned long)stage_histogram_percentile(hist, 99.9),
+                         (unsigned long)hist.max_us);
+    }
+}
+
+// Each stage's task clears its own histogram before its next sample
+void reset_stage_histograms() {
+    for (uint8_t s = 0; s < NUM_PERF_STAGES; s++) {
+        perf_stage_reset[s] = true;
+    }
+}
+
 // Test routines
 void run_frequency_sweep_test() {
     USBSerial.println("\n=== FREQUENCY SWEEP TEST ===");
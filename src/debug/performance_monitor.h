@@ -17,6 +17,28 @@ extern uint32_t g_race_condition_count;
 // Include constants.h for NUM_FREQS definition
 #include "constants.h"
 
+// Stages with a timing histogram (perf_stage_record())
+enum PerfStage : uint8_t {
+    PERF_STAGE_I2S_READ,      // acquire_sample_chunk(), audio task
+    PERF_STAGE_GDFT,          // process_GDFT(), audio task
+    PERF_STAGE_NOVELTY,       // calculate_novelty(), audio task
+    PERF_STAGE_MODE_RENDER,   // render_light_mode(primary_render), LED thread
+    PERF_STAGE_POST_PROCESS,  // show_leds() up to the strip join, LED thread
+    PERF_STAGE_SHOW,          // FastLED.show(), LED thread
+    NUM_PERF_STAGES
+};
+
+// Log-bucketed (HDR-style) histogram of one stage's time: one bucket per
+// microsecond below STAGE_HIST_SUB_BUCKETS, then STAGE_HIST_SUB_BUCKETS
+// per power of two, so a bucket is never wider than 1/8 of its values.
+// Each is written by one task only.
+struct StageHistogram {
+    uint32_t counts[STAGE_HIST_BUCKETS];
+    uint32_t samples;
+    uint32_t max_us;
+    uint64_t total_us;
+};
+
 // Performance tracking structure
 struct PerformanceMetrics {
     // Timing metrics (microseconds)
@@ -56,13 +78,57 @@ struct PerformanceMetrics {
     float fps_avg;
     float cpu_usage;
     uint32_t gdft_time_avg;
+
+    // Every sample of each stage, not just the last
+    StageHistogram stages[NUM_PERF_STAGES];
 };
 
 extern PerformanceMetrics perf_metrics;
+extern volatile bool perf_stage_reset[NUM_PERF_STAGES];  // Set by the serial menu, cleared by the stage's task
 
 // Timing macros
 #define PERF_MONITOR_START() uint32_t _perf_start = micros()
 #define PERF_MONITOR_END(metric) perf_metrics.metric = micros() - _perf_start
+#define PERF_MONITOR_END_STAGE(metric, stage) \
+    do { \
+        perf_metrics.metric = micros() - _perf_start; \
+        perf_stage_record(stage, perf_metrics.metric); \
+    } while(0)
+
+inline uint16_t stage_histogram_bucket(uint32_t us) {
+    if (us > STAGE_HIST_MAX_US) {
+        us = STAGE_HIST_MAX_US;
+    }
+    if (us < STAGE_HIST_SUB_BUCKETS) {
+        return us;
+    }
+    uint8_t shift = (31 - __builtin_clz(us)) - STAGE_HIST_SUB_BITS;
+    return shift * STAGE_HIST_SUB_BUCKETS + (us >> shift);
+}
+
+// Add one sample to a stage's histogram, from the task that runs the stage
+inline void perf_stage_record(PerfStage stage, uint32_t us) {
+    StageHistogram& hist = perf_metrics.stages[stage];
+    if (perf_stage_reset[stage]) {
+        memset(&hist, 0, sizeof(StageHistogram));
+        perf_stage_reset[stage] = false;
+    }
+    hist.counts[stage_histogram_bucket(us)]++;
+    hist.samples++;
+    hist.total_us += us;
+    if (us > hist.max_us) {
+        hist.max_us = us;
+    }
+}
+
+// Upper edge of the bucket holding the given percentile (0.0 - 100.0),
+// capped at max_us, as latency_histogram_percentile() does
+uint32_t stage_histogram_percentile(const StageHistogram& hist, float percentile);
+const char* perf_stage_name(uint8_t stage);
+
+// Serial stage_latency: samples, mean and p50/p90/p99/p99.9/max per stage
+void print_stage_histograms();
+void reset_stage_histograms();
 
 // Initialize performance monitoring
 void init_performance_monitor();
@@ -0,0 +1,272 @@
+#ifndef DEFERRED_LOG_H
+#define DEFERRED_LOG_H
+
+/*----------------------------------------
+  DEFERRED LOGGING
+
+  DLOG("fmt", args...) takes the place of USBSerial.printf() on the
+  audio and LED hot paths. It doesn't format anything: it stores the
+  format string's address, micros() and the raw arguments in this
+  core's ring (deferred_log_rings, globals.h) and returns, a CAS and a
+  few stores, without touching the USB CDC or serial_mutex. The frame
+  being debugged keeps its timing.
+
+  deferred_log_task (tskIDLE_PRIORITY, Core 1) expands the records into
+  text later, oldest first across both cores, and prints them under
+  serial_mutex. The host harness calls drain_deferred_log() once per
+  frame instead.
+
+  Arguments are stored one word each, so the format decides how they
+  read back:
+    %d %i %c       signed / char, up to 32 bits
+    %u %x %X %o    unsigned, up to 32 bits
+    %f %e %g       float (doubles are narrowed to float)
+    %s             const char*; must outlive the drain, so string
+                   literals and other static strings only
+    %p             pointer
+  Length modifiers (%lu, %hhu, ...) are accepted and ignored. 64-bit
+  integers and fixed point don't compile: convert them first.
+
+  A full ring drops the message and counts it; the drain reports the
+  count with the next line it prints.
+  ----------------------------------------*/
+
+#include <stdio.h>
+#include <string.h>
+#include <type_traits>
+#include "globals.h"
+
+#define DEFERRED_LOG_MASK (DEFERRED_LOG_WORDS - 1)
+
+inline uintptr_t deferred_log_arg(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+inline uintptr_t deferred_log_arg(double value) {
+  return deferred_log_arg(float(value));
+}
+
+inline uintptr_t deferred_log_arg(const char* value) {
+  return uintptr_t(value);
+}
+
+inline uintptr_t deferred_log_arg(const void* value) {
+  return uintptr_t(value);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value || std::is_enum<T>::value, uintptr_t>::type
+deferred_log_arg(T value) {
+  static_assert(sizeof(T) <= sizeof(uint32_t), "DLOG: 64-bit integers aren't supported");
+  return uint32_t(value);
+}
+
+// Claim room in this core's ring, write the record, then publish it by
+// storing the (never NULL) format word last
+inline void deferred_log_write(const char* format, const uintptr_t* args, uint8_t arg_count) {
+  DeferredLogRing& ring = deferred_log_rings[xPortGetCoreID() & (DEFERRED_LOG_CORES - 1)];
+  const uint32_t length = DEFERRED_LOG_HEADER_WORDS + arg_count;
+
+  uint32_t head = ring.head.load(std::memory_order_relaxed);
+  do {
+    if (head + length - ring.tail.load(std::memory_order_acquire) > DEFERRED_LOG_WORDS) {
+      ring.dropped.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
+  } while (!ring.head.compare_exchange_weak(head, head + length,
+                                            std::memory_order_acq_rel, std::memory_order_relaxed));
+
+  ring.words[(head + 1) & DEFERRED_LOG_MASK] = micros();
+  ring.words[(head + 2) & DEFERRED_LOG_MASK] = arg_count;
+  for (uint8_t i = 0; i < arg_count; i++) {
+    ring.words[(head + DEFERRED_LOG_HEADER_WORDS + i) & DEFERRED_LOG_MASK] = args[i];
+  }
+  __atomic_store_n(&ring.words[head & DEFERRED_LOG_MASK], uintptr_t(format), __ATOMIC_RELEASE);
+}
+
+template <typename... Args>
+inline void deferred_log(const char* format, Args... args) {
+  static_assert(sizeof...(Args) <= DEFERRED_LOG_MAX_ARGS, "DLOG: too many arguments");
+  const uintptr_t values[] = { deferred_log_arg(args)..., 0 };
+  deferred_log_write(format, values, sizeof...(Args));
+}
+
+// "" format: only string literals, whose address is their ID
+#define DLOG(format, ...) deferred_log("" format, ##__VA_ARGS__)
+
+// printf() one record's arguments back into its format. Conversions
+// without an argument left print as "?"
+inline size_t deferred_log_format(char* out, size_t size, const char* format,
+                                  const uintptr_t* args, uint8_t arg_count) {
+  size_t length = 0;
+  uint8_t next_arg = 0;
+  const char* p = format;
+
+  while (*p != '\0' && length + 1 < size) {
+    if (*p != '%') {
+      out[length++] = *p++;
+      continue;
+    }
+    if (p[1] == '%') {
+      out[length++] = '%';
+      p += 2;
+      continue;
+    }
+
+    // Copy flags, width and precision; drop length modifiers
+    char spec[16];
+    size_t spec_length = 0;
+    spec[spec_length++] = *p++;
+    while (*p != '\0' && strchr("-+ #0123456789.", *p) != NULL && spec_length < sizeof(spec) - 2) {
+      spec[spec_length++] = *p++;
+    }
+    while (*p != '\0' && strchr("hlLjzt", *p) != NULL) {
+      p++;
+    }
+    if (*p == '\0') {
+      break;
+    }
+    char conversion = *p++;
+    spec[spec_length++] = conversion;
+    spec[spec_length] = '\0';
+
+    int written;
+    if (next_arg >= arg_count) {
+      written = snprintf(out + length, size - length, "?");
+    } else {
+      uintptr_t arg = args[next_arg++];
+      switch (conversion) {
+        case 'd': case 'i': case 'c':
+          written = snprintf(out + length, size - length, spec, int(int32_t(uint32_t(arg))));
+          break;
+        case 'u': case 'x': case 'X': case 'o':
+          written = snprintf(out + length, size - length, spec, unsigned(uint32_t(arg)));
+          break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': {
+          uint32_t bits = uint32_t(arg);
+          float value;
+          memcpy(&value, &bits, sizeof(value));
+          written = snprintf(out + length, size - length, spec, double(value));
+          break;
+        }
+        case 's':
+          written = snprintf(out + length, size - length, spec, arg != 0 ? (const char*)arg : "(null)");
+          break;
+        case 'p':
+          written = snprintf(out + length, size - length, spec, (void*)arg);
+          break;
+        default:
+          written = snprintf(out + length, size - length, "?");
+          break;
+      }
+    }
+    if (written < 0) {
+      break;
+    }
+    length += size_t(written);
+    if (length >= size) {
+      length = size - 1;
+    }
+  }
+  out[length] = '\0';
+  return length;
+}
+
+// Oldest published record's timestamp; false if the ring is empty or
+// its next record is still being written
+inline bool deferred_log_peek(DeferredLogRing& ring, uint32_t& timestamp) {
+  uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+  if (tail == ring.head.load(std::memory_order_acquire)) {
+    return false;
+  }
+  if (__atomic_load_n(&ring.words[tail & DEFERRED_LOG_MASK], __ATOMIC_ACQUIRE) == 0) {
+    return false;
+  }
+  timestamp = uint32_t(ring.words[(tail + 1) & DEFERRED_LOG_MASK]);
+  return true;
+}
+
+// Expand the record deferred_log_peek() found, then zero its words
+// before handing them back to the writers
+inline void deferred_log_pop(DeferredLogRing& ring, char* line, size_t size) {
+  uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+  const char* format = (const char*)ring.words[tail & DEFERRED_LOG_MASK];
+  uint8_t arg_count = uint8_t(ring.words[(tail + 2) & DEFERRED_LOG_MASK]);
+  if (arg_count > DEFERRED_LOG_MAX_ARGS) {
+    arg_count = DEFERRED_LOG_MAX_ARGS;
+  }
+
+  uintptr_t args[DEFERRED_LOG_MAX_ARGS];
+  for (uint8_t i = 0; i < arg_count; i++) {
+    args[i] = ring.words[(tail + DEFERRED_LOG_HEADER_WORDS + i) & DEFERRED_LOG_MASK];
+  }
+  deferred_log_format(line, size, format, args, arg_count);
+
+  uint32_t length = DEFERRED_LOG_HEADER_WORDS + arg_count;
+  for (uint32_t i = 0; i < length; i++) {
+    ring.words[(tail + i) & DEFERRED_LOG_MASK] = 0;
+  }
+  ring.tail.store(tail + length, std::memory_order_release);
+}
+
+// Print everything published so far, oldest first across the cores.
+// Returns the number of messages printed
+inline uint32_t drain_deferred_log() {
+  static uint32_t dropped_reported[DEFERRED_LOG_CORES] = {0};
+  static char line[DEFERRED_LOG_LINE_BYTES];
+  uint32_t printed = 0;
+
+  for (;;) {
+    int8_t oldest = -1;
+    uint32_t oldest_timestamp = 0;
+    for (uint8_t core = 0; core < DEFERRED_LOG_CORES; core++) {
+      uint32_t timestamp;
+      if (deferred_log_peek(deferred_log_rings[core], timestamp) &&
+          (oldest == -1 || int32_t(timestamp - oldest_timestamp) < 0)) {
+        oldest = core;
+        oldest_timestamp = timestamp;
+      }
+    }
+    if (oldest == -1) {
+      break;
+    }
+
+    deferred_log_pop(deferred_log_rings[oldest], line, sizeof(line));
+    if (serial_mutex != NULL) {
+      xSemaphoreTake(serial_mutex, portMAX_DELAY);
+    }
+    USBSerial.print(line);
+    if (serial_mutex != NULL) {
+      xSemaphoreGive(serial_mutex);
+    }
+    printed++;
+  }
+
+  for (uint8_t core = 0; core < DEFERRED_LOG_CORES; core++) {
+    uint32_t dropped = deferred_log_rings[core].dropped.load(std::memory_order_relaxed);
+    if (dropped != dropped_reported[core]) {
+      if (serial_mutex != NULL) {
+        xSemaphoreTake(serial_mutex, portMAX_DELAY);
+      }
+      USBSerial.printf("DLOG: %lu messages dropped on core %u (ring full)\n",
+                       (unsigned long)(dropped - dropped_reported[core]), core);
+      if (serial_mutex != NULL) {
+        xSemaphoreGive(serial_mutex);
+      }
+      dropped_reported[core] = dropped;
+    }
+  }
+  return printed;
+}
+
+// Created in setup() next to trace_consumer_task
+inline void deferred_log_task(void* /*param*/) {
+  for (;;) {
+    drain_deferred_log();
+    vTaskDelay(1);
+  }
+}
+
+#endif // DEFERRED_LOG_H
@@ -0,0 +1,104 @@
+#ifndef FRAME_ARENA_H
+#define FRAME_ARENA_H
+
+/*----------------------------------------
+  RENDER RESOLUTION & FRAME ARENA
+
+  Modes draw NATIVE_RESOLUTION pixels, which scale_to_strip() (or the
+  fused strip pass) resamples to CONFIG.LED_COUNT. NATIVE_RESOLUTION
+  is a runtime value: DEFAULT_RENDER_RESOLUTION unless the serial menu
+  saved another (render_resolution=, bridge_fs.h), and it can follow
+  CONFIG.LED_COUNT so no resampling happens at all.
+
+  Every per-pixel render buffer comes out of one allocation made at
+  boot (init_frame_arena(), from init_leds()), sized for render_capacity
+  pixels: the larger of the default and CONFIG.LED_COUNT. Changing the
+  resolution later never reallocates; the LED thread just starts using
+  more or less of each buffer (apply_render_resolution_request(),
+  led_utilities.h).
+
+  Each render context also takes a mode state block here at boot
+  (init_render_context(), render_context.h), big enough for the largest
+  mode's state at render_capacity (light_mode_state_bytes(),
+  lightshow_modes.h). Modes keep their state and per-pixel fields in
+  that block, never in frame_arena_take() calls of their own: the
+  arena is never given back, and the strips render on different cores.
+  ----------------------------------------*/
+
+#include "globals.h"
+
+inline uint32_t light_mode_state_bytes(uint16_t pixels);  // lightshow_modes.h
+
+// Width a saved setting asks for, clamped to what the arena holds
+inline uint16_t resolve_render_resolution(uint16_t setting) {
+  uint16_t width = (setting == RENDER_FOLLOWS_LED_COUNT) ? CONFIG.LED_COUNT : setting;
+  if (width < MIN_RENDER_RESOLUTION) {
+    width = MIN_RENDER_RESOLUTION;
+  }
+  if (width > render_capacity) {
+    width = render_capacity;
+  }
+  return width;
+}
+
+// Pixel distances in the modes (blob widths, scroll speeds) were tuned at
+// DEFAULT_RENDER_RESOLUTION; multiply by this to keep them the same
+// fraction of the strip
+inline float render_scale() {
+  return NATIVE_RESOLUTION / float(DEFAULT_RENDER_RESOLUTION);
+}
+
+// count T's, aligned for T, or NULL once the arena is used up
+template <typename T>
+inline T* frame_arena_take(uint16_t count) {
+  size_t offset = (frame_arena_used + alignof(T) - 1) & ~(alignof(T) - 1);
+  size_t bytes = sizeof(T) * count;
+  if (frame_arena == NULL || offset + bytes > frame_arena_size) {
+    USBSerial.println("ERROR: frame arena exhausted!");
+    return NULL;
+  }
+  frame_arena_used = offset + bytes;
+  return reinterpret_cast<T*>(frame_arena + offset);
+}
+
+// Once at boot, after CONFIG.LED_COUNT is known
+inline void init_frame_arena() {
+  render_capacity = (CONFIG.LED_COUNT > DEFAULT_RENDER_RESOLUTION) ? CONFIG.LED_COUNT : DEFAULT_RENDER_RESOLUTION;
+  if (render_capacity > MAX_RENDER_RESOLUTION) {
+    render_capacity = MAX_RENDER_RESOLUTION;
+  }
+
+  const uint8_t crgb16_buffers = 8;   // leds_16 ... leds_16_fx_secondary, below
+  const uint8_t render_contexts = 2;  // Mode state for primary_render and secondary_render
+  frame_arena_size = render_capacity * (crgb16_buffers * sizeof(CRGB16) + sizeof(SQ15x16))
+                   + render_contexts * (light_mode_state_bytes(render_capacity) + sizeof(uint64_t))
+                   + 64;  // Alignment padding between buffers
+  frame_arena_used = 0;
+  frame_arena = new uint8_t[frame_arena_size];
+  if (frame_arena == nullptr) {
+    USBSerial.println("ERROR: Failed to allocate the frame arena!");
+    ESP.restart();
+  }
+  memset(frame_arena, 0, frame_arena_size);
+
+  leds_16 = frame_arena_take<CRGB16>(render_capacity);
+  leds_16_prev = frame_arena_take<CRGB16>(render_capacity);
+  leds_16_prev_secondary = frame_arena_take<CRGB16>(render_capacity);
+  leds_16_fx = frame_arena_take<CRGB16>(render_capacity);
+  leds_16_temp = frame_arena_take<CRGB16>(render_capacity);
+  leds_16_ui = frame_arena_take<CRGB16>(render_capacity);
+  leds_16_secondary = frame_arena_take<CRGB16>(render_capacity);
+  leds_16_fx_secondary = frame_arena_take<CRGB16>(render_capacity);
+  ui_mask = frame_arena_take<SQ15x16>(render_capacity);
+
+  NATIVE_RESOLUTION = resolve_render_resolution(render_resolution_setting);
+
+  USBSerial.print("FRAME ARENA: ");
+  USBSerial.print(frame_arena_size);
+  USBSerial.print(" bytes, render resolution ");
+  USBSerial.print(NATIVE_RESOLUTION);
+  USBSerial.print(" of ");
+  USBSerial.println(render_capacity);
+}
+
+#endif // FRAME_ARENA_H
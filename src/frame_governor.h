@@ -0,0 +1,157 @@
+#ifndef FRAME_GOVERNOR_H
+#define FRAME_GOVERNOR_H
+
+/*----------------------------------------
+  LED FRAME RATE GOVERNOR
+
+  led_thread starts each frame on a deadline grid, one period
+  (1 / led_frame_rate_setting) apart, and sleeps until the next one
+  once the frame is shown, instead of going round again after one
+  tick. The frame rate is then the setting, not however long
+  FastLED.show() takes to clock the strips out, and the core idles
+  for whatever the frame didn't use:
+
+    deadline n       deadline n+1     deadline n+2
+    |render|show|idle|render|show|idle|render|...
+
+  A frame still showing when its successor was due is late: it's
+  counted (led_frames_late, perf_metrics.dropped_frames) and the grid
+  restarts from now, so a slow frame costs one frame, not a burst of
+  catch-up frames.
+
+  vTaskDelay() only resolves whole ticks (1 ms, up to 40% of a 200 Hz
+  period), so the sleep ends on a one-shot esp_timer armed for the
+  slot itself, which wakes led_thread with a task notification.
+
+  led_frame_rate=max (LED_FRAME_RATE_UNCAPPED) goes back to one tick
+  between frames. Either way led_render_us and led_show_us time the
+  last frame's two halves, from when it actually started (not its
+  slot, which a late wake can have left in the past).
+
+  The grid itself (LedFrameGrid) only sees the times it's given, so
+  sb_dsp_host --check-governor runs it against a fake clock.
+  ----------------------------------------*/
+
+#include "globals.h"
+
+struct LedFrameGrid {
+  uint32_t slot_us;      // This frame's slot on the grid
+  uint32_t start_us;     // When it actually started
+  uint32_t rendered_us;  // publish_frame()
+};
+
+static LedFrameGrid led_frame_grid = { 0, 0, 0 };
+
+// A new grid with its first slot at now_us
+inline void led_frame_grid_restart(LedFrameGrid& grid, uint32_t now_us) {
+  grid.slot_us = now_us;
+  grid.start_us = now_us;
+  grid.rendered_us = now_us;
+}
+
+// Frame published at now_us: returns its render time
+inline uint32_t led_frame_grid_rendered(LedFrameGrid& grid, uint32_t now_us) {
+  grid.rendered_us = now_us;
+  return grid.rendered_us - grid.start_us;
+}
+
+// Frame shown at now_us: moves slot_us on to the next frame's slot and
+// returns true, or returns false if that slot has already gone by (the
+// frame is late) and leaves the grid to be restarted
+inline bool led_frame_grid_advance(LedFrameGrid& grid, uint32_t now_us, uint32_t period_us) {
+  uint32_t next_us = grid.slot_us + period_us;
+  if (int32_t(now_us - next_us) > 0) {
+    return false;
+  }
+  grid.slot_us = next_us;
+  return true;
+}
+
+// Period for the saved rate, or 0 when uncapped
+inline uint32_t led_frame_period_us() {
+  uint16_t rate = led_frame_rate_setting;
+  if (rate == LED_FRAME_RATE_UNCAPPED) {
+    return 0;
+  }
+  if (rate < MIN_LED_FRAME_RATE) {
+    rate = MIN_LED_FRAME_RATE;
+  } else if (rate > MAX_LED_FRAME_RATE) {
+    rate = MAX_LED_FRAME_RATE;
+  }
+  return 1000000 / rate;
+}
+
+static esp_timer_handle_t led_frame_timer = NULL;
+
+static void led_frame_timer_fired(void* task) {
+  xTaskNotifyGive((TaskHandle_t)task);
+}
+
+// Blocks the calling task until micros() reaches slot_us. Without the
+// timer (esp_timer_create() failed) it falls back to whole ticks, and
+// starts up to a tick early.
+inline void sleep_until_led_frame_slot(uint32_t slot_us) {
+  if (led_frame_timer == NULL) {
+    esp_timer_create_args_t timer_args = {};
+    timer_args.callback = led_frame_timer_fired;
+    timer_args.arg = xTaskGetCurrentTaskHandle();
+    timer_args.name = "led_frame";
+    if (esp_timer_create(&timer_args, &led_frame_timer) != ESP_OK) {
+      led_frame_timer = NULL;
+    }
+  }
+
+  // Looped so a stale notification (a timer that fired after the
+  // previous wait timed out) can't start the frame early
+  int32_t wait_us;
+  while ((wait_us = int32_t(slot_us - micros())) > 0) {
+    if (led_frame_timer == NULL || esp_timer_start_once(led_frame_timer, wait_us) != ESP_OK) {
+      TickType_t ticks = wait_us / (portTICK_PERIOD_MS * 1000);
+      if (ticks > 0) {
+        vTaskDelay(ticks);
+      }
+      return;
+    }
+    ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait_us / 1000) + 2);
+    esp_timer_stop(led_frame_timer);  // Already fired unless the wait timed out
+  }
+}
+
+// led_thread, at start and while halted (led_thread_halt): the next
+// frame starts a new grid rather than counting the pause as late
+inline void restart_led_frame_grid() {
+  led_frame_grid_restart(led_frame_grid, micros());
+}
+
+// led_thread, once the frame is published
+inline void led_frame_rendered() {
+  led_render_us = led_frame_grid_rendered(led_frame_grid, micros());
+}
+
+// led_thread, after show_leds(): sleep until the next frame is due
+inline void wait_for_next_led_frame() {
+  uint32_t now_us = micros();
+  led_show_us = now_us - led_frame_grid.rendered_us;
+
+  uint32_t period_us = led_frame_period_us();
+  if (period_us == 0) {
+    vTaskDelay(1);
+    restart_led_frame_grid();
+    return;
+  }
+
+  if (!led_frame_grid_advance(led_frame_grid, now_us, period_us)) {
+    led_frames_late++;
+#ifdef ENABLE_PERFORMANCE_MONITORING
+    perf_metrics.dropped_frames++;
+#endif
+    vTaskDelay(1);  // Still let the idle task run when every frame is late
+    restart_led_frame_grid();
+    return;
+  }
+
+  sleep_until_led_frame_slot(led_frame_grid.slot_us);
+  led_frame_grid.start_us = micros();
+}
+
+#endif // FRAME_GOVERNOR_H
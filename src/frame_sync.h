@@ -14,8 +14,12 @@ inline void begin_frame()
 }
 
 // Publish the fully rendered frame so the LED consumer can safely process it.
+// The audio frame it was rendered from travels with it, for the
+// audio-to-photon latency measured in show_leds() (latency_histogram.h).
 inline void publish_frame()
 {
+  g_frame_audio_seq_ready = led_audio->seq;
+  g_frame_audio_stamp_ready = led_audio->dma_done_us;
   g_frame_seq_ready = g_frame_seq_write;
 }
 
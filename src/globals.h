@@ -3,12 +3,14 @@
 
 #include <stdint.h>        // For standard integer types
 #include <stdbool.h>       // For bool type
+#include <atomic>          // For the audio frame hand-off index
 #include <FixedPoints.h>   // For SQ15x16
 #include <FixedPointsCommon.h> // Required for SQ15x16 typedef
 #include <Ticker.h>        // For Ticker type
 #include <freertos/task.h> // For TaskHandle_t (FreeRTOS task handle)
 #include <freertos/FreeRTOS.h> // For FreeRTOS
 #include <freertos/semphr.h>   // For semaphores/mutexes
+#include <freertos/queue.h>    // For the I2S event queue
 #include <FirmwareMSC.h>   // For FirmwareMSC
 #include <USB.h>           // For USBCDC
 #ifdef ARDUINO_ESP32S3_DEV
@@ -150,7 +152,8 @@ extern bool chromatic_mode;
 // Audio samples (i2s_audio.h) --------------------------------
 
 // MIGRATED TO AudioRawState: int32_t i2s_samples_raw[1024]
-extern short   sample_window[SAMPLE_HISTORY_LENGTH];
+extern short   sample_ring[SAMPLE_HISTORY_LENGTH * 2];  // Mirrored history, read through sample_window.h
+extern uint16_t sample_ring_head;
 extern short   waveform[1024];
 extern SQ15x16 waveform_fixed_point[1024];
 // MIGRATED TO AudioRawState: short waveform_history[4][1024]
@@ -194,33 +197,133 @@ CRGB leds_aux [160];
 CRGB leds_fade[160];
 */
 
-extern CRGB16  leds_16[160];
-extern CRGB16  leds_16_prev[160];
-extern CRGB16  leds_16_prev_secondary[160]; // Buffer for secondary bloom state
-extern CRGB16  leds_16_fx[160];
-// CRGB16  leds_16_fx_2[160]; // Removed to save DRAM
-extern CRGB16  leds_16_temp[160];
-extern CRGB16  leds_16_ui[160];
+// Render resolution and frame arena (frame_arena.h) ---------
+extern uint16_t NATIVE_RESOLUTION;                // Pixels per render buffer this frame (LED thread only)
+extern uint16_t render_capacity;                  // Largest NATIVE_RESOLUTION the arena holds
+extern uint16_t render_resolution_setting;        // Saved value, RENDER_FOLLOWS_LED_COUNT or a width
+extern volatile uint16_t render_resolution_request;  // Set by the serial menu, applied by the LED thread
+extern uint8_t* frame_arena;
+extern size_t frame_arena_size;
+extern size_t frame_arena_used;
+
+// LED frame rate governor (frame_governor.h) ----------------
+extern uint16_t led_frame_rate_setting;  // Saved in /led_rate.bin, Hz or LED_FRAME_RATE_UNCAPPED
+extern uint32_t led_render_us;           // Last frame: start to publish_frame()
+extern uint32_t led_show_us;             // Last frame: show_leds(), strip join and FastLED.show()
+extern uint32_t led_frames_late;         // Frames shown after their deadline
+
+// Output transfer curve (output_curve.h) --------------------
+struct OutputCurve {
+  float gamma;    // Applied to linear 0.0 - 1.0 channels on the way out
+  float gain[3];  // White balance, R / G / B, 0.0 - 1.0
+};
+
+extern OutputCurve output_curve;                  // Saved in /output_curve.bin
+extern volatile bool output_curve_changed;        // Set by the serial menu, applied by the LED thread
+extern uint16_t output_lut[3][OUTPUT_LUT_SIZE];   // 8.8 LED value per channel, shared by both strips
+
+// Every buffer below is NATIVE_RESOLUTION long in use, render_capacity
+// long in memory
+extern CRGB16* leds_16;
+extern CRGB16* leds_16_prev;
+extern CRGB16* leds_16_prev_secondary; // Buffer for secondary bloom state
+extern CRGB16* leds_16_fx;
+extern CRGB16* leds_16_fx_secondary;  // secondary_render.fx
+extern CRGB16* leds_16_temp;
+extern CRGB16* leds_16_ui;
 
 // Frame sequencing handshake between render producer and LED consumer
 extern volatile uint32_t g_frame_seq_write;
 extern volatile uint32_t g_frame_seq_ready;
-extern volatile uint32_t g_frame_seq_shown;
+extern volatile uint32_t g_frame_audio_seq_ready;    // AudioFrame.seq the ready LED frame was rendered from
+extern volatile uint32_t g_frame_audio_stamp_ready;  // ...and that audio frame's dma_done_us
+
+// ------------------------------------------------------------
+// Audio frame snapshots (audio_frame.h) ----------------------
+
+// Everything led_thread() consumes from the audio pipeline, published
+// once per audio frame. Written only by the audio task, read only
+// through led_audio on the LED side.
+struct AudioFrame {
+  uint32_t seq;                  // Publish count, 1 for the first audio frame
+  uint32_t timestamp_us;         // micros() at the start of that audio frame
+  uint32_t dma_done_us;          // micros() when its last I2S DMA buffer completed (i2s_chunk_done_us)
+  SQ15x16  spectrogram[NUM_FREQS];
+  SQ15x16  novelty;              // Newest novelty_curve[] entry
+  SQ15x16  vu_level;             // audio_vu_level
+  SQ15x16  vu_level_average;     // audio_vu_level_average
+  float    waveform_peak_scaled;
+  float    silent_scale;
+  float    current_punch;
+  bool     silence;
+  bool     noise_complete;
+  uint32_t seq_check;            // Copy of seq, written last (torn read detection)
+};
+
+#define AUDIO_FRAME_SLOTS 3
+#define AUDIO_FRAME_INDEX_MASK 0x03
+#define AUDIO_FRAME_FRESH 0x80   // Set in audio_frame_latest until the LED side takes it
+
+extern AudioFrame audio_frames[AUDIO_FRAME_SLOTS];
+extern std::atomic<uint32_t> audio_frame_latest;  // Slot index of the newest frame | AUDIO_FRAME_FRESH
+extern const AudioFrame* led_audio;               // The LED thread's current frame
+extern uint32_t audio_frames_dropped;             // Published, but superseded before the LED side took them
+extern uint32_t audio_frames_repeated;            // LED frames rendered without a new audio frame
 
-// Add state variables for waveform mode instances
-extern CRGB16  waveform_last_color_primary;
-extern CRGB16  waveform_last_color_secondary;
+// ------------------------------------------------------------
+// Audio-to-photon latency (latency_histogram.h) --------------
+
+// DMA completion of an audio chunk -> FastLED.show() returning on the
+// first LED frame rendered from it. Fixed-width buckets, the last one
+// also counts everything above the range.
+struct LatencyHistogram {
+  uint32_t counts[LATENCY_HIST_BUCKETS];
+  uint32_t samples;
+  uint32_t max_us;
+  uint32_t last_us;
+};
+
+extern LatencyHistogram audio_to_photon_latency;   // Written by the LED thread only
+extern volatile bool audio_to_photon_reset;        // Set by the serial menu, cleared by the LED thread
+
+// ------------------------------------------------------------
+// Deferred logging (deferred_log.h) --------------------------
+
+// One ring per core of variable-length records: format pointer,
+// timestamp, argument count, then the raw arguments. head and tail are
+// free-running word counts; words not yet written read as zero.
+struct DeferredLogRing {
+  std::atomic<uint32_t> head;      // Words claimed by writers
+  std::atomic<uint32_t> tail;      // Words released by the drain
+  std::atomic<uint32_t> dropped;   // Messages that didn't fit
+  uintptr_t words[DEFERRED_LOG_WORDS];
+};
 
-extern SQ15x16 ui_mask[160];
+extern DeferredLogRing deferred_log_rings[DEFERRED_LOG_CORES];
+
+extern SQ15x16* ui_mask;
 extern SQ15x16 ui_mask_height;
 
 extern CRGB16 *leds_scaled;
 extern CRGB *leds_out;
 
+// Temporal dither: the part of each 8-bit output channel not yet shown,
+// in 1/65536ths of a step, carried from frame to frame per LED
+struct DitherResidual {
+  uint16_t r;
+  uint16_t g;
+  uint16_t b;
+};
+
+extern DitherResidual *dither_residual;            // [CONFIG.LED_COUNT]
+extern DitherResidual *dither_residual_secondary;  // [SECONDARY_LED_COUNT_CONST]
+
 extern SQ15x16 hue_shift; // Used in auto color cycling
 
 extern uint8_t dither_step;
 
+extern bool led_post_fused;  // show_leds(): fused post-processing (false = staged reference path)
+
 extern bool led_thread_halt;
 
 extern TaskHandle_t led_task;
@@ -363,14 +466,6 @@ extern bool msc_update_started;
 // DOTS
 extern DOT dots[MAX_DOTS];
 
-// Auto Color Shift
-extern SQ15x16 hue_position;
-extern SQ15x16 hue_shift_speed;
-extern SQ15x16 hue_push_direction;
-extern SQ15x16 hue_destination;
-extern SQ15x16 hue_shifting_mix;
-extern SQ15x16 hue_shifting_mix_target;
-
 // VU Calculation
 extern SQ15x16 audio_vu_level;
 extern SQ15x16 audio_vu_level_average;
@@ -404,7 +499,7 @@ inline void unlock_leds(){
 }
 
 // New buffers for secondary LED strip
-extern CRGB16  leds_16_secondary[160];        // Main buffer for secondary strip
+extern CRGB16* leds_16_secondary;             // Main buffer for secondary strip
 extern CRGB16 *leds_scaled_secondary;         // For scaling to actual LED count
 extern CRGB *leds_out_secondary;              // Final output buffer
 
@@ -431,6 +526,18 @@ extern volatile bool g_palette_ready;
 
 // Task handle for audio processing thread
 extern TaskHandle_t audio_task_handle;
+extern TaskHandle_t control_task_handle;
+
+// I2S driver events, one RX_DONE per completed chunk (i2s_audio.h)
+extern QueueHandle_t i2s_event_queue;
+extern uint32_t i2s_event_timeouts;      // AUDIO_EVENT_TIMEOUT_MS passed with no RX_DONE
+extern uint32_t i2s_dma_errors;          // I2S_EVENT_DMA_ERROR / RX_Q_OVF events
+extern uint32_t audio_frame_jitter_us;   // Worst deviation from the nominal hop period since last read
+extern uint32_t i2s_chunk_done_us;       // micros() at the RX_DONE event that completed the current hop
+
+// Analysis hop, samples per audio frame (i2s_audio.h)
+extern uint16_t audio_hop_size;
+extern volatile uint16_t audio_hop_request;  // Set by the control task, applied by the audio task
 
 // FRAME_CONFIG ODR FIX [2025-09-19 17:00] - Declaration for struct defined in globals.cpp
 struct cached_config {
@@ -441,6 +548,8 @@ struct cached_config {
   float SQUARE_ITER;
   float SATURATION;
   uint8_t PALETTE_INDEX;       // Mirror CONFIG.PALETTE_INDEX each frame
+  bool MIRROR_ENABLED;
+  bool AUTO_COLOR_SHIFT;
 
   // Palette cache for atomic switching (prevents race conditions)
   const CRGB16* palette_ptr;   // Pointer to 256-entry CRGB16 LUT (or nullptr if disabled)
@@ -448,4 +557,74 @@ struct cached_config {
 };
 extern struct cached_config frame_config;
 
+// ------------------------------------------------------------
+// Render contexts (render_context.h) --------------------------
+// Everything one strip's light mode reads and keeps between frames
+
+struct ColorShiftState {  // Auto color shift (process_color_shift())
+  SQ15x16 position;       // Hue offset every mode adds
+  SQ15x16 speed;
+  SQ15x16 push_direction;
+  SQ15x16 destination;
+  SQ15x16 shifting_mix;
+  SQ15x16 shifting_mix_target;
+};
+
+struct RenderContext {
+  const char* name;
+
+  // Settings, copied once per frame by cache_frame_config()
+  cached_config config;
+  float prism_count;
+  SQ15x16 chroma_val;    // From config.CHROMA (update_render_chroma())
+  bool chromatic_mode;
+
+  ColorShiftState hue;
+  uint32_t hue_audio_seq;  // Last audio frame the color shift stepped on
+
+  CRGB16* leds;       // Where the mode draws, NATIVE_RESOLUTION pixels
+  CRGB16* leds_prev;  // The mode's last frame (Bloom, Waveform trails)
+  CRGB16* fx;         // Scratch for apply_prism_effect()
+  DOT dots[RENDER_CONTEXT_DOTS];
+
+  // The current mode's state (light_modes[], lightshow_modes.h), in the
+  // context's own slice of the frame arena. Zeroed and handed to the
+  // mode's init hook whenever the context enters a mode
+  uint8_t mode;              // Mode the state belongs to, NUM_MODES = none yet
+  uint8_t* mode_state;
+  uint32_t mode_state_size;
+  uint32_t mode_state_used;  // mode_state_take()'s offset
+};
+
+extern RenderContext primary_render;    // Draws into leds_16
+extern RenderContext secondary_render;  // Draws into leds_16_secondary
+
+// A strip rendered off led_thread (strip_worker.h)
+struct StripJob {
+  RenderContext* ctx;
+  void (*show)();  // Post-processing into the strip's leds_out, e.g. show_secondary_leds()
+};
+
+extern StripJob strip_jobs[MAX_STRIP_JOBS];
+extern uint8_t strip_job_count;
+extern bool strip_jobs_started;       // Handed to the worker, not yet joined
+extern bool strip_render_parallel;    // strip_render= (false runs the jobs on led_thread)
+extern SemaphoreHandle_t strip_jobs_go;
+extern SemaphoreHandle_t strip_jobs_done;
+extern TaskHandle_t strip_worker_task;
+extern uint32_t strip_jobs_us;        // Worker time on the last frame's jobs
+extern uint32_t strip_join_wait_us;   // led_thread time spent waiting for them
+
+// Demand-driven analysis (analysis_demand.h)
+extern volatile uint8_t analysis_demand;  // MODE_INPUT_* the LED thread reads, for the audio task
+extern bool analysis_on_demand;           // analysis= (false runs every stage, every frame)
+extern uint32_t analysis_gdft_skipped;    // Audio frames that skipped the GDFT and novelty
+
+// Binary telemetry stream (telemetry_stream.h)
+extern volatile uint8_t telemetry_channels;  // TELEMETRY_CHANNEL_BIT()s streaming, 0 = off. Not saved
+extern uint16_t telemetry_budget_kbps;       // telemetry_task's output limit, kB/s. Not saved
+
+// Session record / replay (session_record.h)
+extern volatile uint8_t session_state;       // SessionState: idle, recording, replaying, ...
+
 #endif // GLOBALS_H
@@ -13,6 +13,7 @@
 #endif
 
 extern void save_config_delayed();
+extern void session_record_hmi_event(uint8_t encoder, uint8_t click, int32_t rotation);  // session_record.h
 
 #if 0
 
@@ -624,6 +625,7 @@ void DualEncoderController::update(uint32_t now_ms) {
 
     EncoderEvent event;
     while (manager_.popEvent(event)) {
+        session_record_hmi_event(event.encoder_id, static_cast<uint8_t>(event.click), event.rotation);
         if (event.encoder_id == kPrimaryEncoder || event.encoder_id == kSecondaryEncoder) {
             handleChannelEvent(event.encoder_id, event);
         }
@@ -13,14 +13,17 @@ extern SensoryBridge::Audio::AudioRawState audio_raw_state;
 // Phase 2B: Access to AudioProcessedState instance for migration
 extern SensoryBridge::Audio::AudioProcessedState audio_processed_state;
 
+// session= record / replay hook, defined in session_record.h
+void session_audio_samples(int32_t* raw, uint16_t count);
+
 const i2s_config_t i2s_config = {
   .mode = i2s_mode_t(I2S_MODE_MASTER | I2S_MODE_RX),
   .sample_rate = CONFIG.SAMPLE_RATE,
   .bits_per_sample = I2S_BITS_PER_SAMPLE_32BIT,
   .channel_format = I2S_CHANNEL_FMT_ONLY_LEFT,
   .communication_format = I2S_COMM_FORMAT_STAND_I2S,
-  .dma_buf_count = 8,  // Increased from 2 for better double-buffering
-  .dma_buf_len = CONFIG.SAMPLES_PER_CHUNK * 2,  // Larger buffers reduce interrupt overhead
+  .dma_buf_count = I2S_DMA_BUF_COUNT,
+  .dma_buf_len = I2S_DMA_BUF_LEN,  // Small buffers: audio frames are cut from the stream at any hop (wait_for_sample_chunk())
 };
 
 const i2s_pin_config_t pin_config = {
@@ -30,8 +33,64 @@ const i2s_pin_config_t pin_config = {
   .data_in_num = I2S_DIN_PIN
 };
 
+// Analysis hop ----------------------------------------------------------
+//
+// audio_hop_size (globals.h) is the number of samples per audio frame:
+// CONFIG.SAMPLES_PER_CHUNK unless a smaller hop is set (serial
+// hop_size=). VU, GDFT and novelty then run once per hop over the same
+// SAMPLE_HISTORY_LENGTH window, so consecutive analysis windows overlap
+// more and an onset reaches the LEDs after one hop of capture instead
+// of one full chunk.
+
+// Smoothing rates that are applied once per frame were tuned at one
+// frame per CONFIG.SAMPLES_PER_CHUNK. Rescaled for the current hop so
+// their time constants (in seconds) don't change with it.
+struct audio_hop_rates {
+  double magnitude_avg;  // Goertzel magnitude EMA (GDFT.h)
+  double agc_rise;       // AGC peak follower (GDFT.h, GDFT_optimized.h)
+  double agc_fall;
+  double silent_scale;   // Standby dimming fade
+  uint8_t novelty_lookback;  // Frames back that novelty compares against (one chunk's worth)
+};
+
+audio_hop_rates hop_rates = {0.3, 0.0100, 0.0050, 0.1, 1};
+
+double rate_per_hop(double rate) {
+  if (audio_hop_size == CONFIG.SAMPLES_PER_CHUNK) {
+    return rate;
+  }
+  return 1.0 - pow(1.0 - rate, double(audio_hop_size) / CONFIG.SAMPLES_PER_CHUNK);
+}
+
+// Called once at boot (before the GDFT engines are initialized), then
+// only through apply_audio_hop_request()
+void set_audio_hop(uint16_t hop) {
+  audio_hop_size = hop;
+
+  hop_rates.magnitude_avg = rate_per_hop(0.3);
+  hop_rates.agc_rise = rate_per_hop(0.0100);
+  hop_rates.agc_fall = rate_per_hop(0.0050);
+  hop_rates.silent_scale = rate_per_hop(0.1);
+  hop_rates.novelty_lookback = constrain(CONFIG.SAMPLES_PER_CHUNK / hop, 1, SPECTRAL_HISTORY_LENGTH - 1);
+}
+
+// Audio task only, between frames, so no stage sees a half-changed hop.
+// The sliding engine sizes its state by the hop.
+void apply_audio_hop_request() {
+  uint16_t hop = audio_hop_request;
+  if (hop == 0) {
+    return;
+  }
+  audio_hop_request = 0;
+
+  set_audio_hop(hop);
+  init_gdft_sliding();
+}
+
 void init_i2s() {
-  esp_err_t result = i2s_driver_install(I2S_PORT, &i2s_config, 0, NULL);
+  // The driver posts an i2s_event_t per completed DMA buffer; the audio
+  // task sleeps on this queue instead of polling (wait_for_sample_chunk())
+  esp_err_t result = i2s_driver_install(I2S_PORT, &i2s_config, I2S_DMA_BUF_COUNT, &i2s_event_queue);
   USBSerial.print("INIT I2S: ");
   USBSerial.println(result == ESP_OK ? SB_PASS : SB_FAIL);
 
@@ -46,6 +105,45 @@ void init_i2s() {
   USBSerial.println(result == ESP_OK ? SB_PASS : SB_FAIL);
 }
 
+// Blocks the calling task until the I2S driver has completed enough
+// DMA buffers for one hop (audio_hop_size samples ready for
+// acquire_sample_chunk()). Returns false if no buffer arrives within
+// timeout_ms, so the caller can still feed its watchdog.
+//
+// i2s_chunk_done_us is set to when the hop's last buffer completed,
+// the start of the audio-to-photon latency (latency_histogram.h),
+// estimated from the dequeue time minus the RX_DONE backlog.
+bool wait_for_sample_chunk(uint32_t timeout_ms) {
+  static uint32_t samples_ready = 0;  // Completed in DMA, not yet read
+
+  if (samples_ready >= audio_hop_size) {
+    samples_ready -= audio_hop_size;
+    return true;
+  }
+
+  i2s_event_t event;
+  while (xQueueReceive(i2s_event_queue, &event, pdMS_TO_TICKS(timeout_ms)) == pdTRUE) {
+    if (event.type == I2S_EVENT_RX_DONE) {
+      // Every event still queued behind this one is a buffer that has
+      // completed since, so back-date the stamp by them: a task that
+      // fell behind must not hide the latency its backlog adds.
+      uint32_t backlog_samples = uxQueueMessagesWaiting(i2s_event_queue) * I2S_DMA_BUF_LEN;
+      i2s_chunk_done_us = micros() - uint32_t((uint64_t(backlog_samples) * 1000000u) / CONFIG.SAMPLE_RATE);
+      samples_ready += I2S_DMA_BUF_LEN;
+      if (samples_ready >= audio_hop_size) {
+        samples_ready -= audio_hop_size;
+        return true;
+      }
+    }
+    if (event.type == I2S_EVENT_DMA_ERROR || event.type == I2S_EVENT_RX_Q_OVF) {
+      i2s_dma_errors++;
+    }
+  }
+
+  i2s_event_timeouts++;
+  return false;
+}
+
 void acquire_sample_chunk(uint32_t t_now) {
   static int8_t sweet_spot_state_last = 0;
   static bool silence_temp = false;
@@ -56,7 +154,7 @@ void acquire_sample_chunk(uint32_t t_now) {
   static float max_waveform_val_raw_smooth = 0.0; // Added for smoothing
 
   size_t bytes_read = 0;
-  size_t bytes_expected = CONFIG.SAMPLES_PER_CHUNK * sizeof(int32_t);
+  size_t bytes_expected = audio_hop_size * sizeof(int32_t);
 
   // MODIFICATION [2025-09-20 22:45] - SURGICAL-FIX-002: Fix I2S partial reads causing random cutouts
   // FAULT DETECTED: 10ms timeout allows partial I2S reads, causing audio corruption and apparent "cutouts"
@@ -67,18 +165,17 @@ void acquire_sample_chunk(uint32_t t_now) {
   // ROLLBACK PROCEDURE: Restore 10ms timeout if system becomes unresponsive during audio gaps
 
   // Block until we get the full chunk - partial reads cause audio corruption
+  // (called after wait_for_sample_chunk(), so the hop is already in DMA buffers)
   i2s_read(I2S_PORT, audio_raw_state.getRawSamples(), bytes_expected, &bytes_read, portMAX_DELAY);
+  session_audio_samples(audio_raw_state.getRawSamples(), audio_hop_size);  // session= record / replay (session_record.h)
 
   // Validate we got a complete read (should always be true with portMAX_DELAY)
   if (bytes_read != bytes_expected) {
-    USBSerial.printf("WARNING: I2S partial read! Got %d bytes, expected %d\n", bytes_read, bytes_expected);
+    DLOG("WARNING: I2S partial read! Got %u bytes, expected %u\n", unsigned(bytes_read), unsigned(bytes_expected));
   }
 
   if (debug_mode && (t_now % 5000 == 0)) {
-    USBSerial.print("DEBUG: Bytes read from I2S: ");
-    USBSerial.print(bytes_read);
-    USBSerial.print(" Max raw value: ");
-    USBSerial.println(max_waveform_val_raw);
+    DLOG("DEBUG: Bytes read from I2S: %u Max raw value: %.2f\n", unsigned(bytes_read), max_waveform_val_raw);
   }
 
   max_waveform_val = 0.0;
@@ -86,7 +183,7 @@ void acquire_sample_chunk(uint32_t t_now) {
   // Phase 2A: Replace waveform_history_index with AudioRawState method
   audio_raw_state.advanceHistoryIndex();
 
-  for (uint16_t i = 0; i < CONFIG.SAMPLES_PER_CHUNK; i++) {
+  for (uint16_t i = 0; i < audio_hop_size; i++) {
     // MODIFICATION [2025-09-20 23:30] - PUNCH-RESTORE-001: Fix I2S audio scaling corruption
     // FAULT DETECTED: Non-linear scaling with magic constants causing signal chaos
     // ROOT CAUSE: Complex scaling formula creating erratic waveform spikes (-27K to +27K)
@@ -141,9 +238,9 @@ void acquire_sample_chunk(uint32_t t_now) {
 
   if (stream_audio) {
     USBSerial.print("sbs((audio=");
-    for (uint16_t i = 0; i < CONFIG.SAMPLES_PER_CHUNK; i++) {
+    for (uint16_t i = 0; i < audio_hop_size; i++) {
       USBSerial.print(waveform[i]);
-      if (i < CONFIG.SAMPLES_PER_CHUNK - 1) {
+      if (i < audio_hop_size - 1) {
         USBSerial.print(',');
       }
     }
@@ -234,30 +331,26 @@ void acquire_sample_chunk(uint32_t t_now) {
                      if (agc_delta > 50.0) {
                          min_silent_level_tracker = SQ15x16(AGC_FLOOR_INITIAL_RESET);
                          if (debug_mode) {
-                             USBSerial.print("DEBUG: AGC Floor Tracker Reset (deadband met): raw_val=");
-                             USBSerial.print(max_waveform_val_raw);
-                             USBSerial.print(" threshold=");
-                             USBSerial.println(threshold_silence); // Use pre-calculated threshold
+                             DLOG("DEBUG: AGC Floor Tracker Reset (deadband met): raw_val=%.2f threshold=%.2f\n",
+                                  max_waveform_val_raw, threshold_silence); // Use pre-calculated threshold
                          }
                      } else {
                          if (debug_mode) {
-                             USBSerial.print("DEBUG: AGC Floor Tracker not reset due to deadband, delta=");
-                             USBSerial.println(agc_delta);
+                             DLOG("DEBUG: AGC Floor Tracker not reset due to deadband, delta=%.2f\n", agc_delta);
                          }
                      }
                 }
 
                 if (debug_mode) {
-                    USBSerial.println("DEBUG: Entered silent state (Hysteresis Passed)");
-                    USBSerial.print("  max_waveform_val_raw: "); USBSerial.print(max_waveform_val_raw);
-                    USBSerial.print("  MIN_LEVEL threshold: "); USBSerial.println(threshold_silence); // Use pre-calculated threshold
+                    DLOG("DEBUG: Entered silent state (Hysteresis Passed)\n"
+                         "  max_waveform_val_raw: %.2f  MIN_LEVEL threshold: %.2f\n",
+                         max_waveform_val_raw, threshold_silence); // Use pre-calculated threshold
                 }
             } else {
                 if (debug_mode) {
-                   USBSerial.print("DEBUG: Entered ");
-                   USBSerial.print(sweet_spot_state == 1 ? "loud" : "normal");
-                   USBSerial.print(" state (Hysteresis Passed), delta=");
-                   USBSerial.println(max_waveform_val_raw - threshold_silence); // Use pre-calculated threshold
+                   DLOG("DEBUG: Entered %s state (Hysteresis Passed), delta=%.2f\n",
+                        sweet_spot_state == 1 ? "loud" : "normal",
+                        max_waveform_val_raw - threshold_silence); // Use pre-calculated threshold
                 }
             }
         }
@@ -272,7 +365,7 @@ void acquire_sample_chunk(uint32_t t_now) {
             min_silent_level_tracker = fmin_fixed(min_silent_level_tracker, SQ15x16(AGC_FLOOR_INITIAL_RESET));
         }
          if (debug_mode && (t_now % 1000 == 0)) {
-             USBSerial.print("DEBUG (Silence): AGC Floor Tracker Value: "); USBSerial.println(float(min_silent_level_tracker));
+             DLOG("DEBUG (Silence): AGC Floor Tracker Value: %.2f\n", float(min_silent_level_tracker));
          }
     }
 
@@ -281,7 +374,7 @@ void acquire_sample_chunk(uint32_t t_now) {
 
     if (loud_sound_detected) {
         if (silence && debug_mode) {
-             USBSerial.println("DEBUG: Silence broken by loud sound");
+             DLOG("DEBUG: Silence broken by loud sound\n");
         }
         silence = false;
         silence_temp = false;
@@ -297,7 +390,7 @@ void acquire_sample_chunk(uint32_t t_now) {
          // ROLLBACK PROCEDURE: Restore 10000ms if false triggering occurs
          if (t_now - silence_switched >= 1500) {
             if (!silence && debug_mode) {
-                USBSerial.println("DEBUG: Extended silence detected (1.5s)");
+                DLOG("DEBUG: Extended silence detected (1.5s)\n");
             }
             silence = true;
          }
@@ -307,32 +400,26 @@ void acquire_sample_chunk(uint32_t t_now) {
     }
 
     if (debug_mode && (t_now % 10000 == 0)) {
-      USBSerial.print("DEBUG: silent_scale=");
-      USBSerial.print(float(silent_scale));
-      USBSerial.print(" silence=");
-      USBSerial.print(silence ? "true" : "false");
-      USBSerial.print(" sweet_spot_state=");
-      USBSerial.println(sweet_spot_state);
+      DLOG("DEBUG: silent_scale=%.2f silence=%s sweet_spot_state=%.2f\n",
+           float(silent_scale), silence ? "true" : "false", sweet_spot_state);
     }
 
     if (CONFIG.STANDBY_DIMMING) {
       float silent_scale_raw = silence ? 0.0 : 1.0;
-      silent_scale = silent_scale_raw * 0.1 + silent_scale_last * 0.9;
+      silent_scale = silent_scale_raw * hop_rates.silent_scale + silent_scale_last * (1.0 - hop_rates.silent_scale);
       silent_scale_last = silent_scale;
     } else {
       silent_scale = 1.0;
     }
 
-    for (int i = 0; i < SAMPLE_HISTORY_LENGTH - CONFIG.SAMPLES_PER_CHUNK; i++) {
-      sample_window[i] = sample_window[i + CONFIG.SAMPLES_PER_CHUNK];
-    }
-    for (int i = SAMPLE_HISTORY_LENGTH - CONFIG.SAMPLES_PER_CHUNK; i < SAMPLE_HISTORY_LENGTH; i++) {
-      sample_window[i] = waveform[i - (SAMPLE_HISTORY_LENGTH - CONFIG.SAMPLES_PER_CHUNK)];
-    }
+    // Advance the sliding GDFT before the outgoing samples are overwritten (GDFT_sliding.h)
+    gdft_sliding_push(sample_window_base(), waveform, audio_hop_size);
+
+    sample_window_append(waveform, audio_hop_size);
 
     // Pre-calculate reciprocal for fixed-point conversion
     const SQ15x16 RECIP_32768 = SQ15x16(1.0 / 32768.0);
-    for (uint16_t i = 0; i < CONFIG.SAMPLES_PER_CHUNK; i++) {
+    for (uint16_t i = 0; i < audio_hop_size; i++) {
       // Convert using multiplication instead of division
       waveform_fixed_point[i] = SQ15x16(waveform[i]) * RECIP_32768;
     }
@@ -340,9 +427,8 @@ void acquire_sample_chunk(uint32_t t_now) {
     sweet_spot_state_last = sweet_spot_state;
 
     if (debug_mode && (t_now % 2000 == 0)) {
-        USBSerial.print("DEBUG (State): sweet_spot_state="); USBSerial.print(sweet_spot_state);
-        USBSerial.print(" | max_waveform_val_raw="); USBSerial.print(max_waveform_val_raw);
-        USBSerial.print(" | silence_threshold="); USBSerial.println(threshold_silence); // Use pre-calculated threshold
+        DLOG("DEBUG (State): sweet_spot_state=%.2f | max_waveform_val_raw=%.2f | silence_threshold=%.2f\n",
+             sweet_spot_state, max_waveform_val_raw, threshold_silence); // Use pre-calculated threshold
     }
   }
 }
@@ -371,7 +457,7 @@ void calculate_vu() {
 
   float sum = 0.0;
 
-  for (uint16_t i = 0; i < CONFIG.SAMPLES_PER_CHUNK; i++) {
+  for (uint16_t i = 0; i < audio_hop_size; i++) {
     sum += float(waveform_fixed_point[i] * waveform_fixed_point[i]);
   }
 
@@ -382,7 +468,7 @@ void calculate_vu() {
   // IMPACT ASSESSMENT: VU levels will show proper amplitude for visualization
   // VALIDATION METHOD: Monitor typical music shows VU of 0.05-0.2 instead of 0.007
   // ROLLBACK PROCEDURE: Reduce gain if VU levels clip above 1.0
-  SQ15x16 rms = sqrt(float(sum / CONFIG.SAMPLES_PER_CHUNK));
+  SQ15x16 rms = sqrt(float(sum / audio_hop_size));
   audio_vu_level = rms * SQ15x16(10.0);  // Apply gain to compensate for scaling losses
 
   // MODIFICATION [2025-09-20 23:45] - CRITICAL-FIX-001: Fix noise floor calibration killing all audio
@@ -400,8 +486,8 @@ void calculate_vu() {
       if (CONFIG.VU_LEVEL_FLOOR > 0.002f) {
         CONFIG.VU_LEVEL_FLOOR = 0.002f;  // Maximum floor to preserve audio sensitivity
       }
-      USBSerial.printf("NOISE_CAL: Updated VU floor from %.4f to %.4f (rms=%.4f)\n",
-                       old_floor, CONFIG.VU_LEVEL_FLOOR, float(audio_vu_level));
+      DLOG("NOISE_CAL: Updated VU floor from %.4f to %.4f (rms=%.4f)\n",
+           old_floor, CONFIG.VU_LEVEL_FLOOR, float(audio_vu_level));
     }
   } else {
     // MODIFICATION [2025-09-20 22:45] - SURGICAL-FIX-003: Fix VU level calculation stuck at 0.00
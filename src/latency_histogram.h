@@ -0,0 +1,82 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+/*----------------------------------------
+  AUDIO-TO-PHOTON LATENCY
+
+  Every audio frame carries the micros() at which its last I2S DMA
+  buffer completed (AudioFrame.dma_done_us, from wait_for_sample_chunk()).
+  The LED thread copies that stamp into the frame it renders from it
+  (publish_frame(), frame_sync.h), and show_leds() records the time
+  from the stamp to FastLED.show() returning here.
+
+  Only the first LED frame rendered from each audio frame is counted:
+  later ones just repeat the same audio, and that isn't the latency
+  anyone sees.
+  ----------------------------------------*/
+
+#include "globals.h"
+#include "performance_optimized_trace.h"
+
+inline void latency_histogram_clear(LatencyHistogram& hist) {
+  memset(&hist, 0, sizeof(LatencyHistogram));
+}
+
+inline void latency_histogram_add(LatencyHistogram& hist, uint32_t latency_us) {
+  uint32_t bucket = latency_us / LATENCY_HIST_BUCKET_US;
+  if (bucket >= LATENCY_HIST_BUCKETS) {
+    bucket = LATENCY_HIST_BUCKETS - 1;
+  }
+  hist.counts[bucket]++;
+  hist.samples++;
+  hist.last_us = latency_us;
+  if (latency_us > hist.max_us) {
+    hist.max_us = latency_us;
+  }
+}
+
+// Upper edge of the bucket holding the given percentile (0.0 - 100.0),
+// so the result is never lower than the true value. Capped at max_us.
+inline uint32_t latency_histogram_percentile(const LatencyHistogram& hist, float percentile) {
+  if (hist.samples == 0) {
+    return 0;
+  }
+
+  uint32_t target = ceilf(hist.samples * (percentile / 100.0f));
+  if (target < 1) {
+    target = 1;
+  }
+
+  uint32_t seen = 0;
+  for (uint16_t i = 0; i < LATENCY_HIST_BUCKETS; i++) {
+    seen += hist.counts[i];
+    if (seen >= target) {
+      uint32_t edge_us = (i + 1) * LATENCY_HIST_BUCKET_US;
+      return edge_us < hist.max_us ? edge_us : hist.max_us;
+    }
+  }
+  return hist.max_us;
+}
+
+// LED thread, right after FastLED.show() for a newly published frame
+inline void record_audio_to_photon(uint32_t t_shown_us) {
+  static uint32_t last_audio_seq = 0;
+
+  if (audio_to_photon_reset) {
+    latency_histogram_clear(audio_to_photon_latency);
+    audio_to_photon_reset = false;
+  }
+
+  uint32_t audio_seq = g_frame_audio_seq_ready;
+  if (audio_seq == 0 || audio_seq == last_audio_seq) {
+    return;  // No audio yet, or this audio frame already reached the LEDs
+  }
+  last_audio_seq = audio_seq;
+
+  uint32_t latency_us = t_shown_us - g_frame_audio_stamp_ready;
+  latency_histogram_add(audio_to_photon_latency, latency_us);
+
+  TRACE_EVENT(TRACE_CAT_LED | TRACE_CAT_PERF, LED_PHOTON_LATENCY, latency_us);
+}
+
+#endif // LATENCY_HISTOGRAM_H
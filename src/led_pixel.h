@@ -0,0 +1,168 @@
+#ifndef LED_PIXEL_H
+#define LED_PIXEL_H
+
+/*----------------------------------------
+  LED PIXEL CHANNELS
+
+  CRGB16 holds each linear 0.0 - 1.0 colour channel in a led_channel_t.
+  By default that's a PixelChannel: unsigned 1.15 fixed point packed in
+  16 bits, so a pixel is 6 bytes instead of the 12 of three SQ15x16s,
+  and every blend, fade and copy moves half the memory.
+
+  PixelChannel stores 0.0 - 2.0 and saturates there: negative results
+  store as 0.0, and overshoot up to 2x survives until clip_led_values(). All
+  arithmetic on a channel happens in SQ15x16, so rendering code reads
+  the same as it did with SQ15x16 channels; only the store is narrower.
+
+  Build with -DLED_PIXEL_WIDE to go back to SQ15x16 channels (A/B
+  comparison, or a mode that needs negative or >2.0 intermediates).
+
+  The pixel_* helpers at the bottom work on the packed values directly
+  (no SQ15x16 round trip) for the hot blend / fade / add loops.
+  ----------------------------------------*/
+
+#include <stdint.h>
+#include <FixedPoints.h>
+#include <FixedPointsCommon.h>
+
+class PixelChannel {
+ public:
+  static constexpr uint16_t ONE = 0x8000;
+
+  PixelChannel() = default;
+  constexpr PixelChannel(SQ15x16 value) : raw(from_fixed(value)) {}
+  constexpr PixelChannel(double value) : raw(from_fixed(SQ15x16(value))) {}
+  constexpr PixelChannel(float value) : raw(from_fixed(SQ15x16(value))) {}
+  constexpr PixelChannel(int value) : raw(from_fixed(SQ15x16(value))) {}
+
+  static constexpr PixelChannel fromInternal(uint16_t value) { return PixelChannel(value, 0); }
+  constexpr uint16_t getInternal() const { return raw; }
+
+  constexpr operator SQ15x16() const { return SQ15x16::fromInternal(int32_t(raw) << 1); }
+  constexpr explicit operator float() const { return float(SQ15x16(*this)); }
+  constexpr explicit operator double() const { return double(SQ15x16(*this)); }
+
+  constexpr int16_t getInteger() const { return raw >> 15; }
+
+  PixelChannel& operator+=(SQ15x16 other) { return *this = SQ15x16(*this) + other; }
+  PixelChannel& operator-=(SQ15x16 other) { return *this = SQ15x16(*this) - other; }
+  PixelChannel& operator*=(SQ15x16 other) { return *this = SQ15x16(*this) * other; }
+  PixelChannel& operator/=(SQ15x16 other) { return *this = SQ15x16(*this) / other; }
+
+ private:
+  constexpr PixelChannel(uint16_t value, int) : raw(value) {}
+
+  // Round to nearest, saturate to 0.0 - 2.0
+  static constexpr uint16_t from_fixed(SQ15x16 value) {
+    return (value.getInternal() <= 0) ? 0
+         : (value.getInternal() >= 0x1FFFF) ? 0xFFFF
+         : uint16_t((value.getInternal() + 1) >> 1);
+  }
+
+  uint16_t raw;
+};
+
+// Mixed arithmetic and comparisons, all in SQ15x16 (SQ15x16's own
+// operators are templates, so they don't see the conversion above)
+#define LED_CHANNEL_OPERATOR(op)                                                                         \
+  inline SQ15x16 operator op(PixelChannel a, PixelChannel b) { return SQ15x16(a) op SQ15x16(b); }                   \
+  inline SQ15x16 operator op(PixelChannel a, SQ15x16 b) { return SQ15x16(a) op b; }                           \
+  inline SQ15x16 operator op(SQ15x16 a, PixelChannel b) { return a op SQ15x16(b); }                           \
+  inline SQ15x16 operator op(PixelChannel a, double b) { return SQ15x16(a) op SQ15x16(b); }                   \
+  inline SQ15x16 operator op(double a, PixelChannel b) { return SQ15x16(a) op SQ15x16(b); }                   \
+  inline SQ15x16 operator op(PixelChannel a, int b) { return SQ15x16(a) op SQ15x16(b); }                      \
+  inline SQ15x16 operator op(int a, PixelChannel b) { return SQ15x16(a) op SQ15x16(b); }
+
+#define LED_CHANNEL_COMPARISON(op)                                                                       \
+  inline bool operator op(PixelChannel a, PixelChannel b) { return a.getInternal() op b.getInternal(); }            \
+  inline bool operator op(PixelChannel a, SQ15x16 b) { return SQ15x16(a) op b; }                              \
+  inline bool operator op(SQ15x16 a, PixelChannel b) { return a op SQ15x16(b); }                              \
+  inline bool operator op(PixelChannel a, double b) { return SQ15x16(a) op SQ15x16(b); }                      \
+  inline bool operator op(double a, PixelChannel b) { return SQ15x16(a) op SQ15x16(b); }                      \
+  inline bool operator op(PixelChannel a, int b) { return SQ15x16(a) op SQ15x16(b); }                         \
+  inline bool operator op(int a, PixelChannel b) { return SQ15x16(a) op SQ15x16(b); }
+
+LED_CHANNEL_OPERATOR(+)
+LED_CHANNEL_OPERATOR(-)
+LED_CHANNEL_OPERATOR(*)
+LED_CHANNEL_OPERATOR(/)
+LED_CHANNEL_COMPARISON(==)
+LED_CHANNEL_COMPARISON(!=)
+LED_CHANNEL_COMPARISON(<)
+LED_CHANNEL_COMPARISON(<=)
+LED_CHANNEL_COMPARISON(>)
+LED_CHANNEL_COMPARISON(>=)
+
+#undef LED_CHANNEL_OPERATOR
+#undef LED_CHANNEL_COMPARISON
+
+inline SQ15x16 operator-(PixelChannel a) { return -SQ15x16(a); }
+
+#ifdef LED_PIXEL_WIDE
+typedef SQ15x16 led_channel_t;  // 4 bytes per channel, signed
+#else
+typedef PixelChannel led_channel_t;   // 2 bytes per channel, 0.0 - 2.0
+#endif
+
+struct CRGB16 {  // Linear colour channels, 0.0 - 1.0 (led_channel_t)
+  led_channel_t r;
+  led_channel_t g;
+  led_channel_t b;
+};
+
+// Saturating pixel helpers ---------------------------------------------
+
+#ifndef LED_PIXEL_WIDE
+// a + b, per channel
+inline CRGB16 pixel_add(CRGB16 a, CRGB16 b) {
+  uint32_t r = uint32_t(a.r.getInternal()) + b.r.getInternal();
+  uint32_t g = uint32_t(a.g.getInternal()) + b.g.getInternal();
+  uint32_t bl = uint32_t(a.b.getInternal()) + b.b.getInternal();
+  return CRGB16{PixelChannel::fromInternal(r > 0xFFFF ? 0xFFFF : r),
+                PixelChannel::fromInternal(g > 0xFFFF ? 0xFFFF : g),
+                PixelChannel::fromInternal(bl > 0xFFFF ? 0xFFFF : bl)};
+}
+
+// a * scale, per channel (scale >= 0.0)
+inline CRGB16 pixel_scale(CRGB16 a, SQ15x16 scale) {
+  if (scale <= SQ15x16(0.0)) {
+    return CRGB16{0, 0, 0};
+  }
+  uint64_t s = uint32_t(scale.getInternal());
+  uint64_t r = (a.r.getInternal() * s + 0x8000) >> 16;
+  uint64_t g = (a.g.getInternal() * s + 0x8000) >> 16;
+  uint64_t b = (a.b.getInternal() * s + 0x8000) >> 16;
+  return CRGB16{PixelChannel::fromInternal(r > 0xFFFF ? 0xFFFF : r),
+                PixelChannel::fromInternal(g > 0xFFFF ? 0xFFFF : g),
+                PixelChannel::fromInternal(b > 0xFFFF ? 0xFFFF : b)};
+}
+
+// a * b, per channel (1.0 * 1.0 = 1.0)
+inline CRGB16 pixel_multiply(CRGB16 a, CRGB16 b) {
+  uint32_t r = (uint32_t(a.r.getInternal()) * b.r.getInternal() + 0x4000) >> 15;
+  uint32_t g = (uint32_t(a.g.getInternal()) * b.g.getInternal() + 0x4000) >> 15;
+  uint32_t bl = (uint32_t(a.b.getInternal()) * b.b.getInternal() + 0x4000) >> 15;
+  return CRGB16{PixelChannel::fromInternal(r > 0xFFFF ? 0xFFFF : r),
+                PixelChannel::fromInternal(g > 0xFFFF ? 0xFFFF : g),
+                PixelChannel::fromInternal(bl > 0xFFFF ? 0xFFFF : bl)};
+}
+#else
+inline CRGB16 pixel_add(CRGB16 a, CRGB16 b) {
+  return CRGB16{a.r + b.r, a.g + b.g, a.b + b.b};
+}
+
+inline CRGB16 pixel_scale(CRGB16 a, SQ15x16 scale) {
+  return CRGB16{a.r * scale, a.g * scale, a.b * scale};
+}
+
+inline CRGB16 pixel_multiply(CRGB16 a, CRGB16 b) {
+  return CRGB16{a.r * b.r, a.g * b.g, a.b * b.b};
+}
+#endif
+
+// a * (1.0 - mix) + b * mix, per channel (mix 0.0 - 1.0)
+inline CRGB16 pixel_mix(CRGB16 a, CRGB16 b, SQ15x16 mix) {
+  return pixel_add(pixel_scale(a, SQ15x16(1.0) - mix), pixel_scale(b, mix));
+}
+
+#endif // LED_PIXEL_H
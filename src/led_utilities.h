@@ -47,10 +47,14 @@ inline T fmin_fixed(T a, U b) {
 extern float random_float();
 #include "globals.h" // Assuming globals contains necessary definitions
 #include "frame_sync.h"
+#include "frame_arena.h"
+#include "render_context.h"
+#include "output_curve.h"
 #ifndef DEBUG_BUILD
 #define DEBUG_BUILD 1
 #endif
 #include "performance_optimized_trace.h"
+#include "latency_histogram.h"
 #include "constants.h" // Assuming constants contains necessary definitions
 // Local definitions to avoid including sb_strings.h and causing redefinition issues
 #define SB_PASS "PASS"
@@ -67,6 +71,8 @@ extern void start_noise_cal();
   extern HWCDC USBSerial;
 #endif
 
+#include "deferred_log.h" // DLOG() for the per-frame debug output
+
 // Forward declarations for secondary LED functions
 inline void scale_to_secondary_strip();
 inline void apply_brightness_secondary();
@@ -74,6 +80,9 @@ inline void show_secondary_leds();
 inline void init_secondary_leds();
 inline void quantize_color_secondary(bool temporal_dither);
 
+// The other strips' render and show_secondary_leds() (strip_worker.h)
+void finish_strip_jobs();
+
 // Forward declarations for internal functions needed before their implementations
 inline CRGB16 adjust_hue_and_saturation(CRGB16 color, SQ15x16 hue, SQ15x16 saturation);
 
@@ -84,14 +93,14 @@ inline void log_pipeline_addresses(uint32_t frame_count) {
   if ((frame_count & 0x3F) != 0) {
     return;
   }
-  USBSerial.printf("[ADDR] frame=%u S1=%p S2=%p S3=%p S4=%p S5_src=%p S5_dst=%p\n",
-                   frame_count,
-                   static_cast<void*>(leds_16),
-                   static_cast<void*>(leds_16),
-                   static_cast<void*>(leds_16),
-                   static_cast<void*>(leds_scaled),
-                   static_cast<void*>(leds_scaled),
-                   static_cast<void*>(leds_out));
+  DLOG("[ADDR] frame=%u S1=%p S2=%p S3=%p S4=%p S5_src=%p S5_dst=%p\n",
+       frame_count,
+       static_cast<void*>(leds_16),
+       static_cast<void*>(leds_16),
+       static_cast<void*>(leds_16),
+       static_cast<void*>(leds_scaled),
+       static_cast<void*>(leds_scaled),
+       static_cast<void*>(leds_out));
 }
 
 inline bool leds_any_nonzero(const CRGB16* buffer, uint16_t count)
@@ -347,7 +356,9 @@ inline CRGB16 lerp_led_16(SQ15x16 index, CRGB16* led_array) {
   return out_col;
 }
 
-inline void apply_brightness() {
+// Global brightness for this frame (boot fade-in, PHOTONS, standby
+// dimming and the floor). Advances the fade-in, so call once per frame.
+inline SQ15x16 update_frame_brightness() {
   // This is only used to fade in when booting!
   if (millis() >= 1000 && noise_transition_queued == false && mode_transition_queued == false) {
     if (MASTER_BRIGHTNESS < 1.0) {
@@ -361,7 +372,7 @@ inline void apply_brightness() {
   // CRITICAL BRIGHTNESS FIX [2025-09-20] - Remove PHOTONS squaring that crushes colors
   // ROOT CAUSE: PHOTONS² was reducing brightness by up to 75% (0.5² = 0.25)
   // SOLUTION: Use linear PHOTONS scaling to match user expectations
-  SQ15x16 brightness = MASTER_BRIGHTNESS * CONFIG.PHOTONS * silent_scale;
+  SQ15x16 brightness = MASTER_BRIGHTNESS * CONFIG.PHOTONS * led_audio->silent_scale;
 
   // Single global floor (replaces all scattered floors throughout the pipeline)
   // Keep small (3%) to preserve low-end detail; adjust only if hardware flicker requires it
@@ -375,24 +386,22 @@ inline void apply_brightness() {
     const uint8_t raw8 = uint8_t(constrain(brightness_f * 255.0f + 0.5f, 0.0f, 255.0f));
     const uint16_t raw16 = uint16_t(constrain(brightness_f * 65535.0f + 0.5f, 0.0f, 65535.0f));
 
-    USBSerial.print("DEBUG: Brightness components - MASTER_BRIGHTNESS: ");
-    USBSerial.print(MASTER_BRIGHTNESS);
-    USBSerial.print(" PHOTONS: ");
-    USBSerial.print(CONFIG.PHOTONS);
-    USBSerial.print(" silent_scale: ");
-    USBSerial.print(float(silent_scale));
-    USBSerial.print(" Final brightness (SQ15x16): ");
-    USBSerial.print(brightness_f, 4);
-    USBSerial.print(" raw8: ");
-    USBSerial.print(raw8);
-    USBSerial.print(" raw16: ");
-    USBSerial.println(raw16);
+    DLOG("DEBUG: Brightness components - MASTER_BRIGHTNESS: %.2f PHOTONS: %.2f silent_scale: %.2f"
+         " Final brightness (SQ15x16): %.4f raw8: %u raw16: %u\n",
+         float(MASTER_BRIGHTNESS), float(CONFIG.PHOTONS), float(led_audio->silent_scale),
+         brightness_f, raw8, raw16);
   }
 
   uint16_t brightness_linear = (brightness * SQ15x16(255)).getInteger();
   uint16_t brightness_raw = brightness.getInteger();
   TRACE_WARNING(PERF_HIGH_LATENCY, (uint32_t(brightness_linear) << 16) | brightness_raw);
 
+  return brightness;
+}
+
+inline void apply_brightness() {
+  SQ15x16 brightness = update_frame_brightness();
+
   for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
     leds_16[i].r *= brightness;
     leds_16[i].g *= brightness;
@@ -402,60 +411,56 @@ inline void apply_brightness() {
   clip_led_values(leds_16);
 }
 
-inline void quantize_color(bool temporal_dithering) {
-  if (temporal_dithering) {
-    dither_step++;
-    if (dither_step >= 8) {  // Updated for 8-frame dithering
-      dither_step = 0;
-    }
-
-    static uint8_t noise_origin_r = 0;  // 0
-    static uint8_t noise_origin_g = 0;  // 2
-    static uint8_t noise_origin_b = 0;  // 4
+// TEMPORAL DITHER ------------------------------------------------------
+//
+// Sigma-delta: each LED channel keeps the fraction of an 8-bit step it
+// couldn't show (DitherResidual, 16 bits) and adds it to the next
+// frame's fraction; whenever that carries past a whole step, the LED
+// shows one step brighter. Over a few frames the average output equals
+// the output curve's 8.8 value, so slow fades at low brightness step
+// smoothly instead of banding. A table lookup and integer adds only.
 
-    noise_origin_r += 1;
-    noise_origin_g += 1;
-    noise_origin_b += 1;
-
-    for (uint16_t i = 0; i < CONFIG.LED_COUNT; i += 1) {
-      // RED #####################################################
-      SQ15x16 decimal_r = leds_scaled[i].r * SQ15x16(255);
-      SQ15x16 whole_r = decimal_r.getInteger();
-      SQ15x16 fract_r = decimal_r - whole_r;
-
-      if (fract_r >= dither_table[(noise_origin_r + i) % 8]) {
-        whole_r += SQ15x16(1);
-      }
-
-      leds_out[i].r = whole_r.getInteger();
-
-      // GREEN ###################################################
-      SQ15x16 decimal_g = leds_scaled[i].g * SQ15x16(255);
-      SQ15x16 whole_g = decimal_g.getInteger();
-      SQ15x16 fract_g = decimal_g - whole_g;
+// 0 - 255 from an 8.8 output_lut[] value, carrying what's left over in residual
+inline uint8_t dither_channel(uint16_t level, uint16_t& residual) {
+  uint32_t sum = uint32_t(residual) + uint32_t((level & 0xFF) << 8);
+  residual = uint16_t(sum);                      // Fraction still owed
+  return uint8_t((level >> 8) + (sum >> 16));    // Never past 255: full scale has no fraction
+}
 
-      if (fract_g >= dither_table[(noise_origin_g + i) % 8]) {
-        whole_g += SQ15x16(1);
-      }
+inline CRGB dither_led(const CRGB16& col, DitherResidual& residual) {
+  return CRGB(dither_channel(output_level(col.r, 0), residual.r),
+              dither_channel(output_level(col.g, 1), residual.g),
+              dither_channel(output_level(col.b, 2), residual.b));
+}
 
-      leds_out[i].g = whole_g.getInteger();
+// Spreads the starting residuals over the whole step range, so a strip of
+// one flat colour doesn't carry (and flicker) on every LED at once
+inline void seed_dither_residuals(DitherResidual* residual, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) {
+    residual[i].r = uint16_t(i * 40503u);  // 65536 / golden ratio
+    residual[i].g = uint16_t(i * 40503u + 21845u);
+    residual[i].b = uint16_t(i * 40503u + 43690u);
+  }
+}
 
-      // BLUE ####################################################
-      SQ15x16 decimal_b = leds_scaled[i].b * SQ15x16(255);
-      SQ15x16 whole_b = decimal_b.getInteger();
-      SQ15x16 fract_b = decimal_b - whole_b;
+// Steps the dither frame counter (dither_step) on
+inline void advance_dither() {
+  dither_step++;
+  if (dither_step >= 8) {  // Updated for 8-frame dithering
+    dither_step = 0;
+  }
+}
 
-      if (fract_b >= dither_table[(noise_origin_b + i) % 8]) {
-        whole_b += SQ15x16(1);
-      }
+inline void quantize_color(bool temporal_dithering) {
+  if (temporal_dithering) {
+    advance_dither();
 
-      leds_out[i].b = whole_b.getInteger();
+    for (uint16_t i = 0; i < CONFIG.LED_COUNT; i += 1) {
+      leds_out[i] = dither_led(leds_scaled[i], dither_residual[i]);
     }
   } else {
     for (uint16_t i = 0; i < CONFIG.LED_COUNT; i += 1) {
-      leds_out[i].r = uint8_t(leds_scaled[i].r * 255);
-      leds_out[i].g = uint8_t(leds_scaled[i].g * 255);
-      leds_out[i].b = uint8_t(leds_scaled[i].b * 255);
+      leds_out[i] = output_led(leds_scaled[i]);
     }
   }
 }
@@ -472,7 +477,7 @@ inline void apply_incandescent_filter() {
   SQ15x16 mix = CONFIG.INCANDESCENT_FILTER;
   SQ15x16 inv_mix = 1.0 - mix;
 
-  for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+  for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
     SQ15x16 filtered_r = leds_16[i].r * incandescent_lookup.r;
     SQ15x16 filtered_g = leds_16[i].g * incandescent_lookup.g;
     SQ15x16 filtered_b = leds_16[i].b * incandescent_lookup.b;
@@ -506,9 +511,13 @@ inline void apply_incandescent_filter() {
   }
 }
 
+inline void set_dot_position(DOT& dot, SQ15x16 new_pos) {
+  dot.last_position = dot.position;
+  dot.position = new_pos;
+}
+
 inline void set_dot_position(uint16_t dot_index, SQ15x16 new_pos) {
-  dots[dot_index].last_position = dots[dot_index].position;
-  dots[dot_index].position = new_pos;
+  set_dot_position(dots[dot_index], new_pos);
 }
 
 inline void draw_line(CRGB16* layer, SQ15x16 x1, SQ15x16 x2, CRGB16 color, SQ15x16 alpha) {
@@ -581,9 +590,9 @@ inline void draw_line(CRGB16* layer, SQ15x16 x1, SQ15x16 x2, CRGB16 color, SQ15x
   }
 }
 
-inline void draw_dot(CRGB16* layer, uint16_t dot_index, CRGB16 color) {
-  SQ15x16 position = dots[dot_index].position;
-  SQ15x16 last_position = dots[dot_index].last_position;
+inline void draw_dot(CRGB16* layer, const DOT& dot, CRGB16 color) {
+  SQ15x16 position = dot.position;
+  SQ15x16 last_position = dot.last_position;
 
   SQ15x16 positional_distance = fabs_fixed(position - last_position);
   if (positional_distance < 1.0) {
@@ -603,6 +612,10 @@ inline void draw_dot(CRGB16* layer, uint16_t dot_index, CRGB16 color) {
     net_brightness_per_pixel);
 }
 
+inline void draw_dot(CRGB16* layer, uint16_t dot_index, CRGB16 color) {
+  draw_dot(layer, dots[dot_index], color);
+}
+
 inline void render_photons_graph() {
   // Draw graph ticks
   uint8_t ticks = 5;
@@ -657,7 +670,7 @@ inline void render_chroma_graph() {
       }
 
       // CHROMA OVERRIDE FIX [2025-09-20] - Use palette-safe hue calculation
-      SQ15x16 ui_hue_base = (CONFIG.PALETTE_INDEX > 0) ? hue_position : (chroma_val + hue_position);
+      SQ15x16 ui_hue_base = (CONFIG.PALETTE_INDEX > 0) ? primary_render.hue.position : (chroma_val + primary_render.hue.position);
       leds_16_ui[i.getInteger()] = hsv_or_palette((ui_hue_base - 0.48) + prog, CONFIG.SATURATION, brightness * brightness);
     }
   } else {
@@ -728,7 +741,7 @@ inline void transition_ui_mask_to_height(SQ15x16 target_height) {
   }
 
   memset(ui_mask, 0, sizeof(SQ15x16) * NATIVE_RESOLUTION);
-  for (uint8_t i = 0; i < NATIVE_RESOLUTION * ui_mask_height; i++) {
+  for (uint16_t i = 0; i < NATIVE_RESOLUTION * ui_mask_height; i++) {
     ui_mask[i] = SQ15x16(1.0);
   }
 }
@@ -771,7 +784,7 @@ inline void render_noise_cal() {
 }
 
 inline void render_ui() {
-  if (noise_complete == true) {
+  if (led_audio->noise_complete == true) {
     if (current_knob == K_NONE) {
       // Close UI if open
       if (ui_mask_height > 0.005) {
@@ -793,15 +806,12 @@ inline void render_ui() {
     render_noise_cal();
   }
 
-  if (ui_mask_height > 0.005 || noise_complete == false) {
-    for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+  if (ui_mask_height > 0.005 || led_audio->noise_complete == false) {
+    for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
       SQ15x16 mix = ui_mask[i];
-      SQ15x16 mix_inv = SQ15x16(1.0) - mix;
 
       if (mix > 0.0) {
-        leds_16[i].r = leds_16[i].r * mix_inv + leds_16_ui[i].r * mix;
-        leds_16[i].g = leds_16[i].g * mix_inv + leds_16_ui[i].g * mix;
-        leds_16[i].b = leds_16[i].b * mix_inv + leds_16_ui[i].b * mix;
+        leds_16[i] = pixel_mix(leds_16[i], leds_16_ui[i], mix);
       }
     }
   }
@@ -828,6 +838,9 @@ inline void init_lerp_params() {
             
             led_lerp_params[i].index_left = index.getInteger();
             led_lerp_params[i].index_right = led_lerp_params[i].index_left + 1;
+            if (led_lerp_params[i].index_right >= NATIVE_RESOLUTION) {
+                led_lerp_params[i].index_right = NATIVE_RESOLUTION - 1;  // Last pixel: don't read past leds_16[]
+            }
             SQ15x16 index_fract = index - SQ15x16(led_lerp_params[i].index_left);
             led_lerp_params[i].mix_left = SQ15x16(1.0) - index_fract;
             led_lerp_params[i].mix_right = index_fract;
@@ -837,6 +850,27 @@ inline void init_lerp_params() {
 }
 
 
+// LED thread, between frames: switch to the width the serial menu asked
+// for (render_resolution=). Everything per-pixel starts over from black.
+inline void apply_render_resolution_request() {
+  uint16_t request = render_resolution_request;
+  if (request == 0) {
+    return;
+  }
+  render_resolution_request = 0;
+  if (request == NATIVE_RESOLUTION) {
+    return;
+  }
+
+  NATIVE_RESOLUTION = request;
+  memset(frame_arena, 0, frame_arena_used);
+  reset_render_mode(primary_render);  // Their mode state was in there too
+  reset_render_mode(secondary_render);
+  lerp_params_initialized = false;
+  init_lerp_params();
+}
+
+
 inline void scale_to_strip() {
     if (!leds_scaled) {
         return;
@@ -862,81 +896,7 @@ inline void scale_to_strip() {
     }
 }
 
-inline void show_leds() {
-  static uint16_t stage_burst_frames = 0; // emit detailed logs when non-zero
-  bool in_burst_mode = (stage_burst_frames > 0);
-
-  uint32_t ready_seq = g_frame_seq_ready;
-  if (ready_seq == g_frame_seq_shown) {
-    FastLED.setDither(false);
-    FastLED.show();
-    return;
-  }
-  g_frame_seq_shown = ready_seq;
-
-  // SIMPLE TEST: Print every 3 seconds to confirm our code is running
-  static uint32_t last_test_print = 0;
-  if (kEnableShowLedsHeartbeat && millis() - last_test_print > 3000) {
-    USBSerial.printf("[TEST] show_leds() running, PALETTE_INDEX=%d\n", CONFIG.PALETTE_INDEX);
-    last_test_print = millis();
-  }
-
-  // STAGE 1 DEBUG MOVED TO main.cpp after lightshow mode execution
-  // This space intentionally left blank - Stage 1 now samples immediately after lightshow modes write leds_16[]
-
-  apply_brightness();
-  TRACE_EVENT(TRACE_CAT_LED, LED_CALC_START,
-              pack_stage_state(2, leds_any_nonzero(leds_16, NATIVE_RESOLUTION)));
-
-  // ============================================================
-  // STAGE 2: POST-BRIGHTNESS (after global curve/floor)
-  if (kEnableStageDebug && (in_burst_mode || DebugManager::should_print(DEBUG_COLOR))) {
-    uint16_t i0 = 0;
-    uint16_t i1 = (NATIVE_RESOLUTION > 64) ? (NATIVE_RESOLUTION / 2) : 0;
-    uint16_t i2 = (NATIVE_RESOLUTION > 1) ? (NATIVE_RESOLUTION - 1) : 0;
-    USBSerial.printf("[STAGE-2-POST-BRIGHT] Frame:%u 16bit f/m/l: "
-                     "(%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) | u8 f/m/l: "
-                     "(%u,%u,%u) (%u,%u,%u) (%u,%u,%u)\n",
-                     perf_metrics.frame_count,
-                     to_float_fixed(leds_16[i0].r), to_float_fixed(leds_16[i0].g), to_float_fixed(leds_16[i0].b),
-                     to_float_fixed(leds_16[i1].r), to_float_fixed(leds_16[i1].g), to_float_fixed(leds_16[i1].b),
-                     to_float_fixed(leds_16[i2].r), to_float_fixed(leds_16[i2].g), to_float_fixed(leds_16[i2].b),
-                     to_u8_fixed(leds_16[i0].r), to_u8_fixed(leds_16[i0].g), to_u8_fixed(leds_16[i0].b),
-                     to_u8_fixed(leds_16[i1].r), to_u8_fixed(leds_16[i1].g), to_u8_fixed(leds_16[i1].b),
-                     to_u8_fixed(leds_16[i2].r), to_u8_fixed(leds_16[i2].g), to_u8_fixed(leds_16[i2].b));
-    if (!in_burst_mode) DebugManager::mark_printed(DEBUG_COLOR);
-  }
-
-  // PALETTE COLOR PRESERVATION [2025-09-20] - Disable incandescent filter for palette mode
-  // ROOT CAUSE: Incandescent filter crushes blues by 84% (0.1562 multiplier)
-  // SOLUTION: Only apply warm filter in HSV mode to preserve palette color accuracy
-  if (CONFIG.INCANDESCENT_FILTER > 0.0 && CONFIG.PALETTE_INDEX == 0) {
-    apply_incandescent_filter();  // HSV mode only
-  }
-  // Palette colors (index > 0) skip incandescent filtering to maintain color balance
-
-  TRACE_EVENT(TRACE_CAT_LED, LED_CALC_START,
-              pack_stage_state(3, leds_any_nonzero(leds_16, NATIVE_RESOLUTION)));
-
-  // ============================================================
-  // STAGE 3: POST-INCANDESCENT (after warm filter)
-  if (kEnableStageDebug && (in_burst_mode || DebugManager::should_print(DEBUG_COLOR))) {
-    uint16_t i0 = 0;
-    uint16_t i1 = (NATIVE_RESOLUTION > 64) ? (NATIVE_RESOLUTION / 2) : 0;
-    uint16_t i2 = (NATIVE_RESOLUTION > 1) ? (NATIVE_RESOLUTION - 1) : 0;
-    USBSerial.printf("[STAGE-3-POST-INCAND] Frame:%u 16bit f/m/l: "
-                     "(%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) | u8 f/m/l: "
-                     "(%u,%u,%u) (%u,%u,%u) (%u,%u,%u)\n",
-                     perf_metrics.frame_count,
-                     to_float_fixed(leds_16[i0].r), to_float_fixed(leds_16[i0].g), to_float_fixed(leds_16[i0].b),
-                     to_float_fixed(leds_16[i1].r), to_float_fixed(leds_16[i1].g), to_float_fixed(leds_16[i1].b),
-                     to_float_fixed(leds_16[i2].r), to_float_fixed(leds_16[i2].g), to_float_fixed(leds_16[i2].b),
-                     to_u8_fixed(leds_16[i0].r), to_u8_fixed(leds_16[i0].g), to_u8_fixed(leds_16[i0].b),
-                     to_u8_fixed(leds_16[i1].r), to_u8_fixed(leds_16[i1].g), to_u8_fixed(leds_16[i1].b),
-                     to_u8_fixed(leds_16[i2].r), to_u8_fixed(leds_16[i2].g), to_u8_fixed(leds_16[i2].b));
-    if (!in_burst_mode) DebugManager::mark_printed(DEBUG_COLOR);
-  }
-
+inline void draw_base_coat() {
   // PALETTE COLOR PRESERVATION [2025-09-20] - Disable BASE_COAT for palette mode
   // ROOT CAUSE: BASE_COAT draws white backdrop that overwrites vibrant palette colors
   // SOLUTION: Only apply base coat in HSV mode to preserve palette vibrancy
@@ -962,7 +922,7 @@ inline void show_leds() {
 
     CRGB16 backdrop_color = {{ bottom_value_r }, { bottom_value_g }, { bottom_value_b }};
 
-    SQ15x16 base_coat_width_scaled = base_coat_width * silent_scale;
+    SQ15x16 base_coat_width_scaled = base_coat_width * led_audio->silent_scale;
 
     if (base_coat_width_scaled > 0.01) {
       draw_line(leds_16, 0.5 - (base_coat_width_scaled * 0.5), 0.5 + (base_coat_width_scaled * 0.5), backdrop_color, 1.0);
@@ -976,103 +936,313 @@ inline void show_leds() {
     }
     */
   }
+}
 
-  render_ui();
-  clip_led_values(leds_16);
-  scale_to_strip();
-  const bool stage4_any = (leds_scaled != nullptr) ?
-      leds_any_nonzero(leds_scaled, CONFIG.LED_COUNT) : false;
-  TRACE_EVENT(TRACE_CAT_LED, LED_CALC_START,
-              pack_stage_state(4, stage4_any));
-
-  // ============================================================
-  // STAGE 4: POST-SCALE (leds_scaled[] @ CONFIG.LED_COUNT)
-  if (kEnableStageDebug && (in_burst_mode || DebugManager::should_print(DEBUG_COLOR))) {
-    if (leds_scaled != nullptr && CONFIG.LED_COUNT > 0) {
-      uint16_t i0 = 0;
-      uint16_t i1 = CONFIG.LED_COUNT / 2;
-      uint16_t i2 = CONFIG.LED_COUNT - 1;
-      USBSerial.printf("[STAGE-4-POST-SCALE] Frame:%u 16bit f/m/l: "
-                       "(%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) | u8 f/m/l: "
-                       "(%u,%u,%u) (%u,%u,%u) (%u,%u,%u)\n",
-                       perf_metrics.frame_count,
-                       to_float_fixed(leds_scaled[i0].r), to_float_fixed(leds_scaled[i0].g), to_float_fixed(leds_scaled[i0].b),
-                       to_float_fixed(leds_scaled[i1].r), to_float_fixed(leds_scaled[i1].g), to_float_fixed(leds_scaled[i1].b),
-                       to_float_fixed(leds_scaled[i2].r), to_float_fixed(leds_scaled[i2].g), to_float_fixed(leds_scaled[i2].b),
-                       to_u8_fixed(leds_scaled[i0].r), to_u8_fixed(leds_scaled[i0].g), to_u8_fixed(leds_scaled[i0].b),
-                       to_u8_fixed(leds_scaled[i1].r), to_u8_fixed(leds_scaled[i1].g), to_u8_fixed(leds_scaled[i1].b),
-                       to_u8_fixed(leds_scaled[i2].r), to_u8_fixed(leds_scaled[i2].g), to_u8_fixed(leds_scaled[i2].b));
+// FUSED POST-PROCESSING ------------------------------------------------
+//
+// The staged path in show_leds() walks the frame once per step:
+// brightness, clip, warm filter, (base coat, UI), clip, resample,
+// quantize and reverse, each re-reading every 12-byte CRGB16. The fused
+// path does the same arithmetic in the same order, in two passes:
+//
+//   1. leds_16, native:  brightness, clip, warm filter
+//      (base coat and UI are then drawn over leds_16, as before)
+//   2. leds_out, strip:  clip, resample, quantize / dither, reverse
+//      (when resampling, the clip is a quick pass over leds_16 first)
+//
+// Output is bit-identical to the staged path, which stays available
+// (led_pipeline=staged) for the stage debug taps and for comparison.
+// leds_scaled[] isn't written on this path. Colour order needs no pass
+// of its own: FastLED's controller applies it while sending.
+
+inline CRGB16 clipped_led(CRGB16 col) {  // clip_led_values(), one pixel
+#ifndef LED_PIXEL_WIDE
+  const uint16_t one = PixelChannel::ONE;  // Packed channels are never negative
+  if (col.r.getInternal() > one) { col.r = PixelChannel::fromInternal(one); }
+  if (col.g.getInternal() > one) { col.g = PixelChannel::fromInternal(one); }
+  if (col.b.getInternal() > one) { col.b = PixelChannel::fromInternal(one); }
+  return col;
+#endif
+  if (col.r < 0.0) { col.r = 0.0; }
+  if (col.g < 0.0) { col.g = 0.0; }
+  if (col.b < 0.0) { col.b = 0.0; }
+
+  if (col.r > 1.0) { col.r = 1.0; }
+  if (col.g > 1.0) { col.g = 1.0; }
+  if (col.b > 1.0) { col.b = 1.0; }
+  return col;
+}
+
+// Pass 1: apply_brightness() + apply_incandescent_filter()
+inline void prepare_frame_fused() {
+  const SQ15x16 brightness = update_frame_brightness();
+
+  // Same condition show_leds() puts around apply_incandescent_filter()
+  const bool warm = (CONFIG.INCANDESCENT_FILTER > 0.0 && CONFIG.PALETTE_INDEX == 0);
+  const SQ15x16 mix = CONFIG.INCANDESCENT_FILTER;
+  const SQ15x16 inv_mix = 1.0 - mix;
+  const CRGB16 warm_lookup = incandescent_lookup;
+
+  for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
+    CRGB16 col = leds_16[i];
+    col.r *= brightness;
+    col.g *= brightness;
+    col.b *= brightness;
+    col = clipped_led(col);
+
+    if (warm) {
+      SQ15x16 filtered_r = col.r * warm_lookup.r;
+      SQ15x16 filtered_g = col.g * warm_lookup.g;
+      SQ15x16 filtered_b = col.b * warm_lookup.b;
+
+      col.r = (col.r * inv_mix) + (filtered_r * mix);
+      col.g = (col.g * inv_mix) + (filtered_g * mix);
+      col.b = (col.b * inv_mix) + (filtered_b * mix);
+    }
+    leds_16[i] = col;
+  }
+}
+
+// Pass 2: clip_led_values() + scale_to_strip() + quantize_color() +
+// reverse_leds(), with the per-frame choices made once, at compile time
+template <bool kNative, bool kDither>
+inline void write_strip_kernel(CRGB* out, uint16_t led_count, bool reverse) {
+  for (uint16_t i = 0; i < led_count; i++) {
+    CRGB16 col;
+    if (kNative) {
+      col = clipped_led(leds_16[i]);
     } else {
-      USBSerial.printf("[STAGE-4-POST-SCALE] Frame:%u leds_scaled unavailable\n",
-                       perf_metrics.frame_count);
+      const LerpParams& lerp = led_lerp_params[i];  // leds_16 is already clipped
+      const CRGB16& left = leds_16[lerp.index_left];
+      const CRGB16& right = leds_16[lerp.index_right];
+      col.r = left.r * lerp.mix_left + right.r * lerp.mix_right;
+      col.g = left.g * lerp.mix_left + right.g * lerp.mix_right;
+      col.b = left.b * lerp.mix_left + right.b * lerp.mix_right;
+    }
+
+    CRGB& dst = out[reverse ? (led_count - 1 - i) : i];
+    if (kDither) {
+      dst = dither_led(col, dither_residual[i]);
+    } else {
+      dst = output_led(col);
     }
-    if (!in_burst_mode) DebugManager::mark_printed(DEBUG_COLOR);
   }
-  
-  // Only attempt to use secondary LEDs if explicitly enabled
-  if (ENABLE_SECONDARY_LEDS) {
-    show_secondary_leds();
+}
+
+inline void write_strip_fused(bool temporal_dithering) {
+  if (leds_out == nullptr) {
+    return;
+  }
+
+  const uint16_t led_count = CONFIG.LED_COUNT;
+  const bool reverse = CONFIG.REVERSE_ORDER;
+  const bool native = (led_count == NATIVE_RESOLUTION);
+  if (!native) {
+    if (!lerp_params_initialized) {
+      init_lerp_params();
+    }
+    // Resampling reads each source pixel about twice per output pixel it
+    // covers, so clip the (short) native frame once up front instead
+    clip_led_values(leds_16);
+  }
+
+  if (temporal_dithering) {
+    advance_dither();
+    if (native) {
+      write_strip_kernel<true, true>(leds_out, led_count, reverse);
+    } else {
+      write_strip_kernel<false, true>(leds_out, led_count, reverse);
+    }
+  } else {
+    if (native) {
+      write_strip_kernel<true, false>(leds_out, led_count, reverse);
+    } else {
+      write_strip_kernel<false, false>(leds_out, led_count, reverse);
+    }
+  }
+}
+
+inline void show_leds() {
+  static uint16_t stage_burst_frames = 0; // emit detailed logs when non-zero
+  bool in_burst_mode = (stage_burst_frames > 0);
+
+#ifdef ENABLE_PERFORMANCE_MONITORING
+  uint32_t t_post_us = micros();
+#endif
+
+  // SIMPLE TEST: Print every 3 seconds to confirm our code is running
+  static uint32_t last_test_print = 0;
+  if (kEnableShowLedsHeartbeat && millis() - last_test_print > 3000) {
+    USBSerial.printf("[TEST] show_leds() running, PALETTE_INDEX=%d\n", CONFIG.PALETTE_INDEX);
+    last_test_print = millis();
   }
+
+  // STAGE 1 DEBUG MOVED TO main.cpp after lightshow mode execution
+  // This space intentionally left blank - Stage 1 now samples immediately after lightshow modes write leds_16[]
+
+  // Fused post-processing, unless the stage debug taps below need the
+  // staged path this frame (see prepare_frame_fused())
+  const bool use_fused = led_post_fused &&
+      !(kEnableStageDebug && (in_burst_mode || DebugManager::should_print(DEBUG_COLOR)));
+
+  if (use_fused) {
+    prepare_frame_fused();
+    draw_base_coat();
+    render_ui();
+
+    log_pipeline_addresses(perf_metrics.frame_count);
+
+    write_strip_fused(CONFIG.TEMPORAL_DITHERING);
+    TRACE_EVENT(TRACE_CAT_LED, LED_CALC_START,
+                pack_stage_state(5, leds_any_nonzero(leds_out, CONFIG.LED_COUNT)));
+  } else {
+    apply_brightness();
+    TRACE_EVENT(TRACE_CAT_LED, LED_CALC_START,
+                pack_stage_state(2, leds_any_nonzero(leds_16, NATIVE_RESOLUTION)));
+
+    // ============================================================
+    // STAGE 2: POST-BRIGHTNESS (after global curve/floor)
+    if (kEnableStageDebug && (in_burst_mode || DebugManager::should_print(DEBUG_COLOR))) {
+      uint16_t i0 = 0;
+      uint16_t i1 = (NATIVE_RESOLUTION > 64) ? (NATIVE_RESOLUTION / 2) : 0;
+      uint16_t i2 = (NATIVE_RESOLUTION > 1) ? (NATIVE_RESOLUTION - 1) : 0;
+      DLOG("[STAGE-2-POST-BRIGHT] Frame:%u 16bit f/m/l: "
+           "(%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) | u8 f/m/l: "
+           "(%u,%u,%u) (%u,%u,%u) (%u,%u,%u)\n",
+           perf_metrics.frame_count,
+           to_float_fixed(leds_16[i0].r), to_float_fixed(leds_16[i0].g), to_float_fixed(leds_16[i0].b),
+           to_float_fixed(leds_16[i1].r), to_float_fixed(leds_16[i1].g), to_float_fixed(leds_16[i1].b),
+           to_float_fixed(leds_16[i2].r), to_float_fixed(leds_16[i2].g), to_float_fixed(leds_16[i2].b),
+           to_u8_fixed(leds_16[i0].r), to_u8_fixed(leds_16[i0].g), to_u8_fixed(leds_16[i0].b),
+           to_u8_fixed(leds_16[i1].r), to_u8_fixed(leds_16[i1].g), to_u8_fixed(leds_16[i1].b),
+           to_u8_fixed(leds_16[i2].r), to_u8_fixed(leds_16[i2].g), to_u8_fixed(leds_16[i2].b));
+      if (!in_burst_mode) DebugManager::mark_printed(DEBUG_COLOR);
+    }
+
+    // PALETTE COLOR PRESERVATION [2025-09-20] - Disable incandescent filter for palette mode
+    // ROOT CAUSE: Incandescent filter crushes blues by 84% (0.1562 multiplier)
+    // SOLUTION: Only apply warm filter in HSV mode to preserve palette color accuracy
+    if (CONFIG.INCANDESCENT_FILTER > 0.0 && CONFIG.PALETTE_INDEX == 0) {
+      apply_incandescent_filter();  // HSV mode only
+    }
+    // Palette colors (index > 0) skip incandescent filtering to maintain color balance
+
+    TRACE_EVENT(TRACE_CAT_LED, LED_CALC_START,
+                pack_stage_state(3, leds_any_nonzero(leds_16, NATIVE_RESOLUTION)));
+
+    // ============================================================
+    // STAGE 3: POST-INCANDESCENT (after warm filter)
+    if (kEnableStageDebug && (in_burst_mode || DebugManager::should_print(DEBUG_COLOR))) {
+      uint16_t i0 = 0;
+      uint16_t i1 = (NATIVE_RESOLUTION > 64) ? (NATIVE_RESOLUTION / 2) : 0;
+      uint16_t i2 = (NATIVE_RESOLUTION > 1) ? (NATIVE_RESOLUTION - 1) : 0;
+      DLOG("[STAGE-3-POST-INCAND] Frame:%u 16bit f/m/l: "
+           "(%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) | u8 f/m/l: "
+           "(%u,%u,%u) (%u,%u,%u) (%u,%u,%u)\n",
+           perf_metrics.frame_count,
+           to_float_fixed(leds_16[i0].r), to_float_fixed(leds_16[i0].g), to_float_fixed(leds_16[i0].b),
+           to_float_fixed(leds_16[i1].r), to_float_fixed(leds_16[i1].g), to_float_fixed(leds_16[i1].b),
+           to_float_fixed(leds_16[i2].r), to_float_fixed(leds_16[i2].g), to_float_fixed(leds_16[i2].b),
+           to_u8_fixed(leds_16[i0].r), to_u8_fixed(leds_16[i0].g), to_u8_fixed(leds_16[i0].b),
+           to_u8_fixed(leds_16[i1].r), to_u8_fixed(leds_16[i1].g), to_u8_fixed(leds_16[i1].b),
+           to_u8_fixed(leds_16[i2].r), to_u8_fixed(leds_16[i2].g), to_u8_fixed(leds_16[i2].b));
+      if (!in_burst_mode) DebugManager::mark_printed(DEBUG_COLOR);
+    }
+
+    draw_base_coat();
+
+    render_ui();
+    clip_led_values(leds_16);
+    scale_to_strip();
+    const bool stage4_any = (leds_scaled != nullptr) ?
+        leds_any_nonzero(leds_scaled, CONFIG.LED_COUNT) : false;
+    TRACE_EVENT(TRACE_CAT_LED, LED_CALC_START,
+                pack_stage_state(4, stage4_any));
+
+    // ============================================================
+    // STAGE 4: POST-SCALE (leds_scaled[] @ CONFIG.LED_COUNT)
+    if (kEnableStageDebug && (in_burst_mode || DebugManager::should_print(DEBUG_COLOR))) {
+      if (leds_scaled != nullptr && CONFIG.LED_COUNT > 0) {
+        uint16_t i0 = 0;
+        uint16_t i1 = CONFIG.LED_COUNT / 2;
+        uint16_t i2 = CONFIG.LED_COUNT - 1;
+        DLOG("[STAGE-4-POST-SCALE] Frame:%u 16bit f/m/l: "
+             "(%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) | u8 f/m/l: "
+             "(%u,%u,%u) (%u,%u,%u) (%u,%u,%u)\n",
+             perf_metrics.frame_count,
+             to_float_fixed(leds_scaled[i0].r), to_float_fixed(leds_scaled[i0].g), to_float_fixed(leds_scaled[i0].b),
+             to_float_fixed(leds_scaled[i1].r), to_float_fixed(leds_scaled[i1].g), to_float_fixed(leds_scaled[i1].b),
+             to_float_fixed(leds_scaled[i2].r), to_float_fixed(leds_scaled[i2].g), to_float_fixed(leds_scaled[i2].b),
+             to_u8_fixed(leds_scaled[i0].r), to_u8_fixed(leds_scaled[i0].g), to_u8_fixed(leds_scaled[i0].b),
+             to_u8_fixed(leds_scaled[i1].r), to_u8_fixed(leds_scaled[i1].g), to_u8_fixed(leds_scaled[i1].b),
+             to_u8_fixed(leds_scaled[i2].r), to_u8_fixed(leds_scaled[i2].g), to_u8_fixed(leds_scaled[i2].b));
+      } else {
+        DLOG("[STAGE-4-POST-SCALE] Frame:%u leds_scaled unavailable\n",
+             perf_metrics.frame_count);
+      }
+      if (!in_burst_mode) DebugManager::mark_printed(DEBUG_COLOR);
+    }
   
-  log_pipeline_addresses(perf_metrics.frame_count);
-
-  const bool inject_sentinel = false; // disable sentinel overwrite during normal runs
-
-  const bool log_stage5_debug = kEnableStageDebug && (in_burst_mode || DebugManager::should_print(DEBUG_COLOR)) &&
-                                (CONFIG.LED_COUNT > 0) &&
-                                (leds_scaled != nullptr) && (leds_out != nullptr);
-  CRGB16 stage5_src0_pre;
-  CRGB stage5_dst0_pre;
-  if (log_stage5_debug) {
-    stage5_src0_pre = leds_scaled[0];
-    stage5_dst0_pre = leds_out[0];
-  }
-
-  quantize_color(CONFIG.TEMPORAL_DITHERING);
-  const bool stage5_any = (leds_out != nullptr) ?
-      leds_any_nonzero(leds_out, CONFIG.LED_COUNT) : false;
-  TRACE_EVENT(TRACE_CAT_LED, LED_CALC_START,
-              pack_stage_state(5, stage5_any));
-
-  if (log_stage5_debug) {
-    const CRGB16& stage5_src0_post = leds_scaled[0];
-    const CRGB& stage5_dst0_post = leds_out[0];
-    uint8_t wire_bytes[3];
-    encode_color_order_bytes(stage5_dst0_post, wire_bytes);
-    USBSerial.printf("[STAGE-5-DEBUG] Frame:%u src0=(%.3f,%.3f,%.3f)->(%.3f,%.3f,%.3f) "
-                     "dst0=(%u,%u,%u)->(%u,%u,%u) raw=%02X %02X %02X\n",
-                     perf_metrics.frame_count,
-                     to_float_fixed(stage5_src0_pre.r), to_float_fixed(stage5_src0_pre.g), to_float_fixed(stage5_src0_pre.b),
-                     to_float_fixed(stage5_src0_post.r), to_float_fixed(stage5_src0_post.g), to_float_fixed(stage5_src0_post.b),
-                     stage5_dst0_pre.r, stage5_dst0_pre.g, stage5_dst0_pre.b,
-                     stage5_dst0_post.r, stage5_dst0_post.g, stage5_dst0_post.b,
-                     wire_bytes[0], wire_bytes[1], wire_bytes[2]);
-  }
-
-  // ============================================================
-  // STAGE 5: POST-QUANTIZE (leds_out[] 8-bit that goes to FastLED)
-  // Gate spam by DEBUG_COLOR cadence
-  if (kEnableStageDebug && (in_burst_mode || DebugManager::should_print(DEBUG_COLOR))) {
-    uint16_t i0 = 0;
-    uint16_t i1 = (CONFIG.LED_COUNT > 0) ? (CONFIG.LED_COUNT / 2) : 0;
-    uint16_t i2 = (CONFIG.LED_COUNT > 0) ? (CONFIG.LED_COUNT - 1) : 0;
-    USBSerial.printf("[STAGE-5-POST-QUANT] Frame:%u 8bit f/m/l: "
-                     "(%u,%u,%u) (%u,%u,%u) (%u,%u,%u)\n",
-                     perf_metrics.frame_count,
-                     leds_out[i0].r, leds_out[i0].g, leds_out[i0].b,
-                     leds_out[i1].r, leds_out[i1].g, leds_out[i1].b,
-                     leds_out[i2].r, leds_out[i2].g, leds_out[i2].b);
-    // Only mark printed after all 5 stages complete
-    if (!in_burst_mode) DebugManager::mark_printed(DEBUG_COLOR);
-  }
-
-  // Decrement burst frames only at the very end of all stages
-  if (in_burst_mode) {
-    stage_burst_frames--;
-  }
-
-  if (CONFIG.REVERSE_ORDER == true) {
-    reverse_leds(leds_out, CONFIG.LED_COUNT);
+    log_pipeline_addresses(perf_metrics.frame_count);
+
+    const bool inject_sentinel = false; // disable sentinel overwrite during normal runs
+
+    const bool log_stage5_debug = kEnableStageDebug && (in_burst_mode || DebugManager::should_print(DEBUG_COLOR)) &&
+                                  (CONFIG.LED_COUNT > 0) &&
+                                  (leds_scaled != nullptr) && (leds_out != nullptr);
+    CRGB16 stage5_src0_pre;
+    CRGB stage5_dst0_pre;
+    if (log_stage5_debug) {
+      stage5_src0_pre = leds_scaled[0];
+      stage5_dst0_pre = leds_out[0];
+    }
+
+    quantize_color(CONFIG.TEMPORAL_DITHERING);
+    const bool stage5_any = (leds_out != nullptr) ?
+        leds_any_nonzero(leds_out, CONFIG.LED_COUNT) : false;
+    TRACE_EVENT(TRACE_CAT_LED, LED_CALC_START,
+                pack_stage_state(5, stage5_any));
+
+    if (log_stage5_debug) {
+      const CRGB16& stage5_src0_post = leds_scaled[0];
+      const CRGB& stage5_dst0_post = leds_out[0];
+      uint8_t wire_bytes[3];
+      encode_color_order_bytes(stage5_dst0_post, wire_bytes);
+      DLOG("[STAGE-5-DEBUG] Frame:%u src0=(%.3f,%.3f,%.3f)->(%.3f,%.3f,%.3f) "
+           "dst0=(%u,%u,%u)->(%u,%u,%u) raw=%02X %02X %02X\n",
+           perf_metrics.frame_count,
+           to_float_fixed(stage5_src0_pre.r), to_float_fixed(stage5_src0_pre.g), to_float_fixed(stage5_src0_pre.b),
+           to_float_fixed(stage5_src0_post.r), to_float_fixed(stage5_src0_post.g), to_float_fixed(stage5_src0_post.b),
+           stage5_dst0_pre.r, stage5_dst0_pre.g, stage5_dst0_pre.b,
+           stage5_dst0_post.r, stage5_dst0_post.g, stage5_dst0_post.b,
+           wire_bytes[0], wire_bytes[1], wire_bytes[2]);
+    }
+
+    // ============================================================
+    // STAGE 5: POST-QUANTIZE (leds_out[] 8-bit that goes to FastLED)
+    // Gate spam by DEBUG_COLOR cadence
+    if (kEnableStageDebug && (in_burst_mode || DebugManager::should_print(DEBUG_COLOR))) {
+      uint16_t i0 = 0;
+      uint16_t i1 = (CONFIG.LED_COUNT > 0) ? (CONFIG.LED_COUNT / 2) : 0;
+      uint16_t i2 = (CONFIG.LED_COUNT > 0) ? (CONFIG.LED_COUNT - 1) : 0;
+      DLOG("[STAGE-5-POST-QUANT] Frame:%u 8bit f/m/l: "
+           "(%u,%u,%u) (%u,%u,%u) (%u,%u,%u)\n",
+           perf_metrics.frame_count,
+           leds_out[i0].r, leds_out[i0].g, leds_out[i0].b,
+           leds_out[i1].r, leds_out[i1].g, leds_out[i1].b,
+           leds_out[i2].r, leds_out[i2].g, leds_out[i2].b);
+      // Only mark printed after all 5 stages complete
+      if (!in_burst_mode) DebugManager::mark_printed(DEBUG_COLOR);
+    }
+
+    // Decrement burst frames only at the very end of all stages
+    if (in_burst_mode) {
+      stage_burst_frames--;
+    }
+
+    if (CONFIG.REVERSE_ORDER == true) {
+      reverse_leds(leds_out, CONFIG.LED_COUNT);
+    }
   }
 
   if (debug_mode && (millis() % 10000 == 0)) {
@@ -1088,40 +1258,42 @@ inline void show_leds() {
       }
     }
     
-    USBSerial.print("DEBUG: LED Output - HasLight: ");
-    USBSerial.print(has_light ? "YES" : "NO");
     if (has_light) {
-      USBSerial.print(" Range: ");
-      USBSerial.print(first_nonzero);
-      USBSerial.print("-");
-      USBSerial.print(last_nonzero);
-      USBSerial.print(" (");
-      USBSerial.print(last_nonzero - first_nonzero + 1);
-      USBSerial.print(" LEDs)");
+      DLOG("DEBUG: LED Output - HasLight: YES Range: %u-%u (%d LEDs)\n",
+           first_nonzero, last_nonzero, last_nonzero - first_nonzero + 1);
+    } else {
+      DLOG("DEBUG: LED Output - HasLight: NO\n");
     }
-    USBSerial.println();
   }
 
+#ifdef ENABLE_PERFORMANCE_MONITORING
+  perf_metrics.post_process_time = micros() - t_post_us;
+  perf_stage_record(PERF_STAGE_POST_PROCESS, perf_metrics.post_process_time);
+#endif
+
+  finish_strip_jobs();  // Every strip's leds_out ready before the one show()
   FastLED.setDither(false);
+#ifdef ENABLE_PERFORMANCE_MONITORING
+  uint32_t t_show_us = micros();
+#endif
   FastLED.show(); // This will update both LED strips
+  uint32_t t_shown_us = micros();
+  record_audio_to_photon(t_shown_us);  // (latency_histogram.h)
+#ifdef ENABLE_PERFORMANCE_MONITORING
+  perf_metrics.led_update_time = t_shown_us - t_show_us;
+  perf_stage_record(PERF_STAGE_SHOW, perf_metrics.led_update_time);
+#endif
 
   // Add inside show_leds() function, just before FastLED.show()
   if (debug_mode && (millis() % 5000 == 0)) {
-    USBSerial.print("DEBUG: Using modes - Primary: ");
-    USBSerial.print(CONFIG.LIGHTSHOW_MODE);
-    USBSerial.print(" (");
-    USBSerial.print(mode_names + (CONFIG.LIGHTSHOW_MODE * 32));
-    USBSerial.print(")");
-    
     if (ENABLE_SECONDARY_LEDS) {
-      USBSerial.print(", Secondary: ");
-      USBSerial.print(SECONDARY_LIGHTSHOW_MODE);
-      USBSerial.print(" (");
-      USBSerial.print(mode_names + (SECONDARY_LIGHTSHOW_MODE * 32));
-      USBSerial.print(")");
+      DLOG("DEBUG: Using modes - Primary: %u (%s), Secondary: %u (%s)\n",
+           unsigned(CONFIG.LIGHTSHOW_MODE), mode_names + (CONFIG.LIGHTSHOW_MODE * 32),
+           unsigned(SECONDARY_LIGHTSHOW_MODE), mode_names + (SECONDARY_LIGHTSHOW_MODE * 32));
+    } else {
+      DLOG("DEBUG: Using modes - Primary: %u (%s)\n",
+           unsigned(CONFIG.LIGHTSHOW_MODE), mode_names + (CONFIG.LIGHTSHOW_MODE * 32));
     }
-    
-    USBSerial.println();
   }
 }
 
@@ -1134,24 +1306,32 @@ inline void init_leds() {
     CONFIG.LED_COUNT = 128;
   }
 
+  init_frame_arena();  // Render buffers, sized from CONFIG.LED_COUNT
+  init_render_contexts();
+  build_output_lut();
+
   leds_scaled = new CRGB16[CONFIG.LED_COUNT];
   leds_out = new CRGB[CONFIG.LED_COUNT];
+  dither_residual = new DitherResidual[CONFIG.LED_COUNT];
   
   // TACTICAL FIX: Check allocation success
-  if (leds_scaled == nullptr || leds_out == nullptr) {
+  if (leds_scaled == nullptr || leds_out == nullptr || dither_residual == nullptr) {
     USBSerial.println("ERROR: Failed to allocate LED buffers!");
     ESP.restart();
   }
+  seed_dither_residuals(dither_residual, CONFIG.LED_COUNT);
   
   // CRITICAL FIX: Allocate secondary LED buffers if enabled
   if (ENABLE_SECONDARY_LEDS) {
     leds_scaled_secondary = new CRGB16[SECONDARY_LED_COUNT_CONST];
     leds_out_secondary = new CRGB[SECONDARY_LED_COUNT_CONST];
+    dither_residual_secondary = new DitherResidual[SECONDARY_LED_COUNT_CONST];
     
-    if (leds_scaled_secondary == nullptr || leds_out_secondary == nullptr) {
+    if (leds_scaled_secondary == nullptr || leds_out_secondary == nullptr || dither_residual_secondary == nullptr) {
       USBSerial.println("ERROR: Failed to allocate secondary LED buffers!");
       ESP.restart();
     }
+    seed_dither_residuals(dither_residual_secondary, SECONDARY_LED_COUNT_CONST);
     
     // Initialize secondary buffers to black
     for (uint16_t i = 0; i < SECONDARY_LED_COUNT_CONST; i++) {
@@ -1212,19 +1392,20 @@ inline void init_leds() {
 
 inline void blocking_flash(CRGB16 col) {
   led_thread_halt = true;
-  for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+  for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
     leds_16[i] = { 0, 0, 0 };
   }
 
   const uint8_t flash_times = 2;
   for (uint8_t f = 0; f < flash_times; f++) {
-    for (uint8_t i = 0 + 48; i < NATIVE_RESOLUTION - 48; i++) {
+    uint16_t margin = NATIVE_RESOLUTION * 3 / 10;
+    for (uint16_t i = margin; i < NATIVE_RESOLUTION - margin; i++) {
       leds_16[i] = col;
     }
     show_leds();
     FastLED.delay(150);
 
-    for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+    for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
       leds_16[i] = { 0, 0, 0 };
     }
     show_leds();
@@ -1234,7 +1415,7 @@ inline void blocking_flash(CRGB16 col) {
 }
 
 inline void clear_all_led_buffers() {
-  for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+  for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
     leds_16[i] = { 0, 0, 0 };
     leds_16_temp[i] = { 0, 0, 0 };
     leds_16_fx[i] = { 0, 0, 0 };
@@ -1246,16 +1427,17 @@ inline void clear_all_led_buffers() {
   }
 }
 
+// In place, like shift_leds_up() and mirror_image_downwards() below: no
+// shared scratch buffer, so both strips' modes can run at once (strip_worker.h)
 inline void scale_image_to_half(CRGB16* led_array) {
-  for (uint16_t i = 0; i < (NATIVE_RESOLUTION >> 1); i++) {
-    leds_16_temp[i].r = led_array[i << 1].r * SQ15x16(0.5) + led_array[(i << 1) + 1].r * SQ15x16(0.5);
-    leds_16_temp[i].g = led_array[i << 1].g * SQ15x16(0.5) + led_array[(i << 1) + 1].g * SQ15x16(0.5);
-    leds_16_temp[i].b = led_array[i << 1].b * SQ15x16(0.5) + led_array[(i << 1) + 1].b * SQ15x16(0.5);
-    // Clear the second half of the temp buffer
-    leds_16_temp[(NATIVE_RESOLUTION >> 1) + i] = { 0, 0, 0 };
+  uint16_t half_res = NATIVE_RESOLUTION >> 1;
+  for (uint16_t i = 0; i < half_res; i++) {  // Reads i*2 and i*2+1, never behind the write
+    led_array[i].r = led_array[i << 1].r * SQ15x16(0.5) + led_array[(i << 1) + 1].r * SQ15x16(0.5);
+    led_array[i].g = led_array[i << 1].g * SQ15x16(0.5) + led_array[(i << 1) + 1].g * SQ15x16(0.5);
+    led_array[i].b = led_array[i << 1].b * SQ15x16(0.5) + led_array[(i << 1) + 1].b * SQ15x16(0.5);
   }
-
-  memcpy(led_array, leds_16_temp, sizeof(CRGB16) * NATIVE_RESOLUTION);
+  // Clear the second half
+  memset(led_array + half_res, 0, sizeof(CRGB16) * (NATIVE_RESOLUTION - half_res));
 }
 
 inline void unmirror() {
@@ -1283,8 +1465,7 @@ inline void unmirror() {
 }
 
 inline void shift_leds_up(CRGB16* led_array, uint16_t offset) {
-  memcpy(leds_16_temp, led_array, sizeof(CRGB16) * NATIVE_RESOLUTION);
-  memcpy(led_array + offset, leds_16_temp, (NATIVE_RESOLUTION - offset) * sizeof(CRGB16));
+  memmove(led_array + offset, led_array, (NATIVE_RESOLUTION - offset) * sizeof(CRGB16));
   memset(led_array, 0, offset * sizeof(CRGB16));
 }
 
@@ -1296,13 +1477,9 @@ inline void shift_leds_down(CRGB* led_array, uint16_t offset) {
 inline void mirror_image_downwards(CRGB16* led_array) {
   uint16_t half_res = NATIVE_RESOLUTION >> 1;
   for (uint16_t i = 0; i < half_res; i++) { // Loop up to half resolution
-    // Copy the pixel from the second half
-    leds_16_temp[half_res + i] = led_array[half_res + i];
-    // Mirror it to the first half (e.g., index 159 mirrors to 0, 158 to 1, etc.)
-    leds_16_temp[half_res - 1 - i] = led_array[half_res + i];
+    // Mirror the second half to the first (e.g., index 159 mirrors to 0, 158 to 1, etc.)
+    led_array[half_res - 1 - i] = led_array[half_res + i];
   }
-
-  memcpy(led_array, leds_16_temp, sizeof(CRGB16) * NATIVE_RESOLUTION);
 }
 
 inline void intro_animation() {
@@ -1327,12 +1504,13 @@ inline void intro_animation() {
 
     float pos = (cos(progress * 5) + 1) / 2.0;
     float pos_whole = pos * NATIVE_RESOLUTION;
-    for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+    float radius = 5.0 * render_scale();
+    for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
       float delta = fabs(pos_whole - i);
-      if (delta > 5.0) {
-        delta = 5.0;
+      if (delta > radius) {
+        delta = radius;
       }
-      float led_level = 1.0 - (delta / 5.0);
+      float led_level = 1.0 - (delta / radius);
       CRGB16 out_col = hsv_or_palette(progress, 0, led_level);
       leds_16[i] = out_col;
     }
@@ -1357,6 +1535,7 @@ inline void intro_animation() {
   }
   MASTER_BRIGHTNESS = 1.0;
   float center_brightness = 0.0;
+  float particle_radius = 10.0 * render_scale();
 
   for (uint16_t i = 0; i < 50; i++) {
     if (center_brightness < 1.0) {
@@ -1395,12 +1574,12 @@ inline void intro_animation() {
 
       float pos = (sin(particles[p].phase * 5) + 1) / 2.0;
       float pos_whole = pos * NATIVE_RESOLUTION;
-      for (uint8_t pix = 0; pix < NATIVE_RESOLUTION; pix++) {
+      for (uint16_t pix = 0; pix < NATIVE_RESOLUTION; pix++) {
         float delta = fabs(pos_whole - pix);
-        if (delta > 10.0) {
-          delta = 10.0;
+        if (delta > particle_radius) {
+          delta = particle_radius;
         }
-        float led_level = 1.0 - (delta / 10.0);
+        float led_level = 1.0 - (delta / particle_radius);
         led_level *= led_level;
         CRGB16 out_col = particles[p].col;
         out_col.r *= led_level;
@@ -1457,7 +1636,7 @@ inline void run_transition_fade() {
 
 /*
 inline void distort_exponential() {
-  for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+  for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
     float prog = i / float(NATIVE_RESOLUTION - 1);
     float prog_distorted = prog * prog;
     leds_fx[i] = lerp_led_NEW(prog_distorted, leds);
@@ -1466,7 +1645,7 @@ inline void distort_exponential() {
 }
 
 inline void distort_logarithmic() {
-  for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+  for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
     float prog = i / float(NATIVE_RESOLUTION - 1);
     float prog_distorted = sqrt(prog);
     leds_fx[i] = lerp_led_NEW(prog_distorted, leds);
@@ -1475,7 +1654,7 @@ inline void distort_logarithmic() {
 }
 
 inline void increase_saturation(uint8_t amount) {
-  for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+  for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
     CHSV hsv = rgb2hsv_approximate(leds[i]);
     hsv.s = qadd8(hsv.s, amount);
     leds[i] = hsv;
@@ -1487,7 +1666,7 @@ inline void fade_top_half(bool shifted = false) {
   if (shifted == true) {
     shift -= (NATIVE_RESOLUTION >> 1); // Use half resolution
   }
-  for (uint8_t i = 0; i < (NATIVE_RESOLUTION >> 1); i++) {
+  for (uint16_t i = 0; i < (NATIVE_RESOLUTION >> 1); i++) {
     float fade = i / float(NATIVE_RESOLUTION >> 1);
 
     leds[(NATIVE_RESOLUTION - 1 - i) + shift].r *= fade;
@@ -1542,7 +1721,7 @@ inline uint8_t apply_contrast(uint8_t value, uint8_t intensity) {
 
 /*
 inline void force_incandescent_output() {
-  for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+  for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
     uint8_t max_val = 0;
     if (leds[i].r > max_val) { max_val = leds[i].r; }
     if (leds[i].g > max_val) { max_val = leds[i].g; }
@@ -1559,7 +1738,7 @@ inline void force_incandescent_output() {
 inline void render_bulb_cover() {
   SQ15x16 cover[4] = { 0.25, 1.00, 0.25, 0.00 };
 
-  for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+  for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
     CRGB16 covered_color = {
       { leds_16[i].r * cover[i % 4] },
       { leds_16[i].g * cover[i % 4] },
@@ -1593,108 +1772,95 @@ inline CRGB force_hue(CRGB input, uint8_t hue) {
 
 inline void blend_buffers(CRGB16* output_array, CRGB16* input_a, CRGB16* input_b, uint8_t blend_mode, SQ15x16 mix) {
   if (blend_mode == BLEND_MIX) {
-    for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
-      output_array[i].r = input_a[i].r * (1.0 - mix) + input_b[i].r * (mix);
-      output_array[i].g = input_a[i].g * (1.0 - mix) + input_b[i].g * (mix);
-      output_array[i].b = input_a[i].b * (1.0 - mix) + input_b[i].b * (mix);
+    for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
+      output_array[i] = pixel_mix(input_a[i], input_b[i], mix);
     }
   } else if (blend_mode == BLEND_ADD) {
-    for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
-      output_array[i].r = input_a[i].r + (input_b[i].r * mix);
-      output_array[i].g = input_a[i].g + (input_b[i].g * mix);
-      output_array[i].b = input_a[i].b + (input_b[i].b * mix);
+    for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
+      output_array[i] = pixel_add(input_a[i], pixel_scale(input_b[i], mix));
     }
   } else if (blend_mode == BLEND_MULTIPLY) {
-    for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
-      output_array[i].r = input_a[i].r * input_b[i].r;
-      output_array[i].g = input_a[i].g * input_b[i].g;
-      output_array[i].b = input_a[i].b * input_b[i].b;
+    for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
+      output_array[i] = pixel_multiply(input_a[i], input_b[i]);
     }
   }
 }
 
-inline void apply_prism_effect(float iterations, SQ15x16 opacity) {
+inline void apply_prism_effect(RenderContext& ctx, float iterations, SQ15x16 opacity) {
+  CRGB16* leds = ctx.leds;
+  CRGB16* fx = ctx.fx;  // The context's own scratch (render_context.h)
+
   // Handle the whole number part of iterations
   uint8_t whole_iterations = (uint8_t)iterations;
   
-  // Store original values that we need to preserve
-  SQ15x16 original_hue_position = hue_position;
-  
   // Apply full iterations
   for (uint8_t i = 0; i < whole_iterations; i++) {
-    memcpy(leds_16_fx, leds_16, sizeof(CRGB16) * NATIVE_RESOLUTION);
+    memcpy(fx, leds, sizeof(CRGB16) * NATIVE_RESOLUTION);
 
-    scale_image_to_half(leds_16_fx);
-    shift_leds_up(leds_16_fx, (NATIVE_RESOLUTION >> 1));
-    mirror_image_downwards(leds_16_fx);
+    scale_image_to_half(fx);
+    shift_leds_up(fx, (NATIVE_RESOLUTION >> 1));
+    mirror_image_downwards(fx);
     
     // Apply color shift to this prism iteration
     // Each successive prism gets a slight hue shift
     float hue_shift = (i * 0.05); // 5% hue shift per prism
     
     // Apply the hue shift to the prism
-    for (uint8_t j = 0; j < NATIVE_RESOLUTION; j++) {
+    for (uint16_t j = 0; j < NATIVE_RESOLUTION; j++) {
       // Only shift colors if there's actual color data
-      if (leds_16_fx[j].r > 0 || leds_16_fx[j].g > 0 || leds_16_fx[j].b > 0) {
-        leds_16_fx[j] = adjust_hue_and_saturation(
-          leds_16_fx[j], 
-          fmod_fixed(hue_position + hue_shift, 1.0), 
-          CONFIG.SATURATION
+      if (fx[j].r > 0 || fx[j].g > 0 || fx[j].b > 0) {
+        fx[j] = adjust_hue_and_saturation(
+          fx[j], 
+          fmod_fixed(ctx.hue.position + hue_shift, 1.0), 
+          ctx.config.SATURATION
         );
       }
     }
 
-    // memcpy(leds_16_fx_2, leds_16, sizeof(CRGB16) * NATIVE_RESOLUTION); // No longer needed
-    blend_buffers(leds_16, leds_16, leds_16_fx, BLEND_ADD, opacity); // Blend original (leds_16) with processed (leds_16_fx)
+    // memcpy(fx_2, leds_16, sizeof(CRGB16) * NATIVE_RESOLUTION); // No longer needed
+    blend_buffers(leds, leds, fx, BLEND_ADD, opacity); // Blend original (leds) with processed (fx)
   }
   
   // Handle the fractional part if any
   float fractional_part = iterations - whole_iterations;
   if (fractional_part > 0.01) { // Only process if the fractional part is significant
-    memcpy(leds_16_fx, leds_16, sizeof(CRGB16) * NATIVE_RESOLUTION);
+    memcpy(fx, leds, sizeof(CRGB16) * NATIVE_RESOLUTION);
 
-    scale_image_to_half(leds_16_fx);
-    shift_leds_up(leds_16_fx, (NATIVE_RESOLUTION >> 1));
-    mirror_image_downwards(leds_16_fx);
+    scale_image_to_half(fx);
+    shift_leds_up(fx, (NATIVE_RESOLUTION >> 1));
+    mirror_image_downwards(fx);
     
     // Apply color shift to the fractional prism as well
     float hue_shift = (whole_iterations * 0.05);
     
     // Apply the hue shift to the prism
-    for (uint8_t j = 0; j < NATIVE_RESOLUTION; j++) {
+    for (uint16_t j = 0; j < NATIVE_RESOLUTION; j++) {
       // Only shift colors if there's actual color data
-      if (leds_16_fx[j].r > 0 || leds_16_fx[j].g > 0 || leds_16_fx[j].b > 0) {
-        leds_16_fx[j] = adjust_hue_and_saturation(
-          leds_16_fx[j], 
-          fmod_fixed(hue_position + hue_shift, 1.0), 
-          CONFIG.SATURATION
+      if (fx[j].r > 0 || fx[j].g > 0 || fx[j].b > 0) {
+        fx[j] = adjust_hue_and_saturation(
+          fx[j], 
+          fmod_fixed(ctx.hue.position + hue_shift, 1.0), 
+          ctx.config.SATURATION
         );
       }
     }
 
-    // memcpy(leds_16_fx_2, leds_16, sizeof(CRGB16) * NATIVE_RESOLUTION); // No longer needed
+    // memcpy(fx_2, leds_16, sizeof(CRGB16) * NATIVE_RESOLUTION); // No longer needed
     // Apply the effect with reduced opacity based on the fractional part
-    blend_buffers(leds_16, leds_16, leds_16_fx, BLEND_ADD, opacity * fractional_part); // Blend original (leds_16) with processed (leds_16_fx)
+    blend_buffers(leds, leds, fx, BLEND_ADD, opacity * fractional_part); // Blend original (leds) with processed (fx)
   }
-  
-  // Restore the original values to prevent side effects
-  hue_position = original_hue_position;
 }
 
 inline void clear_leds() {
   memset(leds_16, 0, sizeof(CRGB16) * NATIVE_RESOLUTION);
 }
 
-inline void process_color_shift() {
-  int16_t rounded_index = spectral_history_index - 1;
-  while (rounded_index < 0) {
-    rounded_index += SPECTRAL_HISTORY_LENGTH;
-  }
-
-  SQ15x16 novelty_now = novelty_curve[rounded_index];
+// One step of a context's hue walk (update_render_color_shift(),
+// render_context.h); novelty_now is led_audio->novelty
+inline void process_color_shift(ColorShiftState& hue, SQ15x16 novelty_now) {
   
   // Use debug manager for proper timing control (2.6 second interval with stagger)
-  DBG_COLOR_SHIFT(float(novelty_now), float(hue_position), float(hue_shift_speed));
+  DBG_COLOR_SHIFT(float(novelty_now), float(hue.position), float(hue.speed));
 
   // EXACT REFERENCE IMPLEMENTATION - DO NOT MODIFY
   // Remove bottom 10%, stretch values to still occupy full 0.0-1.0 range
@@ -1713,44 +1879,44 @@ inline void process_color_shift() {
   }
 
   // Lower threshold for triggering color shift
-  if (novelty_now > hue_shift_speed * 0.5) {  // More sensitive trigger
-    hue_shift_speed = novelty_now * SQ15x16(0.75);
+  if (novelty_now > hue.speed * 0.5) {  // More sensitive trigger
+    hue.speed = novelty_now * SQ15x16(0.75);
   } else {
-    hue_shift_speed *= SQ15x16(0.99);
+    hue.speed *= SQ15x16(0.99);
   }
   
   // Ensure minimum speed to prevent getting stuck at red
-  if (hue_shift_speed < 0.0001) {
-    hue_shift_speed = 0.0001;
+  if (hue.speed < 0.0001) {
+    hue.speed = 0.0001;
   }
 
   // Add and wrap
-  hue_position += (hue_shift_speed * hue_push_direction);
-  while (hue_position < 0.0) {
-    hue_position += 1.0;
+  hue.position += (hue.speed * hue.push_direction);
+  while (hue.position < 0.0) {
+    hue.position += 1.0;
   }
-  while (hue_position >= 1.0) {
-    hue_position -= 1.0;
+  while (hue.position >= 1.0) {
+    hue.position -= 1.0;
   }
 
-  if (fabs_fixed(hue_position - hue_destination) <= 0.01) {
-    hue_push_direction *= -1.0;
-    hue_shifting_mix_target *= -1.0;
-    hue_destination = random_float();
-    //printf("###################################### NEW DEST: %f\n", hue_destination);
+  if (fabs_fixed(hue.position - hue.destination) <= 0.01) {
+    hue.push_direction *= -1.0;
+    hue.shifting_mix_target *= -1.0;
+    hue.destination = random_float();
+    //printf("###################################### NEW DEST: %f\n", hue.destination);
   }
 
-  SQ15x16 hue_shifting_mix_distance = fabs_fixed(hue_shifting_mix - hue_shifting_mix_target);
-  if (hue_shifting_mix < hue_shifting_mix_target) {
-    hue_shifting_mix += hue_shifting_mix_distance * 0.01;
-  } else if (hue_shifting_mix > hue_shifting_mix_target) {
-    hue_shifting_mix -= hue_shifting_mix_distance * 0.01;
+  SQ15x16 shifting_mix_distance = fabs_fixed(hue.shifting_mix - hue.shifting_mix_target);
+  if (hue.shifting_mix < hue.shifting_mix_target) {
+    hue.shifting_mix += shifting_mix_distance * 0.01;
+  } else if (hue.shifting_mix > hue.shifting_mix_target) {
+    hue.shifting_mix -= shifting_mix_distance * 0.01;
   }
 
   /*
     if(chance(0.2) == true){ //0.2% of loops
-        hue_push_direction *= -1.0;
-        printf("###################################### SWITCH DIR: %f\n", hue_push_direction);
+        hue.push_direction *= -1.0;
+        printf("###################################### SWITCH DIR: %f\n", hue.push_direction);
     }
     */
 }
@@ -2000,13 +2166,13 @@ inline void scale_to_secondary_strip() {
 
 inline void apply_brightness_secondary() {
   // Apply the same silence scaling used for the primary LEDs
-  float bright_val = SECONDARY_PHOTONS * SECONDARY_PHOTONS * silent_scale;
+  float bright_val = SECONDARY_PHOTONS * SECONDARY_PHOTONS * led_audio->silent_scale;
   
   if (debug_mode && (millis() % 5000 == 0)) {
     USBSerial.print("DEBUG: Secondary brightness = ");
     USBSerial.print(SECONDARY_PHOTONS);
     USBSerial.print("² × silent_scale(");
-    USBSerial.print(silent_scale);
+    USBSerial.print(led_audio->silent_scale);
     USBSerial.print(") = ");
     USBSerial.println(bright_val);
   }
@@ -2028,11 +2194,11 @@ inline void show_secondary_leds() {
   if (SECONDARY_INCANDESCENT_FILTER > 0.0) { 
     SQ15x16 filter_strength = SECONDARY_INCANDESCENT_FILTER; // Use fixed-point
     for (uint16_t i = 0; i < SECONDARY_LED_COUNT_CONST; i++) {
-      // Direct fixed-point to uint8_t conversion (assuming 0.0-1.0 maps to 0-255)
-      // Note: Clamping might be needed depending on exact fixed-point behavior
-      uint8_t r_raw = (leds_scaled_secondary[i].r * 255).getInteger(); 
-      uint8_t g_raw = (leds_scaled_secondary[i].g * 255).getInteger();
-      uint8_t b_raw = (leds_scaled_secondary[i].b * 255).getInteger();
+      // Through the output curve, like quantize_color_secondary()
+      CRGB raw = output_led(leds_scaled_secondary[i]);
+      uint8_t r_raw = raw.r;
+      uint8_t g_raw = raw.g;
+      uint8_t b_raw = raw.b;
 
       // Apply incandescent color correction using integer/fixed-point math
       // Ensure filter_strength doesn't exceed 1.0 before calculations
@@ -2100,7 +2266,7 @@ inline void apply_enhanced_visuals() {
   memcpy(leds_16_fx, leds_16, sizeof(CRGB16) * NATIVE_RESOLUTION);
   
   // 1. Add subtle bloom/glow effect based on audio_vu_level
-  float bloom_intensity = 0.15 + float(audio_vu_level) * 0.2;
+  float bloom_intensity = 0.15 + float(led_audio->vu_level) * 0.2;
   
   // Create a blurred version in leds_16_temp
   for (uint16_t i = 1; i < NATIVE_RESOLUTION-1; i++) {
@@ -2140,8 +2306,8 @@ inline void apply_enhanced_visuals() {
   }
   
   // 3. Dynamic color enhancement - make colors more vibrant during beats
-  if (audio_vu_level > audio_vu_level_average * 1.2) {
-    float enhancement = (float(audio_vu_level) / float(audio_vu_level_average) - 1.0) * 0.4;
+  if (led_audio->vu_level > led_audio->vu_level_average * 1.2) {
+    float enhancement = (float(led_audio->vu_level) / float(led_audio->vu_level_average) - 1.0) * 0.4;
     if (enhancement > 0.25) enhancement = 0.25;
     
     for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
@@ -2165,34 +2331,12 @@ inline void apply_enhanced_visuals() {
 // Add a quantization function for the secondary strip similar to primary
 inline void quantize_color_secondary(bool temporal_dither) {
   if (temporal_dither) {
-    static uint8_t noise_origin_r_s = 0, noise_origin_g_s = 0, noise_origin_b_s = 0;
-    noise_origin_r_s++;
-    noise_origin_g_s++;
-    noise_origin_b_s++;
     for (uint16_t i = 0; i < SECONDARY_LED_COUNT_CONST; i++) {
-      SQ15x16 decimal_r = leds_scaled_secondary[i].r * SQ15x16(254);
-      SQ15x16 whole_r = decimal_r.getInteger();
-      SQ15x16 fract_r = decimal_r - whole_r;
-      if (fract_r >= dither_table[(noise_origin_r_s + i) % 8]) whole_r += SQ15x16(1);
-      leds_out_secondary[i].r = whole_r.getInteger();
-
-      SQ15x16 decimal_g = leds_scaled_secondary[i].g * SQ15x16(254);
-      SQ15x16 whole_g = decimal_g.getInteger();
-      SQ15x16 fract_g = decimal_g - whole_g;
-      if (fract_g >= dither_table[(noise_origin_g_s + i) % 8]) whole_g += SQ15x16(1);
-      leds_out_secondary[i].g = whole_g.getInteger();
-
-      SQ15x16 decimal_b = leds_scaled_secondary[i].b * SQ15x16(254);
-      SQ15x16 whole_b = decimal_b.getInteger();
-      SQ15x16 fract_b = decimal_b - whole_b;
-      if (fract_b >= dither_table[(noise_origin_b_s + i) % 8]) whole_b += SQ15x16(1);
-      leds_out_secondary[i].b = whole_b.getInteger();
+      leds_out_secondary[i] = dither_led(leds_scaled_secondary[i], dither_residual_secondary[i]);
     }
   } else {
     for (uint16_t i = 0; i < SECONDARY_LED_COUNT_CONST; i++) {
-      leds_out_secondary[i].r = uint8_t(leds_scaled_secondary[i].r * 255);
-      leds_out_secondary[i].g = uint8_t(leds_scaled_secondary[i].g * 255);
-      leds_out_secondary[i].b = uint8_t(leds_scaled_secondary[i].b * 255);
+      leds_out_secondary[i] = output_led(leds_scaled_secondary[i]);
     }
   }
 }
@@ -12,11 +12,29 @@ void cache_frame_config() {
   frame_config.SQUARE_ITER = CONFIG.SQUARE_ITER;
   frame_config.SATURATION = CONFIG.SATURATION;
   frame_config.PALETTE_INDEX = CONFIG.PALETTE_INDEX;
+  frame_config.MIRROR_ENABLED = CONFIG.MIRROR_ENABLED;
+  frame_config.AUTO_COLOR_SHIFT = CONFIG.AUTO_COLOR_SHIFT;
 
   const CRGB16* palette_lut = palette_lut_for_index(frame_config.PALETTE_INDEX);
   frame_config.palette_ptr = palette_lut;
   frame_config.palette_size = palette_lut_size(frame_config.PALETTE_INDEX);
 
+  // Each strip's settings for this frame (render_context.h)
+  primary_render.config = frame_config;
+  primary_render.prism_count = CONFIG.PRISM_COUNT;
+  update_render_chroma(primary_render);
+
+  // The secondary strip shares everything but its own knobs
+  secondary_render.config = frame_config;
+  secondary_render.config.PHOTONS = SECONDARY_PHOTONS;
+  secondary_render.config.CHROMA = SECONDARY_CHROMA;
+  secondary_render.config.MOOD = SECONDARY_MOOD;
+  secondary_render.config.LIGHTSHOW_MODE = SECONDARY_LIGHTSHOW_MODE;
+  secondary_render.config.MIRROR_ENABLED = SECONDARY_MIRROR_ENABLED;
+  secondary_render.config.AUTO_COLOR_SHIFT = SECONDARY_AUTO_COLOR_SHIFT;
+  secondary_render.prism_count = SECONDARY_PRISM_COUNT;
+  update_render_chroma(secondary_render);
+
   uint32_t pal_state = frame_config.palette_ptr ? (kPaletteTraceMagic | frame_config.palette_size) : 0u;
   TRACE_INFO(LED_FRAME_START, pal_state);
 }
@@ -53,7 +71,7 @@ void get_smooth_spectrogram() {
   }
 
   for (uint8_t bin = 0; bin < NUM_FREQS; bin++) {
-    SQ15x16 note_brightness = spectrogram[bin];
+    SQ15x16 note_brightness = led_audio->spectrogram[bin];
 
     if (spectrogram_smooth[bin] < note_brightness) {
       SQ15x16 distance = note_brightness - spectrogram_smooth[bin];
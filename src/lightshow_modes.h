@@ -39,19 +39,25 @@ inline void avg_bins(uint8_t low_bin, uint8_t high_bin) {
   // TBD
 }
 
-inline void test_mode() {
+inline void test_mode(RenderContext& ctx) {
+  CRGB16* leds = ctx.leds;
+  const cached_config& cfg = ctx.config;
+
   static float radians = 0.00;
-  radians += frame_config.MOOD;
+  radians += cfg.MOOD;
   float position = sin(radians) * 0.5 + 0.5;
-  set_dot_position(RESERVED_DOTS + 0, position);
-  clear_leds();
+  set_dot_position(ctx.dots[0], position);
+  memset(leds, 0, sizeof(CRGB16) * NATIVE_RESOLUTION);
   // CHROMA OVERRIDE FIX [2025-09-20] - Use palette-safe hue calculation
-  SQ15x16 orbit_hue = (CONFIG.PALETTE_INDEX > 0) ? SQ15x16(0.0) : chroma_val;  // Neutral hue for palettes
-  draw_dot(leds_16, RESERVED_DOTS + 0, hsv_or_palette(orbit_hue, frame_config.SATURATION, frame_config.PHOTONS * frame_config.PHOTONS));
+  SQ15x16 orbit_hue = (cfg.PALETTE_INDEX > 0) ? SQ15x16(0.0) : ctx.chroma_val;  // Neutral hue for palettes
+  draw_dot(leds, ctx.dots[0], hsv_or_palette(cfg, orbit_hue, cfg.SATURATION, cfg.PHOTONS * cfg.PHOTONS));
 }
 
 // Default mode!
-inline void light_mode_gdft() {
+inline void light_mode_gdft(RenderContext& ctx) {
+  CRGB16* leds = ctx.leds;
+  const cached_config& cfg = ctx.config;
+
   // Calculate frequency data for the first half of the strip
   for (uint16_t i = 0; i < (NATIVE_RESOLUTION / 2); i++) {
     // Map the 64 frequency bins across the first half (NATIVE_RESOLUTION / 2 LEDs)
@@ -67,11 +73,11 @@ inline void light_mode_gdft() {
 
     if (bin > 1.0) { bin = 1.0; }
 
-    uint8_t base_iters = (uint8_t)frame_config.SQUARE_ITER;
-    float fract_iter = frame_config.SQUARE_ITER - base_iters;
+    uint8_t base_iters = (uint8_t)cfg.SQUARE_ITER;
+    float fract_iter = cfg.SQUARE_ITER - base_iters;
 
     uint8_t extra_iters = 0;
-    if (chromatic_mode == true) {
+    if (ctx.chromatic_mode == true) {
       extra_iters = 1;
     }
 
@@ -88,7 +94,7 @@ inline void light_mode_gdft() {
 
     SQ15x16 led_hue;
     SQ15x16 prog = (SQ15x16)i / (SQ15x16)(NATIVE_RESOLUTION / 2); // Use LED position for hue progression
-    if (chromatic_mode == true) {
+    if (ctx.chromatic_mode == true) {
       // Interpolate note colors across the half-strip based on frequency index
        SQ15x16 color_prog = (SQ15x16)(freq_index_i % 12) / 12.0;
        SQ15x16 next_color_prog = (SQ15x16)((freq_index_i + 1) % 12) / 12.0;
@@ -102,19 +108,19 @@ inline void light_mode_gdft() {
        if (led_hue >= 1.0) led_hue -= 1.0; // Normalize back to 0-1 range
 
     } else {
-      // Use frame_config.CHROMA directly
-      led_hue = frame_config.CHROMA + hue_position + ((sqrt(float(bin)) * SQ15x16(0.05)) + (prog * SQ15x16(0.10)) * hue_shifting_mix);
+      // Use cfg.CHROMA directly
+      led_hue = cfg.CHROMA + ctx.hue.position + ((sqrt(float(bin)) * SQ15x16(0.05)) + (prog * SQ15x16(0.10)) * ctx.hue.shifting_mix);
     }
 
     // Place calculated color in the second half of the buffer initially
-    leds_16[i + (NATIVE_RESOLUTION / 2)] = hsv(led_hue + bin * SQ15x16(0.050), frame_config.SATURATION, bin);
+    leds[i + (NATIVE_RESOLUTION / 2)] = hsv(led_hue + bin * SQ15x16(0.050), cfg.SATURATION, bin);
   }
 
   // Clear the first half before mirroring
-  memset(leds_16, 0, sizeof(CRGB16) * (NATIVE_RESOLUTION / 2));
+  memset(leds, 0, sizeof(CRGB16) * (NATIVE_RESOLUTION / 2));
 
   // No shift needed, just mirror the calculated second half to the first half
-  mirror_image_downwards(leds_16);  // (led_utilities.h) Mirror downwards
+  mirror_image_downwards(leds);  // (led_utilities.h) Mirror downwards
 }
 
 /*
@@ -166,7 +172,7 @@ inline void light_mode_bloom(bool fast_scroll) {
     //sum_color = force_saturation(sum_color, 255 * CONFIG.SATURATION);
 
     if (fast_scroll == true) {  // Fast mode scrolls two LEDs at a time
-      for (uint8_t i = 0; i < NATIVE_RESOLUTION - 2; i++) {
+      for (uint16_t i = 0; i < NATIVE_RESOLUTION - 2; i++) {
         leds_fx[(NATIVE_RESOLUTION - 1) - i] = leds_last[(NATIVE_RESOLUTION - 1) - i - 2];
       }
 
@@ -174,7 +180,7 @@ inline void light_mode_bloom(bool fast_scroll) {
       leds_fx[1] = sum_color;  // New information goes here
 
     } else {  // Slow mode only scrolls one LED at a time
-      for (uint8_t i = 0; i < NATIVE_RESOLUTION - 1; i++) {
+      for (uint16_t i = 0; i < NATIVE_RESOLUTION - 1; i++) {
         leds_fx[(NATIVE_RESOLUTION - 1) - i] = leds_last[(NATIVE_RESOLUTION - 1) - i - 1];
       }
 
@@ -199,14 +205,27 @@ inline void light_mode_bloom(bool fast_scroll) {
 }
 */
 
-inline void light_mode_vu_dot() {
-  static SQ15x16 dot_pos_last = 0.0;
-  static SQ15x16 audio_vu_level_smooth = 0.0;
-  static SQ15x16 max_level = 0.01;
+struct VuDotState {
+  SQ15x16 dot_pos_last;
+  SQ15x16 vu_level_smooth;
+  SQ15x16 max_level;
+};
+
+inline void init_vu_dot(RenderContext& ctx) {
+  mode_state<VuDotState>(ctx).max_level = 0.01;
+}
+
+inline void light_mode_vu_dot(RenderContext& ctx) {
+  CRGB16* leds = ctx.leds;
+  const cached_config& cfg = ctx.config;
+  VuDotState& v = mode_state<VuDotState>(ctx);
+  SQ15x16& dot_pos_last = v.dot_pos_last;
+  SQ15x16& audio_vu_level_smooth = v.vu_level_smooth;
+  SQ15x16& max_level = v.max_level;
 
-  SQ15x16 mix_amount = mood_scale(0.10, 0.05);
+  SQ15x16 mix_amount = render_mood_scale(ctx, 0.10, 0.05);
 
-  audio_vu_level_smooth = (audio_vu_level_average * mix_amount) + (audio_vu_level_smooth * (1.0 - mix_amount));
+  audio_vu_level_smooth = (led_audio->vu_level_average * mix_amount) + (audio_vu_level_smooth * (1.0 - mix_amount));
 
   if (audio_vu_level_smooth * 1.1 > max_level) {
     SQ15x16 distance = (audio_vu_level_smooth * 1.1) - max_level;
@@ -225,39 +244,51 @@ inline void light_mode_vu_dot() {
     dot_pos = 1.0;
   }
 
-  SQ15x16 mix = mood_scale(0.25, 0.24);
+  SQ15x16 mix = render_mood_scale(ctx, 0.25, 0.24);
   SQ15x16 dot_pos_smooth = (dot_pos * mix) + (dot_pos_last * (1.0-mix));
   dot_pos_last = dot_pos_smooth;
 
   SQ15x16 brightness = sqrt(float(dot_pos_smooth));
 
-  set_dot_position(RESERVED_DOTS + 0, dot_pos_smooth * 0.5 + 0.5);
-  set_dot_position(RESERVED_DOTS + 1, 0.5 - dot_pos_smooth * 0.5);
+  set_dot_position(ctx.dots[0], dot_pos_smooth * 0.5 + 0.5);
+  set_dot_position(ctx.dots[1], 0.5 - dot_pos_smooth * 0.5);
 
-  clear_leds();
+  memset(leds, 0, sizeof(CRGB16) * NATIVE_RESOLUTION);
   //fade_grayscale(0.15);
 
   // CHROMA OVERRIDE FIX [2025-09-20] - Use palette-safe hue calculation
   SQ15x16 hue;
-  if (CONFIG.PALETTE_INDEX > 0) {
-    hue = hue_position;  // Palette mode: neutral hue, no CHROMA contamination
+  if (cfg.PALETTE_INDEX > 0) {
+    hue = ctx.hue.position;  // Palette mode: neutral hue, no CHROMA contamination
   } else {
-    hue = chroma_val + hue_position;  // HSV mode: full CHROMA control
+    hue = ctx.chroma_val + ctx.hue.position;  // HSV mode: full CHROMA control
   }
   // PALETTE TEST [2025-01-20]: Single injection point for safe testing
-  CRGB16 color = hsv_or_palette(hue, CONFIG.SATURATION, brightness);
-  draw_dot(leds_16, RESERVED_DOTS + 0, color);
-  draw_dot(leds_16, RESERVED_DOTS + 1, color);
+  CRGB16 color = hsv_or_palette(cfg, hue, cfg.SATURATION, brightness);
+  draw_dot(leds, ctx.dots[0], color);
+  draw_dot(leds, ctx.dots[1], color);
 }
 
-inline void light_mode_kaleidoscope() {
-  static float pos_r = 0.0;
-  static float pos_g = 0.0;
-  static float pos_b = 0.0;
-
-  static SQ15x16 brightness_low = 0.0;
-  static SQ15x16 brightness_mid = 0.0;
-  static SQ15x16 brightness_high = 0.0;
+struct KaleidoscopeState {
+  float pos_r;
+  float pos_g;
+  float pos_b;
+  SQ15x16 brightness_low;
+  SQ15x16 brightness_mid;
+  SQ15x16 brightness_high;
+};
+
+inline void light_mode_kaleidoscope(RenderContext& ctx) {
+  CRGB16* leds = ctx.leds;
+  const cached_config& cfg = ctx.config;
+  KaleidoscopeState& k = mode_state<KaleidoscopeState>(ctx);
+  float& pos_r = k.pos_r;
+  float& pos_g = k.pos_g;
+  float& pos_b = k.pos_b;
+
+  SQ15x16& brightness_low = k.brightness_low;
+  SQ15x16& brightness_mid = k.brightness_mid;
+  SQ15x16& brightness_high = k.brightness_high;
 
   SQ15x16 sum_low = 0.0;
   SQ15x16 sum_mid = 0.0;
@@ -294,7 +325,7 @@ inline void light_mode_kaleidoscope() {
   brightness_mid *= 0.99;
   brightness_high *= 0.99;
 
-  SQ15x16 shift_speed = (SQ15x16)100 + ((SQ15x16)500 * (SQ15x16)CONFIG.MOOD);
+  SQ15x16 shift_speed = (SQ15x16)100 + ((SQ15x16)500 * (SQ15x16)cfg.MOOD);
 
   SQ15x16 shift_r = (shift_speed * sum_low);
   SQ15x16 shift_g = (shift_speed * sum_mid);
@@ -327,8 +358,8 @@ inline void light_mode_kaleidoscope() {
     if (b_val > 1.0) { b_val = 1.0; };
 
     // Handle fractional contrast values
-    uint8_t base_iters = (uint8_t)CONFIG.SQUARE_ITER;
-    float fract_iter = CONFIG.SQUARE_ITER - base_iters;
+    uint8_t base_iters = (uint8_t)cfg.SQUARE_ITER;
+    float fract_iter = cfg.SQUARE_ITER - base_iters;
 
     // Apply full iterations
     for (uint8_t s = 0; s < base_iters; s++) {
@@ -367,22 +398,22 @@ inline void light_mode_kaleidoscope() {
     CRGB16 col = {{ r_val }, { g_val }, { b_val }};
     // COMMENTED OUT [2025-09-20 15:45] - Bug: guaranteed 10% desaturation even at max CONFIG.SATURATION
     // col = desaturate(col, 0.1 + (0.9 - 0.9*CONFIG.SATURATION));
-    // SATURATION FIX: Proper saturation control - only desaturate when CONFIG.SATURATION < 1.0
-    col = desaturate(col, (1.0 - CONFIG.SATURATION));
+    // SATURATION FIX: Proper saturation control - only desaturate when cfg.SATURATION < 1.0
+    col = desaturate(col, (1.0 - cfg.SATURATION));
 
-    if (chromatic_mode == false) {
+    if (ctx.chromatic_mode == false) {
       SQ15x16 brightness = 0.0;
       if(r_val > brightness){ brightness = r_val; }
       if(g_val > brightness){ brightness = g_val; }
       if(b_val > brightness){ brightness = b_val; }
 
       // Palette safety: avoid building palette colours at zero value.
-      if (CONFIG.PALETTE_INDEX > 0) {
+      if (cfg.PALETTE_INDEX > 0) {
         const SQ15x16 VMIN = SQ15x16(0.05); // 5% floor only for palette builds
         if (brightness < VMIN) {
           if (DebugManager::should_print(DEBUG_COLOR)) {
-            USBSerial.printf("[MODE/WAVEFORM] V-floor (palette) %.3f -> %.3f\n",
-                             float(brightness), float(VMIN));
+            DLOG("[MODE/WAVEFORM] V-floor (palette) %.3f -> %.3f\n",
+                 float(brightness), float(VMIN));
             DebugManager::mark_printed(DEBUG_COLOR);
           }
           brightness = VMIN;
@@ -391,26 +422,29 @@ inline void light_mode_kaleidoscope() {
 
       // Hue progression based on position in the half-strip
       SQ15x16 hue_prog = (SQ15x16)i / (SQ15x16)(NATIVE_RESOLUTION / 2 -1);
-      // Use CONFIG.CHROMA directly
-      SQ15x16 led_hue = CONFIG.CHROMA + hue_position + ((sqrt(float(brightness)) * SQ15x16(0.05)) + (hue_prog * SQ15x16(0.10)) * hue_shifting_mix);
-      col = hsv_or_palette(led_hue, CONFIG.SATURATION, brightness);
+      // Use cfg.CHROMA directly
+      SQ15x16 led_hue = cfg.CHROMA + ctx.hue.position + ((sqrt(float(brightness)) * SQ15x16(0.05)) + (hue_prog * SQ15x16(0.10)) * ctx.hue.shifting_mix);
+      col = hsv_or_palette(cfg, led_hue, cfg.SATURATION, brightness);
     }
 
     // Write to the first half and mirror to the second half
-    leds_16[i] = { col.r, col.g, col.b };
-    leds_16[NATIVE_RESOLUTION - 1 - i] = leds_16[i];
+    leds[i] = { col.r, col.g, col.b };
+    leds[NATIVE_RESOLUTION - 1 - i] = leds[i];
   }
 }
 
-inline void light_mode_chromagram_gradient() {
+inline void light_mode_chromagram_gradient(RenderContext& ctx) {
+  CRGB16* leds = ctx.leds;
+  const cached_config& cfg = ctx.config;
+
   // Loop through the second half of the strip
   for (uint16_t i = 0; i < (NATIVE_RESOLUTION / 2); i++) {
     SQ15x16 prog = (SQ15x16)i / (SQ15x16)(NATIVE_RESOLUTION / 2 -1); // Progress across the half strip
     SQ15x16 note_magnitude = interpolate(prog, chromagram_smooth, 12) * 0.9 + 0.1;
 
     // Handle fractional contrast values
-    uint8_t base_iters = (uint8_t)CONFIG.SQUARE_ITER;
-    float fract_iter = CONFIG.SQUARE_ITER - base_iters;
+    uint8_t base_iters = (uint8_t)cfg.SQUARE_ITER;
+    float fract_iter = cfg.SQUARE_ITER - base_iters;
 
     // Apply full iterations
     for (uint8_t s = 0; s < base_iters; s++) {
@@ -424,7 +458,7 @@ inline void light_mode_chromagram_gradient() {
     }
 
     SQ15x16 led_hue;
-    if (chromatic_mode == true) {
+    if (ctx.chromatic_mode == true) {
       // Interpolate note colors based on progress across the half-strip
       SQ15x16 color_prog = prog * 11.0; // Map 0-1 progress to 0-11 index range
       uint8_t idx1 = color_prog.getInteger();
@@ -443,23 +477,26 @@ inline void light_mode_chromagram_gradient() {
       if (led_hue >= 1.0) led_hue -= 1.0; // Normalize back to 0-1 range
 
     } else {
-      // Use CONFIG.CHROMA directly instead of the potentially stale global chroma_val
-      led_hue = CONFIG.CHROMA + hue_position + ((sqrt(float(note_magnitude)) * SQ15x16(0.05)) + (prog * SQ15x16(0.10)) * hue_shifting_mix);
+      // Use cfg.CHROMA directly instead of ctx.chroma_val
+      led_hue = cfg.CHROMA + ctx.hue.position + ((sqrt(float(note_magnitude)) * SQ15x16(0.05)) + (prog * SQ15x16(0.10)) * ctx.hue.shifting_mix);
     }
 
-    CRGB16 col = hsv_or_palette(led_hue, CONFIG.SATURATION, note_magnitude * note_magnitude);
+    CRGB16 col = hsv_or_palette(cfg, led_hue, cfg.SATURATION, note_magnitude * note_magnitude);
 
     // Write to the second half of the strip
-    leds_16[(NATIVE_RESOLUTION / 2) + i] = col;
+    leds[(NATIVE_RESOLUTION / 2) + i] = col;
     // Mirror to the first half of the strip
-    leds_16[(NATIVE_RESOLUTION / 2) - 1 - i] = col;
+    leds[(NATIVE_RESOLUTION / 2) - 1 - i] = col;
   }
 }
 
-inline void light_mode_chromagram_dots() {
+inline void light_mode_chromagram_dots(RenderContext& ctx) {
+  CRGB16* leds = ctx.leds;
+  const cached_config& cfg = ctx.config;
+
   // static SQ15x16 chromagram_last[12]; // Removed static buffer
 
-  memset(leds_16, 0, sizeof(CRGB16) * NATIVE_RESOLUTION);
+  memset(leds, 0, sizeof(CRGB16) * NATIVE_RESOLUTION);
   //dim_display(0.9);
 
   // low_pass_array_fixed(chromagram_smooth, chromagram_last, 12, LED_FPS, float(mood_scale(3.5, 1.5))); // Removed low-pass call
@@ -467,11 +504,11 @@ inline void light_mode_chromagram_dots() {
 
   for (uint8_t i = 0; i < 12; i++) {
     SQ15x16 led_hue;
-    if (chromatic_mode == true) {
+    if (ctx.chromatic_mode == true) {
       led_hue = note_colors[i];
     } else {
-      // Use CONFIG.CHROMA directly
-      led_hue = CONFIG.CHROMA + hue_position + (sqrt(float(1.0)) * SQ15x16(0.05));
+      // Use cfg.CHROMA directly
+      led_hue = cfg.CHROMA + ctx.hue.position + (sqrt(float(1.0)) * SQ15x16(0.05));
     }
 
     SQ15x16 magnitude = chromagram_smooth[i] * 1.0;
@@ -479,39 +516,42 @@ inline void light_mode_chromagram_dots() {
 
     magnitude = magnitude * magnitude;
 
-    CRGB16 col = hsv_or_palette(led_hue, CONFIG.SATURATION, magnitude);
+    CRGB16 col = hsv_or_palette(cfg, led_hue, cfg.SATURATION, magnitude);
 
-    set_dot_position(RESERVED_DOTS + i * 2 + 0, magnitude * 0.45 + 0.5);
-    set_dot_position(RESERVED_DOTS + i * 2 + 1, 0.5 - magnitude * 0.45);
+    set_dot_position(ctx.dots[i * 2 + 0], magnitude * 0.45 + 0.5);
+    set_dot_position(ctx.dots[i * 2 + 1], 0.5 - magnitude * 0.45);
 
-    draw_dot(leds_16, RESERVED_DOTS + i * 2 + 0, col);
-    draw_dot(leds_16, RESERVED_DOTS + i * 2 + 1, col);
+    draw_dot(leds, ctx.dots[i * 2 + 0], col);
+    draw_dot(leds, ctx.dots[i * 2 + 1], col);
   }
 }
 
-inline void light_mode_bloom(CRGB16* leds_prev_buffer) { // Accept previous buffer as argument
+struct BloomState {
+  uint32_t debug_counter;
+};
+
+inline void light_mode_bloom(RenderContext& ctx) {
+  CRGB16* leds = ctx.leds;
+  const cached_config& cfg = ctx.config;
+  CRGB16* leds_prev_buffer = ctx.leds_prev;
+
   // Clear output
-  memset(leds_16, 0, sizeof(CRGB16) * NATIVE_RESOLUTION);
+  memset(leds, 0, sizeof(CRGB16) * NATIVE_RESOLUTION);
 
   // Draw previous frame shifted with mood scaling
   // Use the provided buffer instead of the global one
-  draw_sprite(leds_16, leds_prev_buffer, NATIVE_RESOLUTION, NATIVE_RESOLUTION, 0.250 + 1.750 * CONFIG.MOOD, 0.99);
+  draw_sprite(leds, leds_prev_buffer, NATIVE_RESOLUTION, NATIVE_RESOLUTION, (0.250 + 1.750 * cfg.MOOD) * render_scale(), 0.99);
   
-  // DEBUG: Check chromagram values - DISABLED to reduce serial flooding
-  static uint32_t bloom_debug_counter = 0;
-  bloom_debug_counter++; // Keep counter for other uses
-  /*
-  if (debug_mode && (bloom_debug_counter++ % 100 == 0)) {
+  // DEBUG: Check chromagram values, every 100th frame (deferred, deferred_log.h)
+  uint32_t& bloom_debug_counter = mode_state<BloomState>(ctx).debug_counter;
+  bloom_debug_counter++;
+  if (debug_mode && (bloom_debug_counter % 100 == 0)) {
     float total_chromagram = 0;
     for (int i = 0; i < 12; i++) {
       total_chromagram += float(chromagram_smooth[i]);
     }
-    USBSerial.print("BLOOM DEBUG: total_chromagram=");
-    USBSerial.print(total_chromagram);
-    USBSerial.print(" hue_position=");
-    USBSerial.println(float(hue_position));
+    DLOG("BLOOM DEBUG: total_chromagram=%.2f hue_position=%.2f\n", total_chromagram, float(ctx.hue.position));
   }
-  */
 
   //-------------------------------------------------------
   // Calculate new color input based on chromagram
@@ -524,11 +564,11 @@ inline void light_mode_bloom(CRGB16* leds_prev_buffer) { // Accept previous buff
   for (uint8_t i = 0; i < 12; i++) {
     SQ15x16 bin = chromagram_smooth[i];
     // Apply contrast iterations (integer part)
-    for(uint8_t iter = 0; iter < (uint8_t)CONFIG.SQUARE_ITER; ++iter) {
+    for(uint8_t iter = 0; iter < (uint8_t)cfg.SQUARE_ITER; ++iter) {
         bin *= bin;
     }
     // Apply fractional contrast iteration
-    float fract_iter = CONFIG.SQUARE_ITER - floor(CONFIG.SQUARE_ITER);
+    float fract_iter = cfg.SQUARE_ITER - floor(cfg.SQUARE_ITER);
     if (fract_iter > 0.01) {
         SQ15x16 squared = bin * bin;
         bin = bin * (1.0 - fract_iter) + squared * fract_iter;
@@ -544,12 +584,12 @@ inline void light_mode_bloom(CRGB16* leds_prev_buffer) { // Accept previous buff
       if (note_hue > 1.0) note_hue -= 1.0;
       
       // Apply auto color shift if enabled
-      if (chromatic_mode == true) {
-        note_hue += hue_position;
+      if (ctx.chromatic_mode == true) {
+        note_hue += ctx.hue.position;
         if (note_hue > 1.0) note_hue -= 1.0;
       }
       
-      CRGB16 add_color = hsv_or_palette(note_hue, CONFIG.SATURATION, bin);
+      CRGB16 add_color = hsv_or_palette(cfg, note_hue, cfg.SATURATION, bin);
       
       sum_color.r += add_color.r;
       sum_color.g += add_color.g;
@@ -572,48 +612,39 @@ inline void light_mode_bloom(CRGB16* leds_prev_buffer) { // Accept previous buff
 
   // Apply saturation and hue adjustments (similar to original logic but using fixed point)
   CRGB temp_col_rgb = { uint8_t(sum_color.r * 255), uint8_t(sum_color.g * 255), uint8_t(sum_color.b * 255) };
-  temp_col_rgb = force_saturation(temp_col_rgb, 255*float(CONFIG.SATURATION));
+  temp_col_rgb = force_saturation(temp_col_rgb, 255*float(cfg.SATURATION));
   
   // When chromatic mode is off, use the CHROMA knob to set a fixed hue
-  // PALETTE FIX: Don't force hue when using palettes (CONFIG.PALETTE_INDEX > 0)
-  if (chromatic_mode == false && CONFIG.PALETTE_INDEX == 0) {
-    SQ15x16 led_hue = CONFIG.CHROMA + hue_position;
+  // PALETTE FIX: Don't force hue when using palettes (cfg.PALETTE_INDEX > 0)
+  if (ctx.chromatic_mode == false && cfg.PALETTE_INDEX == 0) {
+    SQ15x16 led_hue = cfg.CHROMA + ctx.hue.position;
     if (led_hue > 1.0) led_hue -= 1.0;
     temp_col_rgb = force_hue(temp_col_rgb, 255*float(led_hue));
   }
   
-  // DEBUG: Check what color we're inserting - DISABLED to reduce serial flooding
-  /*
-  if (debug_mode && (bloom_debug_counter % 100 == 1)) {
-    USBSerial.print("BLOOM COLOR: chromatic_mode=");
-    USBSerial.print(chromatic_mode);
-    USBSerial.print(" RGB=(");
-    USBSerial.print(temp_col_rgb.r);
-    USBSerial.print(",");
-    USBSerial.print(temp_col_rgb.g);
-    USBSerial.print(",");
-    USBSerial.print(temp_col_rgb.b);
-    USBSerial.println(")");
+  // DEBUG: Check what color we're inserting, same frames as above
+  if (debug_mode && (bloom_debug_counter % 100 == 0)) {
+    DLOG("BLOOM COLOR: chromatic_mode=%d RGB=(%u,%u,%u)\n", int(ctx.chromatic_mode),
+         unsigned(temp_col_rgb.r), unsigned(temp_col_rgb.g), unsigned(temp_col_rgb.b));
   }
-  */
 
   CRGB16 final_insert_color = {{ temp_col_rgb.r / 255.0 }, { temp_col_rgb.g / 255.0 }, { temp_col_rgb.b / 255.0 }};
   
   // Apply PHOTONS brightness scaling
-  final_insert_color.r *= frame_config.PHOTONS;
-  final_insert_color.g *= frame_config.PHOTONS;
-  final_insert_color.b *= frame_config.PHOTONS;
+  final_insert_color.r *= cfg.PHOTONS;
+  final_insert_color.g *= cfg.PHOTONS;
+  final_insert_color.b *= cfg.PHOTONS;
 
   // Insert the new color at the center of the strip
   uint16_t center_idx1 = (NATIVE_RESOLUTION / 2) - 1;
   uint16_t center_idx2 = NATIVE_RESOLUTION / 2;
-  leds_16[center_idx1] = final_insert_color;
-  leds_16[center_idx2] = final_insert_color; // Insert in two center pixels for symmetry
+  leds[center_idx1] = final_insert_color;
+  leds[center_idx2] = final_insert_color; // Insert in two center pixels for symmetry
 
   //-------------------------------------------------------
 
   // Copy current frame to the provided previous frame buffer
-  memcpy(leds_prev_buffer, leds_16, sizeof(CRGB16) * NATIVE_RESOLUTION);
+  memcpy(leds_prev_buffer, leds, sizeof(CRGB16) * NATIVE_RESOLUTION);
 
   // Apply fade towards the ends of the strip (adjust fade range if needed)
   uint16_t fade_width = NATIVE_RESOLUTION / 4; // Fade over the outer quarters
@@ -622,50 +653,96 @@ inline void light_mode_bloom(CRGB16* leds_prev_buffer) { // Accept previous buff
     SQ15x16 fade_amount = SQ15x16(prog * prog); // Quadratic fade, ensure SQ15x16
 
     // Fade right end
-    leds_16[NATIVE_RESOLUTION - 1 - i].r *= fade_amount;
-    leds_16[NATIVE_RESOLUTION - 1 - i].g *= fade_amount;
-    leds_16[NATIVE_RESOLUTION - 1 - i].b *= fade_amount;
+    leds[NATIVE_RESOLUTION - 1 - i] = pixel_scale(leds[NATIVE_RESOLUTION - 1 - i], fade_amount);
 
     // Fade left end
-    leds_16[i].r *= fade_amount;
-    leds_16[i].g *= fade_amount;
-    leds_16[i].b *= fade_amount;
+    leds[i] = pixel_scale(leds[i], fade_amount);
   }
 
   // Mirroring is implicitly handled by the structure? Or apply explicitly if needed.
   // If the sprite shift + center insert doesn't create symmetry, uncomment:
-   mirror_image_downwards(leds_16); // Re-enabled mirroring
+   mirror_image_downwards(leds); // Re-enabled mirroring
+}
+
+struct QuantumCollapseState {
+  // Per-pixel fields, after the struct in the mode state block
+  SQ15x16* wave_probabilities;
+  SQ15x16* wave_phase;
+  SQ15x16* fluid_velocity;
+  SQ15x16* temp_fluid;
+  SQ15x16* temp_field;
+  uint16_t initialized_width;  // Re-seed whenever NATIVE_RESOLUTION changes
+  uint32_t last_collapse_time;
+  uint16_t particle_positions[12];
+  SQ15x16 particle_velocities[12];
+  SQ15x16 particle_energies[12];
+  SQ15x16 particle_hues[12];
+  float animation_phase;
+  float field_flow;
+  SQ15x16 field_energy;
+  SQ15x16 triad_hues[3];
+  SQ15x16 field_energy_f;
+  SQ15x16 speed_mult_fixed;
+  SQ15x16 audio_impact;
+  SQ15x16 audio_pulse;
+  SQ15x16 prev_energy_level;
+  SQ15x16 beat_strength;
+};
+
+inline void init_quantum_collapse(RenderContext& ctx) {
+  QuantumCollapseState& q = mode_state<QuantumCollapseState>(ctx);
+  q.wave_probabilities = mode_state_take<SQ15x16>(ctx, render_capacity);
+  q.wave_phase = mode_state_take<SQ15x16>(ctx, render_capacity);     // For organic wave variation
+  q.fluid_velocity = mode_state_take<SQ15x16>(ctx, render_capacity); // For fluid-like motion
+  q.temp_fluid = mode_state_take<SQ15x16>(ctx, render_capacity);
+  q.temp_field = mode_state_take<SQ15x16>(ctx, render_capacity);
+
+  q.field_energy = SQ15x16(0.5);
+  q.field_energy_f = SQ15x16(0.5);
+  q.speed_mult_fixed = SQ15x16(1.0);
 }
 
 // Add at the end of the file, after the last light mode function but before any closing braces
-inline void light_mode_quantum_collapse() {
-  static SQ15x16 wave_probabilities[NATIVE_RESOLUTION];
-  static bool initialized = false;
-  static uint32_t last_collapse_time = 0;
-  static uint16_t particle_positions[12] = {0}; 
-  static SQ15x16 particle_velocities[12] = {0};
-  static SQ15x16 particle_energies[12] = {0}; 
-  static SQ15x16 particle_hues[12] = {0};
-  static float animation_phase = 0.0;
-  static float field_flow = 0.0;
-  static SQ15x16 field_energy = SQ15x16(0.5);
-  static SQ15x16 triad_hues[3];
-  static SQ15x16 field_energy_f = SQ15x16(0.5);
-  static SQ15x16 speed_mult_fixed = SQ15x16(1.0);
-  static SQ15x16 wave_phase[NATIVE_RESOLUTION] = {0};  // For organic wave variation
-  static SQ15x16 fluid_velocity[NATIVE_RESOLUTION] = {0}; // For fluid-like motion
-  static SQ15x16 audio_impact = SQ15x16(0); // Audio impact tracker
-  static SQ15x16 audio_pulse = SQ15x16(0); // Audio pulse effect
-  static SQ15x16 prev_energy_level = SQ15x16(0); // For detecting energy changes
-  static SQ15x16 beat_strength = SQ15x16(0); // For beat response
+inline void light_mode_quantum_collapse(RenderContext& ctx) {
+  CRGB16* leds = ctx.leds;
+  const cached_config& cfg = ctx.config;
+  QuantumCollapseState& q = mode_state<QuantumCollapseState>(ctx);
+
+  if (q.temp_field == NULL) {
+    return;  // Mode state block too small (light_mode_state_bytes())
+  }
+  SQ15x16* wave_probabilities = q.wave_probabilities;
+  SQ15x16* wave_phase = q.wave_phase;
+  SQ15x16* fluid_velocity = q.fluid_velocity;
+  SQ15x16* temp_fluid = q.temp_fluid;
+  SQ15x16* temp_field = q.temp_field;
+  uint16_t& initialized_width = q.initialized_width;  // Re-seed whenever NATIVE_RESOLUTION changes
+  uint32_t& last_collapse_time = q.last_collapse_time;
+  uint16_t* particle_positions = q.particle_positions;
+  SQ15x16* particle_velocities = q.particle_velocities;
+  SQ15x16* particle_energies = q.particle_energies;
+  SQ15x16* particle_hues = q.particle_hues;
+  float& animation_phase = q.animation_phase;
+  float& field_flow = q.field_flow;
+  SQ15x16& field_energy = q.field_energy;
+  SQ15x16* triad_hues = q.triad_hues;
+  SQ15x16& field_energy_f = q.field_energy_f;
+  SQ15x16& speed_mult_fixed = q.speed_mult_fixed;
+  SQ15x16& audio_impact = q.audio_impact;            // Audio impact tracker
+  SQ15x16& audio_pulse = q.audio_pulse;              // Audio pulse effect
+  SQ15x16& prev_energy_level = q.prev_energy_level;  // For detecting energy changes
+  SQ15x16& beat_strength = q.beat_strength;          // For beat response
   
+  // Pixel distances below were tuned at DEFAULT_RENDER_RESOLUTION
+  const float px_scale = render_scale();
+
   // Initialize on first run
-  if (!initialized) {
+  if (initialized_width != NATIVE_RESOLUTION) {
     // Set up triadic colour scheme based on current chroma value
-    // Use CONFIG.CHROMA directly for initialization
-    triad_hues[0] = CONFIG.CHROMA;
-    triad_hues[1] = CONFIG.CHROMA + SQ15x16(0.333);
-    triad_hues[2] = CONFIG.CHROMA + SQ15x16(0.667);
+    // Use cfg.CHROMA directly for initialization
+    triad_hues[0] = cfg.CHROMA;
+    triad_hues[1] = cfg.CHROMA + SQ15x16(0.333);
+    triad_hues[2] = cfg.CHROMA + SQ15x16(0.667);
     
     // Initialize with variable patterns
     for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
@@ -709,13 +786,13 @@ inline void light_mode_quantum_collapse() {
       particle_hues[i] = triad_hues[i % 3] + SQ15x16(hue_variety);
     }
     
-    initialized = true;
+    initialized_width = NATIVE_RESOLUTION;
   }
   
   // Update triadic colours to follow auto color shift if enabled
   // This ensures colors evolve with the global color system
-  // Use CONFIG.CHROMA directly
-  triad_hues[0] = CONFIG.CHROMA + hue_position;
+  // Use cfg.CHROMA directly
+  triad_hues[0] = cfg.CHROMA + ctx.hue.position;
   triad_hues[1] = triad_hues[0] + SQ15x16(0.333);
   triad_hues[2] = triad_hues[0] + SQ15x16(0.667);
   
@@ -726,16 +803,16 @@ inline void light_mode_quantum_collapse() {
   }
   
   // Audio reactivity - detect beats and energy changes
-  SQ15x16 audio_energy = audio_vu_level_average > SQ15x16(0.01) ? 
-                       (audio_vu_level / audio_vu_level_average) : SQ15x16(1.0);
+  SQ15x16 audio_energy = led_audio->vu_level_average > SQ15x16(0.01) ? 
+                       (led_audio->vu_level / led_audio->vu_level_average) : SQ15x16(1.0);
   audio_energy = constrain(audio_energy, SQ15x16(0.5), SQ15x16(3.0));
   
   // Detect sudden audio level increases (beats)
-  SQ15x16 energy_delta = audio_vu_level - prev_energy_level;
-  prev_energy_level = audio_vu_level;
+  SQ15x16 energy_delta = led_audio->vu_level - prev_energy_level;
+  prev_energy_level = led_audio->vu_level;
   
   // Create a beat pulse that decays naturally
-  if (energy_delta > SQ15x16(0.08) && audio_vu_level > SQ15x16(0.15)) {
+  if (energy_delta > SQ15x16(0.08) && led_audio->vu_level > SQ15x16(0.15)) {
     // Strong beat detected - create impulse
     beat_strength = energy_delta * SQ15x16(5.0);
     if (beat_strength > SQ15x16(1.0)) beat_strength = SQ15x16(1.0);
@@ -759,7 +836,7 @@ inline void light_mode_quantum_collapse() {
   }
   
   // Audio impact rises quickly but decays smoothly (fluid mechanics)
-  SQ15x16 target_impact = audio_vu_level * SQ15x16(2.0);
+  SQ15x16 target_impact = led_audio->vu_level * SQ15x16(2.0);
   if (target_impact > audio_impact) {
     // Fast rise
     audio_impact += (target_impact - audio_impact) * SQ15x16(0.3);
@@ -770,10 +847,10 @@ inline void light_mode_quantum_collapse() {
   
   // System energy evolves with audio and MOOD 
   // More dynamic scaling of speed based on MOOD
-  speed_mult_fixed = SQ15x16(0.7) + (CONFIG.MOOD * SQ15x16(4.0)); // More extreme speed range
+  speed_mult_fixed = SQ15x16(0.7) + (cfg.MOOD * SQ15x16(4.0)); // More extreme speed range
   
   // Energy target influenced by audio beat detection
-  field_energy_f = SQ15x16(0.4) + audio_energy * SQ15x16(0.3) + CONFIG.MOOD * SQ15x16(0.7) + beat_strength * SQ15x16(0.5);
+  field_energy_f = SQ15x16(0.4) + audio_energy * SQ15x16(0.3) + cfg.MOOD * SQ15x16(0.7) + beat_strength * SQ15x16(0.5);
   
   // Organic energy transition - faster rise, slower fall (natural feeling)
   if (field_energy_f > field_energy) {
@@ -788,15 +865,15 @@ inline void light_mode_quantum_collapse() {
   field_flow += (0.005 + float(field_energy) * 0.015 * (0.9 + cos(animation_phase * 0.3) * 0.1)) * float(speed_mult_fixed);
   
   // Clear LED buffer
-  memset(leds_16, 0, sizeof(CRGB16) * NATIVE_RESOLUTION);
+  memset(leds, 0, sizeof(CRGB16) * NATIVE_RESOLUTION);
   
   // Detect major beats for collapse events
-  bool collapse_triggered = audio_vu_level > audio_vu_level_average * SQ15x16(1.3) && 
-                         audio_vu_level > SQ15x16(0.15) && 
-                         (millis() - last_collapse_time > 250 - 100 * float(CONFIG.MOOD)); // Quicker collapse at high MOOD
+  bool collapse_triggered = led_audio->vu_level > led_audio->vu_level_average * SQ15x16(1.3) && 
+                         led_audio->vu_level > SQ15x16(0.15) && 
+                         (millis() - last_collapse_time > 250 - 100 * float(cfg.MOOD)); // Quicker collapse at high MOOD
   
   // Secondary collapse detection based on audio dynamics
-  bool small_collapse = energy_delta > SQ15x16(0.08) && audio_vu_level > SQ15x16(0.1);
+  bool small_collapse = energy_delta > SQ15x16(0.08) && led_audio->vu_level > SQ15x16(0.1);
   
   // Wave function collapse on beats
   if (collapse_triggered) {
@@ -823,9 +900,9 @@ inline void light_mode_quantum_collapse() {
     }
     
     // Audio-reactive collapse with more organic distribution
-    float audio_intensity = 0.5 + float(audio_vu_level) * 0.5;
+    float audio_intensity = 0.5 + float(led_audio->vu_level) * 0.5;
     // Width varies with SQUARE_ITER for visible control
-    float collapse_width = 0.3 - float(CONFIG.SQUARE_ITER) * 0.05;
+    float collapse_width = 0.3 - float(cfg.SQUARE_ITER) * 0.05;
     if (collapse_width < 0.1) collapse_width = 0.1;
     
     // Non-uniform collapse pattern for more organic feel
@@ -882,12 +959,12 @@ inline void light_mode_quantum_collapse() {
       particle_velocities[particle_idx] = SQ15x16(dir * speed_variety) * audio_energy;
       
       // Energy varies with audio level
-      particle_energies[particle_idx] = SQ15x16(0.6 + float(audio_vu_level) * 0.4 + random_float() * 0.2);
+      particle_energies[particle_idx] = SQ15x16(0.6 + float(led_audio->vu_level) * 0.4 + random_float() * 0.2);
       
       // Color with slight shift and audio influence
       particle_hues[particle_idx] = triad_hues[particle_idx % 3] + 
                                    SQ15x16(random_float() * 0.1 - 0.05) + 
-                                   audio_vu_level * SQ15x16(0.05);
+                                   led_audio->vu_level * SQ15x16(0.05);
     }
     
     // Boost energy with physical dynamics
@@ -900,7 +977,7 @@ inline void light_mode_quantum_collapse() {
   else if (small_collapse) {
     // Choose mini-collapse center near particles for natural focal points
     uint16_t small_collapse_center;
-    if (random_float() < 0.7 && float(audio_vu_level) > 0.2) {
+    if (random_float() < 0.7 && float(led_audio->vu_level) > 0.2) {
       // Bias toward existing particles
       small_collapse_center = particle_positions[random(12)];
     } else {
@@ -908,8 +985,8 @@ inline void light_mode_quantum_collapse() {
     }
     
     // Audio-reactive radius with organic variation
-    int radius = 5 + int(float(audio_vu_level) * (8.0 + random_float() * 4.0));
-    if (radius > 25) radius = 25;
+    int radius = (5 + float(led_audio->vu_level) * (8.0 + random_float() * 4.0)) * px_scale;
+    if (radius > 25 * px_scale) radius = 25 * px_scale;
     
     // Non-uniform collapse for natural look
     for (int16_t i = -radius; i <= radius; i++) {
@@ -944,18 +1021,16 @@ inline void light_mode_quantum_collapse() {
     }
     
     // Small energy boost with audio reaction
-    field_energy += SQ15x16(0.05 + float(audio_vu_level) * 0.08);
+    field_energy += SQ15x16(0.05 + float(led_audio->vu_level) * 0.08);
     if (field_energy > SQ15x16(2.0)) field_energy = SQ15x16(2.0);
   }
   
   // Continuous fluid wave motion in the probability field
   // Audio-reactive amplitude with organic variation
-  float wave_amplitude = 0.02 + float(audio_vu_level) * 0.08 + float(audio_pulse) * 0.05;
+  float wave_amplitude = 0.02 + float(led_audio->vu_level) * 0.08 + float(audio_pulse) * 0.05;
   
   // Update fluid simulation
-  SQ15x16 fluid_diffusion = SQ15x16(0.03 + float(CONFIG.MOOD) * 0.02); // Diffusion rate
-  SQ15x16 temp_fluid[NATIVE_RESOLUTION];
-  
+  SQ15x16 fluid_diffusion = SQ15x16(0.03 + float(cfg.MOOD) * 0.02); // Diffusion rate
   // Copy fluid velocities for update
   memcpy(temp_fluid, fluid_velocity, sizeof(SQ15x16) * NATIVE_RESOLUTION);
   
@@ -1008,7 +1083,7 @@ inline void light_mode_quantum_collapse() {
   }
   
   // Apply fluid-based diffusion for more organic movement
-  SQ15x16 base_diffusion = SQ15x16(0.08) + (CONFIG.MOOD * SQ15x16(0.3)) + (field_energy * SQ15x16(0.1)); 
+  SQ15x16 base_diffusion = SQ15x16(0.08) + (cfg.MOOD * SQ15x16(0.3)) + (field_energy * SQ15x16(0.1)); 
   SQ15x16 max_diffusion = SQ15x16(0.4);
   if (base_diffusion > max_diffusion) base_diffusion = max_diffusion;
   
@@ -1017,7 +1092,6 @@ inline void light_mode_quantum_collapse() {
   SQ15x16 flow_direction = SQ15x16(sin(flow_angle)) * SQ15x16(0.3);
   
   // Safe copy for diffusion
-  SQ15x16 temp_field[NATIVE_RESOLUTION];
   memcpy(temp_field, wave_probabilities, sizeof(SQ15x16) * NATIVE_RESOLUTION);
   
   // Apply diffusion with organic asymmetry
@@ -1078,7 +1152,7 @@ inline void light_mode_quantum_collapse() {
     // Dynamic speed adjustment with physics
     SQ15x16 speed_mult_sq = speed_mult_fixed * speed_mult_fixed;
     // Base speed with energy influence
-    SQ15x16 speed_mod = particle_energies[i] * (SQ15x16(0.6) + audio_vu_level * SQ15x16(0.8)) * speed_mult_sq;
+    SQ15x16 speed_mod = particle_energies[i] * (SQ15x16(0.6) + led_audio->vu_level * SQ15x16(0.8)) * speed_mult_sq;
     
     // Apply audio beat boost to speed
     if (beat_strength > SQ15x16(0.1)) {
@@ -1086,10 +1160,10 @@ inline void light_mode_quantum_collapse() {
     }
     
     // Calculate movement with inertia effects
-    int delta_pos = (particle_velocities[i] * speed_mod).getInteger();
+    int delta_pos = (particle_velocities[i] * speed_mod * SQ15x16(px_scale)).getInteger();
     
     // Limit maximum speed for stability with organic cap
-    float speed_limit = 15.0 * (0.8 + 0.4 * random_float());
+    float speed_limit = 15.0 * px_scale * (0.8 + 0.4 * random_float());
     if (delta_pos > speed_limit) delta_pos = speed_limit;
     if (delta_pos < -speed_limit) delta_pos = -speed_limit;
     
@@ -1156,7 +1230,7 @@ inline void light_mode_quantum_collapse() {
     // Energy and audio influence trail strength
     SQ15x16 trail_strength = SQ15x16(0.1) + 
                             particle_energies[i] * SQ15x16(0.2) + 
-                            audio_vu_level * SQ15x16(0.2) +
+                            led_audio->vu_level * SQ15x16(0.2) +
                             audio_pulse * SQ15x16(0.4); // Beat responsiveness
     
     // Add to probability field with fluid dynamics
@@ -1164,9 +1238,9 @@ inline void light_mode_quantum_collapse() {
     if (wave_probabilities[pos] > SQ15x16(1.0)) wave_probabilities[pos] = SQ15x16(1.0);
     
     // Audio-reactive trail width
-    float trail_intensity = float(particle_energies[i]) * (1.0 + float(audio_vu_level) * 0.5);
-    uint8_t trail_width = 1 + (SQ15x16(trail_intensity) * SQ15x16(4)).getInteger();
-    if (trail_width > 6) trail_width = 6;
+    float trail_intensity = float(particle_energies[i]) * (1.0 + float(led_audio->vu_level) * 0.5);
+    uint8_t trail_width = 1 + (SQ15x16(trail_intensity) * SQ15x16(4.0 * px_scale)).getInteger();
+    if (trail_width > 6 * px_scale) trail_width = 6 * px_scale;
     
     // Create organic trail with Gaussian-like distribution
     for (int8_t j = -trail_width; j <= trail_width; j++) {
@@ -1175,7 +1249,7 @@ inline void light_mode_quantum_collapse() {
       int16_t trail_pos = pos + j;
       if (trail_pos >= 0 && trail_pos < NATIVE_RESOLUTION) {
         // Non-linear falloff for more natural look
-        float falloff_factor = 2.0 + float(audio_vu_level) * 2.0; // Audio affects trail shape
+        float falloff_factor = 2.0 + float(led_audio->vu_level) * 2.0; // Audio affects trail shape
         float falloff = exp(-(j*j) / (float)(trail_width*trail_width) * falloff_factor);
         
         // Add trail with audio influence
@@ -1217,17 +1291,17 @@ inline void light_mode_quantum_collapse() {
     field_hue += position_variance;
     
     // Audio-reactive color shift (subtle)
-    field_hue += audio_vu_level * SQ15x16(0.02) * SQ15x16(sin(animation_phase * 0.5 + i * 0.03));
+    field_hue += led_audio->vu_level * SQ15x16(0.02) * SQ15x16(sin(animation_phase * 0.5 + i * 0.03));
     
     // Keep hue in valid range
     if (field_hue > SQ15x16(1.0)) field_hue -= SQ15x16(1.0);
     if (field_hue < SQ15x16(0.0)) field_hue += SQ15x16(1.0);
     
     // Dynamic brightness with organic curves
-    SQ15x16 brightness = wave_probabilities[i] * (SQ15x16(0.4) + CONFIG.PHOTONS * SQ15x16(0.6));
+    SQ15x16 brightness = wave_probabilities[i] * (SQ15x16(0.4) + cfg.PHOTONS * SQ15x16(0.6));
     
     // Audio-reactive brightness boost
-    brightness += audio_vu_level * SQ15x16(0.2) * brightness;
+    brightness += led_audio->vu_level * SQ15x16(0.2) * brightness;
     
     // Beat pulse brightening
     if (audio_pulse > SQ15x16(0.01)) {
@@ -1235,24 +1309,24 @@ inline void light_mode_quantum_collapse() {
     }
     
     // Apply contrast with organic feel
-    for (uint8_t s = 0; s < (uint8_t)CONFIG.SQUARE_ITER; s++) {
+    for (uint8_t s = 0; s < (uint8_t)cfg.SQUARE_ITER; s++) {
       brightness = brightness * brightness;
     }
     
     // Apply fractional contrast for smoother control
-    float fract_iter = CONFIG.SQUARE_ITER - floor(CONFIG.SQUARE_ITER);
+    float fract_iter = cfg.SQUARE_ITER - floor(cfg.SQUARE_ITER);
     if (fract_iter > 0.01) {
       SQ15x16 squared = brightness * brightness;
       brightness = brightness * SQ15x16(1.0 - fract_iter) + squared * fract_iter;
     }
     
     // Organic wave modulation for added dimensionality
-    float wave_factor = 0.15 + 0.1 * float(audio_vu_level);
+    float wave_factor = 0.15 + 0.1 * float(led_audio->vu_level);
     brightness *= SQ15x16(1.0 - wave_factor) + 
                  SQ15x16(wave_factor) * sin(i * 0.15 + animation_phase * 2.5 + float(wave_phase[i]));
     
     // Dynamic saturation
-    SQ15x16 saturation = CONFIG.SATURATION;
+    SQ15x16 saturation = cfg.SATURATION;
     
     // Desaturate very bright and dark regions for natural look
     if (wave_probabilities[i] > SQ15x16(0.85)) {
@@ -1262,10 +1336,10 @@ inline void light_mode_quantum_collapse() {
     }
     
     // Audio affects saturation slightly
-    saturation *= SQ15x16(0.9 + float(audio_vu_level) * 0.2);
+    saturation *= SQ15x16(0.9 + float(led_audio->vu_level) * 0.2);
     
     // Create final LED color
-    leds_16[i] = hsv_or_palette(field_hue, saturation, brightness);
+    leds[i] = hsv_or_palette(cfg, field_hue, saturation, brightness);
   }
   
   // Render particles with bloom physics
@@ -1283,14 +1357,14 @@ inline void light_mode_quantum_collapse() {
       if (pulse > SQ15x16(1.5)) pulse = SQ15x16(1.5);
       
       // Energy and audio affect appearance
-      SQ15x16 energy_factor = particle_energies[i] * (SQ15x16(1.0) + audio_vu_level * SQ15x16(0.5));
+      SQ15x16 energy_factor = particle_energies[i] * (SQ15x16(1.0) + led_audio->vu_level * SQ15x16(0.5));
       
       // Get particle hue with slight audio variation
       uint8_t hue_idx = i % 3;
       SQ15x16 particle_hue = triad_hues[hue_idx];
       
       // Audio and energy affect hue slightly
-      float hue_shift = sin(animation_phase * 0.7 + i * 0.5) * 0.03 * float(audio_vu_level);
+      float hue_shift = sin(animation_phase * 0.7 + i * 0.5) * 0.03 * float(led_audio->vu_level);
       particle_hue += SQ15x16(hue_shift);
       
       // Normalize hue
@@ -1302,8 +1376,8 @@ inline void light_mode_quantum_collapse() {
       particle_brightness *= pulse;
       
       // Create particle color
-      CRGB16 particle_color = hsv_or_palette(particle_hue, 
-                                 CONFIG.SATURATION * SQ15x16(0.95), 
+      CRGB16 particle_color = hsv_or_palette(cfg, particle_hue, 
+                                 cfg.SATURATION * SQ15x16(0.95), 
                                  particle_brightness);
       
       // Dynamic intensity with audio response
@@ -1313,14 +1387,14 @@ inline void light_mode_quantum_collapse() {
       intensity += audio_pulse * SQ15x16(3.0);
       
       // Set particle with additive blending for glow
-      leds_16[pos].r = fmax_fixed(leds_16[pos].r, particle_color.r * intensity); 
-      leds_16[pos].g = fmax_fixed(leds_16[pos].g, particle_color.g * intensity);
-      leds_16[pos].b = fmax_fixed(leds_16[pos].b, particle_color.b * intensity);
+      leds[pos].r = fmax_fixed(leds[pos].r, particle_color.r * intensity); 
+      leds[pos].g = fmax_fixed(leds[pos].g, particle_color.g * intensity);
+      leds[pos].b = fmax_fixed(leds[pos].b, particle_color.b * intensity);
       
       // Dynamic bloom radius with energy and audio
-      float bloom_size = 2.0 + float(particle_energies[i]) * 4.0 + float(audio_pulse) * 3.0;
+      float bloom_size = (2.0 + float(particle_energies[i]) * 4.0 + float(audio_pulse) * 3.0) * px_scale;
       int bloom_radius = bloom_size;
-      if (bloom_radius > 8) bloom_radius = 8;
+      if (bloom_radius > 8 * px_scale) bloom_radius = 8 * px_scale;
       
       // Create bloom with organic falloff
       for (int8_t j = -bloom_radius; j <= bloom_radius; j++) {
@@ -1330,7 +1404,7 @@ inline void light_mode_quantum_collapse() {
         if (bloom_pos >= 0 && bloom_pos < NATIVE_RESOLUTION) {
           // Non-linear falloff for more natural glow
           float distance = abs(j) / bloom_size;
-          float bloom_curve = 2.5 + float(audio_vu_level) * 2.0; // Audio affects bloom shape
+          float bloom_curve = 2.5 + float(led_audio->vu_level) * 2.0; // Audio affects bloom shape
           SQ15x16 falloff = SQ15x16(exp(-distance * distance * bloom_curve)) * pulse;
           
           // Energy affects bloom intensity
@@ -1340,9 +1414,9 @@ inline void light_mode_quantum_collapse() {
           bloom_intensity += audio_pulse * SQ15x16(1.5);
           
           // Add bloom to existing color
-          leds_16[bloom_pos].r += particle_color.r * falloff * bloom_intensity;
-          leds_16[bloom_pos].g += particle_color.g * falloff * bloom_intensity;
-          leds_16[bloom_pos].b += particle_color.b * falloff * bloom_intensity;
+          leds[bloom_pos].r += particle_color.r * falloff * bloom_intensity;
+          leds[bloom_pos].g += particle_color.g * falloff * bloom_intensity;
+          leds[bloom_pos].b += particle_color.b * falloff * bloom_intensity;
           
           // Create fluid velocity from bloom for organic flow
           fluid_velocity[bloom_pos] += SQ15x16(j > 0 ? 0.0005 : -0.0005) * falloff * particle_energies[i];
@@ -1350,19 +1424,20 @@ inline void light_mode_quantum_collapse() {
       }
       
       // Occasional energy bursts for added interest
-      if (random(100) < 3 + int(float(audio_vu_level) * 10)) {
+      if (random(100) < 3 + int(float(led_audio->vu_level) * 10)) {
         // Create burst with random spread
         int burst_count = 2 + random(3);
         for (int b = 0; b < burst_count; b++) {
-          int burst_pos = pos + random(21) - 10;
+          int burst_spread = 10 * px_scale;
+          int burst_pos = pos + random(burst_spread * 2 + 1) - burst_spread;
           if (burst_pos >= 0 && burst_pos < NATIVE_RESOLUTION) {
             // Energy and audio affect burst intensity
-            SQ15x16 burst_intensity = SQ15x16(0.3) + particle_energies[i] * SQ15x16(0.7) + audio_vu_level * SQ15x16(0.5);
+            SQ15x16 burst_intensity = SQ15x16(0.3) + particle_energies[i] * SQ15x16(0.7) + led_audio->vu_level * SQ15x16(0.5);
             
             // Add burst glow
-            leds_16[burst_pos].r += particle_color.r * burst_intensity * SQ15x16(0.4);
-            leds_16[burst_pos].g += particle_color.g * burst_intensity * SQ15x16(0.4);
-            leds_16[burst_pos].b += particle_color.b * burst_intensity * SQ15x16(0.4);
+            leds[burst_pos].r += particle_color.r * burst_intensity * SQ15x16(0.4);
+            leds[burst_pos].g += particle_color.g * burst_intensity * SQ15x16(0.4);
+            leds[burst_pos].b += particle_color.b * burst_intensity * SQ15x16(0.4);
             
             // Add fluid impulse
             fluid_velocity[burst_pos] += SQ15x16((random_float() - 0.5) * 0.02) * audio_energy;
@@ -1373,19 +1448,32 @@ inline void light_mode_quantum_collapse() {
   }
   
   // Clip all LED values to prevent overflow
-  clip_led_values(leds_16); // Pass the buffer
+  clip_led_values(leds); // Pass the buffer
   
   // Handle mirroring
-  if (CONFIG.MIRROR_ENABLED) {
-    mirror_image_downwards(leds_16);
+  if (cfg.MIRROR_ENABLED) {
+    mirror_image_downwards(leds);
   }
 }
 
-inline void light_mode_waveform(CRGB16* leds_previous, CRGB16& last_color) { // New signature accepting previous buffer and last color reference
-  static float waveform_peak_scaled_last;
+struct WaveformState {
+  float peak_scaled_last;
+  CRGB16 last_color;
+};
+
+inline void light_mode_waveform(RenderContext& ctx) {
+  CRGB16* leds = ctx.leds;
+  const cached_config& cfg = ctx.config;
+  WaveformState& w = mode_state<WaveformState>(ctx);
+  CRGB16& last_color = w.last_color;
+  float& waveform_peak_scaled_last = w.peak_scaled_last;
+
+  // Trails build on the mode's own last frame, not whatever the prism
+  // or bulb cover left in leds afterwards
+  memcpy(leds, ctx.leds_prev, sizeof(CRGB16) * NATIVE_RESOLUTION);
 
   // Smooth the waveform peak with more aggressive smoothing
-  SQ15x16 smoothed_peak_fixed = SQ15x16(waveform_peak_scaled) * 0.02 + SQ15x16(waveform_peak_scaled_last) * 0.98;
+  SQ15x16 smoothed_peak_fixed = SQ15x16(led_audio->waveform_peak_scaled) * 0.02 + SQ15x16(waveform_peak_scaled_last) * 0.98;
   waveform_peak_scaled_last = float(smoothed_peak_fixed);
 
   CRGB16 current_sum_color = {{ 0 }, { 0 }, { 0 }};
@@ -1396,10 +1484,10 @@ inline void light_mode_waveform(CRGB16* leds_previous, CRGB16& last_color) { //
     float bin = float(chromagram_smooth[c]);
 
     float bright = bin;
-    for (uint8_t s = 0; s < int(CONFIG.SQUARE_ITER); s++) {
+    for (uint8_t s = 0; s < int(cfg.SQUARE_ITER); s++) {
       bright *= bright;
     }
-    float fract_iter = CONFIG.SQUARE_ITER - floor(CONFIG.SQUARE_ITER);
+    float fract_iter = cfg.SQUARE_ITER - floor(cfg.SQUARE_ITER);
     if (fract_iter > 0.01) {
       float squared = bright * bright;
       bright = bright * (1.0f - fract_iter) + squared * fract_iter;
@@ -1409,10 +1497,10 @@ inline void light_mode_waveform(CRGB16* leds_previous, CRGB16& last_color) { //
     if (bright > 0.05) {
       // PALETTE FIX: Ensure minimum brightness for palette colors to prevent washing
       SQ15x16 color_brightness = SQ15x16(bright);
-      if (CONFIG.PALETTE_INDEX > 0 && color_brightness < 0.2) {
+      if (cfg.PALETTE_INDEX > 0 && color_brightness < 0.2) {
         color_brightness = SQ15x16(0.2); // 20% minimum for palettes
       }
-      CRGB16 note_col = hsv_or_palette(SQ15x16(prog), CONFIG.SATURATION, color_brightness);
+      CRGB16 note_col = hsv_or_palette(cfg, SQ15x16(prog), cfg.SATURATION, color_brightness);
       current_sum_color.r += note_col.r;
       current_sum_color.g += note_col.g;
       current_sum_color.b += note_col.b;
@@ -1422,7 +1510,7 @@ inline void light_mode_waveform(CRGB16* leds_previous, CRGB16& last_color) { //
   
   bool waveform_used_chromatic_fallback = false;
 
-  if (chromatic_mode == true) {
+  if (ctx.chromatic_mode == true) {
     if (total_magnitude > SQ15x16(0.01)) {
       // Normalize by total magnitude to get pure color, then scale by brightness
       current_sum_color.r /= total_magnitude;
@@ -1441,16 +1529,16 @@ inline void light_mode_waveform(CRGB16* leds_previous, CRGB16& last_color) { //
       if (fallback_brightness < min_chromatic_brightness) {
         fallback_brightness = min_chromatic_brightness;
       }
-      if (CONFIG.PALETTE_INDEX > 0 && fallback_brightness < SQ15x16(0.20)) {
+      if (cfg.PALETTE_INDEX > 0 && fallback_brightness < SQ15x16(0.20)) {
         fallback_brightness = SQ15x16(0.20); // Palette colors stay visible
       }
-      current_sum_color = hsv_or_palette(hue_position, CONFIG.SATURATION, fallback_brightness);
+      current_sum_color = hsv_or_palette(cfg, ctx.hue.position, cfg.SATURATION, fallback_brightness);
     }
   } else {
     // Use single hue with total_magnitude for brightness
     // PALETTE FIX: Ensure minimum brightness for palette visibility
     SQ15x16 color_brightness = total_magnitude;
-    if (CONFIG.PALETTE_INDEX > 0 && color_brightness < 0.2) {
+    if (cfg.PALETTE_INDEX > 0 && color_brightness < 0.2) {
       color_brightness = SQ15x16(0.2); // 20% minimum for palettes
     }
 
@@ -1458,17 +1546,17 @@ inline void light_mode_waveform(CRGB16* leds_previous, CRGB16& last_color) { //
     // ROOT CAUSE: chroma_val was shifting palette hue indices causing color corruption
     // SOLUTION: Use neutral hue for palettes, preserve CHROMA control for HSV mode
     SQ15x16 effective_hue;
-    if (CONFIG.PALETTE_INDEX > 0) {
+    if (cfg.PALETTE_INDEX > 0) {
       // Palette mode: Use neutral hue to preserve palette colors
-      effective_hue = hue_position;  // Only use natural hue shifting, no CHROMA
+      effective_hue = ctx.hue.position;  // Only use natural hue shifting, no CHROMA
     } else {
       // HSV mode: Use full chroma control as intended
-      effective_hue = chroma_val + hue_position;
+      effective_hue = ctx.chroma_val + ctx.hue.position;
     }
-    current_sum_color = hsv_or_palette(effective_hue, CONFIG.SATURATION, color_brightness);
+    current_sum_color = hsv_or_palette(cfg, effective_hue, cfg.SATURATION, color_brightness);
   }
 
-  if (CONFIG.PALETTE_INDEX > 0) {
+  if (cfg.PALETTE_INDEX > 0) {
     const SQ15x16 palette_floor = SQ15x16(0.20);
     SQ15x16 max_component = current_sum_color.r;
     if (current_sum_color.g > max_component) max_component = current_sum_color.g;
@@ -1483,7 +1571,7 @@ inline void light_mode_waveform(CRGB16* leds_previous, CRGB16& last_color) { //
         current_sum_color.b *= scale;
       } else {
         // All components are zero – synthesize neutral palette color at floor brightness
-        current_sum_color = hsv_or_palette(hue_position, CONFIG.SATURATION, palette_floor);
+        current_sum_color = hsv_or_palette(cfg, ctx.hue.position, cfg.SATURATION, palette_floor);
       }
 
       // Prevent accidental overflow past the fixed-point range
@@ -1495,39 +1583,37 @@ inline void light_mode_waveform(CRGB16* leds_previous, CRGB16& last_color) { //
 
   if (waveform_used_chromatic_fallback && kEnableWaveformGuardLog) {
     if ((perf_metrics.frame_count & 0x3F) == 0) {
-      USBSerial.printf("[WAVEFORM] chromatic guard hit | frame=%u total_mag=%.4f palette=%u\n",
-                       perf_metrics.frame_count,
-                       float(total_magnitude),
-                       CONFIG.PALETTE_INDEX);
+      DLOG("[WAVEFORM] chromatic guard hit | frame=%u total_mag=%.4f palette=%u\n",
+           perf_metrics.frame_count,
+           float(total_magnitude),
+           unsigned(cfg.PALETTE_INDEX));
     }
   }
 
   // Apply PHOTONS brightness scaling
-  current_sum_color.r *= frame_config.PHOTONS;
-  current_sum_color.g *= frame_config.PHOTONS;
-  current_sum_color.b *= frame_config.PHOTONS;
+  current_sum_color.r *= cfg.PHOTONS;
+  current_sum_color.g *= cfg.PHOTONS;
+  current_sum_color.b *= cfg.PHOTONS;
   
   // Use the chromagram color mix for the waveform
   last_color = current_sum_color;
   // --- End Color Calculation ---
 
   // --- Dynamic Fading for Trails ---
-  // Operate directly on the global leds_16 buffer, assuming it holds the *target* state from previous frame
-  float abs_amp = abs(waveform_peak_scaled); 
+  // Operate directly on the leds buffer, seeded above with the mode's previous frame
+  float abs_amp = abs(led_audio->waveform_peak_scaled); 
   if (abs_amp > 1.0f) abs_amp = 1.0f; 
   
   float max_fade_reduction = 0.10; 
   SQ15x16 dynamic_fade_amount = 1.0 - (max_fade_reduction * abs_amp);
 
-  // Apply the dynamic fade TO THE GLOBAL leds_16 buffer
+  // Apply the dynamic fade to the leds buffer
   for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
-      leds_16[i].r *= dynamic_fade_amount;
-      leds_16[i].g *= dynamic_fade_amount;
-      leds_16[i].b *= dynamic_fade_amount;
+      leds[i] = pixel_scale(leds[i], dynamic_fade_amount);
   }
 
   // --- Waveform Display --- 
-  shift_leds_up(leds_16, 1); // Shift the global leds_16 buffer
+  shift_leds_up(leds, 1); // Shift the leds buffer
   
   // Use smoothed peak instead of raw peak
   float amp = waveform_peak_scaled_last;
@@ -1566,7 +1652,7 @@ inline void light_mode_waveform(CRGB16* leds_previous, CRGB16& last_color) { //
   if (pos_frac > 0.001f) { // Only apply probabilistic selection if there's a meaningful fractional component
     // Generate a pseudo-random value using the audio data as entropy source
     // Using waveform_peak_scaled as a simple pseudo-random source to avoid ESP.random() overhead
-    float pseudo_random = fmod(abs(waveform_peak_scaled * 1000.0f), 1.0f);
+    float pseudo_random = fmod(abs(led_audio->waveform_peak_scaled * 1000.0f), 1.0f);
     pos = (pseudo_random < pos_frac) ? int(ceil(pos_f)) : int(floor(pos_f));
   } else {
     pos = int(pos_f + (pos_f >= 0 ? 0.5 : -0.5)); // Fallback to original rounding for edge cases
@@ -1578,21 +1664,94 @@ inline void light_mode_waveform(CRGB16* leds_previous, CRGB16& last_color) { //
 
   // CRITICAL: Single assignment preserved - no additive blending that caused color corruption
   // This maintains the chromagram color pipeline mathematical constraints
-  leds_16[pos] = last_color; // Draw onto the global leds_16 buffer
+  leds[pos] = last_color; // Draw onto the leds buffer
 
   // VERIFICATION: Color pipeline integrity maintained through single assignment
   // Performance impact: +40-60μs validated by Performance Engineer
   // Mathematical constraints: Preserved per Deep Technical Analyst validation
-  if (CONFIG.MIRROR_ENABLED) { // Check current config setting for mirroring
-    mirror_image_downwards(leds_16);
+  if (cfg.MIRROR_ENABLED) { // Check current config setting for mirroring
+    mirror_image_downwards(leds);
   }
-  bool palette_enabled = (frame_config.palette_ptr != nullptr);
+  bool palette_enabled = (cfg.palette_ptr != nullptr);
   if (NATIVE_RESOLUTION > 0) {
-    TRACE_DEBUG(LED_BUFFER_UPDATE, pack_led_sample(0, leds_16[0], palette_enabled));
+    TRACE_DEBUG(LED_BUFFER_UPDATE, pack_led_sample(0, leds[0], palette_enabled));
   }
   if (NATIVE_RESOLUTION > 2) {
     uint16_t mid = NATIVE_RESOLUTION / 2;
-    TRACE_DEBUG(LED_BUFFER_UPDATE, pack_led_sample(mid, leds_16[mid], palette_enabled));
+    TRACE_DEBUG(LED_BUFFER_UPDATE, pack_led_sample(mid, leds[mid], palette_enabled));
+  }
+
+  memcpy(ctx.leds_prev, leds, sizeof(CRGB16) * NATIVE_RESOLUTION);
+}
+
+// Mode registry -------------------------------------------------------
+
+// A mode's state lives in its render context's mode state block, not in
+// statics, so two strips can run the same mode apart. Entering a mode
+// zeroes the block and runs init; the mode finds its state struct with
+// mode_state<T>() and anything per-pixel init took with mode_state_take().
+struct LightMode {
+  const char* name;                    // mode_names[], serial menu
+  void (*render)(RenderContext& ctx);  // Draw into ctx.leds
+  void (*init)(RenderContext& ctx);    // On entering the mode (NULL: all zero is right)
+  uint16_t state_bytes;                // sizeof the state struct
+  uint8_t pixel_bytes;                 // init's mode_state_take()s, per render pixel
+  uint8_t inputs;                      // MODE_INPUT_* (constants.h) the mode reads
+};
+
+// Indexed by LIGHTSHOW_MODE (enum lightshow_modes, constants.h)
+const LightMode light_modes[] = {
+  // name              render                          init                   state_bytes                   pixel_bytes           inputs
+  { "GDFT",             light_mode_gdft,                NULL,                  0,                            0,                    MODE_INPUT_SPECTROGRAM },
+  { "CHROMAGRAM",       light_mode_chromagram_gradient, NULL,                  0,                            0,                    MODE_INPUT_CHROMAGRAM },
+  { "CHROMAGRAM DOTS",  light_mode_chromagram_dots,     NULL,                  0,                            0,                    MODE_INPUT_CHROMAGRAM },
+  { "BLOOM",            light_mode_bloom,               NULL,                  sizeof(BloomState),           0,                    MODE_INPUT_CHROMAGRAM },
+  { "VU DOT",           light_mode_vu_dot,              init_vu_dot,           sizeof(VuDotState),           0,                    MODE_INPUT_VU },
+  { "KALEIDOSCOPE",     light_mode_kaleidoscope,        NULL,                  sizeof(KaleidoscopeState),    0,                    MODE_INPUT_SPECTROGRAM },
+  { "QUANTUM COLLAPSE", light_mode_quantum_collapse,    init_quantum_collapse, sizeof(QuantumCollapseState), 5 * sizeof(SQ15x16),  MODE_INPUT_VU },
+  { "WAVEFORM",         light_mode_waveform,            NULL,                  sizeof(WaveformState),        0,                    MODE_INPUT_WAVEFORM | MODE_INPUT_CHROMAGRAM },
+};
+static_assert(sizeof(light_modes) / sizeof(light_modes[0]) == NUM_MODES, "One light_modes[] entry per lightshow mode");
+
+// Mode state block each render context needs, for the largest mode at
+// `pixels` wide (frame arena sizing, init_render_context())
+inline uint32_t light_mode_state_bytes(uint16_t pixels) {
+  uint32_t largest = 0;
+  for (uint8_t i = 0; i < NUM_MODES; i++) {
+    uint32_t bytes = light_modes[i].state_bytes + light_modes[i].pixel_bytes * uint32_t(pixels)
+                   + sizeof(uint64_t);  // Aligning the per-pixel fields after the struct
+    if (bytes > largest) {
+      largest = bytes;
+    }
+  }
+  return largest;
+}
+
+// mode_names[] from the registry (init_system())
+inline void init_light_mode_names() {
+  for (uint8_t i = 0; i < NUM_MODES; i++) {
+    strncpy(mode_names + 32 * i, light_modes[i].name, 31);
+  }
+}
+
+// Draw ctx's LIGHTSHOW_MODE into ctx.leds, starting the mode's state
+// afresh when the context has just switched to it
+inline void render_light_mode(RenderContext& ctx) {
+  uint8_t mode = ctx.config.LIGHTSHOW_MODE;
+  if (mode >= NUM_MODES || ctx.mode_state == NULL) {
+    return;
   }
+
+  const LightMode& light_mode = light_modes[mode];
+  if (ctx.mode != mode) {
+    memset(ctx.mode_state, 0, ctx.mode_state_size);
+    ctx.mode_state_used = light_mode.state_bytes;
+    ctx.mode = mode;
+    if (light_mode.init != NULL) {
+      light_mode.init(ctx);
+    }
+  }
+
+  light_mode.render(ctx);
 }
 #endif // LIGHTSHOW_MODES_H
@@ -28,6 +28,7 @@
 #include <Wire.h>
 #include <esp_task_wdt.h>
 #include <esp_pm.h>
+#include <esp_timer.h>
 
 // Include Sensory Bridge firmware files, sorted high to low, by boringness ;) -------
 #include "sb_strings.h"          // Strings for printing
@@ -35,6 +36,9 @@
 #include "constants.h"        // Global constants
 #include "globals.h"          // Global variables
 #include "frame_sync.h"
+#include "audio_frame.h"      // Lock-free audio -> LED frame hand-off
+#include "latency_histogram.h" // Audio-to-photon latency
+#include "sample_window.h"     // Mirrored ring buffer behind the audio history window
 #include "presets.h"          // Configuration presets by name
 #include "bridge_fs.h"        // Filesystem access (save/load configuration)
 #include "utilities.h"        // Misc. math and other functions
@@ -49,9 +53,22 @@
 #define DEBUG_BUILD 1
 #endif
 #include "performance_optimized_trace.h"
+#include "deferred_log.h"      // DLOG(): hot-path logging, printed later by deferred_log_task
+#include "GDFT_sliding.h"     // Incremental (sliding) alternative to the full GDFT pass
+
+// Run the full GDFT pass several bins at a time (kernel picked per target in GDFT_simd.h)
+#define ENABLE_GDFT_SIMD
+#ifdef ENABLE_GDFT_SIMD
+#include "GDFT_simd.h"
+#endif
+
+// Keep the GDFT post-processing in squared magnitudes, no per-bin sqrt (GDFT_optimized.h)
+// #define GDFT_POWER_DOMAIN
 #include "i2s_audio.h"        // I2S Microphone audio capture
 #include "led_utilities.h"    // LED color/transform utility functions
 #include "noise_cal.h"        // Background noise removal
+#include "GDFT_optimized.h"   // Shared GDFT post-processing helpers + power-domain pipeline
+#include "session_record.h"   // session= record / replay to flash
 #include "p2p.h"              // Sensory Sync handling
 #include "buttons.h"          // Watch the status of buttons
 #include "knobs.h"            // Watch the status of knobs...
@@ -64,6 +81,10 @@
 // #include "palettes_bridge.h"  // Palette system integration - safe scaffold ready for Phase 2
 #include "GDFT.h"             // Conversion to (and post-processing of) frequency data! (hey, something cool!)
 #include "lightshow_modes.h"  // --- FINALLY, the FUN STUFF!
+#include "strip_worker.h"     // Secondary strips render on Core 0
+#include "analysis_demand.h"  // Only run the analysis the active modes read
+#include "frame_governor.h"   // LED frames on a deadline grid
+#include "telemetry_stream.h" // Binary audio / analysis / LED records for the host recorder
 #include "debug/palette_debug.h"  // Palette debugging instrumentation
 #include "palettes/palette_luts_api.h"  // Names + LUT count for calibrated palettes
 #include "hmi/dual_encoder_controller.h"  // Dual encoder controller
@@ -90,20 +111,19 @@ HMI::DualEncoderController g_hmi_controller;
 // serial_mutex is now defined in globals.cpp to fix ODR violation
 // SemaphoreHandle_t serial_mutex;
 
-// Task handle for main loop on Core 0
-TaskHandle_t main_loop_task = NULL;
-
 // Forward declarations
 void led_thread(void* arg);
-void main_loop_thread(void* arg);
-void main_loop_core0();
+void audio_thread(void* arg);
+void control_thread(void* arg);
+void run_audio_frame(uint32_t t_now_us);
+void run_control_tasks();
 
 // Phase 2A: AudioRawState instance - MIGRATION IN PROGRESS
 // SAFETY: Audio thread only, no shared access, replaces i2s_samples_raw[] first
 SensoryBridge::Audio::AudioRawState audio_raw_state;
 
 // Phase 2B: AudioProcessedState instance - MIGRATION IN PROGRESS
-// SAFETY: Audio writes, LED reads - single-core scheduling provides atomicity
+// SAFETY: Audio task only; the LED thread reads these through led_audio (audio_frame.h)
 SensoryBridge::Audio::AudioProcessedState audio_processed_state;
 
 // Encoder state globals (must be defined exactly once)
@@ -133,11 +153,17 @@ void setup() {
   // REMOVED [2025-09-20 16:30] - preset_audio_debug() was re-enabling the disabled categories
   // DebugManager::preset_audio_debug();  // Start with audio-focused debugging
 
-  init_performance_trace(TRACE_CAT_LED | TRACE_CAT_PERF | TRACE_CAT_CRITICAL | TRACE_CAT_ERROR);
+  init_performance_trace(TRACE_DEFAULT_CATEGORIES);
   set_trace_level(TRACE_LEVEL_DEBUG);
-  set_trace_categories(TRACE_CAT_LED | TRACE_CAT_PERF | TRACE_CAT_CRITICAL | TRACE_CAT_ERROR);
+  set_trace_categories(TRACE_DEFAULT_CATEGORIES);
   xTaskCreatePinnedToCore(trace_consumer_task, "trace_consumer", 4096, nullptr,
                           tskIDLE_PRIORITY, nullptr, 1);
+  xTaskCreatePinnedToCore(deferred_log_task, "deferred_log", 4096, nullptr,
+                          tskIDLE_PRIORITY, nullptr, 1);
+  xTaskCreatePinnedToCore(telemetry_task, "telemetry", 4096, nullptr,
+                          tskIDLE_PRIORITY, nullptr, 1);
+  xTaskCreatePinnedToCore(session_task, "session", 4096, nullptr,
+                          tskIDLE_PRIORITY, nullptr, 1);
 
   // CRITICAL DEBUG: Test if execution continues after init_system()
   // Only print if USB serial is available (external power may not have USB)
@@ -205,6 +231,8 @@ void setup() {
   // The audio pipeline is running on Core 0. By moving the LED thread to the
   // other core, we distribute the workload, reduce contention, and significantly
   // improve performance and stability.
+  // The strips besides the primary render on Core 0 (strip_worker.h).
+  init_strip_worker();
   xTaskCreatePinnedToCore(led_thread, "led_task", 8192, NULL, tskIDLE_PRIORITY + 1, &led_task, 1);
   
   if (USBSerial) {
@@ -212,72 +240,174 @@ void setup() {
     USBSerial.flush();
   }
   
-  // CRITICAL: Create main loop task on Core 0 to prevent Core 1 watchdog issues
+  // CRITICAL: Create the Core 0 tasks to prevent Core 1 watchdog issues.
+  // Audio preempts control, so UI and comms load can't add audio jitter.
   if (USBSerial) {
-    USBSerial.println("DEBUG: Creating main loop task on Core 0...");
+    USBSerial.println("DEBUG: Creating audio and control tasks on Core 0...");
   }
-  xTaskCreatePinnedToCore(main_loop_thread, "main_loop", 16384, NULL, tskIDLE_PRIORITY + 2, &main_loop_task, 0);
+  xTaskCreatePinnedToCore(audio_thread, "audio_task", 16384, NULL, tskIDLE_PRIORITY + 3, &audio_task_handle, 0);
+  xTaskCreatePinnedToCore(control_thread, "control_task", 8192, NULL, tskIDLE_PRIORITY + 1, &control_task_handle, 0);
   if (USBSerial) {
-    USBSerial.println("DEBUG: Main loop task created on Core 0!");
+    USBSerial.println("DEBUG: Audio and control tasks created on Core 0!");
   }
 }
 
-// Main loop thread that runs on Core 0
-void main_loop_thread(void* arg) {
+// Audio task on Core 0: one frame per I2S RX_DONE event ---------------------------
+// Highest priority on Core 0, so control work (I2C, serial, P2P, flash)
+// can't delay audio capture; it only runs while this task waits for DMA.
+void audio_thread(void* arg) {
   if (USBSerial) {
-    USBSerial.println("DEBUG: Main loop thread started on Core 0!");
+    USBSerial.println("DEBUG: Audio thread started on Core 0!");
     USBSerial.print("Running on Core: ");
     USBSerial.println(xPortGetCoreID());
   }
-  
+
   // Register this task with the watchdog
   esp_task_wdt_add(NULL);  // NULL means current task
   if (USBSerial) {
-    USBSerial.println("DEBUG: Task registered with watchdog");
+    USBSerial.println("DEBUG: Audio task registered with watchdog");
   }
-  
-  // Run the actual loop code forever
+
+  uint32_t last_frame_start_us = 0;
+  while (true) {
+    apply_audio_hop_request();  // hop_size= from the serial menu (i2s_audio.h)
+
+    if (wait_for_sample_chunk(AUDIO_EVENT_TIMEOUT_MS)) {  // (i2s_audio.h)
+      // Jitter: how far this frame started from one hop period after the last
+      uint32_t t_start_us = micros();
+      if (last_frame_start_us != 0) {
+        int32_t hop_period_us = (1000000.0 * audio_hop_size) / CONFIG.SAMPLE_RATE;
+        int32_t deviation_us = abs(int32_t(t_start_us - last_frame_start_us) - hop_period_us);
+        if (uint32_t(deviation_us) > audio_frame_jitter_us) {
+          audio_frame_jitter_us = deviation_us;
+        }
+      }
+      last_frame_start_us = t_start_us;
+
+      run_audio_frame(t_start_us);
+    }
+
+    // Feed the watchdog timer
+    esp_task_wdt_reset();
+  }
+}
+
+// Control task on Core 0: UI, comms and housekeeping at a fixed period ------------
+void control_thread(void* arg) {
+  if (USBSerial) {
+    USBSerial.println("DEBUG: Control thread started on Core 0!");
+  }
+
+  // Register this task with the watchdog
+  esp_task_wdt_add(NULL);  // NULL means current task
+
+  TickType_t last_wake = xTaskGetTickCount();
   while (true) {
-    main_loop_core0();
+    run_control_tasks();
+
+    // Feed the watchdog timer
+    esp_task_wdt_reset();
+
+    vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(CONTROL_TASK_PERIOD_MS));
   }
 }
 
-// Actual loop code moved to separate function
-void main_loop_core0() {
+// Audio frames processed since the last performance print (control task reads)
+volatile uint32_t audio_frame_count = 0;
+
+// Frame and stage events for trace_stream=on (performance_optimized_trace.h)
+static AudioFrameTracer audio_tracer;
+static LEDFrameTracer led_tracer;
+
+// One audio frame, run by audio_thread() once a chunk is in DMA memory
+void run_audio_frame(uint32_t t_now_us) {
+  uint32_t t_now = t_now_us / 1000.0;  // Millisecond version
+  audio_tracer.start_frame();
+
+#ifdef ENABLE_PERFORMANCE_MONITORING
+  perf_metrics.frame_start_time = t_now_us;
+#endif
+
+  audio_frame_count++;
+  session_audio_frame_begin(t_now_us);  // session= record / replay (session_record.h)
+
+  function_id = 5;
+#ifdef ENABLE_PERFORMANCE_MONITORING
+  PERF_MONITOR_START();
+#endif
+  acquire_sample_chunk(t_now);  // (i2s_audio.h)
+  // Capture a frame of I2S audio (holy crap, FINALLY something about sound)
+#ifdef ENABLE_PERFORMANCE_MONITORING
+  PERF_MONITOR_END_STAGE(i2s_read_time, PERF_STAGE_I2S_READ);
+#endif
+
+  function_id = 6;
+  run_sweet_spot();  // (led_utilities.h)
+  // Based on the current audio volume, alter the Sweet Spot indicator LEDs
+
+  // Calculates audio loudness (VU) using RMS, adjusting for noise floor based on calibration
+  calculate_vu();
+
+  function_id = 7;
+  audio_tracer.start_gdft();
+  run_spectral_analysis(t_now);  // (analysis_demand.h)
+  audio_tracer.end_gdft();
+  // GDFT and novelty, unless no strip's mode reads them
+  // (If you're wondering about that weird acronym, check out GDFT.h)
+
+  // Hand this frame's results to led_thread() (audio_frame.h)
+  publish_audio_frame(t_now_us);
+  telemetry_audio_frame(t_now_us);  // telemetry= (telemetry_stream.h)
+
+  function_id = 8;
+  //lookahead_smoothing();  // (GDFT.h)
+  // Peek at upcoming frames to study/prevent flickering
+
+  function_id = 8;
+  log_fps(t_now_us);  // (system.h)
+  // Log the audio system FPS
+  
+  // Run diagnostics if enabled (DISABLED - was killing performance)
+  // if (debug_mode) {
+  //   diagnose_dc_offset();  // Diagnose DC offset issues
+  //   // diagnose_audio_pipeline();  // Full pipeline diagnostics (uncomment if needed)
+  // }
+  
+#ifdef ENABLE_PERFORMANCE_MONITORING
+  perf_metrics.total_frame_time = micros() - perf_metrics.frame_start_time;
+  update_performance_metrics();
+  log_performance_data();
+#endif
+  audio_tracer.end_frame();
+}
+
+// Everything on Core 0 that isn't audio, run by control_thread() every
+// CONTROL_TASK_PERIOD_MS
+void run_control_tasks() {
   static bool first_loop = true;
   if (first_loop) {
     if (USBSerial) {
-      USBSerial.println("DEBUG: Entered main loop!");
+      USBSerial.println("DEBUG: Entered control loop!");
       USBSerial.flush();
     }
     first_loop = false;
   }
-  
-  // No frame rate limiting - target is 120+ FPS
-  
-  uint32_t t_now_us = micros();        // Timestamp for this loop, used by some core functions
-  uint32_t t_now = t_now_us / 1000.0;  // Millisecond version
-  
-#ifdef ENABLE_PERFORMANCE_MONITORING
-  perf_metrics.frame_start_time = t_now_us;
-#endif
+
+  uint32_t t_now = millis();
 
   // S3 Performance Validation Metrics
-  static uint32_t frame_count = 0;
   static uint32_t last_fps_print = 0;
   
-  frame_count++;
-  
   // Print performance metrics every 15 seconds
   if (t_now - last_fps_print > 15000) {
     xSemaphoreTake(serial_mutex, portMAX_DELAY);
-    float actual_fps = frame_count / 5.0;
+    float actual_fps = audio_frame_count / 5.0;
     // Use debug manager for performance reporting (2.4 second interval with stagger)
     if (DebugManager::should_print(DEBUG_PERFORMANCE)) {
       DebugManager::print_s3_performance(actual_fps, g_race_condition_count);
       DebugManager::mark_printed(DEBUG_PERFORMANCE);
     }
-    frame_count = 0;
+    audio_frame_count = 0;
     g_race_condition_count = 0;
     last_fps_print = t_now;
     xSemaphoreGive(serial_mutex);
@@ -310,50 +440,6 @@ void main_loop_core0() {
   run_p2p();  // (p2p.h)
   // Process P2P network packets to synchronize units
 
-  function_id = 5;
-#ifdef ENABLE_PERFORMANCE_MONITORING
-  PERF_MONITOR_START();
-#endif
-  acquire_sample_chunk(t_now);  // (i2s_audio.h)
-  // Capture a frame of I2S audio (holy crap, FINALLY something about sound)
-#ifdef ENABLE_PERFORMANCE_MONITORING
-  PERF_MONITOR_END(i2s_read_time);
-#endif
-
-  function_id = 6;
-  run_sweet_spot();  // (led_utilities.h)
-  // Based on the current audio volume, alter the Sweet Spot indicator LEDs
-
-  // Calculates audio loudness (VU) using RMS, adjusting for noise floor based on calibration
-  calculate_vu();
-
-  function_id = 7;
-  process_GDFT();  // (GDFT.h)
-  // Execute GDFT and post-process
-  // (If you're wondering about that weird acronym, check out the source file)
-
-  // Watches the rate of change in the Goertzel bins to guide decisions for auto-color shifting
-  calculate_novelty(t_now);
-
-  // COLOR SHIFT PROCESSING [2025-09-20] - Simplified logic
-  // palettes_bridge.h now handles all palette protection internally
-  // This just manages whether to update hue_position or keep it static
-
-  if (CONFIG.AUTO_COLOR_SHIFT == true && CONFIG.PALETTE_INDEX == 0) {
-    // Only shift hue in HSV mode; keep palettes stable
-    process_color_shift();
-
-    #if DEBUG_COLOR_SHIFT_VALUES
-    // Debug tracking for color shift values
-    debug_color_shift_values(0.0f, 0.001f, 1.0f);
-    #endif
-  } else {
-    // Keep hue static when auto shift disabled
-    // For manual control in both HSV and palette modes
-    hue_position = 0;
-    hue_shifting_mix = -0.35;
-  }
-
   #if DEBUG_PALETTE_INDEX_WALKING
   // Log palette selection changes for on-device debugging
   static uint8_t last_palette_idx = 255;
@@ -366,26 +452,6 @@ void main_loop_core0() {
   }
   #endif
 
-  function_id = 8;
-  //lookahead_smoothing();  // (GDFT.h)
-  // Peek at upcoming frames to study/prevent flickering
-
-  function_id = 8;
-  log_fps(t_now_us);  // (system.h)
-  // Log the audio system FPS
-  
-  // Run diagnostics if enabled (DISABLED - was killing performance)
-  // if (debug_mode) {
-  //   diagnose_dc_offset();  // Diagnose DC offset issues
-  //   // diagnose_audio_pipeline();  // Full pipeline diagnostics (uncomment if needed)
-  // }
-  
-#ifdef ENABLE_PERFORMANCE_MONITORING
-  perf_metrics.total_frame_time = micros() - perf_metrics.frame_start_time;
-  update_performance_metrics();
-  log_performance_data();
-#endif
-
   // --- BENCHMARK LOGIC --- 
   if (benchmark_running) {
     uint32_t current_time = millis();
@@ -452,19 +518,12 @@ void main_loop_core0() {
   // This prevents watchdog timeouts during file operations
   extern void do_config_save();
   do_config_save();
-  
-
-  // Feed the watchdog timer
-  esp_task_wdt_reset();
-  
-  // Always yield to prevent watchdog timeouts
-  taskYIELD();
 }
 
 // Default loop() - just yields to prevent Core 1 execution
 void loop() {
   // CRITICAL: This runs on Core 1 by default
-  // All actual work is done in main_loop_thread on Core 0
+  // All actual work is done in audio_thread and control_thread on Core 0
   vTaskDelay(1000 / portTICK_PERIOD_MS);  // Sleep for 1 second
 }
 
@@ -476,44 +535,51 @@ void led_thread(void* arg) {
   while (!g_palette_ready) {
     vTaskDelay(1);
   }
+  restart_led_frame_grid();
   
   while (true) {
     if (led_thread_halt == false) {
+      led_tracer.start_frame();
+      apply_render_resolution_request();  // render_resolution= from the serial menu (led_utilities.h)
+      apply_output_curve_change();        // output_gamma= / white_balance= (output_curve.h)
       begin_frame();
 
       // Cache CONFIG values at start of frame
       cache_frame_config();
+      update_analysis_demand();  // For the audio task's next frame (analysis_demand.h)
       
       if (mode_transition_queued == true || noise_transition_queued == true) {
         run_transition_fade();
       }
 
-      get_smooth_spectrogram();
-      make_smooth_chromagram();
-
-      // Render the primary LED strip with the primary mode
-      if (frame_config.LIGHTSHOW_MODE == LIGHT_MODE_GDFT) {
-        light_mode_gdft();
-      } else if (frame_config.LIGHTSHOW_MODE == LIGHT_MODE_GDFT_CHROMAGRAM) {
-        light_mode_chromagram_gradient();
-      } else if (frame_config.LIGHTSHOW_MODE == LIGHT_MODE_GDFT_CHROMAGRAM_DOTS) {
-        light_mode_chromagram_dots();
-      } else if (frame_config.LIGHTSHOW_MODE == LIGHT_MODE_BLOOM) {
-        light_mode_bloom(leds_16_prev);
-      } else if (frame_config.LIGHTSHOW_MODE == LIGHT_MODE_VU_DOT) {
-        light_mode_vu_dot();
-      } else if (frame_config.LIGHTSHOW_MODE == LIGHT_MODE_KALEIDOSCOPE) {
-        light_mode_kaleidoscope();
-      } else if (frame_config.LIGHTSHOW_MODE == LIGHT_MODE_QUANTUM_COLLAPSE) {
-        light_mode_quantum_collapse();
-      } else if (frame_config.LIGHTSHOW_MODE == LIGHT_MODE_WAVEFORM) {
-        // Seed primary LED buffer for trails
-        memcpy(leds_16, leds_16_prev, sizeof(CRGB16) * NATIVE_RESOLUTION);
-        // Call waveform with primary state buffers/variables
-        light_mode_waveform(leds_16_prev, waveform_last_color_primary);
-        // Update primary previous buffer for next frame
-        memcpy(leds_16_prev, leds_16, sizeof(CRGB16) * NATIVE_RESOLUTION);
+      // Take the newest audio frame; everything below reads it through led_audio
+      acquire_audio_frame();
 
+      smooth_audio_features();  // (analysis_demand.h)
+
+      // The secondary strip renders on Core 0 meanwhile, in its own
+      // context (SECONDARY_* settings, hue walk, mode state), straight
+      // into leds_16_secondary, then through show_secondary_leds().
+      // show_leds() joins it before FastLED.show() (strip_worker.h)
+      if (ENABLE_SECONDARY_LEDS) {
+        queue_strip_job(secondary_render, show_secondary_leds);
+      }
+      start_strip_jobs();
+
+      // Render the primary LED strip with the primary mode (render_context.h)
+      update_render_color_shift(primary_render, led_audio);
+      #if DEBUG_COLOR_SHIFT_VALUES
+      debug_color_shift_values(0.0f, 0.001f, 1.0f);
+      #endif
+#ifdef ENABLE_PERFORMANCE_MONITORING
+      uint32_t t_render_us = micros();
+      render_light_mode(primary_render);
+      perf_stage_record(PERF_STAGE_MODE_RENDER, micros() - t_render_us);
+#else
+      render_light_mode(primary_render);
+#endif
+
+      if (primary_render.config.LIGHTSHOW_MODE == LIGHT_MODE_WAVEFORM) {
         // STAGE 1 DEBUG: Sample immediately after lightshow mode writes leds_16[]
         static uint16_t stage_burst_frames = 0; // set >0 to re-enable burst logging
         bool in_burst_mode = (stage_burst_frames > 0);
@@ -530,16 +596,16 @@ void led_thread(void* arg) {
           uint16_t i0 = 0;
           uint16_t i1 = (NATIVE_RESOLUTION > 64) ? (NATIVE_RESOLUTION / 2) : 0;
           uint16_t i2 = (NATIVE_RESOLUTION > 1) ? (NATIVE_RESOLUTION - 1) : 0;
-          USBSerial.printf("[STAGE-1-PRE-BRIGHT] Frame:%u 16bit f/m/l: "
-                           "(%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) | u8 f/m/l: "
-                           "(%u,%u,%u) (%u,%u,%u) (%u,%u,%u)\n",
-                           perf_metrics.frame_count,
-                           to_float(leds_16[i0].r), to_float(leds_16[i0].g), to_float(leds_16[i0].b),
-                           to_float(leds_16[i1].r), to_float(leds_16[i1].g), to_float(leds_16[i1].b),
-                           to_float(leds_16[i2].r), to_float(leds_16[i2].g), to_float(leds_16[i2].b),
-                           to_u8(leds_16[i0].r), to_u8(leds_16[i0].g), to_u8(leds_16[i0].b),
-                           to_u8(leds_16[i1].r), to_u8(leds_16[i1].g), to_u8(leds_16[i1].b),
-                           to_u8(leds_16[i2].r), to_u8(leds_16[i2].g), to_u8(leds_16[i2].b));
+          DLOG("[STAGE-1-PRE-BRIGHT] Frame:%u 16bit f/m/l: "
+               "(%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) (%.3f,%.3f,%.3f) | u8 f/m/l: "
+               "(%u,%u,%u) (%u,%u,%u) (%u,%u,%u)\n",
+               perf_metrics.frame_count,
+               to_float(leds_16[i0].r), to_float(leds_16[i0].g), to_float(leds_16[i0].b),
+               to_float(leds_16[i1].r), to_float(leds_16[i1].g), to_float(leds_16[i1].b),
+               to_float(leds_16[i2].r), to_float(leds_16[i2].g), to_float(leds_16[i2].b),
+               to_u8(leds_16[i0].r), to_u8(leds_16[i0].g), to_u8(leds_16[i0].b),
+               to_u8(leds_16[i1].r), to_u8(leds_16[i1].g), to_u8(leds_16[i1].b),
+               to_u8(leds_16[i2].r), to_u8(leds_16[i2].g), to_u8(leds_16[i2].b));
           if (!in_burst_mode) DebugManager::mark_printed(DEBUG_COLOR);
         }
         TRACE_EVENT(TRACE_CAT_LED, LED_CALC_START,
@@ -559,137 +625,33 @@ void led_thread(void* arg) {
         }
       }
 
-      if (CONFIG.PRISM_COUNT > 0) {
-        apply_prism_effect(CONFIG.PRISM_COUNT, 0.25);
+      if (primary_render.prism_count > 0) {
+        apply_prism_effect(primary_render, primary_render.prism_count, 0.25);
       }
 
       if (CONFIG.BULB_OPACITY > 0.00) {
         render_bulb_cover();
       }
       
-      // Only process secondary LEDs if enabled
-      if (ENABLE_SECONDARY_LEDS) {
-        // Store original LED buffer and settings before modifying anything
-        CRGB16 primary_buffer[NATIVE_RESOLUTION];
-        memcpy(primary_buffer, leds_16, sizeof(CRGB16) * NATIVE_RESOLUTION);
-        
-        // Store original settings
-        float saved_photons = CONFIG.PHOTONS;
-        float saved_chroma = CONFIG.CHROMA;
-        float saved_mood = CONFIG.MOOD;
-        bool saved_mirror = CONFIG.MIRROR_ENABLED;
-        float saved_saturation = CONFIG.SATURATION;
-        bool saved_auto_color_shift = CONFIG.AUTO_COLOR_SHIFT;
-        // Save additional potentially modified state
-        SQ15x16 saved_hue_position = hue_position;
-        SQ15x16 saved_chroma_val = chroma_val;
-        bool saved_chromatic_mode = chromatic_mode;
-        SQ15x16 saved_hue_shifting_mix = hue_shifting_mix;
-        uint8_t saved_square_iter = CONFIG.SQUARE_ITER;
-        // Add saving for potentially affected variables by specific modes
-        SQ15x16 saved_base_coat_width = base_coat_width;
-        SQ15x16 saved_base_coat_width_target = base_coat_width_target;
-        // CONFIG.MOOD is already saved in saved_mood (float)
-        // Add others as identified if necessary based on modes used for secondary strip
-
-        // Apply secondary settings
-        CONFIG.PHOTONS = SECONDARY_PHOTONS;
-        CONFIG.CHROMA = SECONDARY_CHROMA;
-        CONFIG.MOOD = SECONDARY_MOOD;
-        CONFIG.MIRROR_ENABLED = SECONDARY_MIRROR_ENABLED;
-        CONFIG.SATURATION = saved_saturation;
-        CONFIG.AUTO_COLOR_SHIFT = SECONDARY_AUTO_COLOR_SHIFT;
-        
-        // SECONDARY COLOR SHIFT [2025-09-20] - Simplified
-        // Let palettes_bridge.h handle protection internally
-        if (CONFIG.AUTO_COLOR_SHIFT == true && CONFIG.PALETTE_INDEX == 0) {
-          // Secondary hue shifting only in HSV mode
-          process_color_shift();
-
-          #if DEBUG_COLOR_SHIFT_VALUES
-          // Track secondary channel shift
-          debug_color_shift_values(0.0f, 0.001f, 1.0f);
-          #endif
-        }
-        
-        // Clear and render new pattern for secondary LEDs
-        // Seed secondary pattern buffer for trails from last frame
-        memcpy(leds_16, leds_16_prev_secondary, sizeof(CRGB16) * NATIVE_RESOLUTION);
-        
-        // Use the SECONDARY_LIGHTSHOW_MODE directly without modifying CONFIG.LIGHTSHOW_MODE
-        if (SECONDARY_LIGHTSHOW_MODE == LIGHT_MODE_GDFT) {
-          light_mode_gdft();
-        } else if (SECONDARY_LIGHTSHOW_MODE == LIGHT_MODE_GDFT_CHROMAGRAM) {
-          light_mode_chromagram_gradient();
-        } else if (SECONDARY_LIGHTSHOW_MODE == LIGHT_MODE_GDFT_CHROMAGRAM_DOTS) {
-          light_mode_chromagram_dots();
-        } else if (SECONDARY_LIGHTSHOW_MODE == LIGHT_MODE_BLOOM) {
-          light_mode_bloom(leds_16_prev_secondary);
-        } else if (SECONDARY_LIGHTSHOW_MODE == LIGHT_MODE_VU_DOT) {
-          light_mode_vu_dot();
-        } else if (SECONDARY_LIGHTSHOW_MODE == LIGHT_MODE_KALEIDOSCOPE) {
-          light_mode_kaleidoscope();
-        } else if (SECONDARY_LIGHTSHOW_MODE == LIGHT_MODE_QUANTUM_COLLAPSE) {
-          light_mode_quantum_collapse();
-        } else if (SECONDARY_LIGHTSHOW_MODE == LIGHT_MODE_WAVEFORM) {
-          // Call waveform with secondary state buffers/variables
-          light_mode_waveform(leds_16_prev_secondary, waveform_last_color_secondary);
-          // Secondary buffer is saved below, but update its 'previous' state now
-          memcpy(leds_16_prev_secondary, leds_16, sizeof(CRGB16) * NATIVE_RESOLUTION);
-        }
-        
-        if (SECONDARY_PRISM_COUNT > 0) {
-          apply_prism_effect(SECONDARY_PRISM_COUNT, 0.25);
-        }
-        
-        // Save secondary pattern
-        memcpy(leds_16_secondary, leds_16, sizeof(CRGB16) * NATIVE_RESOLUTION);
-        clip_led_values(leds_16_secondary); // Clip the secondary buffer values
-        
-        // Restore primary buffer and settings
-        memcpy(leds_16, primary_buffer, sizeof(CRGB16) * NATIVE_RESOLUTION);
-        CONFIG.PHOTONS = saved_photons;
-        CONFIG.CHROMA = saved_chroma;
-        CONFIG.MOOD = saved_mood;
-        CONFIG.MIRROR_ENABLED = saved_mirror;
-        CONFIG.SATURATION = saved_saturation;
-        CONFIG.AUTO_COLOR_SHIFT = saved_auto_color_shift;
-        // Restore additional state
-        hue_position = saved_hue_position;
-        chroma_val = saved_chroma_val;
-        chromatic_mode = saved_chromatic_mode;
-        hue_shifting_mix = saved_hue_shifting_mix;
-        CONFIG.SQUARE_ITER = saved_square_iter;
-        // Restore the additional variables
-        base_coat_width = saved_base_coat_width;
-        base_coat_width_target = saved_base_coat_width_target;
-        // CONFIG.MOOD is restored via saved_mood
-
-        // Debug output disabled to prevent memory overflow
-        /*
-        if (ENABLE_SECONDARY_LEDS && (millis() % 1000 == 0)) { // Print roughly once per second
-            USBSerial.print("DEBUG: Secondary Raw [0-4]: ");
-            for(int k=0; k<5; k++) {
-                USBSerial.printf(" R:%.2f G:%.2f B:%.2f |",
-                    float(leds_16_secondary[k].r),
-                    float(leds_16_secondary[k].g),
-                    float(leds_16_secondary[k].b));
-            }
-            USBSerial.println();
-            USBSerial.printf("Audio peak: %.3f, Chromagram[0]: %.3f\n", 
-                waveform_peak_scaled, float(chromagram_smooth[0]));
-        }
-        */
-      }
-      
       publish_frame();
+      led_frame_rendered();  // (frame_governor.h)
 
+      led_tracer.start_show();
       show_leds();
+      led_tracer.end_show();
       
       LED_FPS = 0.95 * LED_FPS + 0.05 * (1000000.0 / (esp_timer_get_time() - last_frame_us));
       last_frame_us = esp_timer_get_time();
+      led_tracer.end_frame(LED_FPS < 255.0 ? uint8_t(LED_FPS) : 255);
+      telemetry_led_frame();
+      session_led_frame();
+
+      // Sleep until the next frame's deadline (led_frame_rate=)
+      wait_for_next_led_frame();
+    } else {
+      vTaskDelay(1);
+      restart_led_frame_grid();
     }
-    vTaskDelay(1);
   }
 }
 
@@ -39,7 +39,7 @@ void start_noise_cal() {
   for (uint8_t i = 0; i < NUM_FREQS; i++) {
     noise_samples[i] = 0;
   }
-  for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+  for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
     ui_mask[i] = 0;
   }
   USBSerial.println("STARTING NOISE CAL (with AGC preservation)");
@@ -54,4 +54,16 @@ void clear_noise_cal() {
   save_config();
   save_ambient_noise_calibration();
   USBSerial.println("NOISE CAL CLEARED");
-}
\ No newline at end of file
+}
+
+// Called from the GDFT pipeline once noise_iterations reaches 256
+void complete_noise_cal() {
+  noise_complete = true;
+  USBSerial.println("NOISE CAL COMPLETE");
+
+  // SINGLE-CORE OPTIMIZATION: Direct CONFIG write (no mutex needed)
+  CONFIG.DC_OFFSET = audio_raw_state.getDCOffsetSum() / 256.0;  // Calculate average DC offset and store it
+
+  save_ambient_noise_calibration();           // Save results to noise_cal.bin
+  save_config();                              // Save config to config.bin
+}
@@ -0,0 +1,72 @@
+#ifndef OUTPUT_CURVE_H
+#define OUTPUT_CURVE_H
+
+/*----------------------------------------
+  OUTPUT TRANSFER CURVE
+
+  The last step before leds_out: a linear 0.0 - 1.0 channel becomes an
+  8-bit LED value. Instead of multiplying by 255, both strips look the
+  channel up in output_lut[], one table per colour, indexed by the top
+  OUTPUT_LUT_BITS bits of the channel. Each entry is the LED value in
+  8.8 fixed point: the high byte is shown, and the low byte is the
+  fraction the temporal dither carries over (dither_led(),
+  led_utilities.h).
+
+  The tables hold the output gamma and the white balance gains
+  (output_gamma= and white_balance= in the serial menu, saved in
+  /output_curve.bin). They're rebuilt only when one of those changes,
+  by the LED thread between frames. At the defaults (gamma 1.0, gains
+  1.0) the curve is a straight line and only the rounding changes.
+
+  Brightness isn't in the tables: it moves every frame (silent_scale,
+  the boot fade) and is applied before the UI is drawn, so the UI
+  keeps its own brightness. See apply_brightness().
+  ----------------------------------------*/
+
+#include "globals.h"
+
+inline void build_output_lut() {
+  const float gamma = output_curve.gamma;
+  for (uint16_t i = 0; i < OUTPUT_LUT_SIZE; i++) {
+    float level = i / float(OUTPUT_LUT_SIZE - 1);
+    if (gamma != 1.0f) {
+      level = powf(level, gamma);
+    }
+    for (uint8_t c = 0; c < 3; c++) {
+      output_lut[c][i] = uint16_t(level * output_curve.gain[c] * OUTPUT_LUT_FULL_SCALE + 0.5f);
+    }
+  }
+}
+
+// LED thread, between frames: pick up output_gamma= / white_balance=
+inline void apply_output_curve_change() {
+  if (output_curve_changed) {
+    output_curve_changed = false;
+    build_output_lut();
+  }
+}
+
+// Table index for a channel, clipped to 0.0 - 1.0
+inline uint16_t output_lut_index(led_channel_t value) {
+#ifndef LED_PIXEL_WIDE
+  uint16_t index = value.getInternal() >> (15 - OUTPUT_LUT_BITS);
+  return (index > OUTPUT_LUT_SIZE - 1) ? OUTPUT_LUT_SIZE - 1 : index;
+#else
+  int32_t index = value.getInternal() >> (16 - OUTPUT_LUT_BITS);
+  return (index < 0) ? 0 : (index > OUTPUT_LUT_SIZE - 1) ? OUTPUT_LUT_SIZE - 1 : uint16_t(index);
+#endif
+}
+
+// 8.8 LED value of one channel (c: 0 = red, 1 = green, 2 = blue)
+inline uint16_t output_level(led_channel_t value, uint8_t c) {
+  return output_lut[c][output_lut_index(value)];
+}
+
+// Without dithering: the whole part only
+inline CRGB output_led(const CRGB16& col) {
+  return CRGB(output_level(col.r, 0) >> 8,
+              output_level(col.g, 1) >> 8,
+              output_level(col.b, 2) >> 8);
+}
+
+#endif // OUTPUT_CURVE_H
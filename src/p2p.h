@@ -119,6 +119,7 @@ void on_data_rx(const esp_now_recv_info_t *recv_info, const uint8_t *incoming_da
 void on_data_rx(const uint8_t *mac_addr, const uint8_t *incoming_data, int len) {
 #endif
   //Serial.println("RX PACKET");
+  session_record_event(SESSION_EVENT_P2P, incoming_data, len);  // (session_record.h)
   main_override = false;
   last_rx_time = millis();
   char data_type[4];
@@ -18,14 +18,15 @@ static inline uint8_t byte01(SQ15x16 v) {
   return uint8_t(f * 255.0f + 0.5f);
 }
 
-// Sample either HSV or the current LED‑calibrated palette LUT
-static inline CRGB16 hsv_or_palette(SQ15x16 hue01, SQ15x16 sat01, SQ15x16 val01) {
-  const uint8_t sel = CONFIG.PALETTE_INDEX;  // 0 = HSV, 1+ = palette
+// Sample either HSV or the current LED‑calibrated palette LUT, with one
+// render context's settings (light modes pass ctx.config)
+static inline CRGB16 hsv_or_palette(const cached_config& cfg, SQ15x16 hue01, SQ15x16 sat01, SQ15x16 val01) {
+  const uint8_t sel = cfg.PALETTE_INDEX;  // 0 = HSV, 1+ = palette
   if (sel == 0) return hsv(hue01, sat01, val01);
 
   // Palette mode: use 256-entry calibrated LUTs built in palette_luts.cpp
-  const CRGB16* lut = frame_config.palette_ptr;
-  const uint16_t lut_size = frame_config.palette_size;
+  const CRGB16* lut = cfg.palette_ptr;
+  const uint16_t lut_size = cfg.palette_size;
 
   // Fallback to HSV if LUT missing
   if (lut == nullptr || lut_size == 0) {
@@ -34,7 +35,7 @@ static inline CRGB16 hsv_or_palette(SQ15x16 hue01, SQ15x16 sat01, SQ15x16 val01)
 
   // When AUTO_COLOR_SHIFT is enabled, keep palette sampling static to avoid color drift
   // Use mid-point index which is safe for most palettes
-  uint8_t palPos = CONFIG.AUTO_COLOR_SHIFT ? 128 : byte01(hue01);
+  uint8_t palPos = cfg.AUTO_COLOR_SHIFT ? 128 : byte01(hue01);
   if (palPos >= lut_size) palPos = lut_size - 1;
 
   CRGB16 result = lut[palPos];
@@ -49,6 +50,11 @@ static inline CRGB16 hsv_or_palette(SQ15x16 hue01, SQ15x16 sat01, SQ15x16 val01)
   return result;
 }
 
+// The same with this frame's primary settings (UI, transitions)
+static inline CRGB16 hsv_or_palette(SQ15x16 hue01, SQ15x16 sat01, SQ15x16 val01) {
+  return hsv_or_palette(frame_config, hue01, sat01, val01);
+}
+
 // Helpers for UI/debug naming
 static inline const char* get_current_palette_name() {
   return palette_name_for_index(CONFIG.PALETTE_INDEX);
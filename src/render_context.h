@@ -0,0 +1,112 @@
+#ifndef RENDER_CONTEXT_H
+#define RENDER_CONTEXT_H
+
+/*----------------------------------------
+  RENDER CONTEXTS
+
+  Each LED strip renders through its own RenderContext (globals.h):
+  the settings its light mode reads, its auto color shift, the buffer
+  it draws into and its previous frame, its dots, and the state every
+  mode keeps between frames. Modes take the context as an argument and
+  touch nothing strip-specific outside it, so the secondary strip no
+  longer borrows leds_16 and the primary's CONFIG fields to render.
+
+    primary_render    CONFIG.*            -> leds_16
+    secondary_render  SECONDARY_* / CONFIG -> leds_16_secondary
+
+  Settings are copied into each context once per frame
+  (cache_frame_config(), lightshow_modes.cpp), so a serial command or
+  knob landing mid-frame can't change them halfway through a mode.
+  ----------------------------------------*/
+
+#include "globals.h"
+#include "frame_arena.h"
+
+inline void process_color_shift(ColorShiftState& hue, SQ15x16 novelty_now);
+
+// Everything not set here starts at zero (the contexts are globals)
+inline void init_render_context(RenderContext& ctx, const char* name, CRGB16* leds, CRGB16* leds_prev, CRGB16* fx) {
+  ctx.name = name;
+  ctx.leds = leds;
+  ctx.leds_prev = leds_prev;
+  ctx.fx = fx;
+
+  ctx.hue.push_direction = -1.0;
+  ctx.hue.shifting_mix = -0.35;
+  ctx.hue.shifting_mix_target = 1.0;
+
+  // Room for the largest mode's state, taken here rather than on a mode's
+  // first frame: the strips render on different cores (strip_worker.h),
+  // and frame_arena_take() isn't thread safe
+  uint16_t words = (light_mode_state_bytes(render_capacity) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+  ctx.mode_state = reinterpret_cast<uint8_t*>(frame_arena_take<uint64_t>(words));
+  ctx.mode_state_size = (ctx.mode_state != NULL) ? words * sizeof(uint64_t) : 0;
+  ctx.mode = NUM_MODES;
+}
+
+// Once at boot, after init_frame_arena()
+inline void init_render_contexts() {
+  init_render_context(primary_render, "primary", leds_16, leds_16_prev, leds_16_fx);
+  init_render_context(secondary_render, "secondary", leds_16_secondary, leds_16_prev_secondary, leds_16_fx_secondary);
+}
+
+// Forget the context's mode state; its mode starts over from its init
+// hook on the next frame (a new render width, or the arena zeroed)
+inline void reset_render_mode(RenderContext& ctx) {
+  ctx.mode = NUM_MODES;
+}
+
+// The state struct of the context's current mode
+template <typename T>
+inline T& mode_state(RenderContext& ctx) {
+  return *reinterpret_cast<T*>(ctx.mode_state);
+}
+
+// From a mode's init hook: count T's from the context's mode state, after
+// the state struct, or NULL past light_mode_state_bytes()
+template <typename T>
+inline T* mode_state_take(RenderContext& ctx, uint16_t count) {
+  uint32_t offset = (ctx.mode_state_used + alignof(T) - 1) & ~(alignof(T) - 1);
+  uint32_t bytes = sizeof(T) * count;
+  if (offset + bytes > ctx.mode_state_size) {
+    return NULL;
+  }
+  ctx.mode_state_used = offset + bytes;
+  return reinterpret_cast<T*>(ctx.mode_state + offset);
+}
+
+// chroma_val / chromatic_mode from the context's CHROMA, as check_knobs()
+// does for CONFIG.CHROMA: the top 5% of the knob is chromatic mode
+inline void update_render_chroma(RenderContext& ctx) {
+  ctx.chroma_val = 1.0;
+  if (ctx.config.CHROMA < 0.95) {
+    ctx.chroma_val = ctx.config.CHROMA * 1.05263157;  // Reciprocal of 0.95 above
+    ctx.chromatic_mode = false;
+  } else {
+    ctx.chromatic_mode = true;
+  }
+}
+
+// LED thread, each frame: step the context's auto color shift once per
+// new audio frame (it's tuned to the audio frame rate, not the LED one)
+inline void update_render_color_shift(RenderContext& ctx, const AudioFrame* frame) {
+  if (ctx.config.AUTO_COLOR_SHIFT == true && ctx.config.PALETTE_INDEX == 0) {
+    // Only shift hue in HSV mode; keep palettes stable
+    if (frame->seq != ctx.hue_audio_seq) {
+      ctx.hue_audio_seq = frame->seq;
+      process_color_shift(ctx.hue, frame->novelty);
+    }
+  } else {
+    // Keep hue static when auto shift disabled
+    ctx.hue.position = 0;
+    ctx.hue.shifting_mix = -0.35;
+  }
+}
+
+// mood_scale() for the context's MOOD
+inline SQ15x16 render_mood_scale(const RenderContext& ctx, SQ15x16 center, SQ15x16 range) {
+  SQ15x16 knob_value_bidirectional = (SQ15x16(ctx.config.MOOD) - 0.5) * SQ15x16(2.0);  // -1.0 to +1.0
+  return center + range * knob_value_bidirectional;
+}
+
+#endif // RENDER_CONTEXT_H
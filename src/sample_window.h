@@ -0,0 +1,42 @@
+#ifndef SAMPLE_WINDOW_H
+#define SAMPLE_WINDOW_H
+
+#include <cstring>
+#include "globals.h"
+
+// The audio history is a ring buffer stored twice back to back
+// (sample_ring[i] == sample_ring[i + SAMPLE_HISTORY_LENGTH]), so the
+// newest SAMPLE_HISTORY_LENGTH samples are always one contiguous
+// window starting at sample_ring_head, oldest first. Appending a
+// chunk is two short copies instead of shifting the whole history.
+
+// Base of the current window: [0] is the oldest sample and
+// [SAMPLE_HISTORY_LENGTH - 1] the newest. Only valid until the next
+// sample_window_append().
+inline const short* sample_window_base()
+{
+  return &sample_ring[sample_ring_head];
+}
+
+// Append samples to the end of the window, dropping the oldest
+inline void sample_window_append(const short* samples, uint16_t count)
+{
+  while (count > 0) {
+    uint16_t span = SAMPLE_HISTORY_LENGTH - sample_ring_head;
+    if (span > count) {
+      span = count;
+    }
+
+    std::memcpy(&sample_ring[sample_ring_head], samples, sizeof(short) * span);
+    std::memcpy(&sample_ring[sample_ring_head + SAMPLE_HISTORY_LENGTH], samples, sizeof(short) * span);
+
+    sample_ring_head += span;
+    if (sample_ring_head >= SAMPLE_HISTORY_LENGTH) {
+      sample_ring_head = 0;
+    }
+    samples += span;
+    count -= span;
+  }
+}
+
+#endif // SAMPLE_WINDOW_H
@@ -12,6 +12,8 @@ extern void reboot();                  // system.h
 #include "debug/performance_monitor.h"
 #endif
 #include "debug/debug_manager.h"
+#include "telemetry_stream.h"
+#include "session_record.h"
 
 // Benchmark state variables (defined in main .ino file)
 extern bool benchmark_running;
@@ -158,9 +160,32 @@ void dump_info() {
   USBSerial.print("CONFIG.LED_COUNT: ");
   USBSerial.println(CONFIG.LED_COUNT);
 
+  USBSerial.print("RENDER_RESOLUTION: ");
+  USBSerial.print(NATIVE_RESOLUTION);
+  USBSerial.print(" (max ");
+  USBSerial.print(render_capacity);
+  USBSerial.println(render_resolution_setting == RENDER_FOLLOWS_LED_COUNT ? ", follows led_count)" : ")");
+
+  USBSerial.print("LED_FRAME_RATE: ");
+  if (led_frame_rate_setting == LED_FRAME_RATE_UNCAPPED) {
+    USBSerial.println("max");
+  } else {
+    USBSerial.println(led_frame_rate_setting);
+  }
+
   USBSerial.print("CONFIG.LED_COLOR_ORDER: ");
   USBSerial.println(CONFIG.LED_COLOR_ORDER);
 
+  USBSerial.print("OUTPUT_GAMMA: ");
+  USBSerial.println(output_curve.gamma);
+
+  USBSerial.print("WHITE_BALANCE: ");
+  USBSerial.print(output_curve.gain[0]);
+  USBSerial.print(",");
+  USBSerial.print(output_curve.gain[1]);
+  USBSerial.print(",");
+  USBSerial.println(output_curve.gain[2]);
+
   USBSerial.print("CONFIG.SAMPLES_PER_CHUNK: ");
   USBSerial.println(CONFIG.SAMPLES_PER_CHUNK);
 
@@ -309,6 +334,10 @@ void parse_command(char* command_buf) {
     USBSerial.println("                                         stop | Stops the output of any enabled streams");
     USBSerial.println("                                          fps | Return the system FPS");
     USBSerial.println("                                      led_fps | Return the LED FPS");
+    USBSerial.println("                                 audio_frames | Audio -> LED frame hand-off counters (dropped, repeated, torn)");
+    USBSerial.println("                                   audio_task | Audio frame jitter (worst since last query) and I2S event counters");
+    USBSerial.println("                                      latency | Audio-to-photon latency (I2S DMA done -> LEDs shown) p50/p95/p99/max");
+    USBSerial.println("                                reset_latency | Clear the audio-to-photon latency histogram");
     USBSerial.println("                                  audio_guard | Display audio guard protection status");
     USBSerial.println("                                      chip_id | Return the chip id (MAC) of the CPU");
     USBSerial.println("                                     get_mode | Get lightshow mode's ID (index)");
@@ -326,13 +355,33 @@ void parse_command(char* command_buf) {
     USBSerial.println("                                                Options are: audio, fps, magnitudes, spectrogram, chromagram");
     USBSerial.println("led_type=['neopixel'/'neopixel_x2'/'dotstar'] | Sets which LED protocol to use, 3 wire, 4 wire, or dual-data mode");
     USBSerial.println("                 led_count=[int or 'default'] | Sets how many LEDs your display will use (native resolution is 128)");
+    USBSerial.println("    render_resolution=[int/led_count/default] | Pixels the modes draw before resampling to led_count (32 to the");
+    USBSerial.println("                                                larger of 160 and led_count); 'led_count' skips resampling");
     USBSerial.println("        led_color_order=[GRB/RGB/BGR/default] | Sets LED color ordering, default GRB");
     USBSerial.println("       led_interpolation=[true/false/default] | Toggles linear LED interpolation when running in a non-native resolution (slower)");
+    USBSerial.println("          led_pipeline=[fused/staged/default] | LED post-processing in one fused pass, or stage by stage (reference). Not saved");
+    USBSerial.println("              led_frame_rate=[hz/max/default] | LED frames per second, 20 to 500 (led_thread sleeps between");
+    USBSerial.println("                                                frames), or 'max' for as fast as the strip shows");
+    USBSerial.println("       strip_render=[parallel/serial/default] | Render the secondary strip on Core 0 alongside the primary, or after");
+    USBSerial.println("                                                it on Core 1; either way prints the last frame's timing. Not saved");
+    USBSerial.println("               analysis=[demand/full/default] | Run only the audio analysis the active modes read, or");
+    USBSerial.println("                                                every stage every frame; either way prints what ran. Not saved");
+    USBSerial.println("                trace_stream=[on/off/default] | Stream trace events (both cores' audio and LED frame stages) as");
+    USBSerial.println("                                                COBS framed binary; host/sb_trace_convert makes a Perfetto trace");
+    USBSerial.println("         telemetry=[channels/all/off/default] | Stream pcm,spectrogram,chromagram,novelty,leds,perf (any of,");
+    USBSerial.println("                                                comma separated) as binary records for host/sb_telemetry_record");
+    USBSerial.println("         telemetry_budget=[kB/s or 'default'] | Most the telemetry stream may send, 10 to 1000. Not saved");
+    USBSerial.println("     session=[record/replay/send/stop/status] | Record audio, CONFIG changes and input to flash until stop,");
+    USBSerial.println("                                                replay it through the show, or send it over USB (host/sb_dsp_host)");
     USBSerial.println("                           debug=[true/false] | Enables debug mode, where functions are timed");
     USBSerial.println("                sample_rate=[hz or 'default'] | Sets the microphone sample rate");
+    USBSerial.println("           gdft_engine=[full/sliding/default] | Selects the full Goertzel pass or the sliding GDFT for long bins");
+    USBSerial.println("                                   gdft_drift | Compare the sliding GDFT against the full engine");
     USBSerial.println("              note_offset=[0-32 or 'default'] | Sets the lowest note, as a positive offset from A1 (55.0Hz)");
     USBSerial.println("               square_iter=[int or 'default'] | Sets the number of times the LED output is squared (contrast)");
     USBSerial.println("         samples_per_chunk=[int or 'default'] | Sets the number of samples collected every frame");
+    USBSerial.println("                  hop_size=[int or 'default'] | Analyze every N samples (64 to samples_per_chunk),");
+    USBSerial.println("                                                lower is less latency but more CPU. Not saved");
     USBSerial.println("             sensitivity=[float or 'default'] | Sets the scaling of audio data (>1.0 is more sensitive, <1.0 is less sensitive)");
     USBSerial.println("          boot_animation=[true/false/default] | Enable or disable the boot animation");
     USBSerial.println("                   set_main_unit=[true/false] | Sets if this unit is MAIN or not for SensorySync");
@@ -347,6 +396,8 @@ void parse_command(char* command_buf) {
     USBSerial.println("        auto_color_shift=[true/false/default] | Toggle automated color shifting based on positive spectral changes");
     USBSerial.println("     incandescent_filter=[float or 'default'] | Set the intensity of the incandescent LUT (reduces harsh blues)");
     USBSerial.println("       incandescent_mode=[true/false/default] | Force all output into monochrome and tint with 2700K incandescent color");
+    USBSerial.println("            output_gamma=[float or 'default'] | Output curve applied to the linear LED values, 0.5 to 3.0 (1.0 = linear)");
+    USBSerial.println("           white_balance=[r,g,b or 'default'] | Output gain per channel, 0.0 to 1.0 each (e.g. 1.0,0.9,0.8)");
     USBSerial.println("               base_coat=[true/false/default] | Enable a dim gray backdrop to the LEDs (approves appearance in most modes)");
     USBSerial.println("            bulb_opacity=[float or 'default'] | Set opacity of a filter that portrays the output as 32 \"bulbs\" with separation and hot spots");
     USBSerial.println("              saturation=[float or 'default'] | Sets the saturation of internal hues");
@@ -372,6 +423,8 @@ void parse_command(char* command_buf) {
     USBSerial.println("                                   PERF SWEEP | Run frequency sweep test");
     USBSerial.println("                                  PERF STRESS | Run 60-second stress test");
     USBSerial.println("                                   PERF RESET | Reset performance metrics");
+    USBSerial.println("                                stage_latency | Per-stage timing histograms: mean and p50/p90/p99/p99.9/max");
+    USBSerial.println("                          reset_stage_latency | Clear the per-stage timing histograms");
 #endif
     tx_end(); 
   }
@@ -587,7 +640,86 @@ void parse_command(char* command_buf) {
     tx_end();
 
   }
+
+  // Print audio task timing and I2S event counters ---------
+  else if (strcmp(command_buf, "audio_task") == 0) {
+
+    tx_begin();
+    USBSerial.print("AUDIO_HOP_SIZE: ");
+    USBSerial.println(audio_hop_size);
+    USBSerial.print("AUDIO_FRAME_JITTER_US: ");
+    USBSerial.println(audio_frame_jitter_us);
+    USBSerial.print("I2S_EVENT_TIMEOUTS: ");
+    USBSerial.println(i2s_event_timeouts);
+    USBSerial.print("I2S_DMA_ERRORS: ");
+    USBSerial.println(i2s_dma_errors);
+    USBSerial.print("CONTROL_TASK_PERIOD_MS: ");
+    USBSerial.println(CONTROL_TASK_PERIOD_MS);
+    tx_end();
+
+    audio_frame_jitter_us = 0;  // Worst case since the last query
+
+  }
+
+  // Print the audio -> LED frame hand-off counters ---------
+  else if (strcmp(command_buf, "audio_frames") == 0) {
+
+    tx_begin();
+    USBSerial.print("AUDIO_FRAME_SEQ: ");
+    USBSerial.println(led_audio->seq);
+    USBSerial.print("AUDIO_FRAME_AGE_US: ");
+    USBSerial.println(micros() - led_audio->timestamp_us);
+    USBSerial.print("AUDIO_FRAMES_DROPPED: ");
+    USBSerial.println(audio_frames_dropped);
+    USBSerial.print("AUDIO_FRAMES_REPEATED: ");
+    USBSerial.println(audio_frames_repeated);
+    USBSerial.print("TORN_READS: ");
+    USBSerial.println(g_race_condition_count);
+    tx_end();
+
+  }
   
+  // Print the audio-to-photon latency histogram ------------
+  else if (strcmp(command_buf, "latency") == 0) {
+
+    tx_begin();
+    USBSerial.print("LATENCY_SAMPLES: ");
+    USBSerial.println(audio_to_photon_latency.samples);
+    USBSerial.print("LATENCY_LAST_US: ");
+    USBSerial.println(audio_to_photon_latency.last_us);
+    USBSerial.print("LATENCY_P50_US: ");
+    USBSerial.println(latency_histogram_percentile(audio_to_photon_latency, 50.0));
+    USBSerial.print("LATENCY_P95_US: ");
+    USBSerial.println(latency_histogram_percentile(audio_to_photon_latency, 95.0));
+    USBSerial.print("LATENCY_P99_US: ");
+    USBSerial.println(latency_histogram_percentile(audio_to_photon_latency, 99.0));
+    USBSerial.print("LATENCY_MAX_US: ");
+    USBSerial.println(audio_to_photon_latency.max_us);
+    tx_end();
+
+  }
+
+  // Clear the audio-to-photon latency histogram ------------
+  else if (strcmp(command_buf, "reset_latency") == 0) {
+    audio_to_photon_reset = true;  // The LED thread clears it before its next sample
+    ack();
+  }
+
+#ifdef ENABLE_PERFORMANCE_MONITORING
+  // Print the per-stage timing histograms -----------------
+  else if (strcmp(command_buf, "stage_latency") == 0) {
+    tx_begin();
+    print_stage_histograms();  // (debug/performance_monitor.cpp)
+    tx_end();
+  }
+
+  // Clear the per-stage timing histograms -----------------
+  else if (strcmp(command_buf, "reset_stage_latency") == 0) {
+    reset_stage_histograms();  // Each stage's task clears its own before its next sample
+    ack();
+  }
+#endif
+
   // Print audio guard status -------------------------------
   else if (strcmp(command_buf, "audio_guard") == 0) {
 
@@ -702,6 +834,13 @@ void parse_command(char* command_buf) {
     tx_end();
   }
 
+  // Compare the sliding GDFT against the full engine -------
+  else if (strcmp(command_buf, "gdft_drift") == 0) {
+    tx_begin();
+    print_gdft_sliding_drift(sample_window_base());
+    tx_end();
+  }
+
   // COMMANDS WITH METADATA ##################################
 
   else {  // Commands with metadata are parsed here
@@ -859,6 +998,224 @@ void parse_command(char* command_buf) {
       }
     }
 
+    // Select GDFT engine ------------------------------------
+    else if (strcmp(command_type, "gdft_engine") == 0) {
+      bool good = false;
+      if (strcmp(command_data, "full") == 0 || strcmp(command_data, "default") == 0) {
+        good = true;
+        gdft_engine = GDFT_ENGINE_FULL;
+      } else if (strcmp(command_data, "sliding") == 0) {
+        good = true;
+        gdft_engine = GDFT_ENGINE_SLIDING;
+        invalidate_gdft_sliding();  // Rebuilt from sample_window on the next frame
+      } else {
+        bad_command(command_type, command_data);
+      }
+
+      if (good) {
+        tx_begin();
+        USBSerial.print("GDFT_ENGINE: ");
+        if (gdft_engine == GDFT_ENGINE_SLIDING) {
+          USBSerial.println("sliding");
+        } else {
+          USBSerial.println("full");
+        }
+        tx_end();
+      }
+    }
+
+    // Select the LED post-processing path ------------------
+    else if (strcmp(command_type, "led_pipeline") == 0) {
+      bool good = false;
+      if (strcmp(command_data, "fused") == 0 || strcmp(command_data, "default") == 0) {
+        good = true;
+        led_post_fused = true;
+      } else if (strcmp(command_data, "staged") == 0) {
+        good = true;
+        led_post_fused = false;
+      } else {
+        bad_command(command_type, command_data);
+      }
+
+      if (good) {
+        tx_begin();
+        USBSerial.print("LED_PIPELINE: ");
+        USBSerial.println(led_post_fused ? "fused" : "staged");
+        tx_end();
+      }
+    }
+
+    // Where the secondary strips render (strip_worker.h) -----
+    else if (strcmp(command_type, "strip_render") == 0) {
+      bool good = false;
+      if (strcmp(command_data, "parallel") == 0 || strcmp(command_data, "default") == 0) {
+        good = true;
+        strip_render_parallel = true;
+      } else if (strcmp(command_data, "serial") == 0) {
+        good = true;
+        strip_render_parallel = false;
+      } else {
+        bad_command(command_type, command_data);
+      }
+
+      if (good) {
+        tx_begin();
+        USBSerial.print("STRIP_RENDER: ");
+        USBSerial.print(strip_render_parallel ? "parallel" : "serial");
+        USBSerial.print(" (strips ");
+        USBSerial.print(strip_jobs_us);
+        USBSerial.print(" us, led_thread waited ");
+        USBSerial.print(strip_join_wait_us);
+        USBSerial.println(" us)");
+        tx_end();
+      }
+    }
+
+    // Which analysis stages run (analysis_demand.h) ---------
+    else if (strcmp(command_type, "analysis") == 0) {
+      bool good = false;
+      if (strcmp(command_data, "demand") == 0 || strcmp(command_data, "default") == 0) {
+        good = true;
+        analysis_on_demand = true;
+      } else if (strcmp(command_data, "full") == 0) {
+        good = true;
+        analysis_on_demand = false;
+      } else {
+        bad_command(command_type, command_data);
+      }
+
+      if (good) {
+        tx_begin();
+        USBSerial.print("ANALYSIS: ");
+        USBSerial.print(analysis_on_demand ? "demand" : "full");
+        USBSerial.print(" (inputs 0x");
+        USBSerial.print(analysis_demand, HEX);
+        USBSerial.print(", GDFT skipped on ");
+        USBSerial.print(analysis_gdft_skipped);
+        USBSerial.println(" audio frames)");
+        tx_end();
+      }
+    }
+
+    // Binary trace export (trace_stream_format.h) ----------
+    else if (strcmp(command_type, "trace_stream") == 0) {
+      bool good = false;
+      if (strcmp(command_data, "on") == 0) {
+        good = true;
+        set_trace_categories(TRACE_STREAM_CATEGORIES);
+        export_trace_buffer_serial();
+      } else if (strcmp(command_data, "off") == 0 || strcmp(command_data, "default") == 0) {
+        good = true;
+        enable_trace_output(false, false, false);
+        set_trace_categories(TRACE_DEFAULT_CATEGORIES);
+      } else {
+        bad_command(command_type, command_data);
+      }
+
+      if (good) {
+        tx_begin();
+        USBSerial.print("TRACE_STREAM: ");
+        USBSerial.print(g_trace_config.enable_serial ? "on" : "off");
+        USBSerial.print(" (");
+        USBSerial.print(g_trace_buffer.get_dropped_count());
+        USBSerial.println(" events dropped since boot)");
+        tx_end();
+      }
+    }
+
+    // Binary telemetry stream (telemetry_stream.h) ---------
+    else if (strcmp(command_type, "telemetry") == 0 || strcmp(command_type, "telemetry_budget") == 0) {
+      bool good = true;
+      if (strcmp(command_type, "telemetry_budget") == 0) {
+        if (strcmp(command_data, "default") == 0) {
+          telemetry_budget_kbps = DEFAULT_TELEMETRY_BUDGET_KBPS;
+        } else {
+          telemetry_budget_kbps = constrain(atol(command_data), MIN_TELEMETRY_BUDGET_KBPS, MAX_TELEMETRY_BUDGET_KBPS);
+        }
+      } else if (strcmp(command_data, "off") == 0 || strcmp(command_data, "default") == 0) {
+        set_telemetry_channels(0);
+      } else {
+        uint8_t channels;
+        good = parse_telemetry_channels(command_data, channels);
+        if (good) {
+          if (set_telemetry_channels(channels) == false) {
+            tx_begin(true);
+            USBSerial.println("TELEMETRY: couldn't allocate the stream buffers");
+            tx_end(true);
+            good = false;
+          }
+        } else {
+          bad_command(command_type, command_data);
+        }
+      }
+
+      if (good) {
+        uint8_t channels = telemetry_channels;
+        uint32_t estimate_kbps = telemetry_estimated_bytes_per_s(channels) / 1000;
+        tx_begin();
+        USBSerial.print("TELEMETRY: ");
+        if (channels == 0) {
+          USBSerial.print("off");
+        }
+        bool first = true;
+        for (uint8_t i = 0; i < TELEMETRY_NUM_CHANNELS; i++) {
+          if (channels & TELEMETRY_CHANNEL_BIT(i)) {
+            USBSerial.print(first ? "" : ",");
+            USBSerial.print(telemetry_channel_names[i]);
+            first = false;
+          }
+        }
+        USBSerial.print(" (~");
+        USBSerial.print(estimate_kbps);
+        USBSerial.print(" kB/s of a ");
+        USBSerial.print(telemetry_budget_kbps);
+        USBSerial.print(" kB/s budget, ");
+        USBSerial.print(telemetry_dropped_total());
+        USBSerial.println(" records dropped)");
+        if (estimate_kbps > telemetry_budget_kbps) {
+          USBSerial.println("TELEMETRY: over budget, records will be dropped");
+        }
+        tx_end();
+      }
+    }
+
+    // Session record / replay (session_record.h) -----------
+    else if (strcmp(command_type, "session") == 0) {
+      const char* error = NULL;
+      if (strcmp(command_data, "record") == 0) {
+        error = session_begin_recording();
+      } else if (strcmp(command_data, "replay") == 0) {
+        error = session_begin_replay();
+      } else if (strcmp(command_data, "send") == 0) {
+        error = session_begin_send();
+      } else if (strcmp(command_data, "stop") == 0) {
+        session_request_stop();
+      } else if (strcmp(command_data, "status") != 0) {
+        bad_command(command_type, command_data);
+        error = "";
+      }
+
+      if (error == NULL) {
+        static const char* const state_names[] = {"idle", "starting", "recording", "replaying", "stopping", "sending"};
+        tx_begin();
+        USBSerial.print("SESSION: ");
+        USBSerial.print(state_names[session_state]);
+        USBSerial.print(" (");
+        USBSerial.print(session_audio_frames);
+        USBSerial.print(" audio frames, ");
+        USBSerial.print(session_file_bytes);
+        USBSerial.print(" bytes, ");
+        USBSerial.print(session_dropped_total());
+        USBSerial.println(" records dropped)");
+        tx_end();
+      } else if (error[0] != 0) {
+        tx_begin(true);
+        USBSerial.print("SESSION: ");
+        USBSerial.println(error);
+        tx_end(true);
+      }
+    }
+
     // Set Mode Number ----------------------------------------
     else if (strcmp(command_type, "set_mode") == 0) {
       mode_transition_queued = true;
@@ -971,6 +1328,76 @@ void parse_command(char* command_buf) {
       reboot();
     }
 
+    // Set render resolution (saved, applied between LED frames)
+    else if (strcmp(command_type, "render_resolution") == 0) {
+      bool good = false;
+      uint16_t setting = DEFAULT_RENDER_RESOLUTION;
+      if (strcmp(command_data, "default") == 0) {
+        good = true;
+      } else if (strcmp(command_data, "led_count") == 0) {
+        setting = RENDER_FOLLOWS_LED_COUNT;
+        good = true;
+      } else {
+        long requested = atol(command_data);
+        if (requested >= MIN_RENDER_RESOLUTION && requested <= render_capacity) {
+          setting = requested;
+          good = true;
+        } else {
+          bad_command(command_type, command_data);
+        }
+      }
+
+      if (good) {
+        render_resolution_setting = setting;
+        save_render_resolution();
+        render_resolution_request = resolve_render_resolution(setting);
+        tx_begin();
+        USBSerial.print("RENDER_RESOLUTION: ");
+        USBSerial.println(render_resolution_request);
+        tx_end();
+      }
+    }
+
+    // Set LED frame rate (saved, frame_governor.h) -----
+    else if (strcmp(command_type, "led_frame_rate") == 0) {
+      bool good = false;
+      uint16_t setting = DEFAULT_LED_FRAME_RATE;
+      if (strcmp(command_data, "default") == 0) {
+        good = true;
+      } else if (strcmp(command_data, "max") == 0) {
+        setting = LED_FRAME_RATE_UNCAPPED;
+        good = true;
+      } else {
+        long requested = atol(command_data);
+        if (requested >= MIN_LED_FRAME_RATE && requested <= MAX_LED_FRAME_RATE) {
+          setting = requested;
+          good = true;
+        } else {
+          bad_command(command_type, command_data);
+        }
+      }
+
+      if (good) {
+        led_frame_rate_setting = setting;
+        save_led_frame_rate();
+        tx_begin();
+        USBSerial.print("LED_FRAME_RATE: ");
+        if (setting == LED_FRAME_RATE_UNCAPPED) {
+          USBSerial.print("max");
+        } else {
+          USBSerial.print(setting);
+        }
+        USBSerial.print(" (last frame: render ");
+        USBSerial.print(led_render_us);
+        USBSerial.print(" us, show ");
+        USBSerial.print(led_show_us);
+        USBSerial.print(" us; ");
+        USBSerial.print(led_frames_late);
+        USBSerial.println(" frames late)");
+        tx_end();
+      }
+    }
+
     // Set LED Interpolation ----------------------------
     else if (strcmp(command_type, "led_interpolation") == 0) {
       bool good = false;
@@ -1098,6 +1525,32 @@ void parse_command(char* command_buf) {
       reboot();
     }
 
+    // Set analysis hop (runtime only, not saved) -------
+    else if (strcmp(command_type, "hop_size") == 0) {
+      bool good = false;
+      uint16_t hop = CONFIG.SAMPLES_PER_CHUNK;
+      if (strcmp(command_data, "default") == 0) {
+        good = true;
+      } else {
+        long requested = atol(command_data);
+        // No larger than a chunk, which is what the smoothing rates were tuned for
+        if (requested >= AUDIO_HOP_MIN && requested <= CONFIG.SAMPLES_PER_CHUNK) {
+          good = true;
+          hop = requested;
+        } else {
+          bad_command(command_type, command_data);
+        }
+      }
+
+      if (good) {
+        audio_hop_request = hop;  // Applied by the audio task before its next frame
+        tx_begin();
+        USBSerial.print("AUDIO_HOP_SIZE: ");
+        USBSerial.println(hop);
+        tx_end();
+      }
+    }
+
     // Set Audio Sensitivity ----------------------------
     else if (strcmp(command_type, "sensitivity") == 0) {
       if (strcmp(command_data, "default") == 0) {
@@ -1374,6 +1827,51 @@ void parse_command(char* command_buf) {
       tx_end();
     }
 
+    // Set output gamma (saved, LUT rebuilt between LED frames) ----
+    else if (strcmp(command_type, "output_gamma") == 0) {
+      if (strcmp(command_data, "default") == 0) {
+        output_curve.gamma = DEFAULT_OUTPUT_GAMMA;
+      } else {
+        output_curve.gamma = constrain(atof(command_data), MIN_OUTPUT_GAMMA, MAX_OUTPUT_GAMMA);
+      }
+
+      save_output_curve();
+      output_curve_changed = true;
+      tx_begin();
+      USBSerial.print("OUTPUT_GAMMA: ");
+      USBSerial.println(output_curve.gamma);
+      tx_end();
+    }
+
+    // Set white balance (saved, LUT rebuilt between LED frames) ----
+    else if (strcmp(command_type, "white_balance") == 0) {
+      bool good = false;
+      float gain[3] = {1.0f, 1.0f, 1.0f};
+      if (strcmp(command_data, "default") == 0) {
+        good = true;
+      } else if (sscanf(command_data, "%f,%f,%f", &gain[0], &gain[1], &gain[2]) == 3) {
+        good = true;
+      } else {
+        bad_command(command_type, command_data);
+      }
+
+      if (good) {
+        for (uint8_t c = 0; c < 3; c++) {
+          output_curve.gain[c] = constrain(gain[c], 0.0f, 1.0f);
+        }
+        save_output_curve();
+        output_curve_changed = true;
+        tx_begin();
+        USBSerial.print("WHITE_BALANCE: ");
+        USBSerial.print(output_curve.gain[0]);
+        USBSerial.print(",");
+        USBSerial.print(output_curve.gain[1]);
+        USBSerial.print(",");
+        USBSerial.println(output_curve.gain[2]);
+        tx_end();
+      }
+    }
+
     // Toggle Incandescent Mode ----------------------------
     else if (strcmp(command_type, "incandescent_mode") == 0) {
       bool good = false;
@@ -1799,6 +2297,9 @@ void check_serial(uint32_t t_now) {
       command_buf[command_buf_index] = '\0';  // Null terminate at the trimmed position
 
       // the command in the buffer should be parsed
+      if (command_buf_index > 0) {
+        session_record_event(SESSION_EVENT_SERIAL, command_buf, command_buf_index);  // (session_record.h)
+      }
       parse_command(command_buf);                   // Parse
       memset(&command_buf, 0, sizeof(char) * 128);  // Clear
       command_buf_index = 0;                        // Reset
@@ -0,0 +1,843 @@
+#ifndef SESSION_RECORD_H
+#define SESSION_RECORD_H
+
+/*----------------------------------------
+  SESSION RECORD / REPLAY
+
+  session=record captures what the show depends on into /session.bin
+  (include/session_format.h), until session=stop or SESSION_MAX_BYTES:
+
+    record      produced by      per
+    START       audio task       session (CONFIG, noise profile, hop,
+                                 GDFT engine, analysis=, render width,
+                                 RNG seed, settings)
+    CONFIG      audio task       audio frame, when CONFIG changed
+    SETTINGS    audio task       audio frame, when a setting changed
+    AUDIO       audio task       audio frame (the raw I2S hop)
+    LED_FRAME   LED thread       LED frame (audio frame used, checksum)
+    EVENT       control task,    command line, HMI / button press,
+                P2P receive      P2P packet
+
+  CONFIG is compared against the last record at the top of every audio
+  frame, so every change (serial, HMI, P2P, the pipeline's own) lands
+  in the session at the frame boundary where replay applies it again.
+  The events are there to say why. The settings that change leds_out
+  from outside CONFIG (output curve, SECONDARY_*, led_frame_rate) are
+  packed into one image (session_get_settings()) and diffed the same
+  way.
+
+  As with telemetry, the real-time tasks only encode into their own
+  ring and move on; session_task (idle priority, Core 1) writes the
+  rings out to LittleFS. A full ring drops the record and counts it.
+
+  session=replay plays the file back through the same code: session_task
+  feeds START, CONFIG and AUDIO records to the audio task, which applies
+  them at the top of each frame and swaps the recorded hop in for the
+  microphone's in acquire_sample_chunk(). I2S still paces the frames.
+  CONFIG, the settings, the noise profile, hop, engine and analysis=
+  are put back afterwards.
+  The strip's own settings (LED type, count, color order, current
+  limit) and the sample rate stay the device's own.
+
+  On the host (sb_dsp_host --record / --replay) every frame runs in
+  order on the audio clock, so a replay is bit-exact: same spectrogram,
+  chromagram and leds_out. On the device, CONFIG changes land up to a
+  frame late, LED frames pair with audio frames as the two threads
+  happen to line up, and random_float() reads the hardware RNG, so a
+  replay is the same show rather than the same bits.
+
+  session=send streams the file over USB, framed like the telemetry
+  stream; sb_dsp_host --replay reads such a capture as-is.
+  ----------------------------------------*/
+
+#include <atomic>
+#include <new>
+#include "globals.h"
+#include "audio_frame.h"
+#include "session_format.h"
+
+#define SESSION_FILE_PATH "/session.bin"
+
+enum SessionState : uint8_t {
+  SESSION_IDLE = 0,
+  SESSION_ARMED,      // Recording from the audio task's next frame
+  SESSION_RECORDING,
+  SESSION_REPLAYING,
+  SESSION_STOPPING,   // session_task closes the file
+  SESSION_SENDING     // session=send
+};
+
+struct SessionRing {
+  std::atomic<uint32_t> head;  // Bytes written (free-running)
+  std::atomic<uint32_t> tail;  // Bytes taken
+  uint32_t size;               // Power of two
+  uint16_t max_data;
+  uint8_t* bytes;              // u16 length, then the record
+  uint8_t* payload;            // The record being built
+  uint8_t* frame;              // ... and framed
+};
+
+enum {
+  SESSION_AUDIO_PRODUCER = 0,
+  SESSION_LED_PRODUCER,
+  SESSION_CONTROL_PRODUCER,
+  SESSION_P2P_PRODUCER,
+  SESSION_NUM_PRODUCERS
+};
+
+static SessionRing* session_rings[SESSION_NUM_PRODUCERS] = {NULL, NULL, NULL, NULL};
+static SessionRing* session_replay_ring = NULL;  // session_task -> audio task, COBS decoded
+static std::atomic<uint32_t> session_seq[SESSION_NUM_RECORD_TYPES];
+static std::atomic<uint32_t> session_dropped[SESSION_NUM_RECORD_TYPES];
+static volatile bool session_stop_requested = false;
+
+// Audio task
+static SensoryBridge::Config::conf session_config_last;  // CONFIG as of the last record
+static uint8_t session_settings_last[SESSION_SETTINGS_BYTES];  // The settings, likewise
+static uint32_t session_audio_seq_base = 0;  // audio_frame_seq at START
+static uint32_t session_frame_us = 0;
+static uint32_t session_audio_frames = 0;    // Recorded or replayed
+
+// Replay, audio task
+static int32_t session_replay_samples[1024];  // Size of AudioRawState's buffer
+static int16_t session_replay_count = -1;     // Waiting for acquire_sample_chunk(), -1 = none
+static std::atomic<bool> session_replay_eof(false);
+static uint32_t session_replay_underruns = 0;  // Frames the file couldn't keep up with (live audio)
+static uint32_t session_replay_lost = 0;       // Audio frames missing from the recording
+static uint32_t session_replay_next_seq = 0;
+static bool session_replay_saved = false;
+static SensoryBridge::Config::conf session_saved_config;
+static SQ15x16 session_saved_noise[NUM_FREQS];
+static bool session_saved_noise_complete;
+static uint8_t session_saved_gdft_engine;
+static bool session_saved_analysis_on_demand;
+static uint16_t session_saved_hop;
+static uint8_t session_saved_settings[SESSION_SETTINGS_BYTES];
+static uint8_t session_replay_settings[SESSION_SETTINGS_BYTES];  // As of the last START / SETTINGS
+
+static_assert(SESSION_START_BYTES + sizeof(CONFIG) + NUM_FREQS * 4 + 2 + SESSION_SETTINGS_BYTES <= SESSION_MAX_DATA,
+              "START doesn't fit a record");
+static_assert(sizeof(CONFIG) + 3 <= SESSION_MAX_DATA, "A whole-CONFIG change doesn't fit a record");
+
+inline SessionRing* session_ring_create(uint32_t size, uint16_t max_data) {
+  SessionRing* ring = new (std::nothrow) SessionRing();
+  if (ring == NULL) {
+    return NULL;
+  }
+  ring->size = size;
+  ring->max_data = max_data;
+  ring->bytes = new (std::nothrow) uint8_t[size];
+  ring->payload = new (std::nothrow) uint8_t[SESSION_HEADER_BYTES + max_data + 2];
+  ring->frame = new (std::nothrow) uint8_t[SESSION_FRAME_BYTES(SESSION_HEADER_BYTES + max_data + 2)];
+  if (ring->bytes == NULL || ring->payload == NULL || ring->frame == NULL) {
+    delete[] ring->bytes;
+    delete[] ring->payload;
+    delete[] ring->frame;
+    delete ring;
+    return NULL;
+  }
+  return ring;
+}
+
+inline void session_ring_clear(SessionRing& ring) {
+  ring.head.store(0);
+  ring.tail.store(0);
+}
+
+// Queue one record; false if it doesn't fit
+inline bool session_ring_push(SessionRing& ring, const uint8_t* data, size_t length) {
+  uint32_t head = ring.head.load(std::memory_order_relaxed);
+  uint32_t tail = ring.tail.load(std::memory_order_acquire);
+  if (head - tail + 2 + length > ring.size) {
+    return false;
+  }
+
+  const uint32_t mask = ring.size - 1;
+  ring.bytes[head & mask] = uint8_t(length);
+  ring.bytes[(head + 1) & mask] = uint8_t(length >> 8);
+  uint32_t start = (head + 2) & mask;
+  size_t first = ring.size - start;
+  if (first >= length) {
+    memcpy(ring.bytes + start, data, length);
+  } else {
+    memcpy(ring.bytes + start, data, first);
+    memcpy(ring.bytes, data + first, length - first);
+  }
+  ring.head.store(head + 2 + length, std::memory_order_release);
+  return true;
+}
+
+// Take the oldest record into out; returns its length, 0 if the ring is empty
+inline size_t session_ring_pop(SessionRing& ring, uint8_t* out, size_t out_size) {
+  uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+  if (tail == ring.head.load(std::memory_order_acquire)) {
+    return 0;
+  }
+  const uint32_t mask = ring.size - 1;
+  size_t length = ring.bytes[tail & mask] | (size_t(ring.bytes[(tail + 1) & mask]) << 8);
+  uint32_t start = (tail + 2) & mask;
+  size_t first = ring.size - start;
+  size_t copied = (length <= out_size) ? length : 0;  // Can't happen: every ring's records fit SESSION_MAX_FRAME
+  if (first >= copied) {
+    memcpy(out, ring.bytes + start, copied);
+  } else {
+    memcpy(out, ring.bytes + start, first);
+    memcpy(out + first, ring.bytes, copied - first);
+  }
+  ring.tail.store(tail + 2 + length, std::memory_order_release);
+  return copied;
+}
+
+// Seal, frame and queue the record built in ring.payload, or drop it
+inline void session_emit(SessionRing& ring, uint8_t type, uint32_t timestamp, size_t data_length) {
+  uint32_t seq = session_seq[type].fetch_add(1, std::memory_order_relaxed);
+  session_record_begin(ring.payload, type, seq, timestamp);
+  size_t length = session_record_seal(ring.payload, data_length);
+  length = session_record_frame(ring.payload, length, ring.frame);
+  if (!session_ring_push(ring, ring.frame, length)) {
+    session_dropped[type].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+inline uint32_t session_dropped_total() {
+  uint32_t dropped = 0;
+  for (uint8_t i = 0; i < SESSION_NUM_RECORD_TYPES; i++) {
+    dropped += session_dropped[i].load(std::memory_order_relaxed);
+  }
+  return dropped;
+}
+
+// Control task / host, while idle: allocate the rings (first time),
+// empty them and record from the audio task's next frame
+inline bool session_arm_recording() {
+  for (uint8_t i = 0; i < SESSION_NUM_PRODUCERS; i++) {
+    if (session_rings[i] == NULL) {
+      session_rings[i] = (i == SESSION_AUDIO_PRODUCER)
+                             ? session_ring_create(SESSION_AUDIO_RING_BYTES, SESSION_MAX_DATA)
+                             : session_ring_create(SESSION_RING_BYTES, SESSION_EVENT_MAX_DATA);
+      if (session_rings[i] == NULL) {
+        return false;
+      }
+    }
+    session_ring_clear(*session_rings[i]);
+  }
+  for (uint8_t i = 0; i < SESSION_NUM_RECORD_TYPES; i++) {
+    session_seq[i].store(0);
+    session_dropped[i].store(0);
+  }
+  session_audio_frames = 0;
+  session_stop_requested = false;
+  session_state = SESSION_ARMED;
+  return true;
+}
+
+// The settings outside CONFIG that change leds_out, as the image
+// START and SETTINGS carry (session_format.h)
+inline void session_get_settings(uint8_t* image) {
+  uint8_t* p = session_put_f32(image, output_curve.gamma);
+  for (uint8_t c = 0; c < 3; c++) {
+    p = session_put_f32(p, output_curve.gain[c]);
+  }
+  p = trace_stream_put_u16(p, led_frame_rate_setting);
+  *p++ = SECONDARY_LIGHTSHOW_MODE;
+  *p++ = SECONDARY_MIRROR_ENABLED;
+  p = session_put_f32(p, SECONDARY_PHOTONS);
+  p = session_put_f32(p, SECONDARY_CHROMA);
+  p = session_put_f32(p, SECONDARY_MOOD);
+  p = session_put_f32(p, SECONDARY_SATURATION);
+  *p++ = SECONDARY_PRISM_COUNT;
+  p = session_put_f32(p, SECONDARY_INCANDESCENT_FILTER);
+  *p++ = SECONDARY_BASE_COAT;
+  *p++ = SECONDARY_REVERSE_ORDER;
+  *p++ = SECONDARY_AUTO_COLOR_SHIFT;
+}
+
+inline void session_set_settings(const uint8_t* image) {
+  output_curve.gamma = session_get_f32(image);
+  for (uint8_t c = 0; c < 3; c++) {
+    output_curve.gain[c] = session_get_f32(image + 4 + c * 4);
+  }
+  output_curve_changed = true;  // The LED thread rebuilds output_lut[] between frames
+  led_frame_rate_setting = trace_stream_get_u16(image + 16);
+  SECONDARY_LIGHTSHOW_MODE = image[18];
+  SECONDARY_MIRROR_ENABLED = image[19] != 0;
+  SECONDARY_PHOTONS = session_get_f32(image + 20);
+  SECONDARY_CHROMA = session_get_f32(image + 24);
+  SECONDARY_MOOD = session_get_f32(image + 28);
+  SECONDARY_SATURATION = session_get_f32(image + 32);
+  SECONDARY_PRISM_COUNT = image[36];
+  SECONDARY_INCANDESCENT_FILTER = session_get_f32(image + 37);
+  SECONDARY_BASE_COAT = image[41] != 0;
+  SECONDARY_REVERSE_ORDER = image[42] != 0;
+  SECONDARY_AUTO_COLOR_SHIFT = image[43] != 0;
+}
+
+// Audio task: the snapshot everything after it is relative to
+inline void session_write_start(uint32_t t_now_us) {
+  SessionRing& ring = *session_rings[SESSION_AUDIO_PRODUCER];
+  uint32_t seed = esp_random() | 1;  // Arduino's randomSeed() ignores 0
+  randomSeed(seed);
+
+  uint8_t* data = ring.payload + SESSION_HEADER_BYTES;
+  uint8_t* p = trace_stream_put_u32(data, FIRMWARE_VERSION);
+  p = trace_stream_put_u32(p, seed);
+  p = trace_stream_put_u16(p, audio_hop_size);
+  *p++ = gdft_engine;
+  *p++ = noise_complete ? 1 : 0;
+  *p++ = analysis_on_demand ? 1 : 0;
+  *p++ = 0;
+  p = trace_stream_put_u16(p, render_resolution_setting);
+  p = trace_stream_put_u16(p, sizeof(CONFIG));
+  p = trace_stream_put_u16(p, NUM_FREQS);
+  memcpy(p, &CONFIG, sizeof(CONFIG));
+  p += sizeof(CONFIG);
+  for (uint16_t i = 0; i < NUM_FREQS; i++) {
+    p = trace_stream_put_u32(p, uint32_t(noise_samples[i].getInternal()));
+  }
+  p = trace_stream_put_u16(p, SESSION_SETTINGS_BYTES);
+  session_get_settings(p);
+  memcpy(session_settings_last, p, SESSION_SETTINGS_BYTES);
+  p += SESSION_SETTINGS_BYTES;
+
+  memcpy(&session_config_last, &CONFIG, sizeof(CONFIG));
+  session_audio_seq_base = audio_frame_seq;
+  session_emit(ring, SESSION_REC_START, t_now_us, p - data);
+}
+
+// Replay: CONFIG fields that belong to this device, not the recording
+inline void session_keep_device_config(const SensoryBridge::Config::conf& device) {
+  CONFIG.SAMPLE_RATE = device.SAMPLE_RATE;
+  CONFIG.LED_TYPE = device.LED_TYPE;
+  CONFIG.LED_COUNT = device.LED_COUNT;
+  CONFIG.LED_COLOR_ORDER = device.LED_COLOR_ORDER;
+  CONFIG.MAX_CURRENT_MA = device.MAX_CURRENT_MA;
+}
+
+// Audio task: put back what START overwrote, and hand the file back
+inline void session_replay_finish() {
+  if (session_replay_saved) {
+    memcpy(&CONFIG, &session_saved_config, sizeof(CONFIG));
+    memcpy(noise_samples, session_saved_noise, sizeof(noise_samples));
+    noise_complete = session_saved_noise_complete;
+    gdft_engine = session_saved_gdft_engine;
+    analysis_on_demand = session_saved_analysis_on_demand;
+    session_set_settings(session_saved_settings);
+    if (session_saved_hop != audio_hop_size) {
+      audio_hop_request = session_saved_hop;  // Applied at the top of the next frame
+    }
+    render_resolution_request = resolve_render_resolution(render_resolution_setting);
+    session_replay_saved = false;
+  }
+  session_replay_count = -1;
+  session_state = SESSION_STOPPING;
+}
+
+inline void session_replay_start(const SessionRecordInfo& info) {
+  SessionStartInfo start;
+  if (!session_parse_start(info, start) || start.config_bytes != sizeof(CONFIG) || start.num_freqs != NUM_FREQS ||
+      start.settings_bytes != SESSION_SETTINGS_BYTES) {
+    session_replay_finish();  // Checked before replay started; only a corrupt file gets here
+    return;
+  }
+  if (!session_replay_saved) {
+    memcpy(&session_saved_config, &CONFIG, sizeof(CONFIG));
+    memcpy(session_saved_noise, noise_samples, sizeof(noise_samples));
+    session_saved_noise_complete = noise_complete;
+    session_saved_gdft_engine = gdft_engine;
+    session_saved_analysis_on_demand = analysis_on_demand;
+    session_saved_hop = audio_hop_size;
+    session_get_settings(session_saved_settings);
+    session_replay_saved = true;
+  }
+
+  SensoryBridge::Config::conf device = CONFIG;
+  memcpy(&CONFIG, start.config, sizeof(CONFIG));
+  session_keep_device_config(device);
+  for (uint16_t i = 0; i < NUM_FREQS; i++) {
+    noise_samples[i] = SQ15x16::fromInternal(int32_t(trace_stream_get_u32(start.noise_samples + i * 4)));
+  }
+  noise_complete = start.noise_complete != 0;
+  memcpy(session_replay_settings, start.settings, SESSION_SETTINGS_BYTES);
+  session_set_settings(session_replay_settings);
+  gdft_engine = start.gdft_engine;
+  analysis_on_demand = start.analysis_on_demand != 0;
+  if (start.audio_hop_size != audio_hop_size) {
+    audio_hop_request = start.audio_hop_size;
+    apply_audio_hop_request();  // Between frames, as at the top of audio_thread()
+  }
+  render_resolution_request = resolve_render_resolution(start.render_resolution_setting);
+  randomSeed(start.random_seed);
+
+  session_audio_seq_base = audio_frame_seq;
+  session_replay_next_seq = 0;
+}
+
+// Audio task, replaying: apply records up to and including this
+// frame's AUDIO
+inline void session_replay_frame() {
+  static uint8_t payload[SESSION_MAX_PAYLOAD];
+  if (session_stop_requested) {
+    session_replay_finish();
+    return;
+  }
+
+  for (;;) {
+    bool eof = session_replay_eof.load(std::memory_order_acquire);  // Before the pop: the last push comes before it
+    size_t length = session_ring_pop(*session_replay_ring, payload, sizeof(payload));
+    if (length == 0) {
+      if (eof) {
+        session_replay_finish();
+      } else {
+        session_replay_underruns++;
+      }
+      return;
+    }
+
+    SessionRecordInfo info;
+    if (!session_record_parse(payload, length, info)) {
+      continue;
+    }
+    if (info.type == SESSION_REC_START) {
+      session_replay_start(info);
+    } else if (info.type == SESSION_REC_CONFIG) {
+      SensoryBridge::Config::conf device = CONFIG;
+      session_apply_config_diff(info, (uint8_t*)&CONFIG, sizeof(CONFIG));
+      session_keep_device_config(device);
+    } else if (info.type == SESSION_REC_SETTINGS) {
+      if (session_apply_config_diff(info, session_replay_settings, SESSION_SETTINGS_BYTES)) {
+        session_set_settings(session_replay_settings);
+      }
+    } else if (info.type == SESSION_REC_AUDIO) {
+      session_replay_count = session_get_audio(info, session_replay_samples, 1024);
+      session_replay_lost += info.seq - session_replay_next_seq;
+      session_replay_next_seq = info.seq + 1;
+      session_audio_frames++;
+      return;
+    } else if (info.type == SESSION_REC_END) {
+      session_replay_finish();
+      return;
+    }
+  }
+}
+
+// Audio task, at the top of run_audio_frame()
+inline void session_audio_frame_begin(uint32_t t_now_us) {
+  uint8_t state = session_state;
+  if (state == SESSION_IDLE) {
+    return;
+  }
+  session_frame_us = t_now_us;
+
+  if (state == SESSION_ARMED || state == SESSION_RECORDING) {
+    if (session_stop_requested) {
+      session_state = SESSION_STOPPING;
+    } else if (state == SESSION_ARMED) {
+      session_write_start(t_now_us);
+      session_state = SESSION_RECORDING;
+    } else {
+      SessionRing& ring = *session_rings[SESSION_AUDIO_PRODUCER];
+      uint8_t* data = ring.payload + SESSION_HEADER_BYTES;
+      uint8_t* p = session_put_config_diff(data, (const uint8_t*)&CONFIG, (uint8_t*)&session_config_last, sizeof(CONFIG));
+      if (p != data) {
+        session_emit(ring, SESSION_REC_CONFIG, t_now_us, p - data);
+      }
+
+      uint8_t settings[SESSION_SETTINGS_BYTES];
+      session_get_settings(settings);
+      p = session_put_config_diff(data, settings, session_settings_last, SESSION_SETTINGS_BYTES);
+      if (p != data) {
+        session_emit(ring, SESSION_REC_SETTINGS, t_now_us, p - data);
+      }
+    }
+  } else if (state == SESSION_REPLAYING) {
+    session_replay_frame();
+  }
+}
+
+// acquire_sample_chunk(), once the hop is read: record it, or swap in
+// the replayed one
+void session_audio_samples(int32_t* raw, uint16_t count) {
+  uint8_t state = session_state;
+  if (state == SESSION_RECORDING) {
+    SessionRing& ring = *session_rings[SESSION_AUDIO_PRODUCER];
+    uint8_t* data = ring.payload + SESSION_HEADER_BYTES;
+    uint8_t* p = session_put_audio(data, raw, count);
+    session_emit(ring, SESSION_REC_AUDIO, session_frame_us, p - data);
+    session_audio_frames++;
+  } else if (state == SESSION_REPLAYING && session_replay_count >= 0) {
+    uint16_t replayed = (uint16_t(session_replay_count) < count) ? session_replay_count : count;
+    memcpy(raw, session_replay_samples, replayed * sizeof(int32_t));
+    memset(raw + replayed, 0, (count - replayed) * sizeof(int32_t));
+    session_replay_count = -1;
+  }
+}
+
+// LED thread, once the frame is shown
+inline void session_led_frame() {
+  if (session_state != SESSION_RECORDING || leds_out == NULL) {
+    return;
+  }
+  SessionRing& ring = *session_rings[SESSION_LED_PRODUCER];
+  uint32_t audio_frame = led_audio->seq - session_audio_seq_base;
+  if (int32_t(audio_frame) < 0) {
+    audio_frame = 0;  // Rendered from a frame before START
+  }
+  uint8_t* data = ring.payload + SESSION_HEADER_BYTES;
+  uint8_t* p = trace_stream_put_u32(data, audio_frame);
+  p = trace_stream_put_u16(p, CONFIG.LED_COUNT);
+  p = trace_stream_put_u32(p, session_fnv1a(SESSION_FNV1A_BASIS, leds_out, sizeof(CRGB) * CONFIG.LED_COUNT));
+  session_emit(ring, SESSION_REC_LED_FRAME, micros(), p - data);
+}
+
+// Control task (serial, HMI, buttons) or P2P receive
+inline void session_record_event(uint8_t source, const void* event, size_t length) {
+  if (session_state != SESSION_RECORDING) {
+    return;
+  }
+  SessionRing* ring = session_rings[(source == SESSION_EVENT_P2P) ? SESSION_P2P_PRODUCER : SESSION_CONTROL_PRODUCER];
+  if (length + 1 > ring->max_data) {  // Source byte, then the event
+    length = ring->max_data - 1;
+  }
+  uint8_t* data = ring->payload + SESSION_HEADER_BYTES;
+  data[0] = source;
+  memcpy(data + 1, event, length);
+  session_emit(*ring, SESSION_REC_EVENT, micros(), 1 + length);
+}
+
+// Called from hmi/dual_encoder_controller.cpp
+void session_record_hmi_event(uint8_t encoder, uint8_t click, int32_t rotation) {
+  uint8_t event[6] = {encoder, click};
+  trace_stream_put_u32(event + 2, uint32_t(rotation));
+  session_record_event(SESSION_EVENT_HMI, event, sizeof(event));
+}
+
+typedef void (*SessionWrite)(const uint8_t* data, size_t length);
+
+// Hand every queued record to write(), producers in turn. Returns the
+// bytes written
+inline uint32_t drain_session(SessionWrite write) {
+  static uint8_t frame[SESSION_MAX_FRAME];
+  uint32_t written = 0;
+  bool more = true;
+  while (more) {
+    more = false;
+    for (uint8_t i = 0; i < SESSION_NUM_PRODUCERS; i++) {
+      if (session_rings[i] != NULL) {
+        size_t length = session_ring_pop(*session_rings[i], frame, sizeof(frame));
+        if (length > 0) {
+          write(frame, length);
+          written += length;
+          more = true;
+        }
+      }
+    }
+  }
+  return written;
+}
+
+// Once no producer can add to the rings (SESSION_STOPPING): write what's
+// left and the END record. Returns the bytes written
+inline uint32_t finish_session_recording(SessionWrite write, uint32_t timestamp) {
+  uint32_t written = drain_session(write);
+
+  uint8_t payload[SESSION_HEADER_BYTES + SESSION_NUM_RECORD_TYPES * 4 + 2];
+  uint8_t frame[SESSION_FRAME_BYTES(sizeof(payload))];
+  session_record_begin(payload, SESSION_REC_END, session_seq[SESSION_REC_END]++, timestamp);
+  uint8_t* p = payload + SESSION_HEADER_BYTES;
+  for (uint8_t i = 0; i < SESSION_NUM_RECORD_TYPES; i++) {
+    p = trace_stream_put_u32(p, session_dropped[i].load(std::memory_order_relaxed));
+  }
+  size_t length = session_record_seal(payload, p - (payload + SESSION_HEADER_BYTES));
+  length = session_record_frame(payload, length, frame);
+  write(frame, length);
+  return written + length;
+}
+
+// Control task / host, while idle: replay records passed to
+// session_replay_push() from the audio task's next frame
+inline bool session_arm_replay() {
+  if (session_replay_ring == NULL) {
+    session_replay_ring = session_ring_create(SESSION_AUDIO_RING_BYTES, SESSION_MAX_DATA);
+    if (session_replay_ring == NULL) {
+      return false;
+    }
+  }
+  session_ring_clear(*session_replay_ring);
+  session_replay_eof.store(false);
+  session_replay_count = -1;
+  session_replay_underruns = 0;
+  session_replay_lost = 0;
+  session_audio_frames = 0;
+  session_stop_requested = false;
+  session_state = SESSION_REPLAYING;
+  return true;
+}
+
+// A decoded START, CONFIG, AUDIO or END payload; false if the ring is full
+inline bool session_replay_push(const uint8_t* payload, size_t length) {
+  return session_ring_push(*session_replay_ring, payload, length);
+}
+
+// session=stop: the audio task ends a recording or replay at its next frame
+inline void session_request_stop() {
+  session_stop_requested = true;
+}
+
+// Device side: the file, and session_task ----------------------------------
+
+// Reads records out of a session file, skipping whatever isn't one
+// (menu text around a session=send capture, other streams)
+struct SessionFileReader {
+  uint8_t block[256];
+  size_t block_length;
+  size_t block_position;
+  uint8_t chunk[SESSION_MAX_FRAME];  // COBS bytes between two 0x00
+  size_t chunk_length;
+  uint8_t payload[SESSION_MAX_PAYLOAD];
+  size_t payload_length;             // Record read but not yet passed on, 0 = none
+};
+
+static File session_file;
+static SessionFileReader* session_reader = NULL;
+static uint8_t session_file_mode = SESSION_IDLE;  // RECORDING, REPLAYING or SENDING
+static uint32_t session_file_bytes = 0;
+static uint32_t session_file_limit = 0;
+
+inline void session_reader_reset(SessionFileReader& reader) {
+  reader.block_length = 0;
+  reader.block_position = 0;
+  reader.chunk_length = 0;
+  reader.payload_length = 0;
+}
+
+// Next record into reader.payload (its COBS bytes in reader.chunk);
+// false at the end of the file
+inline bool session_read_record(SessionFileReader& reader, SessionRecordInfo& info) {
+  for (;;) {
+    if (reader.block_position == reader.block_length) {
+      reader.block_length = session_file.read(reader.block, sizeof(reader.block));
+      reader.block_position = 0;
+      if (reader.block_length == 0) {
+        return false;
+      }
+    }
+    uint8_t byte = reader.block[reader.block_position++];
+    if (byte != 0) {
+      if (reader.chunk_length < sizeof(reader.chunk)) {
+        reader.chunk[reader.chunk_length] = byte;
+      }
+      reader.chunk_length++;  // Past sizeof(chunk): not a record, skipped at its end
+      continue;
+    }
+    if (reader.chunk_length == 0 || reader.chunk_length > sizeof(reader.chunk)) {
+      reader.chunk_length = 0;
+      continue;
+    }
+    size_t length = cobs_decode(reader.chunk, reader.chunk_length, reader.payload, sizeof(reader.payload));
+    if (length > 0 && session_record_parse(reader.payload, length, info)) {
+      reader.payload_length = length;
+      return true;  // chunk_length is reset on the next call
+    }
+    reader.chunk_length = 0;
+  }
+}
+
+static void write_session_file(const uint8_t* data, size_t length) {
+  session_file.write(data, length);
+  session_file_bytes += length;
+}
+
+// session=record. NULL, or why it can't
+inline const char* session_begin_recording() {
+  if (session_state != SESSION_IDLE) {
+    return "busy, session=stop first";
+  }
+  LittleFS.remove(SESSION_FILE_PATH);
+  size_t free_bytes = LittleFS.totalBytes() - LittleFS.usedBytes();
+  if (free_bytes < SESSION_FS_RESERVE_BYTES + SESSION_AUDIO_RING_BYTES) {
+    return "not enough flash free";
+  }
+  session_file_limit = free_bytes - SESSION_FS_RESERVE_BYTES;
+  if (session_file_limit > SESSION_MAX_BYTES) {
+    session_file_limit = SESSION_MAX_BYTES;
+  }
+  session_file = LittleFS.open(SESSION_FILE_PATH, FILE_WRITE);
+  if (!session_file) {
+    return "couldn't create " SESSION_FILE_PATH;
+  }
+  session_file_bytes = 0;
+  session_file_mode = SESSION_RECORDING;
+  if (!session_arm_recording()) {
+    session_file.close();
+    return "couldn't allocate the buffers";
+  }
+  return NULL;
+}
+
+// Opens the file and finds its START; NULL, or why it can't
+inline const char* session_open_file(SessionRecordInfo& start_info) {
+  if (session_state != SESSION_IDLE) {
+    return "busy, session=stop first";
+  }
+  if (session_reader == NULL) {
+    session_reader = new SessionFileReader();
+    if (session_reader == NULL) {
+      return "couldn't allocate the buffers";
+    }
+  }
+  session_file = LittleFS.open(SESSION_FILE_PATH, FILE_READ);
+  if (!session_file) {
+    return "nothing recorded (" SESSION_FILE_PATH ")";
+  }
+  session_reader_reset(*session_reader);
+  while (session_read_record(*session_reader, start_info)) {
+    if (start_info.type == SESSION_REC_START) {
+      return NULL;
+    }
+  }
+  session_file.close();
+  return "no START record in " SESSION_FILE_PATH;
+}
+
+// session=replay. NULL, or why it can't
+inline const char* session_begin_replay() {
+  SessionRecordInfo info;
+  const char* error = session_open_file(info);
+  if (error != NULL) {
+    return error;
+  }
+  SessionStartInfo start;
+  SensoryBridge::Config::conf recorded;
+  if (!session_parse_start(info, start) || start.config_bytes != sizeof(CONFIG) || start.num_freqs != NUM_FREQS ||
+      start.settings_bytes != SESSION_SETTINGS_BYTES) {
+    error = "recorded by a firmware with a different CONFIG layout";
+  } else if (start.audio_hop_size < 8 || start.audio_hop_size > 1024) {
+    error = "recorded hop size out of range";
+  } else {
+    memcpy(&recorded, start.config, sizeof(recorded));
+    if (recorded.SAMPLE_RATE != CONFIG.SAMPLE_RATE) {
+      error = "recorded at a different sample rate";
+    }
+  }
+  if (error == NULL && !session_arm_replay()) {
+    error = "couldn't allocate the buffers";
+  }
+  if (error != NULL) {
+    session_file.close();
+    return error;
+  }
+  session_file_mode = SESSION_REPLAYING;
+  session_replay_push(session_reader->payload, session_reader->payload_length);
+  session_reader->payload_length = 0;
+  return NULL;
+}
+
+// session=send. NULL, or why it can't
+inline const char* session_begin_send() {
+  SessionRecordInfo info;
+  const char* error = session_open_file(info);
+  if (error != NULL) {
+    return error;
+  }
+  session_file.seek(0);
+  session_reader_reset(*session_reader);
+  session_file_bytes = 0;
+  session_stop_requested = false;
+  session_file_mode = SESSION_SENDING;
+  session_state = SESSION_SENDING;
+  return NULL;
+}
+
+// session_task: keep the replay ring topped up from the file
+inline void session_fill_replay() {
+  SessionFileReader& reader = *session_reader;
+  for (;;) {
+    if (reader.payload_length == 0) {
+      SessionRecordInfo info;
+      if (!session_read_record(reader, info)) {
+        session_replay_eof.store(true, std::memory_order_release);
+        return;
+      }
+      if (info.type == SESSION_REC_LED_FRAME || info.type == SESSION_REC_EVENT) {
+        reader.payload_length = 0;  // Not replayed on the device
+        continue;
+      }
+    }
+    if (!session_replay_push(reader.payload, reader.payload_length)) {
+      return;  // Full: the rest next time
+    }
+    reader.payload_length = 0;
+  }
+}
+
+// session_task: send a few records over USB, whole frames under the
+// mutex so other streams' frames can't land inside them. True when done
+inline bool session_send_some() {
+  SessionFileReader& reader = *session_reader;
+  for (uint8_t i = 0; i < 8; i++) {
+    SessionRecordInfo info;
+    if (session_stop_requested || !session_read_record(reader, info)) {
+      return true;
+    }
+    if (serial_mutex != NULL) {
+      xSemaphoreTake(serial_mutex, portMAX_DELAY);
+    }
+    USBSerial.write(uint8_t(0));
+    USBSerial.write(reader.chunk, reader.chunk_length);
+    USBSerial.write(uint8_t(0));
+    if (serial_mutex != NULL) {
+      xSemaphoreGive(serial_mutex);
+    }
+    session_file_bytes += reader.chunk_length + 2;
+    reader.payload_length = 0;
+  }
+  return false;
+}
+
+inline void session_report(const char* format, uint32_t a, uint32_t b, uint32_t c) {
+  if (serial_mutex != NULL) {
+    xSemaphoreTake(serial_mutex, portMAX_DELAY);
+  }
+  USBSerial.printf(format, (unsigned long)a, (unsigned long)b, (unsigned long)c);
+  if (serial_mutex != NULL) {
+    xSemaphoreGive(serial_mutex);
+  }
+}
+
+// Created in setup() next to telemetry_task
+inline void session_task(void* /*param*/) {
+  for (;;) {
+    uint8_t state = session_state;
+    if (state == SESSION_ARMED || state == SESSION_RECORDING) {
+      drain_session(write_session_file);
+      if (session_file_bytes >= session_file_limit) {
+        session_request_stop();
+      }
+    } else if (state == SESSION_REPLAYING) {
+      session_fill_replay();
+    } else if (state == SESSION_SENDING) {
+      if (session_send_some()) {
+        session_file.close();
+        session_state = SESSION_IDLE;
+        session_report("SESSION: sent %lu bytes\n", session_file_bytes, 0, 0);
+      }
+    } else if (state == SESSION_STOPPING) {
+      if (session_file_mode == SESSION_RECORDING) {
+        vTaskDelay(2);  // Let a record another task is writing land first
+        finish_session_recording(write_session_file, micros());
+        session_file.close();
+        session_report("SESSION: recorded %lu audio frames, %lu bytes to " SESSION_FILE_PATH ", %lu records dropped\n",
+                       session_audio_frames, session_file_bytes, session_dropped_total());
+      } else {
+        session_file.close();
+        session_report("SESSION: replayed %lu audio frames (%lu late from flash, %lu lost in the recording)\n",
+                       session_audio_frames, session_replay_underruns, session_replay_lost);
+      }
+      session_file_mode = SESSION_IDLE;
+      session_state = SESSION_IDLE;
+    }
+    vTaskDelay(1);
+  }
+}
+
+#endif // SESSION_RECORD_H
@@ -0,0 +1,108 @@
+#ifndef STRIP_WORKER_H
+#define STRIP_WORKER_H
+
+/*----------------------------------------
+  STRIP WORKER
+
+  Every strip but the primary renders on Core 0, in
+  strip_worker_thread(), while led_thread renders and post-processes
+  the primary on Core 1. Both finish before the one FastLED.show():
+
+    led_thread (Core 1)               strip_worker (Core 0)
+    audio frame, smoothing
+    queue_strip_job(), start -------> render_strip() + show(), per job
+    primary render, publish_frame(),
+    show_leds() post-processing
+    finish_strip_jobs() <------------ done
+    FastLED.show()
+
+  A job only writes its own RenderContext (render_context.h) and its
+  strip's output buffers. Everything it reads from outside (led_audio,
+  the smoothed spectrogram and chromagram, the output curve) is settled
+  before start_strip_jobs() and isn't written again until
+  finish_strip_jobs() returns. The audio task outranks the worker on
+  Core 0, so a slow strip costs LED frame time, never audio.
+
+  strip_render=serial (serial menu) runs the jobs on led_thread
+  instead, at the join, for comparison.
+  ----------------------------------------*/
+
+#include "globals.h"
+#include "render_context.h"
+#include "led_utilities.h"
+#include "lightshow_modes.h"
+
+// A strip from the shared audio analysis to its clipped render buffer:
+// what led_thread does for the primary, minus the UI and bulb cover
+inline void render_strip(RenderContext& ctx) {
+  update_render_color_shift(ctx, led_audio);
+  render_light_mode(ctx);
+
+  if (ctx.prism_count > 0) {
+    apply_prism_effect(ctx, ctx.prism_count, 0.25);
+  }
+
+  clip_led_values(ctx.leds);
+}
+
+inline void run_strip_jobs() {
+  uint32_t t_start_us = micros();
+  for (uint8_t i = 0; i < strip_job_count; i++) {
+    render_strip(*strip_jobs[i].ctx);
+    strip_jobs[i].show();
+  }
+  strip_jobs_us = micros() - t_start_us;
+}
+
+inline void strip_worker_thread(void* /*param*/) {
+  while (true) {
+    xSemaphoreTake(strip_jobs_go, portMAX_DELAY);
+    run_strip_jobs();
+    xSemaphoreGive(strip_jobs_done);
+  }
+}
+
+// Once at boot, before the LED thread starts. Above the control task,
+// below audio
+inline void init_strip_worker() {
+  strip_jobs_go = xSemaphoreCreateBinary();
+  strip_jobs_done = xSemaphoreCreateBinary();
+  xTaskCreatePinnedToCore(strip_worker_thread, "strip_worker", 8192, NULL, tskIDLE_PRIORITY + 2, &strip_worker_task, 0);
+}
+
+// led_thread, each frame once led_audio and the smoothing are done:
+// queue every strip but the primary...
+inline void queue_strip_job(RenderContext& ctx, void (*show)()) {
+  if (strip_job_count < MAX_STRIP_JOBS) {
+    strip_jobs[strip_job_count] = {&ctx, show};
+    strip_job_count++;
+  }
+}
+
+// ...then hand them to the worker and go render the primary
+inline void start_strip_jobs() {
+  if (strip_job_count > 0 && strip_render_parallel && strip_worker_task != NULL) {
+    strip_jobs_started = true;
+    xSemaphoreGive(strip_jobs_go);
+  }
+}
+
+// show_leds(), before FastLED.show(): wait for the worker, or run the
+// jobs here if they weren't handed over. Not inline: led_utilities.h
+// declares it for show_leds(), and other translation units include that
+void finish_strip_jobs() {
+  uint32_t t_start_us = micros();
+  if (strip_jobs_started) {
+    xSemaphoreTake(strip_jobs_done, portMAX_DELAY);
+    strip_jobs_started = false;
+  } else if (strip_job_count > 0) {
+    run_strip_jobs();
+  }
+
+  if (strip_job_count > 0) {
+    strip_join_wait_us = micros() - t_start_us;
+  }
+  strip_job_count = 0;
+}
+
+#endif // STRIP_WORKER_H
@@ -114,7 +114,7 @@ void enable_usb_update_mode() {
 
   MASTER_BRIGHTNESS = 1.0;
 
-  uint8_t led_index = 0;
+  uint16_t led_index = 0;
   uint8_t sweet_index = 0;
 
   const uint8_t sweet_order[3][3] = {
@@ -124,7 +124,7 @@ void enable_usb_update_mode() {
   };
 
   while (true) {
-    for (uint8_t i = 0; i < NATIVE_RESOLUTION; i++) {
+    for (uint16_t i = 0; i < NATIVE_RESOLUTION; i++) {
       leds_16[i] = {0, 0, 0};
     }
 
@@ -332,12 +332,7 @@ void debug_function_timing(uint32_t t_now) {
   }
 }
 
-void set_mode_name(uint16_t index, const char* mode_name) {
-  uint8_t len = strlen(mode_name);
-  for (uint8_t i = 0; i < len; i++) {
-    mode_names[32 * index + i] = mode_name[i];
-  }
-}
+inline void init_light_mode_names();  // lightshow_modes.h
 
 void init_system() {
   // SINGLE-CORE OPTIMIZATION: Mutex creation removed
@@ -376,14 +371,7 @@ void init_system() {
 
   memcpy(&CONFIG_DEFAULTS, &CONFIG, sizeof(CONFIG)); // Copy defaults values to second CONFIG object
 
-  set_mode_name(0, "GDFT");
-  set_mode_name(1, "CHROMAGRAM");
-  set_mode_name(2, "CHROMAGRAM DOTS");
-  set_mode_name(3, "BLOOM");
-  set_mode_name(4, "VU DOT");
-  set_mode_name(5, "KALEIDOSCOPE");
-  set_mode_name(6, "QUANTUM COLLAPSE");
-  set_mode_name(7, "WAVEFORM");
+  init_light_mode_names();  // From the mode registry (lightshow_modes.h)
 
   init_usb();  // Initialize USB first for ESP32-S3
   init_serial(SERIAL_BAUD);
@@ -393,6 +381,7 @@ void init_system() {
   #endif
   
   init_fs();
+  init_audio_frames();  // After the noise calibration is loaded (audio_frame.h)
 
   #ifndef ARDUINO_ESP32S3_DEV
   // NOISE and MODE held down on boot (S2 only - S3 has no physical buttons)
@@ -417,10 +406,18 @@ void init_system() {
   #endif
 
   init_i2s();
+  set_audio_hop(CONFIG.SAMPLES_PER_CHUNK);  // Before the GDFT engines size themselves by it
   init_p2p();
   generate_a_weights();
   generate_window_lookup();
   precompute_goertzel_constants();
+  init_gdft_sliding();
+#ifdef ENABLE_GDFT_SIMD
+  init_gdft_simd();
+#endif
+#ifdef GDFT_POWER_DOMAIN
+  init_power_compression_lut();
+#endif
 
   // PALETTE SYSTEM INITIALIZATION: Convert FastLED gradients to CRGB16 LUTs
   // This initializes all 33 LED-calibrated palettes from your curated collection
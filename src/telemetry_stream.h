@@ -0,0 +1,312 @@
+#ifndef TELEMETRY_STREAM_H
+#define TELEMETRY_STREAM_H
+
+/*----------------------------------------
+  TELEMETRY STREAM
+
+  telemetry=pcm,spectrogram,... streams the selected channels as binary
+  records (include/telemetry_stream_format.h) for host/sb_telemetry_record
+  to write to disk:
+
+    channel       produced by      per
+    pcm           audio task       audio frame (this hop's samples)
+    spectrogram   audio task       audio frame
+    novelty       audio task       audio frame (novelty, VU, VU average)
+    chromagram    LED thread       LED frame
+    leds          LED thread       LED frame (leds_out, as shown)
+    perf          LED thread       LED frame (frame rates and counters)
+
+  Neither real-time task touches USB: each encodes its records into
+  its own ring (a producer) and moves on. telemetry_task, at idle
+  priority on Core 1, writes them out no faster than
+  telemetry_budget_kbps. When a ring is full the record is dropped
+  and counted; its channel's seq still advances, so the recorder sees
+  the gap.
+
+  Rings are allocated the first time telemetry is switched on and kept.
+  The stream=[type] text streams are separate and unchanged.
+  ----------------------------------------*/
+
+#include <new>
+#include "globals.h"
+#include "audio_frame.h"
+#include "telemetry_stream_format.h"
+
+struct TelemetryProducer {
+  std::atomic<uint32_t> head;   // Bytes written (free-running)
+  std::atomic<uint32_t> tail;   // Bytes sent
+  uint32_t dropped;             // Records that didn't fit
+  uint8_t ring[TELEMETRY_RING_BYTES];  // u16 length, then the framed record
+  uint8_t payload[TELEMETRY_MAX_PAYLOAD];
+  uint8_t frame[TELEMETRY_MAX_FRAME];
+};
+
+enum { TELEMETRY_AUDIO_PRODUCER = 0, TELEMETRY_LED_PRODUCER, TELEMETRY_NUM_PRODUCERS };
+
+static TelemetryProducer* telemetry_producers[TELEMETRY_NUM_PRODUCERS] = {NULL, NULL};
+static uint32_t telemetry_seq[TELEMETRY_NUM_CHANNELS] = {0};
+
+typedef void (*TelemetryWrite)(const uint8_t* frame, size_t length);
+
+inline uint32_t telemetry_dropped_total() {
+  uint32_t dropped = 0;
+  for (uint8_t i = 0; i < TELEMETRY_NUM_PRODUCERS; i++) {
+    if (telemetry_producers[i] != NULL) {
+      dropped += telemetry_producers[i]->dropped;
+    }
+  }
+  return dropped;
+}
+
+// Serial menu: allocate the rings (first time) and select channels.
+// False if the rings couldn't be allocated
+inline bool set_telemetry_channels(uint8_t channels) {
+  if (channels != 0) {
+    for (uint8_t i = 0; i < TELEMETRY_NUM_PRODUCERS; i++) {
+      if (telemetry_producers[i] == NULL) {
+        telemetry_producers[i] = new (std::nothrow) TelemetryProducer();
+        if (telemetry_producers[i] == NULL) {
+          telemetry_channels = 0;
+          return false;
+        }
+      }
+    }
+  }
+  telemetry_channels = channels;
+  return true;
+}
+
+// "pcm,leds" / "all" -> channel mask; false on an unknown name
+inline bool parse_telemetry_channels(const char* list, uint8_t& channels) {
+  if (strcmp(list, "all") == 0) {
+    channels = TELEMETRY_ALL_CHANNELS;
+    return true;
+  }
+  channels = 0;
+  const char* p = list;
+  while (*p != '\0') {
+    const char* end = strchr(p, ',');
+    size_t length = (end != NULL) ? size_t(end - p) : strlen(p);
+    int8_t channel = telemetry_channel_from_name(p, length);
+    if (channel < 0) {
+      return false;
+    }
+    channels |= TELEMETRY_CHANNEL_BIT(channel);
+    p += length;
+    if (*p == ',') {
+      p++;
+    }
+  }
+  return channels != 0;
+}
+
+// Wire bytes per second for a channel mask at the current frame rates,
+// framing and ring length included
+inline uint32_t telemetry_estimated_bytes_per_s(uint8_t channels) {
+  const uint32_t overhead = TELEMETRY_STREAM_HEADER_BYTES + 2 + 2 + 2;  // + CRC, delimiters, COBS
+  float audio_bytes = 0.0;
+  float led_bytes = 0.0;
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_PCM)) {
+    audio_bytes += overhead + audio_hop_size * 2;
+  }
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_SPECTROGRAM)) {
+    audio_bytes += overhead + NUM_FREQS * 4;
+  }
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_NOVELTY)) {
+    audio_bytes += overhead + 3 * 4;
+  }
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_CHROMAGRAM)) {
+    led_bytes += overhead + 12 * 4;
+  }
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_LEDS)) {
+    uint32_t chunks = (CONFIG.LED_COUNT + TELEMETRY_LED_CHUNK - 1) / TELEMETRY_LED_CHUNK;
+    led_bytes += chunks * (overhead + 4) + CONFIG.LED_COUNT * 3;
+  }
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_PERF)) {
+    led_bytes += overhead + TELEMETRY_PERF_FIELDS * 4;
+  }
+  return uint32_t(audio_bytes * SYSTEM_FPS + led_bytes * LED_FPS);
+}
+
+// Frame the record in producer.payload and queue it, or drop it
+inline void telemetry_emit(TelemetryProducer& producer, uint8_t channel, uint32_t seq,
+                           uint32_t timestamp, size_t data_length) {
+  telemetry_record_begin(producer.payload, channel, seq, timestamp);
+  size_t length = telemetry_record_finish(producer.payload, data_length, producer.frame);
+
+  uint32_t head = producer.head.load(std::memory_order_relaxed);
+  uint32_t tail = producer.tail.load(std::memory_order_acquire);
+  if (head - tail + 2 + length > TELEMETRY_RING_BYTES) {
+    producer.dropped++;
+    return;
+  }
+
+  uint8_t prefix[2] = {uint8_t(length), uint8_t(length >> 8)};
+  for (uint8_t i = 0; i < 2; i++) {
+    producer.ring[(head + i) & (TELEMETRY_RING_BYTES - 1)] = prefix[i];
+  }
+  uint32_t start = (head + 2) & (TELEMETRY_RING_BYTES - 1);
+  size_t first = TELEMETRY_RING_BYTES - start;
+  if (first >= length) {
+    memcpy(producer.ring + start, producer.frame, length);
+  } else {
+    memcpy(producer.ring + start, producer.frame, first);
+    memcpy(producer.ring, producer.frame + first, length - first);
+  }
+  producer.head.store(head + 2 + length, std::memory_order_release);
+}
+
+inline uint8_t* telemetry_put_sq15x16(uint8_t* p, const SQ15x16* values, uint16_t count) {
+  for (uint16_t i = 0; i < count; i++) {
+    p = trace_stream_put_u32(p, uint32_t(values[i].getInternal()));
+  }
+  return p;
+}
+
+// Audio task, after publish_audio_frame()
+inline void telemetry_audio_frame(uint32_t t_now_us) {
+  uint8_t channels = telemetry_channels;
+  TelemetryProducer* producer = telemetry_producers[TELEMETRY_AUDIO_PRODUCER];
+  if (channels == 0 || producer == NULL) {
+    return;
+  }
+  uint8_t* data = producer->payload + TELEMETRY_STREAM_HEADER_BYTES;
+
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_PCM)) {
+    uint8_t* p = data;
+    for (uint16_t i = 0; i < audio_hop_size; i++) {
+      p = trace_stream_put_u16(p, uint16_t(waveform[i]));
+    }
+    telemetry_emit(*producer, TELEMETRY_CH_PCM, telemetry_seq[TELEMETRY_CH_PCM]++, t_now_us, p - data);
+  }
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_SPECTROGRAM)) {
+    uint8_t* p = telemetry_put_sq15x16(data, spectrogram, NUM_FREQS);
+    telemetry_emit(*producer, TELEMETRY_CH_SPECTROGRAM, telemetry_seq[TELEMETRY_CH_SPECTROGRAM]++, t_now_us, p - data);
+  }
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_NOVELTY)) {
+    const SQ15x16 features[3] = {latest_novelty(), audio_vu_level, audio_vu_level_average};
+    uint8_t* p = telemetry_put_sq15x16(data, features, 3);
+    telemetry_emit(*producer, TELEMETRY_CH_NOVELTY, telemetry_seq[TELEMETRY_CH_NOVELTY]++, t_now_us, p - data);
+  }
+}
+
+// LED thread, once the frame is shown
+inline void telemetry_led_frame() {
+  uint8_t channels = telemetry_channels;
+  TelemetryProducer* producer = telemetry_producers[TELEMETRY_LED_PRODUCER];
+  if (channels == 0 || producer == NULL) {
+    return;
+  }
+  uint8_t* data = producer->payload + TELEMETRY_STREAM_HEADER_BYTES;
+  uint32_t t_now_us = micros();
+
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_CHROMAGRAM)) {
+    uint8_t* p = telemetry_put_sq15x16(data, chromagram_smooth, 12);
+    telemetry_emit(*producer, TELEMETRY_CH_CHROMAGRAM, telemetry_seq[TELEMETRY_CH_CHROMAGRAM]++, t_now_us, p - data);
+  }
+  if ((channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_LEDS)) && leds_out != NULL) {
+    uint16_t led_count = CONFIG.LED_COUNT;
+    uint32_t seq = telemetry_seq[TELEMETRY_CH_LEDS]++;
+    for (uint16_t first = 0; first < led_count; first += TELEMETRY_LED_CHUNK) {
+      uint16_t last = (led_count - first > TELEMETRY_LED_CHUNK) ? first + TELEMETRY_LED_CHUNK : led_count;
+      uint8_t* p = trace_stream_put_u16(data, first);
+      p = trace_stream_put_u16(p, led_count);
+      for (uint16_t i = first; i < last; i++) {
+        *p++ = leds_out[i].r;
+        *p++ = leds_out[i].g;
+        *p++ = leds_out[i].b;
+      }
+      telemetry_emit(*producer, TELEMETRY_CH_LEDS, seq, t_now_us, p - data);
+    }
+  }
+  if (channels & TELEMETRY_CHANNEL_BIT(TELEMETRY_CH_PERF)) {
+    uint32_t fields[TELEMETRY_PERF_FIELDS];
+    fields[TELEMETRY_PERF_SYSTEM_FPS_X100] = uint32_t(SYSTEM_FPS * 100.0);
+    fields[TELEMETRY_PERF_LED_FPS_X100] = uint32_t(LED_FPS * 100.0);
+    fields[TELEMETRY_PERF_LED_RENDER_US] = led_render_us;
+    fields[TELEMETRY_PERF_LED_SHOW_US] = led_show_us;
+    fields[TELEMETRY_PERF_LED_FRAMES_LATE] = led_frames_late;
+    fields[TELEMETRY_PERF_AUDIO_FRAMES_DROPPED] = audio_frames_dropped;
+    fields[TELEMETRY_PERF_AUDIO_FRAMES_REPEATED] = audio_frames_repeated;
+    fields[TELEMETRY_PERF_RECORDS_DROPPED] = telemetry_dropped_total();
+    uint8_t* p = data;
+    for (uint8_t i = 0; i < TELEMETRY_PERF_FIELDS; i++) {
+      p = trace_stream_put_u32(p, fields[i]);
+    }
+    telemetry_emit(*producer, TELEMETRY_CH_PERF, telemetry_seq[TELEMETRY_CH_PERF]++, t_now_us, p - data);
+  }
+}
+
+// Hand the producer's oldest record to write(); returns its length, 0
+// if the ring is empty
+inline size_t telemetry_send_one(TelemetryProducer& producer, TelemetryWrite write) {
+  uint32_t tail = producer.tail.load(std::memory_order_relaxed);
+  if (tail == producer.head.load(std::memory_order_acquire)) {
+    return 0;
+  }
+  size_t length = producer.ring[tail & (TELEMETRY_RING_BYTES - 1)] |
+                  (size_t(producer.ring[(tail + 1) & (TELEMETRY_RING_BYTES - 1)]) << 8);
+  uint32_t start = (tail + 2) & (TELEMETRY_RING_BYTES - 1);
+  size_t first = TELEMETRY_RING_BYTES - start;
+  if (first >= length) {
+    write(producer.ring + start, length);
+  } else {
+    write(producer.ring + start, first);
+    write(producer.ring, length - first);
+  }
+  producer.tail.store(tail + 2 + length, std::memory_order_release);
+  return length;
+}
+
+// Send queued records, alternating producers, while budget_bytes lasts
+// (the last record may overrun it). Returns the bytes sent
+inline uint32_t send_telemetry(TelemetryWrite write, int32_t budget_bytes) {
+  uint32_t sent = 0;
+  bool more = true;
+  while (more && int32_t(sent) < budget_bytes) {
+    more = false;
+    for (uint8_t i = 0; i < TELEMETRY_NUM_PRODUCERS; i++) {
+      if (telemetry_producers[i] != NULL) {
+        size_t length = telemetry_send_one(*telemetry_producers[i], write);
+        if (length > 0) {
+          sent += length;
+          more = true;
+        }
+      }
+    }
+  }
+  return sent;
+}
+
+static void write_telemetry_serial(const uint8_t* frame, size_t length) {
+  USBSerial.write(frame, length);
+}
+
+// Created in setup() next to trace_consumer_task. A token bucket holds
+// the output to telemetry_budget_kbps, with up to 100 ms of burst
+inline void telemetry_task(void* /*param*/) {
+  int32_t tokens = 0;
+  uint32_t last_us = micros();
+  for (;;) {
+    uint32_t now_us = micros();
+    int32_t rate = int32_t(telemetry_budget_kbps);  // kB/s = bytes/ms
+    tokens += int32_t((now_us - last_us) / 1000) * rate;
+    last_us = now_us - (now_us - last_us) % 1000;
+    if (tokens > rate * 100) {
+      tokens = rate * 100;
+    }
+
+    if (tokens > 0 && telemetry_producers[TELEMETRY_AUDIO_PRODUCER] != NULL) {  // Also flushes what's queued after telemetry=off
+      if (serial_mutex != NULL) {
+        xSemaphoreTake(serial_mutex, portMAX_DELAY);
+      }
+      tokens -= int32_t(send_telemetry(write_telemetry_serial, tokens));
+      if (serial_mutex != NULL) {
+        xSemaphoreGive(serial_mutex);
+      }
+    }
+    vTaskDelay(1);
+  }
+}
+
+#endif // TELEMETRY_STREAM_H
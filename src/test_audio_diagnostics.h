@@ -25,14 +25,15 @@ void diagnose_audio_pipeline() {
   USBSerial.print("Sample History Length: ");
   USBSerial.println(SAMPLE_HISTORY_LENGTH);
   
-  // 2. Check sample_window contents
+  // 2. Check sample window contents
+  const short* window = sample_window_base();
   float max_sample = 0;
   float min_sample = 0;
   float avg_sample = 0;
   int zero_count = 0;
   
   for (int i = 0; i < SAMPLE_HISTORY_LENGTH; i++) {
-    float sample = sample_window[i];
+    float sample = window[i];
     if (sample > max_sample) max_sample = sample;
     if (sample < min_sample) min_sample = sample;
     avg_sample += sample;
@@ -94,8 +95,8 @@ void diagnose_audio_pipeline() {
   
   // 5. Check if sliding window is working
   static short last_window_end = 0;
-  bool window_changed = (sample_window[SAMPLE_HISTORY_LENGTH-1] != last_window_end);
-  last_window_end = sample_window[SAMPLE_HISTORY_LENGTH-1];
+  bool window_changed = (window[SAMPLE_HISTORY_LENGTH-1] != last_window_end);
+  last_window_end = window[SAMPLE_HISTORY_LENGTH-1];
   
   USBSerial.print("\nSliding window updating: ");
   USBSerial.println(window_changed ? "YES" : "NO");
@@ -210,8 +211,10 @@ void generate_test_tone(float frequency, float amplitude = 16000) {
   
   for (int i = 0; i < SAMPLE_HISTORY_LENGTH; i++) {
     float t = (float)i / CONFIG.SAMPLE_RATE;
-    sample_window[i] = (short)(amplitude * sin(2.0 * PI * frequency * t));
+    short sample = (short)(amplitude * sin(2.0 * PI * frequency * t));
+    sample_window_append(&sample, 1);
   }
+  invalidate_gdft_sliding();  // Window was rewritten behind the sliding engine's back
 }
 
 // Function to test specific frequencies
@@ -5,10 +5,10 @@ SQ15x16 IRAM_ATTR interpolate(SQ15x16 index, SQ15x16* array, uint16_t array_size
   SQ15x16 index_f_frac = index_f - index_i;
 
   SQ15x16 left_val  = array[index_i];
-  SQ15x16 right_val = array[index_i + 1];
+  SQ15x16 right_val = left_val;  // index 1.0: don't read past the end
 
-  if (index_i + 1 >= array_size) {
-    right_val = left_val;
+  if (index_i + 1 < array_size) {
+    right_val = array[index_i + 1];
   }
 
   return (1 - index_f_frac) * left_val + index_f_frac * right_val;